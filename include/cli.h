@@ -17,6 +17,9 @@ enum CliCommand {
   CMD_HEX,
   CMD_TX2,
   CMD_TX2HEX,
+  CMD_CAP,      // CAP ON|OFF|DUMP|CLEAR
+  CMD_QRBENCH,  // QRBENCH [n]
+  CMD_NFCBG,    // NFCBG ON|OFF|<budget ‰>
   CMD_UNKNOWN
 };
 
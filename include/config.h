@@ -6,6 +6,9 @@
 #define RC522_MOSI  23
 #define RC522_SS    5
 #define RC522_RST   22
+#define RC522_IRQ   21   // IRQ RC522 -> GPIO (interruption). -1: pas de broche, polling
+#define RC522_SPI_HZ      10000000  // rafales du pilote rc522_drv (max datasheet 10 Mbit/s)
+#define RC522_SPI_SAFE_HZ 4000000   // repli si l'aller-retour FIFO échoue (horloge de la bibliothèque)
 
 // Anti-rebond NFC (en ms)
 #define NFC_DEBOUNCE_MS 1000
@@ -13,6 +16,72 @@
 // Fenêtre de scan NFC lorsqu'une notification est reçue (en ms)
 #define NFC_SCAN_TIMEOUT_MS 15000
 
+// Attente de carte pendant la fenêtre de scan
+#define NFC_IRQ_REARM_MS      20   // REQA réémis à cette période, la tâche dort entre deux
+#define NFC_POLL_INTERVAL_MS  30   // repli polling (IRQ absente ou auto-test en échec)
+
+// Détection de fond (NFCBG): champ RF allumé par courtes salves, éteint entre deux
+#define NFC_BG_ENABLED            0      // actif au démarrage
+#define NFC_BG_IDLE_INTERVAL_MS   500    // période entre salves au repos
+#define NFC_BG_ACTIVE_INTERVAL_MS 100    // période après une carte ou un scan
+#define NFC_BG_ACTIVE_HOLD_MS     10000  // puis doublée à chaque période écoulée
+#define NFC_BG_SETTLE_MS          5      // établissement du champ avant REQA (ISO 14443-3)
+#define NFC_BG_ATQA_US            600    // attente de l'ATQA en mode polling
+#define NFC_BG_BURST_US           6000   // estimation d'une salve avant mesure
+#define NFC_BG_BUDGET_PERMILLE    50     // champ RF allumé au plus 5 % du temps
+
+// Clés MIFARE Classic essayées dans l'ordre (après la dernière clé acceptée pour le même
+// préfixe d'UID). Chaque refus coûte le timeout d'authentification (~25 ms) et une réactivation.
+#define MFC_KEYS { \
+  { { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, MFC_AUTH_KEY_A },  /* transport */ \
+  { { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5 }, MFC_AUTH_KEY_A },  /* MAD (secteurs 0 et 16) */ \
+  { { 0xD3, 0xF7, 0xD3, 0xF7, 0xD3, 0xF7 }, MFC_AUTH_KEY_A },  /* secteurs NDEF NFC Forum */ \
+  { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, MFC_AUTH_KEY_A },  \
+}
+
+// Texte NDEF mémorisé par UID (nfc_read_cache.h), validé à chaque tap par une page ou un bloc
+// relu. Borne la durée pendant laquelle une réécriture de même longueur et même début passe inaperçue.
+#define NFC_READ_CACHE_TTL_MS 300000
+
+// Index local des cartes NFC (nfc_auth_index.h): partition "nfcauth" (partitions.csv),
+// deux emplacements A/B, deltas backend appliqués quand le workflow est au repos
+#define NFC_AUTH_PARTITION_LABEL   "nfcauth"
+#define NFC_AUTH_SYNC_INTERVAL_MS  300000   // demande de delta à jour
+#define NFC_AUTH_RETRY_MS          60000    // après un échec (réseau, page refusée)
+#define NFC_AUTH_HTTP_TIMEOUT_MS   10000
+#define NFC_AUTH_RESPONSE_TIMEOUT_MS 15000  // réponse perdue (requête rejetée par le service HTTP)
+
+// Connexion Wi-Fi: BSSID, canal et configuration IP de la dernière connexion en NVS
+// (wifi_fast_connect.h), connexion directe tentée avant le balayage complet
+#define WIFI_CONNECT_TIMEOUT_MS       10000
+#define WIFI_CONNECT_POLL_MS          10
+#define WIFI_FAST_CONNECT_ENABLED     1
+#define WIFI_FAST_CONNECT_TIMEOUT_MS  3000   // sur le temps total de WIFI_CONNECT_TIMEOUT_MS
+#define WIFI_FAST_REUSE_IP            0      // dernier bail DHCP repris comme IP fixe (réservation DHCP requise)
+#define NVS_NAMESPACE_WIFI_FAST       "wifi_fast"
+
+// Réseaux enregistrés (wifi_networks.h): priorité puis latence backend mesurée
+#define WIFI_NET_DEFAULT_PRIORITY     5
+#define WIFI_NET_ATTEMPT_TIMEOUT_MS   4000   // par réseau quand d'autres candidats suivent
+#define WIFI_NET_SCAN_MAX             16     // AP de réseaux connus retenus au balayage
+#define WIFI_NET_SCAN_DWELL_MS        120    // par canal (balayage actif)
+
+// Reconnexion pilotée par les événements du pilote (wifi_reconnect.h) et test du backend
+#define WIFI_RECONNECT_BASE_MS        500    // délai après une coupure, doublé à chaque échec (gigue 50 %)
+#define WIFI_RECONNECT_MAX_MS         60000
+#define WIFI_RECONNECT_PORTAL_AFTER   8      // échecs consécutifs avant de relancer le portail SoftAP
+#define WIFI_PORTAL_POLL_MS           20     // service du portail HTTP
+#define WIFI_TASK_IDLE_WAIT_MS        1000
+#define WIFI_BACKEND_CHECK_ENABLED    1      // READY exige une connexion TCP réussie à l'hôte de l'API
+#define WIFI_BACKEND_CHECK_INTERVAL_MS 60000
+#define WIFI_BACKEND_RETRY_MS         5000
+#define WIFI_BACKEND_CHECK_TIMEOUT_MS 3000
+
+// Économie d'énergie Wi-Fi (wifi_power.h): WIFI_PS_NONE pendant un workflow, modem sleep au repos
+#define WIFI_POWER_POLICY_ENABLED     1      // 0: modem sleep permanent
+#define WIFI_PS_SLEEP_CURRENT_MA      30     // courant moyen de la carte au repos en modem sleep (banc, DTIM 1)
+#define WIFI_PS_AWAKE_CURRENT_MA      110    // idem radio toujours éveillée
+
 // Configuration tâches FreeRTOS
 #define NFC_TASK_STACK_SIZE         4096
 #define NFC_TASK_PRIORITY           1
@@ -22,11 +91,55 @@
 // File d'événements orchestrateur
 #define ORCHESTRATOR_QUEUE_LENGTH   10
 
+// Mises à jour de quantités envoyées item par item pendant la livraison
+#define ORDER_HTTP_TIMEOUT_MS             10000
+#define ORDER_UPDATE_RESPONSE_TIMEOUT_MS  15000  // réponse perdue (requête rejetée par le service HTTP)
+
+// Cache des tokens QR récents (réponse locale aux scans répétés)
+#define QR_TOKEN_CACHE_REJECTED_TTL_MS    30000    // token refusé: nouvel essai backend après 30 s
+#define QR_TOKEN_CACHE_CONSUMED_TTL_MS    600000   // commande livrée
+#define QR_TOKEN_CACHE_IN_PROGRESS_TTL_MS 120000   // borne de sécurité si le workflow ne se termine pas
+
+// Tokens QR signés acceptés hors ligne (rapprochement backend différé)
+#define OFFLINE_SALES_MAX                 8
+#define OFFLINE_RECONCILE_RETRY_MS        60000
+#define QR_SPENT_RETENTION_MARGIN_S       3600     // order_id servi gardé 1 h après l'expiration (dérive d'horloge)
+#define NVS_NAMESPACE_OFFLINE             "offline_qr"
+
 // UART vers NUCLEO (adapter si besoin)
 #define UART_BAUDRATE 115200
 #define UART_TX_PIN   25
 #define UART_RX_PIN   26
 
+// Protocole binaire tramé (COBS + CRC-16 + fenêtre d'ACK) proposé à la NUCLEO.
+// Négocié depuis le protocole texte, repli automatique sur le texte si refusé ou en échec.
+#define UART_BINARY_PROTOCOL_ENABLED 1
+
+// Négociation du débit NUCLEO (UART_BAUDRATE reste le débit de démarrage et de repli)
+#define UART_BAUD_NEGOTIATION_ENABLED 1
+#define UART_BAUD_MAX                 921600
+#define UART_BAUD_RETRY_INTERVAL_MS   60000  // nouvel essai après un repli, liaison au repos
+#define UART_BAUD_RETRY_QUIET_MS      2000   // silence RX minimal avant un nouvel essai
+#define UART_NEGOTIATION_DEFER_LINES  4      // lignes NUCLEO reçues pendant la négociation, traitées après
+
+// Capture du trafic UART (commande CAP ON|OFF|DUMP|CLEAR), arrêtée au démarrage
+#define UART_CAPTURE_ENABLED          1
+#define UART_CAPTURE_PSRAM_BYTES      (256 * 1024)
+#define UART_CAPTURE_INTERNAL_BYTES   (16 * 1024)   // repli sans PSRAM
+
+// Journal console asynchrone (services/log_service.h)
+#define LOG_TASK_STACK_SIZE           4096   // snprintf de flottants
+#define LOG_TASK_PRIORITY             1      // au plus bas des tâches applicatives
+#define LOG_DRAIN_PERIOD_MS           20     // file de 32 messages: ~1600 messages/s en rafale
+#define LOG_LINE_MAX                  256
+
+// Tâche d'émission UART NUCLEO (seule à écrire sur le port)
+#define UART_TX_TASK_STACK_SIZE        3072
+#define UART_TX_TASK_PRIORITY          2
+#define UART_TX_QUEUE_LENGTH           32     // lignes (un bloc ORDER_START doit y tenir en entier)
+#define UART_TX_PRIORITY_QUEUE_LENGTH  8      // réponses ACK/NAK/ERR
+#define UART_TX_BINARY_POLL_MS         10     // réveil pour retransmissions en mode binaire
+
 // Activer un fallback de lecture sur UART0 (Serial) si le câblage utilise RX0/TX0
 #define UART0_FALLBACK_ENABLED 1
 
@@ -34,5 +147,10 @@
 #define QR_UART_BAUDRATE 115200
 #define QR_UART_TX_PIN   17
 #define QR_UART_RX_PIN   16
+// Driver IDF UART2: réveil sur fin de ligne (pattern) ou silence de la liaison (RX timeout)
+#define QR_UART_RX_BUFFER_BYTES    1024
+#define QR_UART_EVENT_QUEUE_LEN    16
+#define QR_UART_PATTERN_CHR        '\r'   // suffixe CR (CR/LF) des scanners
+#define QR_UART_RX_TIMEOUT_SYMBOLS 10     // ~0.9 ms de silence à 115200 bauds
 
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Format binaire des mots de passe Wi-Fi en NVS (putBytes, un blob par emplacement).
+//
+//   AES-256-GCM: format(1) | nonce(12) | chiffré(n) | tag(16)
+//   en clair   : format(1) | mot de passe(n)      (chiffrement désactivé ou réseau ouvert)
+//
+// La clé de chaque réseau est dérivée une fois par démarrage: clé maître PBKDF2-HMAC-SHA256
+// (MAC eFuse, sel PASSWORD_SALT) gardée en RAM, puis HKDF-Expand(clé maître, SSID). Le SSID
+// est aussi la donnée authentifiée du GCM: un blob recopié sur un autre réseau est refusé.
+// Les primitives (accélérateurs SHA/AES de l'ESP32 via mbedtls) sont dans security_utils.cpp;
+// ce module ne fait que le découpage du blob et le décodage de l'ancien format hexadécimal.
+
+#define CRED_KEY_SIZE       32
+#define CRED_NONCE_SIZE     12
+#define CRED_TAG_SIZE       16
+#define CRED_PASS_MAX       64    // WPA2: 63 caractères (64 en hexadécimal)
+
+#define CRED_FORMAT_PLAIN   0
+#define CRED_FORMAT_AES_GCM 1
+
+#define CRED_BLOB_MAX       (1 + CRED_NONCE_SIZE + CRED_PASS_MAX + CRED_TAG_SIZE)
+
+// Vue sur un blob: pointeurs dans le tampon de l'appelant
+typedef struct {
+  uint8_t format;
+  uint8_t* nonce;           // nullptr en clair
+  uint8_t* data;            // chiffré ou mot de passe
+  size_t dataLen;
+  uint8_t* tag;             // nullptr en clair
+} CredBlob;
+
+// Taille du blob pour un mot de passe de passLen octets (0: format inconnu ou trop long)
+size_t CredBlob_Size(uint8_t format, size_t passLen);
+
+// Écrit l'en-tête et découpe buf pour un mot de passe de passLen octets; l'appelant remplit
+// nonce, data et tag. Retourne la taille totale (0: tampon trop petit ou trop long)
+size_t CredBlob_Layout(uint8_t* buf, size_t bufSize, uint8_t format, size_t passLen, CredBlob* out);
+
+// Découpe un blob lu en NVS (format connu, tailles cohérentes)
+bool CredBlob_Parse(uint8_t* buf, size_t len, CredBlob* out);
+
+// Ancien format: chiffré AES-ECB stocké en hexadécimal (majuscules ou minuscules)
+bool CredBlob_HexDecode(const char* hex, uint8_t* out, size_t outSize, size_t* outLen);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,10 +10,14 @@
 #define DEFAULT_API_DELIVERY_CONFIRM_ENDPOINT "/api/order-delivery/confirm"
 #define DEFAULT_API_UPDATE_QUANTITIES_ENDPOINT "/api/stocks/update-quantity"
 #define DEFAULT_API_SUPERVISION_ENDPOINT "/api/supervision/event-notification"
+#define DEFAULT_API_NFC_AUTH_ENDPOINT "/api/nfc-auth/delta"
 
 // Tailles maximales pour les URLs
 #define MAX_URL_LENGTH 256
 #define MAX_ENDPOINT_LENGTH 128
+#define MAX_QR_PUBLIC_KEY_LENGTH 96   // base64url d'un point P-256 non compressé (87 caractères)
+#define MAX_ENV_MACHINE_ID_LENGTH 32
+#define MAX_WIFI_STATIC_IP_LENGTH 80   // "ip,passerelle,masque[,dns1[,dns2]]"
 
 // Structure pour stocker la configuration
 typedef struct {
@@ -24,6 +28,10 @@ typedef struct {
   char api_delivery_confirm_endpoint[MAX_ENDPOINT_LENGTH];
   char api_update_quantities_endpoint[MAX_ENDPOINT_LENGTH];
   char api_supervision_endpoint[MAX_ENDPOINT_LENGTH];
+  char api_nfc_auth_endpoint[MAX_ENDPOINT_LENGTH];   // pages de l'index local des cartes NFC
+  char qr_public_key[MAX_QR_PUBLIC_KEY_LENGTH];      // vérification locale des tokens signés (vide: désactivée)
+  char machine_id[MAX_ENV_MACHINE_ID_LENGTH];        // contrôle d'affectation des tokens signés (vide: aucun)
+  char wifi_static_ip[MAX_WIFI_STATIC_IP_LENGTH];    // IP fixe sans DHCP (vide: DHCP)
   bool loaded_from_env;
 } ApiConfig;
 
@@ -43,6 +51,7 @@ public:
     static String GetDeliveryConfirmUrl();
     static String GetUpdateQuantitiesUrl();
     static String GetSupervisionUrl();
+    static String GetNfcAuthUrl();
   
   // Getters pour les composants
   static const char* GetApiBaseUrl();
@@ -52,6 +61,14 @@ public:
   static const char* GetDeliveryConfirmEndpoint();
   static const char* GetUpdateQuantitiesEndpoint();
   static const char* GetSupervisionEndpoint();
+  static const char* GetNfcAuthEndpoint();
+  
+  // Tokens QR signés
+  static const char* GetQrPublicKey();
+  static const char* GetMachineId();
+  
+  // Wi-Fi
+  static const char* GetWifiStaticIp();
   
   // Utilitaires
   static bool IsLoadedFromEnv();
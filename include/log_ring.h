@@ -0,0 +1,138 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// File de journalisation sans verrou, plusieurs producteurs / un consommateur.
+//
+// Le producteur ne formate rien: il enregistre le pointeur vers la chaîne de format (littéral,
+// durée de vie statique), l'heure et les arguments bruts typés. Les chaînes (%s) sont copiées
+// dans l'enregistrement, tronquées à LOG_RING_TEXT_SIZE octets au total, car les c_str() de
+// temporaires ne vivent pas jusqu'au formatage. Une tâche de basse priorité dépile, formate
+// (LogRing_Format) et écrit sur la console.
+//
+// File bornée à numéros de séquence par case: réservation d'une case par compare-and-swap
+// sur la tête, publication par écriture de la séquence. File pleine: enregistrement perdu et
+// compté, jamais d'attente.
+
+#define LOG_RING_CAPACITY     32      // puissance de 2
+#define LOG_RING_MAX_ARGS     8
+#define LOG_RING_TEXT_SIZE    96
+
+typedef enum {
+  LOG_ARG_INT = 0,
+  LOG_ARG_UINT,
+  LOG_ARG_DOUBLE,
+  LOG_ARG_PTR,
+  LOG_ARG_STR,
+} LogArgType;
+
+// Argument tel que passé par l'appelant (LogRing_Write le construit)
+typedef struct {
+  uint8_t type;           // LogArgType
+  uint8_t size;           // taille de l'entier après promotion (int au minimum)
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void* p;
+    const char* s;
+  } v;
+} LogArg;
+
+typedef struct {
+  uint32_t seq;           // numéro de séquence de la case, accès atomique
+  uint32_t timeMs;
+  const char* fmt;
+  uint8_t argc;
+  uint8_t textLen;
+  uint8_t type[LOG_RING_MAX_ARGS];
+  uint8_t size[LOG_RING_MAX_ARGS];
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void* p;
+    uint16_t text;        // LOG_ARG_STR: début dans text[], 0xFFFF pour nullptr
+  } arg[LOG_RING_MAX_ARGS];
+  char text[LOG_RING_TEXT_SIZE];
+} LogRecord;
+
+typedef struct {
+  LogRecord slots[LOG_RING_CAPACITY];
+  uint32_t head;          // prochaine case à réserver, accès atomique
+  uint32_t tail;          // prochaine case à lire (consommateur seul)
+  uint32_t written;       // compteurs, accès atomique
+  uint32_t dropped;
+} LogRing;
+
+void LogRing_Init(LogRing* r);
+
+// Producteur (toute tâche): false si la file est pleine (compté dans dropped)
+bool LogRing_Push(LogRing* r, uint32_t timeMs, const char* fmt, const LogArg* args, uint8_t argc);
+
+// Consommateur unique: copie le plus ancien enregistrement publié, false si aucun
+bool LogRing_Pop(LogRing* r, LogRecord* out);
+
+// Formate un enregistrement comme printf (conversions d i u o x X c s p f F e E g G a A %,
+// largeur et précision littérales seulement, pas de *).
+// Retourne la longueur écrite, tronquée à size - 1.
+size_t LogRing_Format(const LogRecord* rec, char* out, size_t size);
+
+uint32_t LogRing_Dropped(const LogRing* r);
+uint32_t LogRing_Written(const LogRing* r);
+
+#ifdef __cplusplus
+}
+
+#include <type_traits>
+
+// Construction des arguments typés à la compilation
+template <typename T>
+static inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, LogArg>::type
+LogRing_Arg(T v) {
+  LogArg a;
+  a.type = std::is_signed<T>::value ? LOG_ARG_INT : LOG_ARG_UINT;
+  a.size = (uint8_t)(sizeof(T) < sizeof(int) ? sizeof(int) : sizeof(T));   // promotion en int comme printf
+  if (std::is_signed<T>::value) a.v.i = (int64_t)v; else a.v.u = (uint64_t)v;
+  return a;
+}
+
+template <typename T>
+static inline typename std::enable_if<std::is_floating_point<T>::value, LogArg>::type LogRing_Arg(T v) {
+  LogArg a;
+  a.type = LOG_ARG_DOUBLE;
+  a.size = (uint8_t)sizeof(double);
+  a.v.d = (double)v;
+  return a;
+}
+
+static inline LogArg LogRing_Arg(const char* s) {
+  LogArg a;
+  a.type = LOG_ARG_STR;
+  a.size = (uint8_t)sizeof(s);
+  a.v.s = s;
+  return a;
+}
+
+static inline LogArg LogRing_Arg(const void* p) {
+  LogArg a;
+  a.type = LOG_ARG_PTR;
+  a.size = (uint8_t)sizeof(p);
+  a.v.p = p;
+  return a;
+}
+
+// fmt: littéral (seul son pointeur est conservé)
+template <typename... Args>
+static inline bool LogRing_Write(LogRing* r, uint32_t timeMs, const char* fmt, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_RING_MAX_ARGS, "LogRing_Write: trop d'arguments");
+  const LogArg packed[sizeof...(Args) + 1] = { LogRing_Arg(args)... };
+  return LogRing_Push(r, timeMs, fmt, packed, (uint8_t)sizeof...(Args));
+}
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lecture NDEF des MIFARE Classic 1K/4K (mapping NFC Forum "Type MIFARE Classic"):
+//   1) secteur 0 (et secteur 16 sur 4K): MAD, secteurs d'AID NDEF 0x03E1
+//   2) une authentification par secteur, puis tous ses blocs de données
+//   3) secteurs NDEF suivants jusqu'à la fin du TLV NDEF
+// Sans MAD valide (carte non formatée NFC Forum), secteurs lus à la suite depuis le 1.
+//
+// Clés essayées dans l'ordre de la table, en commençant par la dernière clé acceptée
+// pour le même préfixe d'UID (cartes d'un même lot), séparément pour MAD et données.
+// Un préfixe dont la dernière carte n'avait pas de MAD saute la lecture du secteur 0.
+// Le buffer de sortie contient les blocs de données concaténés (trailers exclus):
+// il se parse directement comme une suite de TLV.
+
+#define MFC_AUTH_KEY_A         0x60
+#define MFC_AUTH_KEY_B         0x61
+#define MFC_BLOCK_SIZE         16
+#define MFC_SECTORS_1K         16
+#define MFC_SECTORS_4K         40
+#define MFC_NDEF_AID_LO        0x03   // AID 0xE103 (cluster NDEF 0xE1), octet faible en premier
+#define MFC_NDEF_AID_HI        0xE1
+#define MFC_READER_MAX_BYTES   1024
+
+// Cache des clés: préfixe d'UID -> index de la dernière clé acceptée
+#define MFC_KEY_CACHE_SIZE     8
+#define MFC_UID_PREFIX_LEN     3
+#define MFC_KEY_UNKNOWN        0xFF
+
+typedef struct {
+  uint8_t key[6];
+  uint8_t type;            // MFC_AUTH_KEY_A ou MFC_AUTH_KEY_B
+} MfcKey;
+
+typedef enum {
+  MFC_READ_OK = 0,
+  MFC_READ_ERR_IO = -1,        // lecture de bloc en échec
+  MFC_READ_ERR_AUTH = -2,      // aucune clé de la table acceptée
+  MFC_READ_ERR_NO_NDEF = -3,   // pas de TLV NDEF (ou message tronqué)
+  MFC_READ_ERR_TOO_LARGE = -4  // message plus grand que le buffer
+} MfcReadResult;
+
+// Transport vers la carte (Crypto1 géré par le lecteur).
+// auth authentifie le secteur contenant 'block'. Après un refus la carte ne répond plus:
+// reactivate (WUPA + SELECT) la remet en état ACTIVE avant la clé suivante.
+typedef struct {
+  bool (*auth)(void* ctx, uint8_t keyType, uint8_t block, const uint8_t key[6]);
+  bool (*read)(void* ctx, uint8_t block, uint8_t out[16]);
+  bool (*reactivate)(void* ctx);
+  void* ctx;
+} MfcTransport;
+
+typedef struct {
+  uint8_t prefix[MFC_UID_PREFIX_LEN];
+  uint8_t prefixLen;
+  uint8_t madKey;          // index dans la table, MFC_KEY_UNKNOWN sinon
+  uint8_t dataKey;
+  bool noMad;              // MAD absente sur la dernière carte: secteurs lus à la suite
+  uint32_t lastUse;
+  bool used;
+} MfcKeyCacheEntry;
+
+typedef struct {
+  MfcKeyCacheEntry entries[MFC_KEY_CACHE_SIZE];
+  uint32_t clock;
+} MfcKeyCache;
+
+typedef struct {
+  bool mad;                // secteurs NDEF pris dans la MAD
+  uint8_t sectors;         // secteurs de données lus
+  uint8_t auths;           // authentifications émises
+  uint8_t authFailures;
+  uint8_t cacheHits;       // clé mémorisée acceptée du premier coup
+  uint8_t blocks;          // blocs lus (MAD comprise)
+  uint16_t ndefOffset;     // début du message NDEF dans le buffer (après T et L)
+  uint16_t ndefLen;
+  uint16_t bytesRead;      // octets de données placés dans le buffer, même en échec
+  uint8_t firstBlock;      // bloc lu en tête du buffer (0: aucun)
+} MfcReadInfo;
+
+void MfcKeyCache_Init(MfcKeyCache* c);
+// Entrée du préfixe de l'UID, créée si absente (la plus ancienne est remplacée)
+MfcKeyCacheEntry* MfcKeyCache_Get(MfcKeyCache* c, const uint8_t* uid, size_t uidLen);
+
+uint8_t MfcReader_SectorFirstBlock(uint8_t sector);
+uint8_t MfcReader_SectorDataBlocks(uint8_t sector);   // 3, ou 15 pour les secteurs 32..39 (4K)
+// CRC-8 MAD (polynôme 0x1D, valeur initiale 0xC7)
+uint8_t MfcReader_MadCrc(const uint8_t* data, size_t len);
+
+// sectorCount: MFC_SECTORS_1K ou MFC_SECTORS_4K. cache optionnel.
+// Retourne le nombre d'octets placés dans buf jusqu'à la fin du TLV NDEF (>0)
+// ou un MfcReadResult négatif.
+int MfcReader_ReadNdef(const MfcTransport* t, const MfcKey* keys, size_t keyCount, MfcKeyCache* cache,
+                       const uint8_t* uid, size_t uidLen, uint8_t sectorCount,
+                       uint8_t* buf, size_t bufSize, MfcReadInfo* info);
+
+// Un bloc avec la clé de données mémorisée pour ce préfixe d'UID: une authentification
+// et un READ, sans parcourir la table. false si aucune clé mémorisée, refus ou erreur
+// (carte muette jusqu'à la réactivation).
+bool MfcReader_ReadBlock(const MfcTransport* t, const MfcKey* keys, size_t keyCount, MfcKeyCache* cache,
+                         const uint8_t* uid, size_t uidLen, uint8_t block, uint8_t out[MFC_BLOCK_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Index des cartes NFC autorisées (personnel, réassort) ou bloquées, lu directement en flash.
+//
+// Clé: empreinte 40 bits de l'UID = 40 bits de poids fort du FNV-1a 64 des octets de l'UID
+// (le backend calcule la même empreinte, aucun UID en clair en flash).
+//
+// Image (little-endian), écrite en un seul passage:
+//   en-tête (32 octets) | répertoire | enregistrements
+//   répertoire   : 2^12 + 1 entiers u32, index du premier enregistrement de chaque seau
+//                  (12 bits de poids fort de l'empreinte), dernier = nombre d'enregistrements
+//   enregistrement: empreinte 5 octets big-endian + drapeaux, triés par empreinte croissante
+// Recherche: deux lectures du répertoire puis dichotomie dans le seau (~25 entrées à 100k).
+// L'en-tête est écrit en dernier: une image interrompue reste invalide.
+//
+// Synchronisation backend par pages texte (corps HTTP de 1 Ko au plus):
+//   "<from> <to> <more>[ <after>]\n" puis une opération par ligne, empreintes croissantes:
+//   "+<10 hex> <2 hex drapeaux>\n" ajout ou mise à jour, "-<10 hex>\n" suppression.
+//   from = 0: image complète (snapshot), sinon delta depuis la version 'from'.
+//   more = 1: page suivante demandée après la dernière empreinte reçue (curseur).
+//   after: curseur de la requête renvoyé (10 hex), absent pour la première page; une réponse
+//   arrivée en retard est ainsi reconnue et écartée.
+// Les opérations sont fusionnées au fil de l'eau avec l'image courante vers l'autre
+// emplacement flash; la nouvelle image remplace l'ancienne une fois complète.
+
+#define NFC_AUTH_MAGIC          0x5849414Eu   // "NAIX"
+#define NFC_AUTH_FORMAT         1
+#define NFC_AUTH_HASH_BITS      40
+#define NFC_AUTH_HASH_MASK      0xFFFFFFFFFFull
+#define NFC_AUTH_RECORD_SIZE    6
+#define NFC_AUTH_DIR_BITS       12
+#define NFC_AUTH_DIR_ENTRIES    ((1u << NFC_AUTH_DIR_BITS) + 1)
+#define NFC_AUTH_HEADER_SIZE    32
+#define NFC_AUTH_RECORDS_OFFSET (NFC_AUTH_HEADER_SIZE + 4 * NFC_AUTH_DIR_ENTRIES)
+
+#define NFC_AUTH_FLAG_STAFF     0x01   // maintenance
+#define NFC_AUTH_FLAG_REFILL    0x02   // réassort
+#define NFC_AUTH_FLAG_BLOCKED   0x80   // prioritaire sur les autres drapeaux
+#define NFC_AUTH_ABSENT         (-1)
+
+// Tampons d'écriture du constructeur
+#define NFC_AUTH_CHUNK_RECORDS  42     // 252 octets
+#define NFC_AUTH_CHUNK_DIR      64     // 256 octets
+
+typedef enum {
+  NFC_AUTH_OK = 0,
+  NFC_AUTH_ERR_MALFORMED = -1,  // page illisible
+  NFC_AUTH_ERR_ORDER = -2,      // empreintes non croissantes (ou antérieures au curseur)
+  NFC_AUTH_ERR_FULL = -3,       // capacité de l'emplacement dépassée
+  NFC_AUTH_ERR_IO = -4          // écriture flash en échec
+} NfcAuthResult;
+
+typedef struct {
+  const uint8_t* dir;
+  const uint8_t* records;
+  uint32_t count;
+  uint32_t version;             // version backend, 0: index vide
+  uint32_t generation;          // incrémentée à chaque image écrite (choix au démarrage)
+} NfcAuthIndex;
+
+// Écriture dans l'emplacement cible (zone effacée par l'appelant)
+typedef bool (*NfcAuthWriteFn)(void* ctx, uint32_t offset, const uint8_t* data, size_t len);
+
+typedef struct {
+  NfcAuthWriteFn write;
+  void* ctx;
+  uint32_t capacity;            // enregistrements
+  uint32_t count;
+  uint64_t lastHash;
+  uint32_t nextBucket;          // prochaine entrée du répertoire à émettre
+  uint32_t dirWritten;
+  uint32_t dirCrc;
+  uint32_t recCrc;
+  uint8_t recBuf[NFC_AUTH_CHUNK_RECORDS * NFC_AUTH_RECORD_SIZE];
+  uint8_t dirBuf[NFC_AUTH_CHUNK_DIR * 4];
+  uint16_t recFill;
+  uint16_t dirFill;
+  NfcAuthResult error;
+} NfcAuthBuilder;
+
+typedef struct {
+  NfcAuthBuilder b;
+  NfcAuthIndex base;            // image courante (vide pour un snapshot)
+  uint32_t baseIdx;
+  uint64_t lastOp;
+  bool hasOp;
+  uint32_t puts;
+  uint32_t removes;
+} NfcAuthMerge;
+
+typedef struct {
+  uint32_t from;
+  uint32_t to;
+  bool more;
+  uint16_t ops;
+  uint64_t lastHash;            // curseur de la page suivante
+  uint64_t after;               // curseur de la requête renvoyé par le backend
+  bool hasAfter;                // false: première page de la session
+} NfcAuthPage;
+
+uint64_t NfcAuthIndex_HashUid(const uint8_t* uid, size_t len);
+size_t NfcAuthIndex_ImageSize(uint32_t count);
+uint32_t NfcAuthIndex_Capacity(size_t imageBytes);
+
+void NfcAuthIndex_Clear(NfcAuthIndex* idx);
+// En-tête, bornes et CRC (checkCrc) vérifiés; l'image doit rester accessible
+bool NfcAuthIndex_Open(NfcAuthIndex* idx, const uint8_t* image, size_t size, bool checkCrc);
+// Drapeaux de la carte, NFC_AUTH_ABSENT si inconnue
+int NfcAuthIndex_Lookup(const NfcAuthIndex* idx, uint64_t hash);
+// "BLOCKED", "STAFF", "REFILL", "ALLOWED" ou "UNKNOWN" (NFC_AUTH_ABSENT)
+const char* NfcAuthIndex_RoleName(int flags);
+
+// ---- Construction d'une image (empreintes strictement croissantes) ----
+void NfcAuthBuilder_Begin(NfcAuthBuilder* b, NfcAuthWriteFn write, void* ctx, size_t imageBytes);
+bool NfcAuthBuilder_Add(NfcAuthBuilder* b, uint64_t hash, uint8_t flags);
+bool NfcAuthBuilder_Finish(NfcAuthBuilder* b, uint32_t generation, uint32_t version);
+
+// ---- Fusion image courante + opérations croissantes ----
+// base NULL: snapshot (image reconstruite depuis zéro)
+void NfcAuthMerge_Begin(NfcAuthMerge* m, const NfcAuthIndex* base, NfcAuthWriteFn write, void* ctx,
+                        size_t imageBytes);
+bool NfcAuthMerge_Put(NfcAuthMerge* m, uint64_t hash, uint8_t flags);
+bool NfcAuthMerge_Remove(NfcAuthMerge* m, uint64_t hash);
+bool NfcAuthMerge_Finish(NfcAuthMerge* m, uint32_t generation, uint32_t version);
+
+// ---- Pages de synchronisation ----
+// En-tête seul (snapshot, delta ou index à jour) avant d'ouvrir la fusion
+bool NfcAuthSync_ParseHeader(const char* body, NfcAuthPage* page);
+// Applique les opérations de la page (croissantes aussi d'une page à l'autre)
+NfcAuthResult NfcAuthSync_ApplyPage(NfcAuthMerge* m, const char* body, NfcAuthPage* page);
+
+#ifdef __cplusplus
+}
+#endif
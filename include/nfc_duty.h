@@ -0,0 +1,79 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NFC_DUTY_UID_MAX 10          // UID triple (ISO 14443-3)
+
+// Détection de carte NFC en tâche de fond à faible rapport cyclique.
+// Le champ RF n'est allumé que pendant de courtes salves (établissement du champ,
+// REQA, attente de l'ATQA) espacées d'une période adaptative:
+//  - rapide (activeIntervalMs) pendant activeHoldMs après une activité,
+//  - puis doublée à chaque période activeHoldMs écoulée jusqu'à idleIntervalMs,
+//  - jamais plus courte que ce qu'autorise le budget RF (‰ du temps champ allumé).
+// Le champ étant coupé entre deux salves, une carte restée posée repart de IDLE et répond à
+// chaque REQA: son UID est retenu tant qu'elle répond, pour ne la signaler qu'une fois.
+//
+// Module pur: l'appelant mesure les salves et fournit l'horloge (ms).
+
+typedef struct {
+  uint32_t idleIntervalMs;     // période entre deux salves au repos
+  uint32_t activeIntervalMs;   // période après une activité
+  uint32_t activeHoldMs;       // maintien de la période rapide après l'activité
+  uint32_t burstUs;            // durée estimée d'une salve avant la première mesure
+  uint16_t budgetPermille;     // part maximale du temps avec champ RF allumé (1..1000)
+} NfcDutyConfig;
+
+typedef struct {
+  NfcDutyConfig cfg;
+  uint32_t startMs;            // début des statistiques
+  uint32_t lastActivityMs;
+  bool hadActivity;
+  uint32_t lastBurstMs;        // début de la dernière salve
+  bool hadBurst;
+  uint64_t rfOnUs;             // salves + fenêtres de scan
+  uint64_t burstUsTotal;       // salves seules (durée moyenne pour le budget)
+  uint32_t bursts;
+  uint32_t detections;
+  uint32_t lastLatencyMs;      // borne haute: carte posée au plus tôt après la salve précédente
+  uint32_t maxLatencyMs;
+  uint64_t latencySumMs;
+  uint8_t presentUid[NFC_DUTY_UID_MAX];   // carte sur le lecteur à la dernière salve
+  uint8_t presentUidLen;                  // 0: aucune
+} NfcDuty;
+
+void NfcDuty_Init(NfcDuty* d, const NfcDutyConfig* cfg, uint32_t nowMs);
+// Budget borné à 1..1000 ‰
+void NfcDuty_SetBudget(NfcDuty* d, uint16_t permille);
+
+// Période minimale imposée par le budget (durée moyenne mesurée d'une salve)
+uint32_t NfcDuty_MinIntervalMs(const NfcDuty* d);
+// Période courante entre deux débuts de salve
+uint32_t NfcDuty_IntervalMs(const NfcDuty* d, uint32_t nowMs);
+// Temps restant avant la prochaine salve (0: salve due)
+uint32_t NfcDuty_NextBurstDelayMs(const NfcDuty* d, uint32_t nowMs);
+
+// Activité (scan demandé, carte lue): repasse en cadence rapide
+void NfcDuty_MarkActivity(NfcDuty* d, uint32_t nowMs);
+// Salve terminée: début, durée champ allumé, nouvelle carte signalée ou non (une carte restée
+// posée ne compte ni comme détection ni comme activité)
+void NfcDuty_RecordBurst(NfcDuty* d, uint32_t startMs, uint32_t rfOnUs, bool card);
+// Carte sélectionnée (salve ou fenêtre de scan): true si c'est la carte déjà présente et jamais
+// retirée depuis, à ne pas signaler de nouveau. L'UID est retenu dans tous les cas.
+bool NfcDuty_CardPresent(NfcDuty* d, const uint8_t* uid, uint8_t len);
+// Salve sans ATQA: carte retirée, son prochain passage sera signalé
+void NfcDuty_CardGone(NfcDuty* d);
+// Champ allumé hors salve (fenêtre de scan)
+void NfcDuty_AddRfOn(NfcDuty* d, uint32_t rfOnUs);
+
+// Rapport cyclique RF depuis NfcDuty_Init, en ‰
+uint32_t NfcDuty_DutyPermille(const NfcDuty* d, uint32_t nowMs);
+uint32_t NfcDuty_AvgLatencyMs(const NfcDuty* d);
+
+#ifdef __cplusplus
+}
+#endif
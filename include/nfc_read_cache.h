@@ -0,0 +1,63 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Dernières lectures par UID: texte NDEF déjà extrait et octets de tête de la mémoire du tag
+// (sonde). Au tap suivant de la même carte, une seule page Type 2 ou un seul bloc MIFARE
+// Classic est relu et comparé à la sonde avant de reprendre le texte, au lieu de la lecture
+// complète (CC + FAST_READ, ou MAD + une authentification par secteur).
+//
+// La sonde couvre les 16 premiers octets du TLV NDEF (longueur, en-tête du record, début du
+// texte): un message réécrit avec la même longueur et le même début n'est vu qu'à
+// l'expiration de l'entrée (ttlMs de NfcReadCache_Find).
+
+#define NFC_READ_CACHE_SIZE        8
+#define NFC_READ_CACHE_UID_MAX     10
+#define NFC_READ_CACHE_PROBE_SIZE  16     // une réponse READ Type 2 (4 pages) ou un bloc Classic
+#define NFC_READ_CACHE_TEXT_MAX    120    // texte rendu par l'extraction NDEF de nfc_service
+
+typedef struct {
+  uint8_t uid[NFC_READ_CACHE_UID_MAX];
+  uint8_t uidLen;
+  uint8_t probeAddr;        // page Type 2 ou bloc Classic relu pour valider l'entrée
+  uint8_t probeLen;         // octets significatifs de la sonde (message plus court que 16 octets)
+  uint8_t probe[NFC_READ_CACHE_PROBE_SIZE];
+  bool hasText;             // false: carte lue sans texte exploitable
+  char text[NFC_READ_CACHE_TEXT_MAX];
+  uint32_t storedMs;
+  uint32_t lastUse;
+  bool used;
+} NfcReadCacheEntry;
+
+typedef struct {
+  NfcReadCacheEntry entries[NFC_READ_CACHE_SIZE];
+  uint32_t clock;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t stale;           // sonde différente ou illisible: entrée oubliée
+  uint32_t expired;
+} NfcReadCache;
+
+void NfcReadCache_Init(NfcReadCache* c);
+
+// Entrée de l'UID lue depuis moins de ttlMs, NULL sinon (absente ou expirée)
+NfcReadCacheEntry* NfcReadCache_Find(NfcReadCache* c, const uint8_t* uid, size_t uidLen,
+                                     uint32_t nowMs, uint32_t ttlMs);
+
+// Octets relus à l'adresse de la sonde (probe NULL: lecture en échec).
+// true: contenu inchangé (hit); false: entrée oubliée, lecture complète à faire.
+bool NfcReadCache_Validate(NfcReadCache* c, NfcReadCacheEntry* e, const uint8_t* probe, size_t len);
+
+// Mémorise une lecture complète; mem/memLen: octets du tag depuis probeAddr. text NULL: sans texte.
+void NfcReadCache_Store(NfcReadCache* c, const uint8_t* uid, size_t uidLen, uint8_t probeAddr,
+                        const uint8_t* mem, size_t memLen, const char* text, uint32_t nowMs);
+
+#ifdef __cplusplus
+}
+#endif
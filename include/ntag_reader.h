@@ -0,0 +1,72 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lecture NDEF des tags Type 2 (Ultralight, NTAG213/215/216) au plus juste:
+//   1) READ page 3 -> Capability Container + 12 premiers octets de données
+//   2) TLV NDEF (0x03) localisé, longueur du message connue
+//   3) pages restantes lues par FAST_READ (0x3A, plage en une transaction),
+//      repli sur READ (0x30, 4 pages) si le tag ne le supporte pas
+//
+// Le buffer de sortie contient la zone de données depuis la page 4, jusqu'à la fin
+// du TLV NDEF: il se parse directement comme une suite de TLV.
+
+#define NTAG_CMD_READ            0x30
+#define NTAG_CMD_FAST_READ       0x3A
+#define NTAG_PAGE_SIZE           4
+#define NTAG_FIRST_DATA_PAGE     4
+#define NTAG_CC_MAGIC            0xE1
+// FIFO RC522 de 64 octets: 15 pages (60 octets) + CRC par FAST_READ
+#define NTAG_FAST_READ_MAX_PAGES 15
+#define NTAG_READER_MAX_BYTES    872   // zone utilisateur NTAG216
+
+typedef enum {
+  NTAG_TYPE_UNKNOWN = 0,
+  NTAG_TYPE_ULTRALIGHT,    // CC 0x06, 48 octets
+  NTAG_TYPE_NTAG213,       // CC 0x12, 144 octets (aussi Ultralight C)
+  NTAG_TYPE_NTAG215,       // CC 0x3E, 496 octets
+  NTAG_TYPE_NTAG216        // CC 0x6D, 872 octets
+} NtagType;
+
+typedef enum {
+  NTAG_READ_OK = 0,
+  NTAG_READ_ERR_IO = -1,       // pas de réponse / NAK
+  NTAG_READ_ERR_CC = -2,       // Capability Container absent ou invalide
+  NTAG_READ_ERR_NO_NDEF = -3,  // pas de TLV NDEF (ou TLV hors zone)
+  NTAG_READ_ERR_TOO_LARGE = -4 // message plus grand que le buffer
+} NtagReadResult;
+
+// Transport vers le tag (CRC ISO 14443-A ajouté et vérifié par le transport).
+// transceive retourne le nombre d'octets de réponse (sans CRC), -1 sur NAK/timeout.
+// reactivate (optionnel) remet le tag en état ACTIVE après un NAK (WUPA + SELECT).
+typedef struct {
+  int (*transceive)(void* ctx, const uint8_t* cmd, size_t cmdLen, uint8_t* resp, size_t respMax);
+  bool (*reactivate)(void* ctx);
+  void* ctx;
+} NtagTransport;
+
+typedef struct {
+  NtagType type;
+  uint16_t dataBytes;      // taille de la zone de données annoncée par le CC
+  uint16_t ndefOffset;     // début du message NDEF dans le buffer (après T et L)
+  uint16_t ndefLen;
+  uint16_t bytesRead;      // octets reçus du tag (CC compris)
+  uint8_t transactions;    // échanges RF
+  bool fastRead;           // FAST_READ utilisé pour la suite du message
+} NtagReadInfo;
+
+NtagType NtagReader_TypeFromCc(uint8_t ccSize);
+const char* NtagReader_TypeName(NtagType type);
+
+// Retourne le nombre d'octets placés dans buf (>0) ou un NtagReadResult négatif
+int NtagReader_ReadNdef(const NtagTransport* t, uint8_t* buf, size_t bufSize, NtagReadInfo* info);
+
+#ifdef __cplusplus
+}
+#endif
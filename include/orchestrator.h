@@ -12,14 +12,23 @@ enum OrchestratorEventType {
   ORCH_EVT_QR_TOKEN_READ = 5,
   ORCH_EVT_DELIVERY_COMPLETED = 6,
   ORCH_EVT_DELIVERY_FAILED = 7,
+  ORCH_EVT_VEND_COMPLETED = 8,
+  ORCH_EVT_VEND_FAILED = 9,
+  ORCH_EVT_NFC_AUTH = 10,      // rôle de la carte dans l'index local (NfcAuthIndex_RoleName)
 };
 
 struct OrchestratorEvent {
   OrchestratorEventType type;
-  char payload[128];
+  char payload[224];   // token QR signé le plus long: QR_OFFLINE_TOKEN_MAX (210)
 };
 
 QueueHandle_t Orchestrator_GetQueue();
 void StartTaskOrchestrator();
 
+// Aucune commande en cours (la liaison NUCLEO peut être renégociée)
+bool Orchestrator_IsIdle();
+
+// Statistiques du cache de tokens QR (commande INFO)
+void Orchestrator_DebugInfo();
+
 
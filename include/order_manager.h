@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Arduino.h>
+#include "order_progress.h"
+#include "qr_offline_token.h"
 
 // Constantes pour la gestion des commandes
 #define MAX_ORDER_ITEMS 10
@@ -32,10 +34,13 @@ class OrderManager {
 private:
   static OrderData current_order;
   static bool has_active_order;
+  static OrderProgress progress;
 
 public:
   // Gestion de la commande courante
   static bool ParseOrderFromJSON(const char* json_response, OrderData* order);
+  // Commande issue d'un token signé vérifié localement (sans product_id, complétée au rapprochement backend)
+  static bool BuildOfflineOrder(const QrOfflineOrder* offline, OrderData* order);
   static void SetCurrentOrder(const OrderData* order);
   static OrderData* GetCurrentOrder();
   static bool HasActiveOrder();
@@ -45,11 +50,14 @@ public:
   static String GenerateDeliveryCommands();
   static String GenerateStockUpdateData();
   
-  // Génération de données pour confirmation de livraison
+  // Génération de données pour confirmation de livraison (quantités réellement livrées)
   static String GenerateDeliveryConfirmationData();
   
-  // Mise à jour des quantités de stock pour tous les items
-  static bool UpdateAllQuantities(QueueHandle_t responseQueue, uint32_t timeoutMs);
+  // Suivi de livraison item par item (VEND_COMPLETED / VEND_FAILED)
+  static OrderProgress* GetProgress();
+  
+  // Mise à jour des quantités de stock pour un item livré
+  static bool SendItemQuantityUpdate(int index, QueueHandle_t responseQueue, uint32_t timeoutMs);
   
   // Validation
   static bool ValidateOrder(const OrderData* order);
@@ -0,0 +1,83 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Suivi de livraison item par item (VEND_COMPLETED / VEND_FAILED) d'une commande en cours.
+// Les mises à jour de quantités partent dès qu'un item est livré, une requête HTTP à la fois
+// (le service HTTP est séquentiel et rejette les requêtes trop rapprochées).
+
+#define ORDER_PROGRESS_MAX_ITEMS    10   // = MAX_ORDER_ITEMS
+#define ORDER_PROGRESS_REASON_MAX   24
+
+typedef enum {
+  ORDER_ITEM_PENDING = 0,   // pas encore de statut NUCLEO
+  ORDER_ITEM_VENDED,        // VEND_COMPLETED reçu (ou déduit de DELIVERY_COMPLETED)
+  ORDER_ITEM_FAILED         // VEND_FAILED reçu, ou livraison interrompue avant l'item
+} OrderItemOutcome;
+
+typedef enum {
+  ORDER_SYNC_NONE = 0,      // rien à envoyer (en attente ou non livré)
+  ORDER_SYNC_QUEUED,        // mise à jour de quantité à envoyer
+  ORDER_SYNC_IN_FLIGHT,
+  ORDER_SYNC_DONE,          // backend: 200
+  ORDER_SYNC_ERROR          // backend en erreur, envoi impossible ou sans réponse
+} OrderItemSync;
+
+typedef struct {
+  int slot;
+  int ordered;
+  int delivered;
+  uint8_t outcome;          // OrderItemOutcome
+  uint8_t sync;             // OrderItemSync
+  char reason[ORDER_PROGRESS_REASON_MAX];
+} OrderProgressItem;
+
+typedef struct {
+  OrderProgressItem items[ORDER_PROGRESS_MAX_ITEMS];
+  uint8_t count;
+  bool deliveryEnded;       // DELIVERY_COMPLETED / DELIVERY_FAILED reçu
+  bool deliveryFailed;
+  int8_t inFlight;          // item dont la mise à jour attend sa réponse, -1 sinon
+  uint32_t spacingMs;       // écart minimal entre deux requêtes HTTP
+  uint32_t lastRequestMs;
+  uint32_t inFlightSinceMs;
+  uint16_t updatesOk;
+  uint16_t updatesFailed;
+} OrderProgress;
+
+// lastRequestMs: date de la dernière requête HTTP émise (validation du token)
+void OrderProgress_Begin(OrderProgress* p, uint32_t spacingMs, uint32_t lastRequestMs);
+bool OrderProgress_AddItem(OrderProgress* p, int slot, int quantity);
+
+// Lignes NUCLEO complètes: "VEND_COMPLETED:<slot>" et "VEND_FAILED:<slot>:<reason>".
+// Retourne l'index de l'item concerné (premier item en attente sur ce slot), -1 sinon.
+int OrderProgress_OnVendCompleted(OrderProgress* p, const char* line);
+int OrderProgress_OnVendFailed(OrderProgress* p, const char* line);
+// Fin de livraison: en succès les items sans statut sont considérés livrés (ligne perdue),
+// en échec ils sont marqués non livrés avec 'reason'.
+void OrderProgress_OnDeliveryEnd(OrderProgress* p, bool success, const char* reason);
+
+// Item dont la mise à jour doit partir maintenant (passe IN_FLIGHT), -1 si rien à envoyer,
+// une requête déjà en cours ou écart minimal non écoulé.
+int OrderProgress_NextUpdate(OrderProgress* p, uint32_t nowMs);
+// Réponse à la mise à jour en cours (statusCode 0: envoi impossible). Retourne l'index, -1 si aucune.
+int OrderProgress_OnUpdateResponse(OrderProgress* p, int statusCode);
+// Réponse perdue: la mise à jour en cours passe en erreur après timeoutMs. true si expirée.
+bool OrderProgress_CheckTimeout(OrderProgress* p, uint32_t nowMs, uint32_t timeoutMs);
+
+// Livraison terminée, plus rien à envoyer ni en attente de réponse
+bool OrderProgress_IsSettled(const OrderProgress* p);
+// Écart minimal écoulé depuis la dernière requête (confirmation de livraison)
+bool OrderProgress_CanRequest(const OrderProgress* p, uint32_t nowMs);
+void OrderProgress_MarkRequest(OrderProgress* p, uint32_t nowMs);
+int OrderProgress_DeliveredTotal(const OrderProgress* p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Tokens QR signés, vérifiables sans backend (voir QR_TOKEN_VALIDATION.md).
+//
+// Token : "qrs_" + base64url(payload || signature), sans padding
+//   payload   : version u8 | expiration u32 BE (secondes Unix) | order_id (u8 longueur + octets)
+//               | machine_id (u8 longueur + octets) | nombre d'items u8 | items (slot u8, quantité u8)
+//   signature : ECDSA P-256 sur SHA-256(payload), r || s (64 octets)
+
+#define QR_OFFLINE_TOKEN_PREFIX     "qrs_"
+#define QR_OFFLINE_TOKEN_VERSION    1
+#define QR_OFFLINE_ID_MAX           31
+#define QR_OFFLINE_MAX_ITEMS        10
+#define QR_OFFLINE_SIGNATURE_SIZE   64
+#define QR_OFFLINE_PUBLIC_KEY_SIZE  65     // point non compressé 0x04 || X || Y
+#define QR_OFFLINE_PAYLOAD_MAX      (1 + 4 + 2 * (1 + QR_OFFLINE_ID_MAX) + 1 + 2 * QR_OFFLINE_MAX_ITEMS)
+#define QR_OFFLINE_TOKEN_MAX        (4 + ((QR_OFFLINE_PAYLOAD_MAX + QR_OFFLINE_SIGNATURE_SIZE) * 4 + 2) / 3)
+#define QR_OFFLINE_MIN_UNIX_TIME    1700000000u  // en dessous, horloge non synchronisée
+
+typedef struct {
+  uint8_t slot;
+  uint8_t quantity;
+} QrOfflineItem;
+
+typedef struct {
+  uint32_t expiresAt;
+  char orderId[QR_OFFLINE_ID_MAX + 1];
+  char machineId[QR_OFFLINE_ID_MAX + 1];
+  QrOfflineItem items[QR_OFFLINE_MAX_ITEMS];
+  uint8_t itemCount;
+} QrOfflineOrder;
+
+typedef enum {
+  QR_OFFLINE_OK = 0,
+  QR_OFFLINE_NOT_SIGNED,       // token classique: validation backend
+  QR_OFFLINE_MALFORMED,
+  QR_OFFLINE_BAD_SIGNATURE,
+  QR_OFFLINE_EXPIRED,
+  QR_OFFLINE_WRONG_MACHINE,
+  QR_OFFLINE_NO_CLOCK          // heure inconnue: expiration invérifiable, validation backend
+} QrOfflineResult;
+
+// Vérification de signature fournie par l'appelant (mbedtls sur cible)
+typedef bool (*QrOfflineVerifyFn)(void* ctx, const uint8_t* msg, size_t msgLen,
+                                  const uint8_t* sig, size_t sigLen);
+
+bool QrOffline_IsSigned(const char* token, size_t len);
+
+// Décodage base64url sans padding; -1 si caractère invalide ou sortie trop petite
+int QrOffline_Base64UrlDecode(const char* in, size_t len, uint8_t* out, size_t outMax);
+
+// Lecture du payload seul (bornes et valeurs), sans vérification de signature
+QrOfflineResult QrOffline_ParsePayload(const uint8_t* payload, size_t len, QrOfflineOrder* out);
+
+// Vérification complète: format, signature, horloge, expiration puis machine.
+// machineId obligatoire (NULL ou vide: WRONG_MACHINE), le registre anti-rejeu étant propre à chaque
+// machine. *out n'est rempli qu'en cas de succès.
+QrOfflineResult QrOffline_Verify(const char* token, size_t len, uint32_t nowUnix, const char* machineId,
+                                 QrOfflineVerifyFn verify, void* ctx, QrOfflineOrder* out);
+
+const char* QrOffline_ResultName(QrOfflineResult r);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Découpage des lectures du scanner QR en lignes et détection des tokens, sans allocation.
+// Une ligne entièrement contenue dans le bloc reçu est livrée directement depuis ce bloc (pas de copie);
+// seule une ligne répartie sur plusieurs blocs passe par le buffer interne.
+
+#define QR_SCAN_LINE_MAX 250   // au-delà, la ligne est ignorée jusqu'à la fin de ligne
+
+typedef struct {
+  char buf[QR_SCAN_LINE_MAX + 1];  // début de ligne en attente de la suite
+  size_t len;
+  bool discarding;                 // ligne trop longue: ignorée jusqu'à la fin de ligne
+  uint32_t truncated;
+} QrScanAssembler;
+
+void QrScan_Init(QrScanAssembler* a);
+
+// Consomme des octets jusqu'à la première fin de ligne ('\r' ou '\n') incluse.
+// idle: le bloc se termine sur un silence de la liaison (RX timeout), la fin du bloc
+// termine la ligne (scanners configurés sans suffixe).
+// Retourne le nombre d'octets consommés. Si une ligne non vide est complète, *line/*lineLen
+// la désignent (dans 'data' ou dans le buffer interne, non nul-terminée, valide jusqu'au
+// prochain appel et tant que 'data' n'est pas réutilisé), sinon *line = NULL.
+size_t QrScan_Push(QrScanAssembler* a, const uint8_t* data, size_t len, bool idle,
+                   const char** line, size_t* lineLen);
+
+// Token de commande: "qr_" suivi d'au moins un autre '_', ou token signé "qrs_" (qr_offline_token.h)
+bool QrScan_IsToken(const char* line, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Registre des commandes servies sur token QR signé, conservé en NVS jusqu'à l'expiration du
+// token: un même order_id ne peut être livré qu'une fois, redémarrage compris.
+// Seule une empreinte (FNV-1a 64 bits, QrTokenCache_Hash) de l'order_id est conservée.
+
+#define QR_SPENT_CAPACITY 128
+
+typedef struct {
+  uint64_t idHash;
+  uint32_t expiresAt;          // secondes Unix; entrée oubliée une fois dépassée
+} QrSpentEntry;
+
+typedef struct {
+  QrSpentEntry entries[QR_SPENT_CAPACITY];
+  uint32_t count;
+} QrSpentSet;
+
+void QrSpent_Init(QrSpentSet* s);
+
+// Contrôle d'un bloc relu en NVS (taille, nombre d'entrées)
+bool QrSpent_IsValid(const QrSpentSet* s, size_t len);
+
+bool QrSpent_Contains(const QrSpentSet* s, uint64_t idHash);
+
+// Enregistre (ou prolonge) une commande. Les entrées expirées sont d'abord retirées; false si le
+// registre est plein d'entrées encore valides (aucune n'est évincée: le rejeu redeviendrait possible)
+bool QrSpent_Add(QrSpentSet* s, uint64_t idHash, uint32_t expiresAt, uint32_t nowUnix);
+
+// Libère une commande réservée mais non livrée
+bool QrSpent_Remove(QrSpentSet* s, uint64_t idHash);
+
+// Retire les entrées expirées; renvoie leur nombre
+int QrSpent_Purge(QrSpentSet* s, uint32_t nowUnix);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Cache LRU des tokens QR récemment vus: un nouveau scan du même code est traité localement
+// avec la réponse UART adaptée, sans aller-retour de validation HTTP.
+// Seule une empreinte (FNV-1a 64 bits) du token est conservée.
+
+#define QR_TOKEN_CACHE_CAPACITY 16
+
+typedef enum {
+  QR_TOKEN_CACHE_MISS = 0,
+  QR_TOKEN_CACHE_REJECTED,     // refusé par le backend (4xx)
+  QR_TOKEN_CACHE_CONSUMED,     // commande livrée (tout ou partie)
+  QR_TOKEN_CACHE_IN_PROGRESS   // validation ou livraison en cours
+} QrTokenOutcome;
+
+typedef struct {
+  uint64_t hash;
+  uint32_t storedMs;
+  uint32_t ttlMs;
+  uint32_t lastUse;            // horloge LRU (compteur d'accès)
+  uint8_t outcome;             // QrTokenOutcome, MISS = entrée libre
+} QrTokenCacheEntry;
+
+typedef struct {
+  QrTokenCacheEntry entries[QR_TOKEN_CACHE_CAPACITY];
+  uint32_t clock;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t expired;
+  uint32_t evicted;
+} QrTokenCache;
+
+void QrTokenCache_Init(QrTokenCache* c);
+uint64_t QrTokenCache_Hash(const char* token, size_t len);
+
+// Résultat mémorisé pour ce token (MISS si absent ou expiré); met à jour les statistiques
+QrTokenOutcome QrTokenCache_Lookup(QrTokenCache* c, uint64_t hash, uint32_t nowMs);
+// Ajoute ou remplace; le moins récemment utilisé est évincé si le cache est plein
+void QrTokenCache_Store(QrTokenCache* c, uint64_t hash, QrTokenOutcome outcome, uint32_t nowMs, uint32_t ttlMs);
+// Oublie un token (erreur transitoire: la prochaine lecture repassera par le backend)
+void QrTokenCache_Remove(QrTokenCache* c, uint64_t hash);
+size_t QrTokenCache_Count(const QrTokenCache* c, uint32_t nowMs);
+
+// Réponse NUCLEO pour un résultat mémorisé, NULL pour MISS
+const char* QrTokenCache_Reply(QrTokenOutcome outcome);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Limitation de débit par seau à jetons, une entrée par service connu à la compilation.
+// Chaque seau accepte `burst` demandes d'affilée puis une toutes les `intervalMs`.
+//
+// Forme GCRA: l'état d'un seau tient dans un seul mot de 32 bits (heure théorique de la
+// prochaine demande conforme), mis à jour par compare-and-swap. Les tâches NFC, UART, HTTP
+// et Wi-Fi l'appellent sans verrou ni section critique (CAS 32 bits natif sur l'ESP32).
+//
+// Module pur: l'appelant fournit l'horloge (ms, millis() accepté avec son rebouclage).
+
+typedef enum {
+  RATE_LIMIT_NFC = 0,     // déclenchement d'un scan
+  RATE_LIMIT_UART,        // commande reçue de l'hôte
+  RATE_LIMIT_HTTP,        // requête sortante
+  RATE_LIMIT_WIFI,        // enregistrement depuis le portail
+  RATE_LIMIT_COUNT
+} RateLimitId;
+
+typedef struct {
+  uint32_t intervalMs;    // une demande par intervalle en régime établi
+  uint32_t burst;         // demandes acceptées d'affilée (>= 1)
+} RateLimitRule;
+
+typedef struct {
+  uint32_t tat;           // heure théorique d'arrivée (ms, 0: seau plein), accès atomique
+  uint32_t accepted;      // compteurs, accès atomique
+  uint32_t rejected;
+} RateLimitBucket;
+
+// Initialisable statiquement: { { règles dans l'ordre de RateLimitId }, {} }
+typedef struct {
+  RateLimitRule rules[RATE_LIMIT_COUNT];
+  RateLimitBucket buckets[RATE_LIMIT_COUNT];
+} RateLimiter;
+
+// Prend un jeton: true si la demande est acceptée
+bool RateLimit_TryAcquire(RateLimiter* rl, RateLimitId id, uint32_t nowMs);
+
+// Seau plein à nouveau (compteurs conservés)
+void RateLimit_Reset(RateLimiter* rl, RateLimitId id);
+
+uint32_t RateLimit_Accepted(const RateLimiter* rl, RateLimitId id);
+uint32_t RateLimit_Rejected(const RateLimiter* rl, RateLimitId id);
+const char* RateLimit_Name(RateLimitId id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "rc522_irq.h"
+
+// Pilote RC522 minimal pour les échanges ISO 14443-A de la tâche NFC
+// (REQA/WUPA, anticollision + SELECT, READ/FAST_READ, HLTA).
+//
+// Accès SPI par rafales: une transaction (CS bas -> haut) par accès FIFO multi-octets,
+// et attente de réponse en lisant ComIrq, Error, FIFOLevel et Control en une seule
+// transaction (le RC522 accepte une adresse différente par octet en lecture).
+// CRC_A calculé en logiciel au lieu du coprocesseur CRC du RC522 (aller-retour SPI
+// et attente CRCIRq évités). HLTA émis par la commande Transmit, sans attendre le
+// timeout de 25 ms qui signale son acceptation.
+//
+// Le transport est fourni par l'appelant (SPI matériel sur cible, RC522 simulé en test).
+// La configuration du lecteur (timer, modulation, antenne) reste celle de PCD_Init.
+
+#define RC522_REG_CONTROL      0x0C
+#define RC522_REG_COLL         0x0E
+
+#define RC522_CMD_TRANSMIT     0x04
+
+#define RC522_COM_TX_IRQ       0x40
+#define RC522_COM_IDLE_IRQ     0x10
+
+#define RC522_ERRREG_BUFFER_OVFL 0x10
+#define RC522_ERRREG_COLL        0x08
+#define RC522_ERRREG_CRC         0x04
+#define RC522_ERRREG_PARITY      0x02
+#define RC522_ERRREG_PROTOCOL    0x01
+
+#define RC522_COLL_POS_NOT_VALID 0x20
+
+#define RC522_PICC_WUPA        0x52
+#define RC522_PICC_SEL_CL1     0x93
+#define RC522_PICC_SEL_CL2     0x95
+#define RC522_PICC_SEL_CL3     0x97
+#define RC522_PICC_HLTA        0x50
+#define RC522_PICC_READ        0x30
+#define RC522_PICC_CASCADE_TAG 0x88
+
+#define RC522_FIFO_SIZE        64
+#define RC522_DRV_TIMEOUT_US   30000   // au-delà du timer TAuto (25 ms) réglé par PCD_Init
+#define RC522_DRV_MAX_POLLS    2000    // borne sans horloge (transport sans micros)
+
+// Transaction SPI complète, full duplex. rx peut être NULL (écriture).
+typedef struct {
+  bool (*transfer)(void* ctx, const uint8_t* tx, uint8_t* rx, size_t len);
+  uint32_t (*micros)(void* ctx);   // optionnel: mesures et timeout
+  void* ctx;
+} Rc522Transport;
+
+typedef enum {
+  RC522_OK = 0,
+  RC522_ERR_IO = -1,         // transport en échec
+  RC522_ERR_TIMEOUT = -2,    // pas de réponse de la carte
+  RC522_ERR_COLLISION = -3,
+  RC522_ERR_CRC = -4,
+  RC522_ERR_PROTOCOL = -5,   // trame erronée (parité, protocole, BCC, SAK)
+  RC522_ERR_NO_ROOM = -6,    // réponse plus grande que le buffer
+  RC522_ERR_NAK = -7
+} Rc522Status;
+
+typedef enum {
+  RC522_OP_REQA = 0,         // REQA ou WUPA
+  RC522_OP_SELECT,           // anticollision + SELECT, tous niveaux de cascade
+  RC522_OP_READ,             // READ 16 octets
+  RC522_OP_TRANSCEIVE,       // échange avec CRC (FAST_READ, commandes NTAG)
+  RC522_OP_HALT,
+  RC522_OP_COUNT
+} Rc522Op;
+
+typedef struct {
+  uint32_t calls;
+  uint32_t errors;
+  uint32_t transactions;     // transactions SPI cumulées
+  uint32_t bytes;            // octets SPI cumulés
+  uint32_t lastUs;
+  uint64_t totalUs;
+} Rc522OpStats;
+
+typedef struct {
+  uint8_t size;              // 4, 7 ou 10
+  uint8_t bytes[10];
+  uint8_t sak;
+} Rc522Uid;
+
+typedef struct {
+  const Rc522Transport* t;
+  uint32_t timeoutUs;
+  uint32_t transactions;
+  uint32_t bytes;
+  Rc522OpStats ops[RC522_OP_COUNT];
+} Rc522Drv;
+
+void Rc522Drv_Init(Rc522Drv* d, const Rc522Transport* t);
+const char* Rc522Drv_OpName(Rc522Op op);
+
+// ---- Accès registres ----
+uint8_t Rc522Drv_ReadReg(Rc522Drv* d, uint8_t reg);
+bool Rc522Drv_WriteReg(Rc522Drv* d, uint8_t reg, uint8_t value);
+// n registres quelconques (n <= RC522_FIFO_SIZE) en une transaction
+bool Rc522Drv_ReadRegs(Rc522Drv* d, const uint8_t* regs, uint8_t* out, size_t n);
+bool Rc522Drv_WriteFifo(Rc522Drv* d, const uint8_t* data, size_t n);
+bool Rc522Drv_ReadFifo(Rc522Drv* d, uint8_t* out, size_t n);
+
+// Vérifie les rafales à l'horloge courante: motif de 64 octets écrit puis relu dans la FIFO
+bool Rc522Drv_CheckFifo(Rc522Drv* d);
+
+// CRC_A ISO 14443-3 (0x6363, polynôme réfléchi 0x8408), octet de poids faible en premier
+uint16_t Rc522Drv_CrcA(const uint8_t* data, size_t len);
+
+// ---- Échanges ----
+// Trame brute: txLastBits = bits valides du dernier octet (0: 8), rxAlign = position du
+// premier bit reçu dans le premier octet. Retourne le nombre d'octets reçus ou Rc522Status.
+// En cas de collision (RC522_ERR_COLLISION) les octets reçus sont dans rx.
+int Rc522Drv_Transceive(Rc522Drv* d, const uint8_t* tx, size_t txLen, uint8_t txLastBits, uint8_t rxAlign,
+                        uint8_t* rx, size_t rxMax, uint8_t* rxLastBits);
+// Commande avec CRC_A ajouté, réponse vérifiée et renvoyée sans CRC; NAK 4 bits -> RC522_ERR_NAK
+int Rc522Drv_TransceiveCrc(Rc522Drv* d, const uint8_t* cmd, size_t len, uint8_t* resp, size_t respMax);
+
+int Rc522Drv_RequestA(Rc522Drv* d, uint8_t atqa[2]);
+int Rc522Drv_WakeupA(Rc522Drv* d, uint8_t atqa[2]);
+// Carte en état READY (après REQA/WUPA) -> ACTIVE, collisions résolues bit à bit
+int Rc522Drv_Select(Rc522Drv* d, Rc522Uid* uid);
+int Rc522Drv_Read(Rc522Drv* d, uint8_t block, uint8_t out[16]);
+int Rc522Drv_HaltA(Rc522Drv* d);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Détection de carte RC522 par interruption (broche IRQ) au lieu du polling.
+// Le lecteur émet un REQA et ne lève IRQ qu'à la réception d'un ATQA (RxIRq):
+// la tâche NFC dort sur une notification entre deux réarmements.
+//
+// Accès registres via Rc522Bus (adresses datasheet non décalées), ce qui permet
+// de compter les transactions SPI et de tester la séquence sur PC.
+
+// Registres MFRC522 (datasheet, section 9)
+#define RC522_REG_COMMAND      0x01
+#define RC522_REG_COM_IEN      0x02
+#define RC522_REG_DIV_IEN      0x03
+#define RC522_REG_COM_IRQ      0x04
+#define RC522_REG_DIV_IRQ      0x05
+#define RC522_REG_ERROR        0x06
+#define RC522_REG_FIFO_DATA    0x09
+#define RC522_REG_FIFO_LEVEL   0x0A
+#define RC522_REG_BIT_FRAMING  0x0D
+
+#define RC522_CMD_IDLE         0x00
+#define RC522_CMD_CALC_CRC     0x03
+#define RC522_CMD_TRANSCEIVE   0x0C
+
+#define RC522_COM_IRQ_INV      0x80  // ComIEnReg: IRQ active à l'état bas
+#define RC522_COM_RX_IRQ       0x20  // fin de réception
+#define RC522_COM_ERR_IRQ      0x02
+#define RC522_COM_TIMER_IRQ    0x01
+#define RC522_DIV_IRQ_PUSHPULL 0x80  // DivIEnReg: sortie IRQ push-pull (pas de pull-up externe)
+#define RC522_DIV_CRC_IRQ      0x04
+
+#define RC522_PICC_REQA        0x26
+
+typedef struct {
+  uint8_t (*read)(void* ctx, uint8_t reg);
+  void (*write)(void* ctx, uint8_t reg, uint8_t value);
+  void* ctx;
+  uint32_t transfers;      // transactions SPI émises via ce bus
+} Rc522Bus;
+
+uint8_t Rc522Irq_Read(Rc522Bus* bus, uint8_t reg);
+void Rc522Irq_Write(Rc522Bus* bus, uint8_t reg, uint8_t value);
+
+// IRQ sur RxIRq uniquement (active basse, push-pull)
+void Rc522Irq_Enable(Rc522Bus* bus);
+// Valeurs de reset: IRQ inactive, aucune source
+void Rc522Irq_Disable(Rc522Bus* bus);
+// Acquitte toutes les sources (ComIrqReg et DivIrqReg)
+void Rc522Irq_Clear(Rc522Bus* bus);
+
+// Émet un REQA (7 bits) sans attendre la réponse; IRQ à la réception de l'ATQA.
+// Quelques écritures par réarmement au lieu de la boucle d'attente de PICC_IsNewCardPresent.
+void Rc522Irq_ArmReqa(Rc522Bus* bus);
+
+// Après un réveil IRQ: true si une réponse sans erreur a été reçue (carte présente)
+bool Rc522Irq_CardResponded(Rc522Bus* bus);
+
+// Auto-test de câblage: lance un calcul CRC avec CRCIRq activée.
+// L'appelant vérifie ensuite que la broche IRQ a bien été activée puis appelle ProbeEnd.
+void Rc522Irq_ProbeBegin(Rc522Bus* bus);
+void Rc522Irq_ProbeEnd(Rc522Bus* bus);
+
+#ifdef __cplusplus
+}
+#endif
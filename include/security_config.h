@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Arduino.h>
+#include "rate_limiter.h"
+#include "services/log_service.h"
 
 // Configuration de sécurité OWASP pour ESP32
 // Implémentation des recommandations de sécurité critiques
@@ -67,6 +69,16 @@ static const char* CA_CERT = \
 // Salt pour le hachage des mots de passe
 static const char* PASSWORD_SALT = "DPM2_ESP32_SALT_2024";
 
+// Clé maître des credentials (cred_crypto.h): PBKDF2-HMAC-SHA256, une fois par démarrage.
+// L'ESP32 n'a pas de clé HMAC en eFuse (ESP32-S2/S3/C3 seulement): secret = MAC eFuse.
+#ifndef CRED_PBKDF2_ITERATIONS
+#define CRED_PBKDF2_ITERATIONS          2048
+#endif
+// Mesure du chemin credentials au démarrage (ancien format vs PBKDF2/GCM)
+#ifndef CRED_BENCH_ENABLED
+#define CRED_BENCH_ENABLED              0
+#endif
+
 // =============================================================================
 // CONFIGURATION LOGGING SÉCURISÉ
 // =============================================================================
@@ -97,17 +109,27 @@ typedef enum {
 // CONFIGURATION RATE LIMITING
 // =============================================================================
 
+// Seaux à jetons (rate_limiter.h): une demande par *_COOLDOWN_MS en régime établi,
+// *_BURST demandes acceptées d'affilée
+
 // Rate limiting NFC
 #define NFC_MAX_SCANS_PER_MINUTE        10
 #define NFC_SCAN_COOLDOWN_MS            3000
+#define NFC_SCAN_BURST                  2
 
 // Rate limiting UART
 #define UART_MAX_COMMANDS_PER_SECOND    5
 #define UART_COMMAND_COOLDOWN_MS        200
+#define UART_COMMAND_BURST              UART_MAX_COMMANDS_PER_SECOND
 
 // Rate limiting HTTP
 #define HTTP_MAX_REQUESTS_PER_MINUTE    20
 #define HTTP_REQUEST_COOLDOWN_MS        3000
+#define HTTP_REQUEST_BURST              3
+
+// Rate limiting portail Wi-Fi (enregistrement d'un réseau)
+#define WIFI_SAVE_COOLDOWN_MS           5000
+#define WIFI_SAVE_BURST                 1
 
 // =============================================================================
 // VALIDATION D'ENTRÉES
@@ -148,25 +170,42 @@ typedef enum {
 // Macro pour nettoyage sécurisé de la mémoire
 #define SECURE_ZERO(ptr, size) do { if (ptr) memset((ptr), 0, (size)); } while(0)
 
-// Macro pour logging sécurisé avec masquage
-#define SECURE_LOG_INFO(tag, format, ...) do { if (getLogLevel() >= LOG_LEVEL_INFO) Serial.printf("[" tag "] " format "\n", ##__VA_ARGS__); } while(0)
-#define SECURE_LOG_WARN(tag, format, ...) do { if (getLogLevel() >= LOG_LEVEL_WARN) Serial.printf("[WARN][" tag "] " format "\n", ##__VA_ARGS__); } while(0)
-#define SECURE_LOG_ERROR(tag, format, ...) do { if (getLogLevel() >= LOG_LEVEL_ERROR) Serial.printf("[ERR][" tag "] " format "\n", ##__VA_ARGS__); } while(0)
+// Macro pour logging sécurisé avec masquage (asynchrone, voir services/log_service.h)
+#define SECURE_LOG_INFO(tag, format, ...) do { if (getLogLevel() >= LOG_LEVEL_INFO) LOG_PRINTF("[" tag "] " format "\n", ##__VA_ARGS__); } while(0)
+#define SECURE_LOG_WARN(tag, format, ...) do { if (getLogLevel() >= LOG_LEVEL_WARN) LOG_PRINTF("[WARN][" tag "] " format "\n", ##__VA_ARGS__); } while(0)
+#define SECURE_LOG_ERROR(tag, format, ...) do { if (getLogLevel() >= LOG_LEVEL_ERROR) LOG_PRINTF("[ERR][" tag "] " format "\n", ##__VA_ARGS__); } while(0)
 
 // Déclarations des fonctions utilitaires
 LogLevel getLogLevel();
 void setLogLevel(LogLevel level);
 String maskSensitiveData(const String& data, int visibleChars);
+size_t maskSensitiveDataTo(const char* data, size_t len, size_t visibleChars, char* out, size_t outSize);
 String maskUID(const String& uid);
 String maskSSID(const String& ssid);
 String maskPassword(const String& password);
 bool isValidUrl(const char* url);
 bool isValidSSID(const char* ssid);
 bool isValidNFCData(const char* data);
-bool rateLimitCheck(const char* service, unsigned long cooldownMs);
+bool rateLimitCheck(RateLimitId id);
+void rateLimitDebugInfo();
 bool deriveKey(const char* password, const char* salt, uint8_t* key, size_t keyLen);
-bool encryptData(const char* plaintext, const uint8_t* key, char* ciphertext, size_t maxLen);
 bool decryptData(const char* ciphertext, const uint8_t* key, char* plaintext, size_t maxLen);
+
+// Credentials Wi-Fi en binaire (cred_crypto.h): AES-256-GCM authentifié par le SSID
+typedef struct {
+    uint32_t masterKeyUs;       // dérivation PBKDF2 de la clé maître (0: pas encore faite)
+    uint32_t lastKeyUs;         // dernière clé réseau (HKDF)
+    uint32_t lastCipherUs;      // dernier chiffrement/déchiffrement GCM
+    uint32_t encrypts;
+    uint32_t decrypts;
+    uint32_t authFailures;      // blob altéré ou recopié sur un autre SSID
+} CredCryptoStats;
+
+bool credKeyInit();
+bool credEncrypt(const char* ssid, const char* password, uint8_t* blob, size_t maxLen, size_t* outLen);
+bool credDecrypt(const char* ssid, uint8_t* blob, size_t len, char* password, size_t maxLen);
+const CredCryptoStats* credCryptoStats();
+void credBenchmark();
 void logSecurityEvent(const char* event, const char* details);
 void checkSystemSecurity();
 
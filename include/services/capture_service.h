@@ -0,0 +1,20 @@
+#pragma once
+
+#include <Arduino.h>
+#include "uart_capture.h"
+
+// Capture du trafic UART (NUCLEO + scanner QR) pour relecture sur PC (voir UART_PROTOCOL.md)
+
+// Alloue le buffer (PSRAM si disponible) au premier appel et démarre l'enregistrement
+bool CaptureService_Start();
+void CaptureService_Stop();
+bool CaptureService_IsActive();
+void CaptureService_Clear();
+
+// Appelé par les services UART; sans effet si la capture est arrêtée
+void CaptureService_Record(UartCaptureChannel channel, UartCaptureDir dir, const uint8_t* data, size_t len);
+
+// Vidage binaire sur la console USB: "[CAP] DUMP <n>\n" + n octets + "\n[CAP] END\n"
+void CaptureService_Dump();
+
+void CaptureService_DebugInfo();
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+#include "log_ring.h"
+
+// Journal console asynchrone: les tâches déposent format + arguments bruts dans une file sans
+// verrou (log_ring.h), une tâche de basse priorité formate et écrit sur Serial. L'appelant ne
+// paie ni le formatage ni l'attente de l'UART. File pleine: message perdu et compté, signalé
+// par la tâche dès qu'elle reprend la main.
+
+// Démarre la tâche d'écriture; à appeler en tout début de setup(). Avant cet appel, LOG_PRINTF
+// écrit en synchrone.
+void LogService_Init();
+bool LogService_IsRunning();
+
+LogRing* LogService_Ring();
+
+// Vide la file en synchrone depuis la tâche appelante (arrêt, redémarrage)
+void LogService_Flush();
+
+// Chemin de panique (pile presque épuisée, tâche condamnée): chaîne fixe écrite directement, sans
+// formatage. La file est vidée avant si la console est libre, sans jamais attendre le verrou.
+void LogService_PanicWrite(const char* msg);
+
+// Accès exclusif à la console (vidage binaire de la capture UART): la tâche d'écriture attend
+void LogService_LockConsole();
+void LogService_UnlockConsole();
+
+void LogService_DebugInfo();
+
+template <typename... Args>
+static inline void LogService_Write(const char* fmt, Args... args) {
+  if (LogService_IsRunning()) {
+    LogRing_Write(LogService_Ring(), millis(), fmt, args...);
+  } else {
+    Serial.printf(fmt, args...);
+  }
+}
+
+// Remplace Serial.printf sur les chemins chauds; fmt doit être un littéral. La branche morte
+// garde la vérification du format par le compilateur.
+#define LOG_PRINTF(fmt, ...) do { \
+    if (0) Serial.printf(fmt, ##__VA_ARGS__); \
+    LogService_Write(fmt, ##__VA_ARGS__); \
+  } while (0)
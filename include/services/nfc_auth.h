@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Arduino.h>
+#include "nfc_auth_index.h"
+
+// Autorisation locale des cartes NFC: index nfc_auth_index.h lu en flash (partition
+// NFC_AUTH_PARTITION_LABEL mappée en mémoire), synchronisé depuis le backend par deltas versionnés.
+
+// Choisit l'emplacement valide le plus récent; false si la partition est absente
+bool NfcAuth_Init();
+
+// true si un index (version backend > 0) est chargé
+bool NfcAuth_IsLoaded();
+
+// Drapeaux NFC_AUTH_FLAG_* de la carte, NFC_AUTH_ABSENT si inconnue ou index absent.
+// Appelée par la tâche NFC: quelques microsecondes, aucune allocation.
+int NfcAuth_Lookup(const uint8_t* uid, size_t uidLen);
+
+// Synchronisation (tâche orchestrateur): une page par appel au plus, requêtes
+// envoyées seulement si workflowIdle et réseau présent
+void NfcAuth_Pump(bool workflowIdle);
+
+// Version, taille, emplacement, temps de recherche (commande INFO)
+void NfcAuth_DebugInfo();
@@ -24,3 +24,10 @@ void StopTaskNfcService();
 bool NfcService_IsRunning();
 
 
+
+// Détection de fond à faible rapport cyclique: courtes salves RF, cadence adaptative
+void NfcService_SetBackground(bool enabled);
+bool NfcService_IsBackground();
+
+// Budget RF de la détection de fond, en ‰ du temps champ allumé (1..1000)
+void NfcService_SetBackgroundBudget(uint16_t permille);
@@ -13,6 +13,9 @@ void StopTaskQrService();
 // Indique si la tâche QR tourne
 bool QrService_IsRunning();
 
+// Envoi vers le scanner (UART2), 0 si le service n'est pas démarré
+size_t QrService_Write(const uint8_t* data, size_t len);
+
 // Active/Désactive le mode hex dump (octets bruts)
 void QrService_SetHexDump(bool enable);
 bool QrService_GetHexDump();
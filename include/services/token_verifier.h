@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Arduino.h>
+#include "qr_offline_token.h"
+
+// Vérification locale des tokens QR signés (ECDSA P-256, mbedtls) avec la clé publique
+// QR_TOKEN_PUBLIC_KEY de EnvConfig (voir QR_TOKEN_VALIDATION.md)
+
+// Charge la clé publique; false si absente ou invalide (tokens signés alors validés par le backend)
+bool TokenVerifier_Init();
+bool TokenVerifier_IsReady();
+
+// Vérifie un token signé à l'heure système (SNTP) et pour MACHINE_ID si configuré
+QrOfflineResult TokenVerifier_Check(const char* token, QrOfflineOrder* out);
+
+// Mesure du temps de vérification sur un vecteur de test embarqué (commande QRBENCH)
+void TokenVerifier_Benchmark(int iterations);
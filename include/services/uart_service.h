@@ -9,4 +9,8 @@ void StartTaskUartService(QueueHandle_t orchestratorQueue);
 // API d'envoi vers NUCLEO
 void UartService_SendLine(const char* line);
 
+// Infos debug (mode texte/binaire, débit négocié, statistiques de trames)
+void UartService_DebugInfo();
 
+// Débit courant de la liaison NUCLEO (après négociation)
+uint32_t UartService_GetBaudRate();
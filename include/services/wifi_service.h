@@ -2,16 +2,31 @@
 
 #include <Arduino.h>
 
+// Bits du groupe d'événements Wi-Fi (attente sans scrutation: WifiService_Wait)
+#define WIFI_EVT_LINK_UP     (1u << 0)   // IP obtenue
+#define WIFI_EVT_BACKEND_OK  (1u << 1)   // backend joignable (connexion TCP à l'hôte de l'API)
+#define WIFI_EVT_READY       (1u << 2)   // LINK_UP et BACKEND_OK
+
 // Démarre la tâche Wi-Fi: tentative creds NVS, sinon SoftAP + portail HTTP pour configurer
 void StartTaskWifiService();
 
 // Indique si la connexion Internet est prête (Wi-Fi connecté + test backend optionnel)
 bool WifiService_IsReady();
 
+// Attend que tous les bits demandés soient levés (UINT32_MAX: sans limite)
+bool WifiService_Wait(uint32_t bits, uint32_t timeoutMs);
+
+// Politique d'énergie: radio éveillée (WIFI_PS_NONE) pendant une transaction, modem sleep au repos
+void WifiService_SetTransactionActive(bool active);
+
+// Latence d'une requête backend complète, attribuée au mode d'énergie courant
+void WifiService_RecordRequestLatency(uint32_t ms);
+
+// Oublie le réseau enregistré n° index (numéros affichés par WIFI?)
+void WifiService_ForgetNetwork(int index);
+
 // Déconnexion du Wi‑Fi (et relance du SoftAP de provisioning)
 void WifiService_Disconnect();
 
 // Affiche l'état Wi‑Fi (STA/AP) sur le port série
 void WifiService_DebugStatus();
-
-
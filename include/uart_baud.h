@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Négociation du débit UART ESP32 <-> NUCLEO (voir UART_PROTOCOL.md)
+// Échange texte au débit courant, puis motif d'entraînement au nouveau débit.
+
+#define UART_BAUD_PROPOSE_PREFIX      "BAUD?:"
+#define UART_BAUD_ACCEPT_PREFIX       "BAUD_OK:"
+#define UART_BAUD_COMMIT              "BAUD_COMMIT"
+#define UART_BAUD_RESET               "BAUD_RESET"
+#define UART_BAUD_TRAIN_PREFIX        "TRAIN:"
+
+#define UART_BAUD_TRAIN_LINES         8     // lignes d'entraînement envoyées par essai
+#define UART_BAUD_TRAIN_MAX_ERRORS    0     // échos erronés tolérés
+#define UART_BAUD_ERROR_WINDOW_MS     5000  // fenêtre de comptage des erreurs en service
+#define UART_BAUD_ERROR_THRESHOLD     5     // erreurs dans la fenêtre -> retour au débit de base
+
+#define UART_BAUD_REPLY_TIMEOUT_MS    200   // attente de BAUD_OK
+#define UART_BAUD_SWITCH_DELAY_MS     20    // délai de bascule des deux côtés
+#define UART_BAUD_TRAIN_TIMEOUT_MS    100   // attente de l'écho d'une ligne TRAIN
+#define UART_BAUD_COMMIT_TIMEOUT_MS   1500  // NUCLEO: sans BAUD_COMMIT, retour au débit précédent
+
+typedef enum {
+  UART_BAUD_ERR_FRAMING = 0,   // erreur de trame/parité matérielle
+  UART_BAUD_ERR_CRC            // trame binaire rejetée ou caractère invalide
+} UartBaudErrorKind;
+
+typedef struct {
+  uint32_t baseBaud;       // débit de repli (UART_BAUDRATE)
+  uint32_t currentBaud;
+  uint32_t maxBaud;        // plafond courant, abaissé après un échec
+  uint32_t windowStartMs;
+  uint16_t windowErrors;
+  uint32_t framingErrors;
+  uint32_t crcErrors;
+  uint32_t upgrades;
+  uint32_t downgrades;
+} UartBaudState;
+
+void UartBaud_Init(UartBaudState* st, uint32_t baseBaud, uint32_t maxBaud);
+
+// Plus haut débit candidat > courant et <= plafond. 0 si aucun.
+uint32_t UartBaud_NextCandidate(const UartBaudState* st);
+
+// Formatage / reconnaissance des lignes de négociation
+size_t UartBaud_FormatProposal(char* out, size_t outSize, uint32_t baud);
+bool UartBaud_IsAccept(const char* line, uint32_t baud);
+size_t UartBaud_FormatTrainingLine(char* out, size_t outSize, uint8_t seq);
+bool UartBaud_CheckTrainingLine(const char* line, uint8_t seq);
+bool UartBaud_TrainingPassed(uint8_t goodEchoes, uint8_t sent);
+
+// Transitions
+void UartBaud_OnUpgradeSucceeded(UartBaudState* st, uint32_t baud);
+void UartBaud_OnUpgradeFailed(UartBaudState* st, uint32_t baud);
+// Compte une erreur; true si le seuil est atteint et qu'un repli au débit de base est requis
+bool UartBaud_RecordError(UartBaudState* st, UartBaudErrorKind kind, uint32_t nowMs);
+void UartBaud_OnDowngrade(UartBaudState* st);
+
+#ifdef __cplusplus
+}
+#endif
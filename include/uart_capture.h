@@ -0,0 +1,100 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Enregistrement du trafic UART (NUCLEO et scanner QR) dans un buffer circulaire,
+// vidage binaire compact et relecture déterministe (voir UART_PROTOCOL.md).
+//
+// Vidage : [en-tête 16 octets][enregistrements]
+//   en-tête : "UCAP" | version u8 | réservé u8 | perdus u16 LE | t0 ms u32 LE | taille u32 LE
+//   enregistrement : [tag u8][delta ms varint][longueur varint][octets]
+//   tag = (canal << 1) | sens ; delta relatif à l'enregistrement précédent (ignoré pour le premier)
+
+#define UART_CAPTURE_MAGIC          "UCAP"
+#define UART_CAPTURE_VERSION        1
+#define UART_CAPTURE_HEADER_SIZE    16
+#define UART_CAPTURE_RECORD_MAX     512   // octets par enregistrement (= UART_TX_BATCH_MAX)
+#define UART_CAPTURE_RECORD_OVERHEAD 8    // tag + delta (5) + longueur (2)
+
+typedef enum {
+  UART_CAPTURE_CH_NUCLEO = 0,
+  UART_CAPTURE_CH_QR = 1
+} UartCaptureChannel;
+
+typedef enum {
+  UART_CAPTURE_RX = 0,
+  UART_CAPTURE_TX = 1
+} UartCaptureDir;
+
+typedef struct {
+  uint8_t* data;           // fourni par l'appelant (PSRAM sur cible)
+  size_t capacity;
+  size_t head;             // prochaine écriture
+  size_t tail;             // plus ancien enregistrement
+  size_t used;
+  uint32_t records;
+  uint32_t tailMs;         // date absolue du plus ancien enregistrement
+  uint32_t lastMs;         // date du plus récent
+  uint32_t dropped;        // enregistrements écrasés ou refusés
+  uint32_t bytesCaptured;  // octets UART enregistrés depuis Init
+} UartCapture;
+
+typedef struct {
+  uint8_t channel;         // UartCaptureChannel
+  uint8_t dir;             // UartCaptureDir
+  uint32_t timeMs;
+  const uint8_t* data;     // pointe dans le vidage, pas de copie
+  size_t len;
+} UartCaptureRecord;
+
+void UartCapture_Init(UartCapture* c, uint8_t* buffer, size_t capacity);
+void UartCapture_Clear(UartCapture* c);
+// Ajoute un enregistrement; les plus anciens sont écrasés si besoin.
+// Les blocs plus longs que UART_CAPTURE_RECORD_MAX sont découpés.
+bool UartCapture_Record(UartCapture* c, uint8_t channel, uint8_t dir, uint32_t nowMs,
+                        const uint8_t* data, size_t len);
+
+// Vidage: en-tête puis contenu du buffer, au plus deux segments contigus. Retourne le total écrit.
+typedef void (*UartCaptureWriteFn)(void* ctx, const uint8_t* data, size_t len);
+size_t UartCapture_DumpSize(const UartCapture* c);
+size_t UartCapture_Dump(const UartCapture* c, UartCaptureWriteFn write, void* ctx);
+
+// Lecture d'un vidage
+typedef struct {
+  const uint8_t* data;
+  size_t len;
+  size_t offset;
+  uint32_t timeMs;
+  uint32_t count;
+  uint16_t dropped;        // perdus avant le vidage (en-tête)
+} UartCaptureReader;
+
+bool UartCapture_OpenDump(UartCaptureReader* r, const uint8_t* dump, size_t len);
+// false en fin de vidage ou sur enregistrement tronqué/invalide
+bool UartCapture_Next(UartCaptureReader* r, UartCaptureRecord* rec);
+
+// Relecture: chaque enregistrement est passé à 'sink' dans l'ordre.
+// originalTiming: 'wait' est appelé avec l'écart d'origine avant chaque enregistrement.
+typedef void (*UartReplaySinkFn)(void* ctx, const UartCaptureRecord* rec);
+typedef void (*UartReplayWaitFn)(void* ctx, uint32_t ms);
+
+typedef struct {
+  uint32_t records;
+  uint32_t bytes;
+  uint32_t spanMs;         // du premier au dernier enregistrement
+  bool complete;           // vidage lu jusqu'au bout sans erreur
+} UartReplayStats;
+
+bool UartCapture_Replay(const uint8_t* dump, size_t len, bool originalTiming,
+                        UartReplaySinkFn sink, UartReplayWaitFn wait, void* ctx,
+                        UartReplayStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
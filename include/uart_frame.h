@@ -0,0 +1,111 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Protocole binaire optionnel ESP32 <-> NUCLEO (voir UART_PROTOCOL.md)
+// Trame brute : [type][seq][ack][len][payload...][crc16 MSB][crc16 LSB]
+// Sur le fil  : COBS(trame brute) suivi du délimiteur 0x00
+// Code C pur, sans dépendance Arduino : utilisable tel quel côté NUCLEO ou simulateur hôte.
+
+#define UART_FRAME_MAX_PAYLOAD      120
+#define UART_FRAME_HEADER_SIZE      4
+#define UART_FRAME_CRC_SIZE         2
+#define UART_FRAME_RAW_MAX          (UART_FRAME_HEADER_SIZE + UART_FRAME_MAX_PAYLOAD + UART_FRAME_CRC_SIZE)
+#define UART_FRAME_ENCODED_MAX      (UART_FRAME_RAW_MAX + (UART_FRAME_RAW_MAX / 254) + 2) // COBS + délimiteur
+
+// Fenêtre glissante (go-back-N, ACK cumulatif)
+#define UART_FRAME_WINDOW_SIZE      4
+#define UART_FRAME_RETX_TIMEOUT_MS  150
+#define UART_FRAME_MAX_RETRIES      5
+
+// Lignes texte de négociation (échangées en protocole texte)
+#define UART_PROTO_OFFER_BIN        "PROTO?:BIN1"
+#define UART_PROTO_ACCEPT_BIN       "PROTO:BIN1"
+#define UART_PROTO_FALLBACK_TEXT    "PROTO:TEXT"
+
+typedef enum {
+  UART_FRAME_TYPE_DATA = 0x01,
+  UART_FRAME_TYPE_ACK  = 0x02
+} UartFrameType;
+
+typedef struct {
+  uint8_t type;
+  uint8_t seq;
+  uint8_t ack;   // prochain seq attendu par l'émetteur de la trame (ACK cumulatif)
+  uint8_t len;
+  uint8_t payload[UART_FRAME_MAX_PAYLOAD];
+} UartFrame;
+
+typedef enum {
+  UART_FRAME_NONE = 0,       // octet consommé, trame incomplète
+  UART_FRAME_OK,             // trame complète et valide
+  UART_FRAME_ERR_CRC,
+  UART_FRAME_ERR_COBS,
+  UART_FRAME_ERR_LENGTH,
+  UART_FRAME_ERR_OVERFLOW
+} UartFrameStatus;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+uint16_t UartFrame_Crc16(const uint8_t* data, size_t len);
+
+// COBS: retournent la taille produite, 0 en cas d'erreur
+size_t UartFrame_CobsEncode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize);
+size_t UartFrame_CobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize);
+
+// Encode une trame complète (délimiteur 0x00 inclus). Retourne 0 si erreur.
+size_t UartFrame_Encode(const UartFrame* frame, uint8_t* out, size_t outSize);
+// Décode une trame COBS (sans délimiteur)
+UartFrameStatus UartFrame_Decode(const uint8_t* encoded, size_t len, UartFrame* out);
+
+// Décodeur flux: accumule les octets jusqu'au délimiteur 0x00
+typedef struct {
+  uint8_t buf[UART_FRAME_ENCODED_MAX];
+  size_t len;
+  bool overflow;
+} UartFrameDecoder;
+
+void UartFrameDecoder_Init(UartFrameDecoder* dec);
+UartFrameStatus UartFrameDecoder_Push(UartFrameDecoder* dec, uint8_t byte, UartFrame* out);
+
+// Lien fiable: numérotation, fenêtre d'émission, retransmissions, ACK
+typedef struct {
+  UartFrame frame;
+  uint32_t sentMs;
+  bool pending;          // à (ré)émettre au prochain Poll
+} UartFrameSlot;
+
+typedef struct {
+  UartFrameSlot slots[UART_FRAME_WINDOW_SIZE];
+  uint8_t txBase;        // plus ancien seq non acquitté
+  uint8_t txNext;        // prochain seq à attribuer
+  uint8_t rxExpected;    // prochain seq attendu en réception
+  uint8_t retries;       // retransmissions consécutives de txBase
+  bool ackPending;       // un ACK doit être émis
+  bool failed;           // retransmissions épuisées -> repli sur le protocole texte
+  uint32_t framesSent;
+  uint32_t framesReceived;
+  uint32_t retransmits;
+  uint32_t duplicates;
+} UartFrameLink;
+
+void UartFrameLink_Init(UartFrameLink* link);
+// Place un payload dans la fenêtre. false si fenêtre pleine ou payload trop long.
+bool UartFrameLink_Send(UartFrameLink* link, const uint8_t* payload, size_t len);
+// Produit la prochaine trame à écrire sur le fil (nouvelle, retransmise ou ACK). 0 si rien.
+size_t UartFrameLink_Poll(UartFrameLink* link, uint32_t nowMs, uint8_t* out, size_t outSize);
+// Traite une trame valide reçue. true si la trame porte un payload DATA à livrer.
+bool UartFrameLink_OnFrame(UartFrameLink* link, const UartFrame* frame);
+uint8_t UartFrameLink_InFlight(const UartFrameLink* link);
+// Retire le plus ancien payload non acquitté (repli texte: réémission en clair, dans l'ordre).
+// false si la fenêtre est vide ou out trop petit.
+bool UartFrameLink_TakeUnacked(UartFrameLink* link, uint8_t* out, size_t outSize, size_t* len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Assemblage des lignes NUCLEO sans allocation + classification par préfixe
+
+#define UART_LINE_MAX 128   // = MAX_UART_LINE_LENGTH
+
+typedef struct {
+  char buf[UART_LINE_MAX + 1];  // ligne courante, nul-terminée à la livraison
+  size_t len;
+  bool discarding;              // ligne trop longue: ignorée jusqu'à la fin de ligne
+  uint32_t overflows;
+} UartLineAssembler;
+
+void UartLine_Init(UartLineAssembler* a);
+
+// Consomme des octets jusqu'à la première fin de ligne ('\r' ou '\n') incluse.
+// Retourne le nombre d'octets consommés. Si une ligne non vide est complète, *line/*lineLen
+// pointent sur le buffer interne (nul-terminé, valide jusqu'au prochain appel), sinon *line = NULL.
+size_t UartLine_Push(UartLineAssembler* a, const uint8_t* data, size_t len,
+                     const char** line, size_t* lineLen);
+
+// Messages reconnus par préfixe (réponses NUCLEO et négociation de la liaison)
+typedef enum {
+  UART_MSG_UNKNOWN = 0,        // à confier à UartParser_HandleLine (STATE:..., erreurs)
+  UART_MSG_PROTO_ACCEPT_BIN,
+  UART_MSG_PROTO_OFFER_BIN,
+  UART_MSG_PROTO_TEXT,
+  UART_MSG_BAUD_RESET,
+  UART_MSG_BAUD_OK,
+  UART_MSG_BAUD_TRAIN,
+  UART_MSG_DELIVERY_COMPLETED,
+  UART_MSG_DELIVERY_FAILED,
+  UART_MSG_ORDER_ACK,
+  UART_MSG_ORDER_NAK,
+  UART_MSG_VEND_COMPLETED,
+  UART_MSG_VEND_FAILED,
+  UART_MSG_SUPERVISION_ERROR,
+  UART_MSG_COUNT
+} UartMsgType;
+
+// Classe une ligne; *argOffset reçoit la longueur du préfixe reconnu (0 si inconnu)
+UartMsgType UartLine_Classify(const char* line, size_t len, size_t* argOffset);
+
+#ifdef __cplusplus
+}
+#endif
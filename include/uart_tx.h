@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// File d'émission UART NUCLEO: découpage en lignes, regroupement en une écriture, statistiques
+
+#define UART_TX_LINE_MAX        128   // = MAX_UART_LINE_LENGTH (NFC_TEXT: + 119 caractères); en
+                                      // binaire, une ligne = une trame: au plus UART_FRAME_MAX_PAYLOAD
+#define UART_TX_BATCH_MAX       512   // octets envoyés au driver en une écriture
+
+#define UART_TX_FLAG_PRIORITY   0x01  // réponse ACK/NAK/ERR: passe avant les messages en attente
+#define UART_TX_FLAG_CONTINUED  0x02  // la ligne suivante appartient au même message (bloc ORDER_START)
+
+typedef struct {
+  char text[UART_TX_LINE_MAX];  // sans fin de ligne, non nul-terminé
+  uint8_t len;
+  uint8_t flags;
+  uint32_t enqueuedMs;
+} UartTxLine;
+
+// Nombre de lignes non vides d'un texte multi-lignes ('\n', '\r' final ignoré).
+// 0 si le texte est vide ou si une ligne dépasse UART_TX_LINE_MAX.
+size_t UartTx_CountLines(const char* text);
+// Extrait la ligne non vide suivante et avance *cursor. CONTINUED est posé si une autre ligne suit.
+bool UartTx_NextLine(const char** cursor, uint8_t flags, uint32_t nowMs, UartTxLine* out);
+
+typedef struct {
+  uint8_t data[UART_TX_BATCH_MAX];
+  size_t len;
+  uint16_t lines;
+  uint32_t oldestMs;            // date d'enfilage de la plus ancienne ligne du lot
+} UartTxBatch;
+
+void UartTxBatch_Reset(UartTxBatch* b);
+// Ajoute la ligne suivie de "\r\n"; false si le lot est plein (rien n'est ajouté)
+bool UartTxBatch_AppendLine(UartTxBatch* b, const UartTxLine* line);
+// Octets bruts (trames binaires déjà encodées); false si le lot est plein
+bool UartTxBatch_AppendBytes(UartTxBatch* b, const uint8_t* data, size_t len);
+// Compte une ligne du lot pour la latence (mode binaire: la ligne part dans une trame)
+void UartTxBatch_Track(UartTxBatch* b, uint32_t enqueuedMs);
+
+typedef struct {
+  uint32_t lines;
+  uint32_t batches;
+  uint32_t dropped;             // file pleine ou ligne trop longue
+  uint16_t depth;               // profondeur courante (lignes en file)
+  uint16_t depthMax;
+  uint32_t latencyLastMs;       // enfilage -> écriture driver, plus ancienne ligne du lot
+  uint32_t latencyAvgMs;        // moyenne glissante (1/8)
+  uint32_t latencyMaxMs;
+  uint32_t writeLastUs;         // durée de l'appel d'écriture driver
+  uint32_t writeMaxUs;
+} UartTxStats;
+
+void UartTxStats_Init(UartTxStats* s);
+void UartTxStats_OnDepth(UartTxStats* s, uint16_t depth);
+void UartTxStats_OnWrite(UartTxStats* s, const UartTxBatch* b, uint32_t nowMs, uint32_t writeUs);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reconnexion rapide: dernier point d'accès (BSSID, canal) et configuration IP obtenus,
+// conservés en NVS. Le démarrage suivant se connecte directement à ce BSSID sur ce canal
+// (pas de balayage des 13 canaux), puis repasse par un balayage complet en cas d'échec.
+//
+// Adresses IPv4 en uint32_t dans l'ordre mémoire d'IPAddress (ESP32): premier octet
+// en poids faible, "192.168.1.20" -> 0x1401A8C0.
+
+#define WIFI_FAST_RECORD_VERSION  1
+#define WIFI_FAST_MAX_FAILURES    2     // échecs consécutifs avant d'ignorer l'enregistrement
+
+typedef struct {
+  uint8_t version;
+  uint8_t channel;
+  uint8_t bssid[6];
+  uint32_t ssidHash;        // enregistrement lié au réseau configuré (FNV-1a du SSID)
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t mask;
+  uint32_t dns1;
+  uint32_t dns2;
+  uint8_t failures;         // connexions directes échouées depuis la dernière réussie
+  uint8_t reserved[3];
+  uint32_t crc;             // CRC-32 des champs précédents
+} WifiFastRecord;
+
+// Configuration IP fixe: "ip,passerelle,masque[,dns1[,dns2]]"
+typedef struct {
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t mask;
+  uint32_t dns1;
+  uint32_t dns2;
+} WifiStaticIp;
+
+uint32_t WifiFast_SsidHash(const char* ssid);
+
+// Remplit l'enregistrement après une connexion réussie (failures remis à 0) et le scelle
+void WifiFast_Fill(WifiFastRecord* r, const char* ssid, const uint8_t bssid[6], uint8_t channel,
+                   uint32_t ip, uint32_t gateway, uint32_t mask, uint32_t dns1, uint32_t dns2);
+void WifiFast_Seal(WifiFastRecord* r);
+
+// Version, CRC, SSID, canal 1..14, BSSID non nul et moins de WIFI_FAST_MAX_FAILURES échecs
+bool WifiFast_IsUsable(const WifiFastRecord* r, const char* ssid);
+
+// Échec de la connexion directe (AP déplacé ou remplacé): compteur incrémenté, resceller
+void WifiFast_OnFailure(WifiFastRecord* r);
+
+// true si les deux enregistrements décrivent la même connexion (écriture NVS évitée)
+bool WifiFast_SameLink(const WifiFastRecord* a, const WifiFastRecord* b);
+
+bool WifiFast_ParseIpv4(const char* s, size_t len, uint32_t* out);
+bool WifiFast_ParseStaticIp(const char* s, WifiStaticIp* out);
+
+#ifdef __cplusplus
+}
+#endif
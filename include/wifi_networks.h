@@ -0,0 +1,89 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Liste des réseaux Wi-Fi connus avec priorité et statistiques (dernier RSSI vu,
+// latence moyenne du backend, échecs consécutifs). La liste est conservée en NVS
+// (blob scellé par CRC-32), les mots de passe chiffrés à part, un par emplacement.
+//
+// Sélection après balayage: parmi les réseaux visibles, coût croissant
+//   - priorité (chaque niveau vaut WIFI_NET_PRIORITY_WEIGHT_MS),
+//   + latence moyenne mesurée du backend (WIFI_NET_UNKNOWN_LATENCY_MS si jamais mesurée),
+//   + pénalité de signal faible sous -60 dBm (retransmissions),
+//   + pénalité par échec consécutif.
+// Le réseau historiquement le plus rapide passe donc devant à priorité égale.
+
+#define WIFI_NETWORKS_MAX             5
+#define WIFI_NETWORKS_VERSION         1
+#define WIFI_NET_SSID_MAX             32
+#define WIFI_NET_PRIORITY_MAX         9
+#define WIFI_NET_PRIORITY_WEIGHT_MS   1000
+#define WIFI_NET_UNKNOWN_LATENCY_MS   400
+#define WIFI_NET_WEAK_RSSI            -60
+#define WIFI_NET_RSSI_PENALTY_MS      10    // par dBm sous WIFI_NET_WEAK_RSSI
+#define WIFI_NET_FAILURE_PENALTY_MS   1500
+#define WIFI_NET_MIN_RSSI             -88   // AP ignoré en dessous
+
+typedef struct {
+  char ssid[WIFI_NET_SSID_MAX + 1];
+  uint8_t priority;         // 0..WIFI_NET_PRIORITY_MAX, plus élevé = préféré
+  int8_t lastRssi;          // dBm au dernier balayage où il était visible (0: jamais vu)
+  uint8_t failures;         // connexions échouées depuis la dernière réussie
+  uint16_t latencyMs;       // moyenne glissante (1/4) de la latence backend, 0: inconnue
+  uint16_t connects;
+  uint32_t lastSeenScan;    // numéro du dernier balayage où il était visible
+} WifiNetwork;
+
+typedef struct {
+  uint8_t version;
+  uint8_t count;
+  uint8_t reserved[2];
+  uint32_t scanSeq;
+  WifiNetwork nets[WIFI_NETWORKS_MAX];
+  uint32_t crc;             // CRC-32 des champs précédents
+} WifiNetworkList;
+
+// Point d'accès vu au balayage
+typedef struct {
+  char ssid[WIFI_NET_SSID_MAX + 1];
+  int8_t rssi;
+  uint8_t channel;
+  uint8_t bssid[6];
+} WifiScanEntry;
+
+typedef struct {
+  uint8_t index;            // réseau dans la liste
+  uint8_t scanIndex;        // meilleur AP de ce SSID dans le balayage (RSSI le plus fort)
+  int32_t cost;
+} WifiCandidate;
+
+void WifiNetworks_Init(WifiNetworkList* l);
+void WifiNetworks_Seal(WifiNetworkList* l);
+// Version, CRC, nombre d'entrées et SSID terminés
+bool WifiNetworks_IsValid(const WifiNetworkList* l);
+
+int WifiNetworks_Find(const WifiNetworkList* l, const char* ssid);
+// Ajout ou mise à jour de priorité. Liste pleine: remplace la priorité la plus basse
+// (puis le plus d'échecs, puis le moins récemment vu). Retourne l'emplacement, -1 si invalide.
+int WifiNetworks_Add(WifiNetworkList* l, const char* ssid, uint8_t priority);
+// Supprime l'entrée; la dernière prend sa place (*movedFrom: son ancien emplacement, -1 sinon)
+bool WifiNetworks_Remove(WifiNetworkList* l, int index, int* movedFrom);
+
+int32_t WifiNetworks_Cost(const WifiNetwork* n, int8_t rssi);
+// Met à jour RSSI et dernier balayage des réseaux visibles et classe les candidats par coût
+size_t WifiNetworks_Rank(WifiNetworkList* l, const WifiScanEntry* scan, size_t scanCount,
+                         WifiCandidate* out, size_t outMax);
+
+void WifiNetworks_OnConnected(WifiNetworkList* l, int index);
+void WifiNetworks_OnFailed(WifiNetworkList* l, int index);
+void WifiNetworks_RecordLatency(WifiNetworkList* l, int index, uint32_t latencyMs);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Politique d'économie d'énergie Wi-Fi liée aux transactions: radio toujours éveillée
+// (WIFI_PS_NONE) pendant un workflow de commande, modem sleep au repos. En modem sleep
+// la station ne se réveille qu'aux balises DTIM: chaque réponse du backend peut attendre
+// jusqu'à un intervalle DTIM (~100-300 ms) de plus.
+//
+// Statistiques par mode: temps passé, latences mesurées (requêtes HTTP complètes et
+// connexions TCP du test backend), courant moyen estimé à partir du courant de la carte
+// dans chaque mode (valeurs de banc, pas de capteur de courant sur la carte).
+//
+// Module pur: l'appelant applique le mode au pilote et fournit l'horloge (ms).
+
+typedef enum {
+  WIFI_POWER_MODEM_SLEEP = 0,   // WIFI_PS_MIN_MODEM
+  WIFI_POWER_AWAKE = 1,         // WIFI_PS_NONE
+  WIFI_POWER_MODES
+} WifiPowerMode;
+
+typedef enum {
+  WIFI_POWER_SAMPLE_HTTP = 0,   // requête complète (TLS compris)
+  WIFI_POWER_SAMPLE_TCP = 1,    // connexion TCP seule
+  WIFI_POWER_SAMPLES
+} WifiPowerSample;
+
+typedef struct {
+  uint32_t count;
+  uint64_t sumMs;
+  uint32_t maxMs;
+} WifiPowerLatency;
+
+typedef struct {
+  uint64_t timeMs;              // périodes terminées (la période en cours est ajoutée à la lecture)
+  uint32_t entries;
+  WifiPowerLatency latency[WIFI_POWER_SAMPLES];
+} WifiPowerModeStats;
+
+typedef struct {
+  WifiPowerMode mode;
+  uint32_t sinceMs;             // entrée dans le mode courant
+  uint16_t currentMa[WIFI_POWER_MODES];
+  WifiPowerModeStats modes[WIFI_POWER_MODES];
+} WifiPower;
+
+void WifiPower_Init(WifiPower* p, WifiPowerMode mode, uint16_t sleepMa, uint16_t awakeMa, uint32_t nowMs);
+
+// Mode voulu: éveillé pendant une transaction
+WifiPowerMode WifiPower_ModeFor(bool transactionActive);
+// true si le mode change (à appliquer au pilote)
+bool WifiPower_SetMode(WifiPower* p, WifiPowerMode mode, uint32_t nowMs);
+
+// Latence attribuée au mode courant
+void WifiPower_Record(WifiPower* p, WifiPowerSample kind, uint32_t latencyMs);
+
+uint64_t WifiPower_TimeMs(const WifiPower* p, WifiPowerMode mode, uint32_t nowMs);
+uint32_t WifiPower_AvgLatencyMs(const WifiPower* p, WifiPowerMode mode, WifiPowerSample kind);
+// Courant moyen pondéré par le temps passé dans chaque mode, en dixièmes de mA
+uint32_t WifiPower_AvgCurrentDeciMa(const WifiPower* p, uint32_t nowMs);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reconnexion Wi-Fi pilotée par les événements du pilote (IP obtenue, IP perdue,
+// déconnexion avec sa raison). Après une coupure, les tentatives sont espacées d'un
+// délai exponentiel avec gigue: base * 2^échecs plafonné à maxMs, tiré au hasard dans
+// [délai/2, délai] pour que plusieurs distributeurs ne se reconnectent pas ensemble
+// au retour du point d'accès.
+//
+// Module pur: l'appelant fournit l'horloge (ms) et émet les tentatives.
+
+// Raisons de déconnexion ESP-IDF (wifi_err_reason_t) traitées à part
+#define WIFI_RC_REASON_AUTH_FAIL    202   // mot de passe refusé: délai maximal directement
+#define WIFI_RC_REASON_NO_AP_FOUND  201
+
+typedef enum {
+  WIFI_RC_IDLE = 0,       // pas de credentials
+  WIFI_RC_CONNECTING,     // tentative émise, en attente d'IP ou de déconnexion
+  WIFI_RC_CONNECTED,      // IP obtenue
+  WIFI_RC_BACKOFF,        // attente avant la tentative suivante
+} WifiRcState;
+
+typedef struct {
+  uint32_t baseMs;            // délai après la première coupure
+  uint32_t maxMs;             // plafond du délai
+  uint32_t attemptTimeoutMs;  // tentative sans réponse du pilote comptée en échec
+} WifiRcConfig;
+
+typedef struct {
+  WifiRcConfig cfg;
+  WifiRcState state;
+  uint32_t failures;          // tentatives échouées depuis la dernière connexion
+  uint32_t deadlineMs;        // fin du délai (BACKOFF) ou de la tentative (CONNECTING)
+  uint32_t rng;
+  uint16_t lastReason;
+  uint32_t attempts;          // statistiques
+  uint32_t disconnects;
+  uint32_t authFailures;
+} WifiReconnect;
+
+void WifiRc_Init(WifiReconnect* r, const WifiRcConfig* cfg, uint32_t seed);
+
+// Délai avant la tentative suivant `failures` échecs, random: tirage 32 bits
+uint32_t WifiRc_BackoffMs(const WifiRcConfig* cfg, uint32_t failures, uint32_t random);
+
+// Tentative émise (WiFi.begin / reconnect)
+void WifiRc_OnAttempt(WifiReconnect* r, uint32_t nowMs);
+void WifiRc_OnGotIp(WifiReconnect* r);
+// Déconnexion ou IP perdue (reason 0): coupure si connecté, échec si tentative en cours
+void WifiRc_OnDisconnected(WifiReconnect* r, uint16_t reason, uint32_t nowMs);
+
+// true si une tentative est due (fin du délai, ou tentative restée sans réponse)
+bool WifiRc_ShouldAttempt(WifiReconnect* r, uint32_t nowMs);
+// Temps avant la prochaine échéance (UINT32_MAX: aucune)
+uint32_t WifiRc_NextDelayMs(const WifiReconnect* r, uint32_t nowMs);
+
+// Hôte et port du backend à partir de l'URL de base ("https://hote[:port][/...]")
+bool WifiRc_ParseHost(const char* url, char* host, size_t hostSize, uint16_t* port);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,3 +4,4 @@
 #include "../../include/uart_parser.h"
 #include "../../include/http_utils.h"
 #include "../../include/nfc_ndef.h"
+#include "src/ndef.h"
@@ -0,0 +1,326 @@
+#include "ndef.h"
+#include <string.h>
+
+// ---- TLV ----
+
+void Ndef_TlvBegin(NdefTlvIter* it, const uint8_t* mem, size_t len) {
+  if (!it) return;
+  it->mem = mem;
+  it->len = mem ? len : 0;
+  it->pos = 0;
+  it->error = false;
+}
+
+bool Ndef_TlvNext(NdefTlvIter* it, NdefTlv* tlv) {
+  if (!it || !tlv) return false;
+  while (it->pos < it->len) {
+    uint8_t t = it->mem[it->pos];
+    if (t == NDEF_TLV_NULL) {
+      it->pos++;
+      continue;
+    }
+    if (t == NDEF_TLV_TERMINATOR) {
+      it->pos = it->len;
+      return false;
+    }
+    size_t p = it->pos + 1;
+    bool ok = p < it->len;
+    size_t len = ok ? it->mem[p++] : 0;
+    if (ok && len == 0xFF) {  // longueur sur 3 octets
+      ok = p + 2 <= it->len;
+      if (ok) {
+        len = ((size_t)it->mem[p] << 8) | it->mem[p + 1];
+        p += 2;
+      }
+    }
+    if (!ok || len > it->len - p) {
+      it->error = true;
+      it->pos = it->len;
+      return false;
+    }
+    tlv->type = t;
+    tlv->value = it->mem + p;
+    tlv->len = len;
+    it->pos = p + len;
+    return true;
+  }
+  return false;
+}
+
+// ---- Records ----
+
+void Ndef_RecordBegin(NdefRecordIter* it, const uint8_t* msg, size_t len) {
+  if (!it) return;
+  memset(it, 0, sizeof(*it));
+  it->msg = msg;
+  it->len = msg ? len : 0;
+}
+
+static bool recordError(NdefRecordIter* it) {
+  it->error = true;
+  it->pos = it->len;
+  return false;
+}
+
+bool Ndef_RecordNext(NdefRecordIter* it, NdefRecord* rec) {
+  if (!it || !rec || it->done || it->error) return false;
+  if (it->pos >= it->len) {
+    // Zone terminée sans ME: acceptable sauf au milieu d'un record fragmenté
+    if (it->inChunk) return recordError(it);
+    return false;
+  }
+
+  const uint8_t* p = it->msg + it->pos;
+  const uint8_t* end = it->msg + it->len;
+  uint8_t hdr = *p++;
+  bool cf = (hdr & 0x20) != 0;
+  bool sr = (hdr & 0x10) != 0;
+  bool il = (hdr & 0x08) != 0;
+  uint8_t tnf = hdr & 0x07;
+
+  if (end - p < 1) return recordError(it);
+  uint8_t typeLen = *p++;
+  uint32_t payloadLen = 0;
+  if (sr) {
+    if (end - p < 1) return recordError(it);
+    payloadLen = *p++;
+  } else {
+    if (end - p < 4) return recordError(it);
+    payloadLen = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    p += 4;
+  }
+  uint8_t idLen = 0;
+  if (il) {
+    if (end - p < 1) return recordError(it);
+    idLen = *p++;
+  }
+  if ((size_t)(end - p) < typeLen) return recordError(it);
+  const uint8_t* type = p;
+  p += typeLen;
+  if ((size_t)(end - p) < idLen) return recordError(it);
+  const uint8_t* id = p;
+  p += idLen;
+  if ((size_t)(end - p) < payloadLen) return recordError(it);
+  const uint8_t* payload = p;
+  p += payloadLen;
+
+  // Contraintes NFC Forum NDEF 1.0
+  if (tnf == 0x07) return recordError(it);
+  if (tnf == NDEF_TNF_EMPTY && (typeLen || idLen || payloadLen)) return recordError(it);
+  if ((tnf == NDEF_TNF_UNKNOWN || tnf == NDEF_TNF_UNCHANGED) && typeLen) return recordError(it);
+  if (it->inChunk ? (tnf != NDEF_TNF_UNCHANGED || il) : (tnf == NDEF_TNF_UNCHANGED)) return recordError(it);
+  if (cf && (hdr & 0x40)) return recordError(it);  // ME sur un fragment non final
+
+  memset(rec, 0, sizeof(*rec));
+  rec->mb = (hdr & 0x80) != 0;
+  rec->me = (hdr & 0x40) != 0;
+  rec->id = id;
+  rec->idLen = idLen;
+  rec->payload = payload;
+  rec->payloadLen = payloadLen;
+  if (it->inChunk) {
+    rec->chunk = true;
+    rec->chunkIndex = ++it->chunkIndex;
+    rec->lastChunk = !cf;
+    rec->tnf = it->chunkTnf;
+    rec->type = it->chunkType;
+    rec->typeLen = it->chunkTypeLen;
+    it->inChunk = cf;
+  } else {
+    rec->tnf = tnf;
+    rec->type = type;
+    rec->typeLen = typeLen;
+    if (cf) {
+      rec->chunk = true;
+      it->inChunk = true;
+      it->chunkIndex = 0;
+      it->chunkTnf = tnf;
+      it->chunkType = type;
+      it->chunkTypeLen = typeLen;
+    }
+  }
+
+  it->pos = (size_t)(p - it->msg);
+  if (rec->me) it->done = true;
+  return true;
+}
+
+int Ndef_JoinChunks(NdefRecordIter* it, const NdefRecord* first, uint8_t* out, size_t outSize) {
+  if (!first || !out) return -1;
+  NdefRecord rec = *first;
+  size_t total = 0;
+  for (;;) {
+    if (rec.payloadLen > outSize - total) return -1;
+    memcpy(out + total, rec.payload, rec.payloadLen);
+    total += rec.payloadLen;
+    if (!rec.chunk || rec.lastChunk) return (int)total;
+    if (!Ndef_RecordNext(it, &rec)) return -1;
+  }
+}
+
+bool Ndef_IsType(const NdefRecord* rec, uint8_t tnf, const char* type) {
+  if (!rec || rec->tnf != tnf) return false;
+  size_t n = type ? strlen(type) : 0;
+  return rec->typeLen == n && (n == 0 || memcmp(rec->type, type, n) == 0);
+}
+
+bool Ndef_FindRecord(const uint8_t* mem, size_t len, uint8_t tnf, const char* type, NdefRecord* out) {
+  NdefTlvIter tlvs;
+  NdefTlv tlv;
+  Ndef_TlvBegin(&tlvs, mem, len);
+  while (Ndef_TlvNext(&tlvs, &tlv)) {
+    if (tlv.type != NDEF_TLV_MESSAGE) continue;
+    NdefRecordIter records;
+    NdefRecord rec;
+    Ndef_RecordBegin(&records, tlv.value, tlv.len);
+    while (Ndef_RecordNext(&records, &rec)) {
+      if (rec.chunk && rec.chunkIndex > 0) continue;
+      if (Ndef_IsType(&rec, tnf, type)) {
+        if (out) *out = rec;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// ---- Text ----
+
+bool Ndef_ParseTextPayload(const uint8_t* payload, size_t len, NdefText* out) {
+  if (!payload || len < 1 || !out) return false;
+  uint8_t status = payload[0];
+  uint8_t langLen = status & 0x3F;
+  if ((size_t)1 + langLen > len) return false;
+  out->lang = payload + 1;
+  out->langLen = langLen;
+  out->text = payload + 1 + langLen;
+  out->textLen = len - 1 - langLen;
+  out->utf16 = (status & 0x80) != 0;
+  return true;
+}
+
+bool Ndef_ParseText(const NdefRecord* rec, NdefText* out) {
+  if (!Ndef_IsType(rec, NDEF_TNF_WELL_KNOWN, "T")) return false;
+  if (rec->chunk) return false;  // réassembler d'abord (Ndef_JoinChunks)
+  return Ndef_ParseTextPayload(rec->payload, rec->payloadLen, out);
+}
+
+static size_t utf8Encode(uint32_t u, uint8_t* enc) {
+  if (u < 0x80) {
+    enc[0] = (uint8_t)u;
+    return 1;
+  }
+  if (u < 0x800) {
+    enc[0] = (uint8_t)(0xC0 | (u >> 6));
+    enc[1] = (uint8_t)(0x80 | (u & 0x3F));
+    return 2;
+  }
+  if (u < 0x10000) {
+    enc[0] = (uint8_t)(0xE0 | (u >> 12));
+    enc[1] = (uint8_t)(0x80 | ((u >> 6) & 0x3F));
+    enc[2] = (uint8_t)(0x80 | (u & 0x3F));
+    return 3;
+  }
+  enc[0] = (uint8_t)(0xF0 | (u >> 18));
+  enc[1] = (uint8_t)(0x80 | ((u >> 12) & 0x3F));
+  enc[2] = (uint8_t)(0x80 | ((u >> 6) & 0x3F));
+  enc[3] = (uint8_t)(0x80 | (u & 0x3F));
+  return 4;
+}
+
+size_t Ndef_TextToUtf8(const NdefText* text, char* out, size_t outSize) {
+  if (!out || outSize == 0) return 0;
+  size_t n = 0;
+  if (text && !text->utf16) {
+    size_t copy = text->textLen < outSize - 1 ? text->textLen : outSize - 1;
+    if (copy < text->textLen) {
+      while (copy > 0 && (text->text[copy] & 0xC0) == 0x80) copy--;
+    }
+    if (copy > 0) memcpy(out, text->text, copy);
+    n = copy;
+  } else if (text) {
+    const uint8_t* p = text->text;
+    size_t len = text->textLen & ~(size_t)1;
+    size_t i = 0;
+    bool le = false;
+    if (len >= 2 && p[0] == 0xFF && p[1] == 0xFE) {
+      le = true;
+      i = 2;
+    } else if (len >= 2 && p[0] == 0xFE && p[1] == 0xFF) {
+      i = 2;
+    }
+    while (i + 1 < len) {
+      uint32_t u = le ? (uint32_t)(p[i] | (p[i + 1] << 8)) : (uint32_t)((p[i] << 8) | p[i + 1]);
+      i += 2;
+      if (u >= 0xD800 && u <= 0xDBFF && i + 1 < len) {
+        uint32_t lo = le ? (uint32_t)(p[i] | (p[i + 1] << 8)) : (uint32_t)((p[i] << 8) | p[i + 1]);
+        if (lo >= 0xDC00 && lo <= 0xDFFF) {
+          u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+          i += 2;
+        } else {
+          u = '?';
+        }
+      } else if (u >= 0xD800 && u <= 0xDFFF) {
+        u = '?';  // surrogate isolé
+      }
+      uint8_t enc[4];
+      size_t k = utf8Encode(u, enc);
+      if (n + k > outSize - 1) break;
+      memcpy(out + n, enc, k);
+      n += k;
+    }
+  }
+  out[n] = '\0';
+  return n;
+}
+
+// ---- URI ----
+
+// NFC Forum RTD URI, table des abréviations (0x00..0x23)
+static const char* const kUriPrefixes[] = {
+  "", "http://www.", "https://www.", "http://", "https://", "tel:", "mailto:",
+  "ftp://anonymous:anonymous@", "ftp://ftp.", "ftps://", "sftp://", "smb://", "nfs://",
+  "ftp://", "dav://", "news:", "telnet://", "imap:", "rtsp://", "urn:", "pop:", "sip:",
+  "sips:", "tftp:", "btspp://", "btl2cap://", "btgoep://", "tcpobex://", "irdaobex://",
+  "file://", "urn:epc:id:", "urn:epc:tag:", "urn:epc:pat:", "urn:epc:raw:", "urn:epc:",
+  "urn:nfc:"
+};
+
+bool Ndef_ParseUriPayload(const uint8_t* payload, size_t len, NdefUri* out) {
+  if (!payload || len < 1 || !out) return false;
+  if (payload[0] >= sizeof(kUriPrefixes) / sizeof(kUriPrefixes[0])) return false;  // RFU
+  out->prefix = kUriPrefixes[payload[0]];
+  out->rest = payload + 1;
+  out->restLen = len - 1;
+  return true;
+}
+
+bool Ndef_ParseUri(const NdefRecord* rec, NdefUri* out) {
+  if (!rec || !out || rec->chunk) return false;
+  if (rec->tnf == NDEF_TNF_ABSOLUTE_URI) {
+    // L'URI est le champ type, payload vide
+    out->prefix = "";
+    out->rest = rec->type;
+    out->restLen = rec->typeLen;
+    return true;
+  }
+  if (!Ndef_IsType(rec, NDEF_TNF_WELL_KNOWN, "U")) return false;
+  return Ndef_ParseUriPayload(rec->payload, rec->payloadLen, out);
+}
+
+size_t Ndef_UriToString(const NdefUri* uri, char* out, size_t outSize) {
+  if (!out || outSize == 0) return 0;
+  size_t n = 0;
+  if (uri) {
+    size_t plen = strlen(uri->prefix);
+    if (plen > outSize - 1) plen = outSize - 1;
+    memcpy(out, uri->prefix, plen);
+    n = plen;
+    size_t rlen = uri->restLen;
+    if (rlen > outSize - 1 - n) rlen = outSize - 1 - n;
+    if (rlen > 0) memcpy(out + n, uri->rest, rlen);
+    n += rlen;
+  }
+  out[n] = '\0';
+  return n;
+}
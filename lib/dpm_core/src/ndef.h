@@ -0,0 +1,122 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Parcours NDEF sans copie: TLV (mémoire du tag) -> message NDEF -> records.
+// Toutes les structures retournées pointent dans la mémoire lue sur le tag,
+// qui doit rester valide pendant l'exploitation des résultats.
+// Seule Ndef_JoinChunks copie (records fragmentés, payload non contigu).
+
+// ---- TLV (tags Type 2, secteurs MIFARE Classic) ----
+#define NDEF_TLV_NULL        0x00
+#define NDEF_TLV_LOCK        0x01
+#define NDEF_TLV_MEMORY      0x02
+#define NDEF_TLV_MESSAGE     0x03
+#define NDEF_TLV_PROPRIETARY 0xFD
+#define NDEF_TLV_TERMINATOR  0xFE
+
+typedef struct {
+  uint8_t type;
+  const uint8_t* value;
+  size_t len;
+} NdefTlv;
+
+typedef struct {
+  const uint8_t* mem;
+  size_t len;
+  size_t pos;
+  bool error;              // TLV tronqué
+} NdefTlvIter;
+
+void Ndef_TlvBegin(NdefTlvIter* it, const uint8_t* mem, size_t len);
+// TLV suivant (NULL ignorés); false sur Terminator, fin de zone ou troncature (it->error)
+bool Ndef_TlvNext(NdefTlvIter* it, NdefTlv* tlv);
+
+// ---- Records ----
+#define NDEF_TNF_EMPTY        0x00
+#define NDEF_TNF_WELL_KNOWN   0x01
+#define NDEF_TNF_MEDIA        0x02
+#define NDEF_TNF_ABSOLUTE_URI 0x03
+#define NDEF_TNF_EXTERNAL     0x04
+#define NDEF_TNF_UNKNOWN      0x05
+#define NDEF_TNF_UNCHANGED    0x06
+
+typedef struct {
+  uint8_t tnf;             // TNF du premier fragment pour un record fragmenté
+  bool mb;
+  bool me;
+  bool chunk;              // fait partie d'un record fragmenté
+  bool lastChunk;          // dernier fragment (CF = 0)
+  uint16_t chunkIndex;
+  const uint8_t* type;     // type du premier fragment pour un record fragmenté
+  uint8_t typeLen;
+  const uint8_t* id;
+  uint8_t idLen;
+  const uint8_t* payload;  // payload de ce fragment uniquement
+  uint32_t payloadLen;
+} NdefRecord;
+
+typedef struct {
+  const uint8_t* msg;
+  size_t len;
+  size_t pos;
+  bool done;               // record ME atteint
+  bool error;              // record malformé ou tronqué
+  bool inChunk;
+  uint16_t chunkIndex;
+  uint8_t chunkTnf;
+  const uint8_t* chunkType;
+  uint8_t chunkTypeLen;
+} NdefRecordIter;
+
+void Ndef_RecordBegin(NdefRecordIter* it, const uint8_t* msg, size_t len);
+bool Ndef_RecordNext(NdefRecordIter* it, NdefRecord* rec);
+
+// Concatène les fragments à partir de 'first' (premier fragment déjà lu), l'itérateur
+// avance jusqu'au dernier. Retourne la longueur du payload complet, -1 si erreur ou
+// buffer trop petit. Un record non fragmenté est simplement copié.
+int Ndef_JoinChunks(NdefRecordIter* it, const NdefRecord* first, uint8_t* out, size_t outSize);
+
+bool Ndef_IsType(const NdefRecord* rec, uint8_t tnf, const char* type);
+
+// Premier record correspondant dans toute la zone TLV (tous les TLV NDEF).
+// Les fragments de continuation sont ignorés.
+bool Ndef_FindRecord(const uint8_t* mem, size_t len, uint8_t tnf, const char* type, NdefRecord* out);
+
+// ---- Text (well-known "T") ----
+typedef struct {
+  const uint8_t* lang;
+  uint8_t langLen;
+  const uint8_t* text;
+  size_t textLen;          // en octets
+  bool utf16;
+} NdefText;
+
+bool Ndef_ParseText(const NdefRecord* rec, NdefText* out);
+// Payload complet (record fragmenté réassemblé par Ndef_JoinChunks)
+bool Ndef_ParseTextPayload(const uint8_t* payload, size_t len, NdefText* out);
+// Texte en UTF-8 terminé par '\0' (UTF-16 converti, BOM respecté, BE par défaut).
+// Tronqué sur une frontière de caractère. Retourne le nombre d'octets écrits.
+size_t Ndef_TextToUtf8(const NdefText* text, char* out, size_t outSize);
+
+// ---- URI (well-known "U", ou TNF absolute URI) ----
+typedef struct {
+  const char* prefix;      // abréviation développée (table NFC Forum RTD URI)
+  const uint8_t* rest;
+  size_t restLen;
+} NdefUri;
+
+bool Ndef_ParseUri(const NdefRecord* rec, NdefUri* out);
+bool Ndef_ParseUriPayload(const uint8_t* payload, size_t len, NdefUri* out);
+// prefix + rest terminé par '\0', tronqué si besoin. Retourne la longueur écrite.
+size_t Ndef_UriToString(const NdefUri* uri, char* out, size_t outSize);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+Génération de tokens QR signés (format de include/qr_offline_token.h), pour le développement
+et les tests. En production, les tokens sont émis par le backend avec sa clé privée.
+
+Nécessite la commande openssl (ECDSA P-256).
+
+Usage:
+  python3 scripts/qr_offline_token.py keygen <cle.pem>
+      -> affiche QR_TOKEN_PUBLIC_KEY=... à copier dans .env
+  python3 scripts/qr_offline_token.py sign <cle.pem> <order_id> <machine_id> <expiration_unix> <slot:qte> [...]
+  python3 scripts/qr_offline_token.py                                     (auto-test)
+"""
+
+import base64
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+PREFIX = "qrs_"
+VERSION = 1
+
+
+def b64url(data: bytes) -> str:
+    return base64.urlsafe_b64encode(data).decode().rstrip("=")
+
+
+def payload(order_id: str, machine_id: str, expires: int, items) -> bytes:
+    out = bytearray(struct.pack(">BI", VERSION, expires))
+    for ident in (order_id, machine_id):
+        raw = ident.encode()
+        if not 0 < len(raw) <= 31:
+            raise ValueError("identifiant de 1 à 31 caractères")
+        out += bytes([len(raw)]) + raw
+    if not 0 < len(items) <= 10:
+        raise ValueError("1 à 10 items")
+    out.append(len(items))
+    for slot, qty in items:
+        out += bytes([slot, qty])
+    return bytes(out)
+
+
+def _der_to_raw(der: bytes) -> bytes:
+    """Signature ECDSA DER (SEQUENCE { r, s }) -> r || s sur 32 octets chacun"""
+    pos = 2 if der[1] < 0x80 else 3
+    raw = b""
+    for _ in range(2):
+        assert der[pos] == 0x02
+        n = der[pos + 1]
+        v = der[pos + 2:pos + 2 + n].lstrip(b"\x00")
+        raw += v.rjust(32, b"\x00")
+        pos += 2 + n
+    return raw
+
+
+def public_key(key_pem: str) -> bytes:
+    der = subprocess.run(["openssl", "ec", "-in", key_pem, "-pubout", "-outform", "DER"],
+                         check=True, capture_output=True).stdout
+    return der[-65:]  # SubjectPublicKeyInfo: le point non compressé termine la structure
+
+
+def sign(key_pem: str, data: bytes) -> bytes:
+    with tempfile.NamedTemporaryFile(delete=False) as f:
+        f.write(data)
+        path = f.name
+    try:
+        der = subprocess.run(["openssl", "dgst", "-sha256", "-sign", key_pem, path],
+                             check=True, capture_output=True).stdout
+    finally:
+        os.unlink(path)
+    return _der_to_raw(der)
+
+
+def verify(pub: bytes, data: bytes, raw_sig: bytes) -> bool:
+    """Vérification par openssl (auto-test): reconstruit clé PEM et signature DER"""
+    spki = bytes.fromhex("3059301306072a8648ce3d020106082a8648ce3d030107034200") + pub
+
+    def der_int(v: bytes) -> bytes:
+        v = v.lstrip(b"\x00") or b"\x00"
+        if v[0] & 0x80:
+            v = b"\x00" + v
+        return bytes([0x02, len(v)]) + v
+
+    body = der_int(raw_sig[:32]) + der_int(raw_sig[32:])
+    der = bytes([0x30, len(body)]) + body
+    with tempfile.TemporaryDirectory() as d:
+        paths = {}
+        for name, content in (("pub.der", spki), ("sig.der", der), ("msg", data)):
+            paths[name] = os.path.join(d, name)
+            with open(paths[name], "wb") as f:
+                f.write(content)
+        r = subprocess.run(["openssl", "dgst", "-sha256", "-keyform", "DER", "-verify", paths["pub.der"],
+                            "-signature", paths["sig.der"], paths["msg"]], capture_output=True)
+    return r.returncode == 0
+
+
+def token(key_pem: str, order_id: str, machine_id: str, expires: int, items) -> str:
+    data = payload(order_id, machine_id, expires, items)
+    return PREFIX + b64url(data + sign(key_pem, data))
+
+
+def keygen(key_pem: str):
+    subprocess.run(["openssl", "ecparam", "-name", "prime256v1", "-genkey", "-noout", "-out", key_pem], check=True)
+    return public_key(key_pem)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 3 and sys.argv[1] == "keygen":
+        print("QR_TOKEN_PUBLIC_KEY=" + b64url(keygen(sys.argv[2])))
+    elif len(sys.argv) >= 7 and sys.argv[1] == "sign":
+        items = [tuple(int(x) for x in it.split(":")) for it in sys.argv[6:]]
+        print(token(sys.argv[2], sys.argv[3], sys.argv[4], int(sys.argv[5]), items))
+    else:
+        with tempfile.TemporaryDirectory() as d:
+            key = os.path.join(d, "k.pem")
+            pub = keygen(key)
+            assert len(pub) == 65 and pub[0] == 4
+            data = payload("ord_42", "VM-01", 2000000000, [(3, 1), (12, 2)])
+            sig = sign(key, data)
+            assert len(sig) == 64 and verify(pub, data, sig)
+            assert not verify(pub, data[:-1] + b"\x03", sig)
+            tok = token(key, "ord_42", "VM-01", 2000000000, [(3, 1), (12, 2)])
+            assert tok.startswith(PREFIX) and len(tok) < 211
+        print("qr_offline_token.py: OK")
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Récupération et lecture des captures UART (commande CLI CAP DUMP).
+Miroir du format de include/uart_capture.h.
+
+Vidage : [en-tête 16 octets][enregistrements]
+  en-tête : "UCAP" | version | réservé | perdus u16 LE | t0 ms u32 LE | taille u32 LE
+  enregistrement : [tag][delta ms varint][longueur varint][octets], tag = (canal << 1) | sens
+
+Usage:
+  python3 scripts/uart_capture.py pull <port> <sortie.ucap>   (pyserial, envoie CAP DUMP)
+  python3 scripts/uart_capture.py extract <log_console> <sortie.ucap>
+  python3 scripts/uart_capture.py show <capture.ucap>
+  python3 scripts/uart_capture.py                              (auto-test)
+
+Relecture sur PC: UART_REPLAY_FILE=<capture.ucap> pio test -e native -f test_uart_replay_native
+"""
+
+import struct
+import sys
+
+MAGIC = b"UCAP"
+VERSION = 1
+HEADER_SIZE = 16
+CHANNELS = {0: "NUCLEO", 1: "QR"}
+DIRS = {0: "RX", 1: "TX"}
+DUMP_MARKER = b"[CAP] DUMP "
+END_MARKER = b"\n[CAP] END"
+
+
+def _varint(data: bytes, pos: int):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data):
+            raise ValueError("varint tronqué")
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+        shift += 7
+
+
+def _put_varint(v: int) -> bytes:
+    out = bytearray()
+    while v >= 0x80:
+        out.append((v & 0x7F) | 0x80)
+        v >>= 7
+    out.append(v)
+    return bytes(out)
+
+
+def parse(dump: bytes):
+    """Retourne (perdus, [(temps_ms, canal, sens, octets), ...])"""
+    if len(dump) < HEADER_SIZE or dump[:4] != MAGIC or dump[4] != VERSION:
+        raise ValueError("pas un vidage UCAP")
+    dropped, t, size = struct.unpack_from("<HII", dump, 6)
+    body = dump[HEADER_SIZE:HEADER_SIZE + size]
+    if len(body) != size:
+        raise ValueError("vidage tronqué")
+    records = []
+    pos = 0
+    while pos < len(body):
+        tag = body[pos]
+        delta, pos = _varint(body, pos + 1)
+        length, pos = _varint(body, pos)
+        if records:
+            t += delta
+        records.append((t, tag >> 1, tag & 1, body[pos:pos + length]))
+        pos += length
+    return dropped, records
+
+
+def build(records, dropped=0) -> bytes:
+    """Construit un vidage (tests, captures synthétiques)"""
+    body = bytearray()
+    last = records[0][0] if records else 0
+    for t, ch, d, data in records:
+        body += bytes([(ch << 1) | d]) + _put_varint(t - last) + _put_varint(len(data)) + data
+        last = t
+    t0 = records[0][0] if records else 0
+    return MAGIC + struct.pack("<BBHII", VERSION, 0, dropped, t0, len(body)) + bytes(body)
+
+
+def extract(log: bytes) -> bytes:
+    """Isole le vidage binaire d'un journal console ("[CAP] DUMP <n>\\n" + n octets)"""
+    start = log.rfind(DUMP_MARKER)
+    if start < 0:
+        raise ValueError("marqueur [CAP] DUMP absent")
+    eol = log.index(b"\n", start)
+    size = int(log[start + len(DUMP_MARKER):eol])
+    dump = log[eol + 1:eol + 1 + size]
+    if len(dump) != size:
+        raise ValueError("vidage incomplet (%d/%d octets)" % (len(dump), size))
+    return dump
+
+
+def pull(port: str, baud: int = 115200, timeout: float = 10.0) -> bytes:
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=timeout) as s:
+        s.reset_input_buffer()
+        s.write(b"CAP DUMP\n")
+        log = bytearray()
+        while END_MARKER not in log:
+            chunk = s.read(4096)
+            if not chunk:
+                raise TimeoutError("pas de fin de vidage")
+            log += chunk
+    return extract(bytes(log))
+
+
+def show(dump: bytes):
+    dropped, records = parse(dump)
+    print("%d enregistrements, %d perdus avant le vidage" % (len(records), dropped))
+    for t, ch, d, data in records:
+        print("%10d ms %-6s %s %r" % (t, CHANNELS.get(ch, ch), DIRS[d], bytes(data)))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 4 and sys.argv[1] in ("pull", "extract"):
+        if sys.argv[1] == "pull":
+            dump = pull(sys.argv[2])
+        else:
+            with open(sys.argv[2], "rb") as f:
+                dump = extract(f.read())
+        with open(sys.argv[3], "wb") as f:
+            f.write(dump)
+        show(dump)
+    elif len(sys.argv) == 3 and sys.argv[1] == "show":
+        with open(sys.argv[2], "rb") as f:
+            show(f.read())
+    else:
+        recs = [(1000, 0, 0, b"ORDER_ACK\r\n"), (1250, 1, 0, b"qr_a_b\r\n"), (100000, 0, 1, b"QR_TOKEN_BUSY\r\n")]
+        dump = build(recs)
+        assert len(dump) == HEADER_SIZE + 11 + 8 + 15 + 3 + 4 + 5
+        assert parse(dump) == (0, recs)
+        log = b"[CLI] x\n" + DUMP_MARKER + str(len(dump)).encode() + b"\n" + dump + END_MARKER + b"\n"
+        assert extract(log) == dump
+        print("uart_capture.py: OK")
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Encodeur/décodeur hôte du protocole binaire tramé ESP32 <-> NUCLEO.
+Miroir de include/uart_frame.h pour un simulateur NUCLEO sur PC (pyserial).
+
+Trame brute : [type][seq][ack][len][payload...][crc16 MSB][crc16 LSB]
+Sur le fil  : COBS(trame brute) + 0x00
+
+Usage: python3 scripts/uart_frame.py   (auto-test)
+"""
+
+FRAME_DATA = 0x01
+FRAME_ACK = 0x02
+MAX_PAYLOAD = 120
+
+PROTO_OFFER_BIN = "PROTO?:BIN1"
+PROTO_ACCEPT_BIN = "PROTO:BIN1"
+PROTO_FALLBACK_TEXT = "PROTO:TEXT"
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)"""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data: bytes) -> bytes:
+    out = bytearray([0])
+    code_idx = 0
+    code = 1
+    for b in data:
+        if b == 0:
+            out[code_idx] = code
+            code = 1
+            code_idx = len(out)
+            out.append(0)
+        else:
+            out.append(b)
+            code += 1
+            if code == 0xFF:
+                out[code_idx] = code
+                code = 1
+                code_idx = len(out)
+                out.append(0)
+    out[code_idx] = code
+    return bytes(out)
+
+
+def cobs_decode(data: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            raise ValueError("COBS invalide")
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(ftype: int, seq: int, ack: int, payload: bytes = b"") -> bytes:
+    """Retourne les octets à écrire sur le fil (délimiteur inclus)"""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload trop long")
+    raw = bytes([ftype, seq & 0xFF, ack & 0xFF, len(payload)]) + payload
+    crc = crc16(raw)
+    return cobs_encode(raw + bytes([crc >> 8, crc & 0xFF])) + b"\x00"
+
+
+def decode_frame(encoded: bytes):
+    """Décode une trame sans délimiteur -> (type, seq, ack, payload). Lève ValueError."""
+    raw = cobs_decode(encoded)
+    if len(raw) < 6 or len(raw) != 6 + raw[3]:
+        raise ValueError("longueur invalide")
+    if crc16(raw[:-2]) != (raw[-2] << 8 | raw[-1]):
+        raise ValueError("CRC invalide")
+    return raw[0], raw[1], raw[2], raw[4:-2]
+
+
+class FrameReader:
+    """Découpe un flux d'octets en trames sur le délimiteur 0x00"""
+
+    def __init__(self):
+        self._buf = bytearray()
+
+    def feed(self, data: bytes):
+        frames = []
+        for b in data:
+            if b != 0:
+                self._buf.append(b)
+                continue
+            if self._buf:
+                try:
+                    frames.append(decode_frame(bytes(self._buf)))
+                except ValueError:
+                    pass
+                self._buf.clear()
+        return frames
+
+
+if __name__ == "__main__":
+    assert crc16(b"123456789") == 0x29B1
+    wire = encode_frame(FRAME_DATA, 3, 1, b"VEND_COMPLETED:1")
+    assert wire.count(0) == 1 and wire[-1] == 0
+    frames = FrameReader().feed(wire)
+    assert frames == [(FRAME_DATA, 3, 1, b"VEND_COMPLETED:1")]
+    print("uart_frame.py: OK")
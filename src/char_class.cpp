@@ -0,0 +1,41 @@
+#include "char_class.h"
+#include <string.h>
+
+size_t CharClass_Span(const CharClass* cls, const char* str, size_t maxLen) {
+  if (!cls || !str) return 0;
+  const unsigned char* p = (const unsigned char*)str;
+  size_t limit = maxLen < SIZE_MAX ? maxLen + 1 : maxLen;
+  size_t n = 0;
+
+  // Début non aligné
+  while (n < limit && ((uintptr_t)(p + n) & (sizeof(size_t) - 1)) != 0) {
+    if (!CharClass_Has(cls, p[n])) return n;
+    n++;
+  }
+
+  // Mots alignés: tous les octets du mot testés sans branchement, un seul test par mot.
+  // Le mot contenant le nul final est lu en entier, sans jamais franchir une page ni une
+  // frontière d'allocation. Bitmap copié en local (registres, pas de relecture via cls).
+  uint32_t bits[8];
+  memcpy(bits, cls->bits, sizeof(bits));
+  while (limit - n >= sizeof(size_t)) {
+    const unsigned char* w = p + n;
+    uint32_t ok = 1;
+    for (size_t k = 0; k < sizeof(size_t); k += 4) {
+      ok &= (bits[w[k] >> 5] >> (w[k] & 31)) & (bits[w[k + 1] >> 5] >> (w[k + 1] & 31)) &
+            (bits[w[k + 2] >> 5] >> (w[k + 2] & 31)) & (bits[w[k + 3] >> 5] >> (w[k + 3] & 31));
+    }
+    if (!(ok & 1u)) break;
+    n += sizeof(size_t);
+  }
+
+  // Mot fautif ou fin de la limite
+  while (n < limit && CharClass_Has(cls, p[n])) n++;
+  return n;
+}
+
+bool CharClass_Matches(const CharClass* cls, const char* str, size_t minLen, size_t maxLen) {
+  if (!cls || !str) return false;
+  size_t n = CharClass_Span(cls, str, maxLen);
+  return str[n] == '\0' && n >= minLen && n <= maxLen;
+}
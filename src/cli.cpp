@@ -16,5 +16,8 @@ CliCommand parseCommand(const char* token) {
   if (eq(token, "HEX")) return CMD_HEX;
   if (eq(token, "TX2")) return CMD_TX2;
   if (eq(token, "TX2HEX")) return CMD_TX2HEX;
+  if (eq(token, "CAP")) return CMD_CAP;
+  if (eq(token, "QRBENCH")) return CMD_QRBENCH;
+  if (eq(token, "NFCBG")) return CMD_NFCBG;
   return CMD_UNKNOWN;
 }
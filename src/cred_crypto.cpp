@@ -0,0 +1,62 @@
+#include "cred_crypto.h"
+#include <string.h>
+
+size_t CredBlob_Size(uint8_t format, size_t passLen) {
+  if (passLen > CRED_PASS_MAX) return 0;
+  if (format == CRED_FORMAT_PLAIN) return 1 + passLen;
+  if (format == CRED_FORMAT_AES_GCM) return 1 + CRED_NONCE_SIZE + passLen + CRED_TAG_SIZE;
+  return 0;
+}
+
+static void split(uint8_t* buf, size_t len, CredBlob* out) {
+  out->format = buf[0];
+  if (buf[0] == CRED_FORMAT_AES_GCM) {
+    out->nonce = buf + 1;
+    out->data = buf + 1 + CRED_NONCE_SIZE;
+    out->dataLen = len - 1 - CRED_NONCE_SIZE - CRED_TAG_SIZE;
+    out->tag = buf + len - CRED_TAG_SIZE;
+  } else {
+    out->nonce = nullptr;
+    out->data = buf + 1;
+    out->dataLen = len - 1;
+    out->tag = nullptr;
+  }
+}
+
+size_t CredBlob_Layout(uint8_t* buf, size_t bufSize, uint8_t format, size_t passLen, CredBlob* out) {
+  if (!buf || !out) return 0;
+  size_t size = CredBlob_Size(format, passLen);
+  if (size == 0 || size > bufSize) return 0;
+  buf[0] = format;
+  split(buf, size, out);
+  return size;
+}
+
+bool CredBlob_Parse(uint8_t* buf, size_t len, CredBlob* out) {
+  if (!buf || !out || len == 0) return false;
+  size_t overhead = CredBlob_Size(buf[0], 0);
+  if (overhead == 0 || len < overhead || len - overhead > CRED_PASS_MAX) return false;
+  split(buf, len, out);
+  return true;
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+bool CredBlob_HexDecode(const char* hex, uint8_t* out, size_t outSize, size_t* outLen) {
+  if (!hex || !out || !outLen) return false;
+  size_t n = 0;
+  while (hex[0]) {
+    int hi = hexValue(hex[0]);
+    int lo = hi < 0 ? -1 : hexValue(hex[1]);
+    if (lo < 0 || n >= outSize) return false;
+    out[n++] = (uint8_t)(hi << 4 | lo);
+    hex += 2;
+  }
+  *outLen = n;
+  return true;
+}
@@ -103,6 +103,31 @@ const char* EnvConfig::GetSupervisionEndpoint() {
   return config.api_supervision_endpoint;
 }
 
+String EnvConfig::GetNfcAuthUrl() {
+  if (!initialized) Initialize();
+  return String(config.api_base_url) + String(config.api_nfc_auth_endpoint);
+}
+
+const char* EnvConfig::GetNfcAuthEndpoint() {
+  if (!initialized) Initialize();
+  return config.api_nfc_auth_endpoint;
+}
+
+const char* EnvConfig::GetQrPublicKey() {
+  if (!initialized) Initialize();
+  return config.qr_public_key;
+}
+
+const char* EnvConfig::GetMachineId() {
+  if (!initialized) Initialize();
+  return config.machine_id;
+}
+
+const char* EnvConfig::GetWifiStaticIp() {
+  if (!initialized) Initialize();
+  return config.wifi_static_ip;
+}
+
 bool EnvConfig::IsLoadedFromEnv() {
   if (!initialized) Initialize();
   return config.loaded_from_env;
@@ -117,6 +142,10 @@ void EnvConfig::PrintConfig() {
   Serial.printf("Delivery: %s\n", config.api_delivery_confirm_endpoint);
   Serial.printf("Quantities: %s\n", config.api_update_quantities_endpoint);
   Serial.printf("Supervision: %s\n", config.api_supervision_endpoint);
+  Serial.printf("NFC auth: %s\n", config.api_nfc_auth_endpoint);
+  Serial.printf("Machine ID: %s\n", config.machine_id[0] ? config.machine_id : "(none)");
+  Serial.printf("QR public key: %s\n", config.qr_public_key[0] ? "set" : "(none)");
+  Serial.printf("Wi-Fi static IP: %s\n", config.wifi_static_ip[0] ? config.wifi_static_ip : "(DHCP)");
   Serial.printf("Source: %s\n", config.loaded_from_env ? ".env file" : "defaults");
   Serial.println("[ENV] === End Configuration ===");
 }
@@ -162,6 +191,7 @@ void EnvConfig::LoadDefaults() {
   strncpy(config.api_delivery_confirm_endpoint, DEFAULT_API_DELIVERY_CONFIRM_ENDPOINT, MAX_ENDPOINT_LENGTH - 1);
   strncpy(config.api_update_quantities_endpoint, DEFAULT_API_UPDATE_QUANTITIES_ENDPOINT, MAX_ENDPOINT_LENGTH - 1);
   strncpy(config.api_supervision_endpoint, DEFAULT_API_SUPERVISION_ENDPOINT, MAX_ENDPOINT_LENGTH - 1);
+  strncpy(config.api_nfc_auth_endpoint, DEFAULT_API_NFC_AUTH_ENDPOINT, MAX_ENDPOINT_LENGTH - 1);
   
   config.api_base_url[MAX_URL_LENGTH - 1] = '\0';
   config.api_validate_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
@@ -170,6 +200,10 @@ void EnvConfig::LoadDefaults() {
   config.api_delivery_confirm_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
   config.api_update_quantities_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
   config.api_supervision_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
+  config.api_nfc_auth_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
+  config.qr_public_key[0] = '\0';
+  config.machine_id[0] = '\0';
+  config.wifi_static_ip[0] = '\0';
   
   config.loaded_from_env = false;
 }
@@ -230,6 +264,22 @@ void EnvConfig::SetConfigValue(const String& key, const String& value) {
     strncpy(config.api_supervision_endpoint, value.c_str(), MAX_ENDPOINT_LENGTH - 1);
     config.api_supervision_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
   }
+  else if (key == "API_NFC_AUTH_ENDPOINT") {
+    strncpy(config.api_nfc_auth_endpoint, value.c_str(), MAX_ENDPOINT_LENGTH - 1);
+    config.api_nfc_auth_endpoint[MAX_ENDPOINT_LENGTH - 1] = '\0';
+  }
+  else if (key == "QR_TOKEN_PUBLIC_KEY") {
+    strncpy(config.qr_public_key, value.c_str(), MAX_QR_PUBLIC_KEY_LENGTH - 1);
+    config.qr_public_key[MAX_QR_PUBLIC_KEY_LENGTH - 1] = '\0';
+  }
+  else if (key == "MACHINE_ID") {
+    strncpy(config.machine_id, value.c_str(), MAX_ENV_MACHINE_ID_LENGTH - 1);
+    config.machine_id[MAX_ENV_MACHINE_ID_LENGTH - 1] = '\0';
+  }
+  else if (key == "WIFI_STATIC_IP") {
+    strncpy(config.wifi_static_ip, value.c_str(), MAX_WIFI_STATIC_IP_LENGTH - 1);
+    config.wifi_static_ip[MAX_WIFI_STATIC_IP_LENGTH - 1] = '\0';
+  }
   else {
     Serial.printf("[ENV] Unknown configuration key: %s\n", key.c_str());
   }
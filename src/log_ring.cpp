@@ -0,0 +1,211 @@
+#include "log_ring.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_TEXT_NULL   0xFFFFu
+#define LOG_TEXT_EMPTY  0xFFFEu   // plus de place dans text[]
+
+void LogRing_Init(LogRing* r) {
+  if (!r) return;
+  memset(r, 0, sizeof(*r));
+  for (uint32_t i = 0; i < LOG_RING_CAPACITY; i++) r->slots[i].seq = i;
+}
+
+static void fillRecord(LogRecord* rec, uint32_t timeMs, const char* fmt, const LogArg* args, uint8_t argc) {
+  rec->timeMs = timeMs;
+  rec->fmt = fmt;
+  rec->argc = argc;
+  size_t used = 0;
+  for (uint8_t i = 0; i < argc; i++) {
+    rec->type[i] = args[i].type;
+    rec->size[i] = args[i].size;
+    if (args[i].type != LOG_ARG_STR) {
+      rec->arg[i].u = args[i].v.u;
+      continue;
+    }
+    const char* s = args[i].v.s;
+    if (!s) {
+      rec->arg[i].text = LOG_TEXT_NULL;
+    } else if (used >= LOG_RING_TEXT_SIZE) {
+      rec->arg[i].text = LOG_TEXT_EMPTY;
+    } else {
+      // Copie bornée sans strlen: les réponses HTTP passées en %s font jusqu'à 1 Ko
+      rec->arg[i].text = (uint16_t)used;
+      while (*s && used < LOG_RING_TEXT_SIZE - 1) rec->text[used++] = *s++;
+      rec->text[used++] = '\0';
+    }
+  }
+  rec->textLen = (uint8_t)used;
+}
+
+bool LogRing_Push(LogRing* r, uint32_t timeMs, const char* fmt, const LogArg* args, uint8_t argc) {
+  if (!r || !fmt || argc > LOG_RING_MAX_ARGS || (argc && !args)) return false;
+  uint32_t pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+  LogRecord* slot;
+  for (;;) {
+    slot = &r->slots[pos & (LOG_RING_CAPACITY - 1)];
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      // Case libre à cette position: la réserver
+      if (__atomic_compare_exchange_n(&r->head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+    } else if (diff < 0) {
+      // Case pas encore lue depuis le tour précédent: file pleine
+      __atomic_fetch_add(&r->dropped, 1, __ATOMIC_RELAXED);
+      return false;
+    } else {
+      pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    }
+  }
+  fillRecord(slot, timeMs, fmt, args, argc);
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+  __atomic_fetch_add(&r->written, 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+bool LogRing_Pop(LogRing* r, LogRecord* out) {
+  if (!r || !out) return false;
+  uint32_t pos = r->tail;
+  LogRecord* slot = &r->slots[pos & (LOG_RING_CAPACITY - 1)];
+  // Case réservée mais pas encore publiée (producteur préempté): attendre le prochain passage
+  if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1) return false;
+  memcpy(out, slot, sizeof(*out));
+  __atomic_store_n(&slot->seq, pos + LOG_RING_CAPACITY, __ATOMIC_RELEASE);
+  r->tail = pos + 1;
+  return true;
+}
+
+uint32_t LogRing_Dropped(const LogRing* r) {
+  return r ? __atomic_load_n(&r->dropped, __ATOMIC_RELAXED) : 0;
+}
+
+uint32_t LogRing_Written(const LogRing* r) {
+  return r ? __atomic_load_n(&r->written, __ATOMIC_RELAXED) : 0;
+}
+
+// Entier de `size` octets relu comme signé ou non signé (printf le tronque de même)
+static int64_t asSigned(uint64_t u, uint8_t size) {
+  if (size >= 8) return (int64_t)u;
+  unsigned bits = size * 8u;
+  uint64_t sign = 1ull << (bits - 1);
+  u &= (1ull << bits) - 1;
+  return (int64_t)((u ^ sign) - sign);
+}
+
+static uint64_t asUnsigned(uint64_t u, uint8_t size) {
+  return size >= 8 ? u : u & ((1ull << (size * 8u)) - 1);
+}
+
+static void append(char* out, size_t size, size_t* n, const char* s, size_t len) {
+  size_t room = size - 1 - *n;
+  if (len > room) len = room;
+  memcpy(out + *n, s, len);
+  *n += len;
+}
+
+static void appendFormatted(size_t size, size_t* n, int written) {
+  if (written <= 0) return;
+  size_t room = size - 1 - *n;
+  *n += (size_t)written < room ? (size_t)written : room;
+}
+
+size_t LogRing_Format(const LogRecord* rec, char* out, size_t size) {
+  if (!out || size == 0) return 0;
+  size_t n = 0;
+  out[0] = '\0';
+  if (!rec || !rec->fmt) return 0;
+  const char* f = rec->fmt;
+  uint8_t next = 0;
+
+  while (*f && n < size - 1) {
+    if (*f != '%') {
+      const char* pct = strchr(f, '%');
+      size_t len = pct ? (size_t)(pct - f) : strlen(f);
+      append(out, size, &n, f, len);
+      f += len;
+      continue;
+    }
+    if (f[1] == '%') {
+      append(out, size, &n, "%", 1);
+      f += 2;
+      continue;
+    }
+
+    // %[drapeaux][largeur][.précision][longueur]conversion; la longueur est recalculée
+    const char* start = f++;
+    char spec[24];
+    size_t sl = 0;
+    spec[sl++] = '%';
+    while (*f && strchr("-+ #0", *f) && sl < 8) spec[sl++] = *f++;
+    while (*f >= '0' && *f <= '9' && sl < 12) spec[sl++] = *f++;
+    if (*f == '.') {
+      spec[sl++] = *f++;
+      while (*f >= '0' && *f <= '9' && sl < 18) spec[sl++] = *f++;
+    }
+    // Seuls h et hh comptent: ils tronquent l'entier comme printf
+    unsigned shorts = 0;
+    while (*f && strchr("hlLqjzt", *f)) shorts += (*f++ == 'h');
+    char conv = *f;
+    if (!conv) break;
+    f++;
+
+    if (!strchr("diuoxXcsSpfFeEgGaA", conv) || next >= rec->argc) {
+      // Conversion inconnue ou argument manquant: recopiée telle quelle
+      append(out, size, &n, start, (size_t)(f - start));
+      continue;
+    }
+    uint8_t type = rec->type[next];
+    uint8_t argSize = shorts >= 2 ? 1 : shorts == 1 ? 2 : rec->size[next];
+    uint64_t raw = rec->arg[next].u;
+    uint16_t text = rec->arg[next].text;
+    double d = rec->arg[next].d;
+    const void* p = rec->arg[next].p;
+    next++;
+
+    bool isInt = type == LOG_ARG_INT || type == LOG_ARG_UINT;
+    switch (conv) {
+      case 'd': case 'i': {
+        if (!isInt) break;
+        spec[sl++] = 'l'; spec[sl++] = 'l'; spec[sl++] = 'd'; spec[sl] = '\0';
+        appendFormatted(size, &n, snprintf(out + n, size - n, spec, (long long)asSigned(raw, argSize)));
+        continue;
+      }
+      case 'u': case 'o': case 'x': case 'X': {
+        if (!isInt) break;
+        spec[sl++] = 'l'; spec[sl++] = 'l'; spec[sl++] = conv; spec[sl] = '\0';
+        appendFormatted(size, &n, snprintf(out + n, size - n, spec, (unsigned long long)asUnsigned(raw, argSize)));
+        continue;
+      }
+      case 'c': {
+        if (!isInt) break;
+        spec[sl++] = 'c'; spec[sl] = '\0';
+        appendFormatted(size, &n, snprintf(out + n, size - n, spec, (int)(raw & 0xFF)));
+        continue;
+      }
+      case 's': case 'S': {
+        if (type != LOG_ARG_STR) break;
+        const char* s = text == LOG_TEXT_NULL ? "(null)" : text == LOG_TEXT_EMPTY ? "" : rec->text + text;
+        spec[sl++] = 's'; spec[sl] = '\0';
+        appendFormatted(size, &n, snprintf(out + n, size - n, spec, s));
+        continue;
+      }
+      case 'p': {
+        if (type != LOG_ARG_PTR) break;
+        spec[sl++] = 'p'; spec[sl] = '\0';
+        appendFormatted(size, &n, snprintf(out + n, size - n, spec, p));
+        continue;
+      }
+      default: {
+        if (type != LOG_ARG_DOUBLE && !isInt) break;
+        spec[sl++] = conv; spec[sl] = '\0';
+        double v = type == LOG_ARG_DOUBLE ? d : (double)asSigned(raw, argSize);
+        appendFormatted(size, &n, snprintf(out + n, size - n, spec, v));
+        continue;
+      }
+    }
+    // Type d'argument incompatible avec la conversion
+    append(out, size, &n, "(?)", 3);
+  }
+  out[n] = '\0';
+  return n;
+}
@@ -2,12 +2,17 @@
 #include "config.h"
 #include "orchestrator.h"
 #include "env_config.h"
+#include "security_config.h"
 #include "supervision_service.h"
 #include "services/nfc_service.h"
 #include "services/uart_service.h"
 #include "services/qr_service.h"
 #include "services/wifi_service.h"
 #include "services/http_service.h"
+#include "services/capture_service.h"
+#include "services/token_verifier.h"
+#include "services/nfc_auth.h"
+#include "services/log_service.h"
 
 // --- CLI command mapping in cli.h ---
 #include "cli.h"
@@ -16,24 +21,31 @@ void setup() {
   Serial.begin(115200);
   while (!Serial) { delay(10); }
   delay(200);
+  LogService_Init();
   Serial.println("\n[DPM2] ESP32 boot");
   Serial.printf("[BOARD] Free heap: %lu bytes\n", (unsigned long)ESP.getFreeHeap());
 
   // Initialiser la configuration d'environnement
   Serial.println("\n[MAIN] Initializing environment configuration...");
   EnvConfig::Initialize();
+  bool offlineTokens = TokenVerifier_Init();
+  NfcAuth_Init();
 
   StartTaskWifiService();
   StartTaskOrchestrator();
   StartTaskUartService(Orchestrator_GetQueue()); // UART1 actif aussi hors réseau pour ACK/NAK
+  if (offlineTokens) {
+    // Tokens signés vérifiables localement: le scanner QR sert aussi sans réseau
+    StartTaskQrService(Orchestrator_GetQueue());
+  }
 
   // Lancer NFC/QR apres que le Wi-Fi soit pret (tache differée)
   xTaskCreate([](void* arg){
-    // Attendre que le Wi-Fi soit pret
-    while (!WifiService_IsReady()) vTaskDelay(pdMS_TO_TICKS(200));
+    // Attendre que le Wi-Fi soit connecte (groupe d'evenements, sans scrutation)
+    WifiService_Wait(WIFI_EVT_LINK_UP, UINT32_MAX);
     StartTaskHttpService();
     StartTaskNfcService(Orchestrator_GetQueue());
-    StartTaskQrService(Orchestrator_GetQueue());
+    if (!QrService_IsRunning()) StartTaskQrService(Orchestrator_GetQueue());
     vTaskDelete(nullptr);
   }, "defer_services", 4096, nullptr, 1, nullptr);
 }
@@ -74,8 +86,12 @@ void loop() {
           Serial.println("CMD: INFO -> afficher etat UART1/NFC");
           Serial.println("CMD: WIFI? -> etat Wi-Fi");
           Serial.println("CMD: WIFI OFF -> deconnecter et relancer le portail SoftAP");
+          Serial.println("CMD: WIFI FORGET <n> -> oublier le reseau enregistre n (voir WIFI?)");
           Serial.println("CMD: HTTPGET <url> -> requete GET");
           Serial.println("CMD: HTTPPOST <url>|<ctype>|<body> -> requete POST");
+          Serial.println("CMD: CAP ON|OFF|DUMP|CLEAR -> capture trafic UART1/UART2 (vidage binaire)");
+          Serial.println("CMD: QRBENCH [n] -> temps de verification d'un token QR signe");
+          Serial.println("CMD: NFCBG ON|OFF|<budget pour mille> -> detection NFC de fond basse consommation");
           break;
         }
         case CMD_SCAN: {
@@ -90,8 +106,14 @@ void loop() {
           break;
         }
         case CMD_INFO: {
-          Serial.printf("[INFO] UART1 RX=%d, TX=%d, BAUD=%lu\n", UART_RX_PIN, UART_TX_PIN, (unsigned long)UART_BAUDRATE);
+          Serial.printf("[INFO] UART1 RX=%d, TX=%d, BAUD=%lu\n", UART_RX_PIN, UART_TX_PIN, (unsigned long)UartService_GetBaudRate());
+          UartService_DebugInfo();
+          CaptureService_DebugInfo();
+          Orchestrator_DebugInfo();
           NfcService_DebugInfo();
+          NfcAuth_DebugInfo();
+          rateLimitDebugInfo();
+          LogService_DebugInfo();
           break;
         }
         case CMD_WIFI_Q: {
@@ -105,8 +127,10 @@ void loop() {
             if (NfcService_IsRunning()) StopTaskNfcService();
             if (QrService_IsRunning()) StopTaskQrService();
             WifiService_Disconnect();
+          } else if (arg.startsWith("FORGET ") && isdigit((unsigned char)arg.charAt(7))) {
+            WifiService_ForgetNetwork((int)arg.substring(7).toInt());
           } else {
-            Serial.println("Usage: WIFI OFF");
+            Serial.println("Usage: WIFI OFF | WIFI FORGET <n>");
           }
           break;
         }
@@ -152,7 +176,8 @@ void loop() {
         }
         case CMD_TX2: {
           String msg = args;
-          Serial2.println(msg);
+          msg += "\r\n";
+          QrService_Write((const uint8_t*)msg.c_str(), msg.length());
           Serial.println("[CLI] TX2 sent");
           break;
         }
@@ -173,11 +198,52 @@ void loop() {
             int v2 = hexval(hex[i++]);
             if (v1 < 0 || v2 < 0) continue;
             uint8_t b = (uint8_t)((v1 << 4) | v2);
-            Serial2.write(b);
+            QrService_Write(&b, 1);
           }
           Serial.println("[CLI] TX2HEX sent");
           break;
         }
+        case CMD_QRBENCH: {
+          int n = args.length() > 0 ? args.toInt() : 20;
+          TokenVerifier_Benchmark(n);
+          break;
+        }
+        case CMD_NFCBG: {
+          String arg = args;
+          arg.trim();
+          if (arg == "ON") {
+            NfcService_SetBackground(true);
+            Serial.println("[CLI] NFC background: ON");
+          } else if (arg == "OFF") {
+            NfcService_SetBackground(false);
+            Serial.println("[CLI] NFC background: OFF");
+          } else if (arg.toInt() >= 1 && arg.toInt() <= 1000) {
+            NfcService_SetBackgroundBudget((uint16_t)arg.toInt());
+            Serial.printf("[CLI] NFC background budget: %d pour mille\n", (int)arg.toInt());
+          } else {
+            Serial.println("Usage: NFCBG ON|OFF|<budget 1..1000 pour mille>");
+          }
+          break;
+        }
+        case CMD_CAP: {
+          String arg = args;
+          arg.trim();
+          if (arg == "ON") {
+            Serial.println(CaptureService_Start() ? "[CLI] Capture ON" : "[CLI] Capture indisponible");
+          } else if (arg == "OFF") {
+            CaptureService_Stop();
+            Serial.println("[CLI] Capture OFF");
+          } else if (arg == "DUMP") {
+            CaptureService_Dump();
+          } else if (arg == "CLEAR") {
+            CaptureService_Clear();
+            Serial.println("[CLI] Capture videe");
+          } else {
+            CaptureService_DebugInfo();
+            Serial.println("Usage: CAP ON|OFF|DUMP|CLEAR");
+          }
+          break;
+        }
         case CMD_UNKNOWN:
         default: {
           Serial.print("[CLI] Commande inconnue: ");
@@ -0,0 +1,225 @@
+#include "mfc_reader.h"
+#include <string.h>
+
+void MfcKeyCache_Init(MfcKeyCache* c) {
+  memset(c, 0, sizeof(*c));
+}
+
+MfcKeyCacheEntry* MfcKeyCache_Get(MfcKeyCache* c, const uint8_t* uid, size_t uidLen) {
+  uint8_t len = (uint8_t)(uidLen < MFC_UID_PREFIX_LEN ? uidLen : MFC_UID_PREFIX_LEN);
+  MfcKeyCacheEntry* victim = &c->entries[0];
+  c->clock++;
+  for (size_t i = 0; i < MFC_KEY_CACHE_SIZE; i++) {
+    MfcKeyCacheEntry* e = &c->entries[i];
+    if (e->used && e->prefixLen == len && memcmp(e->prefix, uid, len) == 0) {
+      e->lastUse = c->clock;
+      return e;
+    }
+    if (!e->used) {
+      if (victim->used) victim = e;
+    } else if (victim->used && e->lastUse < victim->lastUse) {
+      victim = e;
+    }
+  }
+  memcpy(victim->prefix, uid, len);
+  victim->prefixLen = len;
+  victim->madKey = MFC_KEY_UNKNOWN;
+  victim->dataKey = MFC_KEY_UNKNOWN;
+  victim->noMad = false;
+  victim->lastUse = c->clock;
+  victim->used = true;
+  return victim;
+}
+
+uint8_t MfcReader_SectorFirstBlock(uint8_t sector) {
+  if (sector < 32) return (uint8_t)(sector * 4);
+  return (uint8_t)(128 + (sector - 32) * 16);
+}
+
+uint8_t MfcReader_SectorDataBlocks(uint8_t sector) {
+  return sector < 32 ? 3 : 15;
+}
+
+uint8_t MfcReader_MadCrc(const uint8_t* data, size_t len) {
+  uint8_t crc = 0xC7;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x1D) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// TLV NDEF dans buf[0..have): 1 trouvé, 0 octets manquants,
+// -1 absent (Terminator ou type inconnu: secteur hors NDEF, texte brut...)
+static int findNdefTlv(const uint8_t* buf, size_t have, size_t* valueOff, size_t* valueLen) {
+  size_t i = 0;
+  while (i < have) {
+    uint8_t t = buf[i];
+    if (t == 0x00) {  // NULL TLV
+      i++;
+      continue;
+    }
+    if (t == 0xFE) return -1;
+    if (t != 0x01 && t != 0x02 && t != 0x03 && t != 0xFD) return -1;
+    if (i + 1 >= have) return 0;
+    size_t len = buf[i + 1];
+    size_t hdr = 2;
+    if (len == 0xFF) {
+      if (i + 3 >= have) return 0;
+      len = ((size_t)buf[i + 2] << 8) | buf[i + 3];
+      hdr = 4;
+    }
+    if (t == 0x03) {
+      *valueOff = i + hdr;
+      *valueLen = len;
+      return 1;
+    }
+    i += hdr + len;  // Lock / Memory Control, propriétaire
+  }
+  return 0;
+}
+
+static bool tryKey(const MfcTransport* t, const MfcKey* key, uint8_t block, MfcReadInfo* info) {
+  info->auths++;
+  if (t->auth(t->ctx, key->type, block, key->key)) return true;
+  info->authFailures++;
+  return false;
+}
+
+// Une authentification par secteur: clé mémorisée d'abord, puis la table.
+// *remembered reçoit l'index de la clé acceptée.
+static bool authSector(const MfcTransport* t, const MfcKey* keys, size_t keyCount, uint8_t* remembered,
+                       uint8_t sector, MfcReadInfo* info) {
+  uint8_t block = MfcReader_SectorFirstBlock(sector);
+  uint8_t first = *remembered;
+  bool mute = false;  // carte muette après un refus
+  if (first < keyCount) {
+    if (tryKey(t, &keys[first], block, info)) {
+      info->cacheHits++;
+      return true;
+    }
+    mute = true;
+  }
+  for (size_t i = 0; i < keyCount; i++) {
+    if (i == first) continue;
+    if (mute && !(t->reactivate && t->reactivate(t->ctx))) return false;
+    if (tryKey(t, &keys[i], block, info)) {
+      *remembered = (uint8_t)i;
+      return true;
+    }
+    mute = true;
+  }
+  return false;
+}
+
+static bool readBlock(const MfcTransport* t, uint8_t block, uint8_t* out, MfcReadInfo* info) {
+  info->blocks++;
+  return t->read(t->ctx, block, out);
+}
+
+static bool isNdefAid(const uint8_t* aid) {
+  return aid[0] == MFC_NDEF_AID_LO && aid[1] == MFC_NDEF_AID_HI;
+}
+
+// MAD1 (secteur 0, blocs 1-2) puis MAD2 (secteur 16, blocs 64-66) sur 4K.
+// Retourne le nombre de secteurs NDEF, -1 si MAD absente, -2 si la carte ne répond plus.
+static int readMad(const MfcTransport* t, const MfcKey* keys, size_t keyCount, MfcKeyCacheEntry* entry,
+                   uint8_t sectorCount, uint8_t* sectors, MfcReadInfo* info) {
+  uint8_t mad[3 * MFC_BLOCK_SIZE];
+  if (!authSector(t, keys, keyCount, &entry->madKey, 0, info)) {
+    return (t->reactivate && t->reactivate(t->ctx)) ? -1 : -2;
+  }
+  if (!readBlock(t, 1, mad, info) || !readBlock(t, 2, mad + MFC_BLOCK_SIZE, info)) return -2;
+  if (MfcReader_MadCrc(mad + 1, 2 * MFC_BLOCK_SIZE - 1) != mad[0]) return -1;
+
+  int n = 0;
+  for (uint8_t s = 1; s < 16 && s < sectorCount; s++) {
+    if (isNdefAid(&mad[2 * s])) sectors[n++] = s;
+  }
+  if (sectorCount <= 16) return n;
+
+  // MAD2 facultative: secteur 16 illisible ou CRC faux -> secteurs de la MAD1 seuls
+  if (!authSector(t, keys, keyCount, &entry->madKey, 16, info)) {
+    return (t->reactivate && t->reactivate(t->ctx)) ? n : -2;
+  }
+  for (uint8_t b = 0; b < 3; b++) {
+    if (!readBlock(t, (uint8_t)(64 + b), mad + b * MFC_BLOCK_SIZE, info)) return -2;
+  }
+  if (MfcReader_MadCrc(mad + 1, 3 * MFC_BLOCK_SIZE - 1) != mad[0]) return n;
+  for (uint8_t s = 17; s < sectorCount; s++) {
+    if (isNdefAid(&mad[2 * (s - 16)])) sectors[n++] = s;
+  }
+  return n;
+}
+
+int MfcReader_ReadNdef(const MfcTransport* t, const MfcKey* keys, size_t keyCount, MfcKeyCache* cache,
+                       const uint8_t* uid, size_t uidLen, uint8_t sectorCount,
+                       uint8_t* buf, size_t bufSize, MfcReadInfo* info) {
+  memset(info, 0, sizeof(*info));
+  if (sectorCount > MFC_SECTORS_4K) sectorCount = MFC_SECTORS_4K;
+
+  MfcKeyCacheEntry local = {};
+  local.madKey = MFC_KEY_UNKNOWN;
+  local.dataKey = MFC_KEY_UNKNOWN;
+  MfcKeyCacheEntry* entry = cache ? MfcKeyCache_Get(cache, uid, uidLen) : &local;
+
+  uint8_t sectors[MFC_SECTORS_4K];
+  int count = entry->noMad ? -1 : readMad(t, keys, keyCount, entry, sectorCount, sectors, info);
+  if (count == -2) return MFC_READ_ERR_IO;
+  if (count >= 0) {
+    info->mad = true;
+  } else {
+    count = 0;
+    for (uint8_t s = 1; s < sectorCount; s++) sectors[count++] = s;
+  }
+  entry->noMad = !info->mad;
+
+  size_t have = 0;
+  for (int i = 0; i < count; i++) {
+    uint8_t sector = sectors[i];
+    if (!authSector(t, keys, keyCount, &entry->dataKey, sector, info)) {
+      entry->noMad = false;  // carte différente du lot: MAD relue au prochain tap
+      return MFC_READ_ERR_AUTH;
+    }
+
+    uint8_t first = MfcReader_SectorFirstBlock(sector);
+    uint8_t blocks = MfcReader_SectorDataBlocks(sector);
+    if (i == 0) info->firstBlock = first;
+    bool noNdef = false;
+    for (uint8_t b = 0; b < blocks; b++) {
+      if (have + MFC_BLOCK_SIZE > bufSize) return MFC_READ_ERR_TOO_LARGE;
+      if (!readBlock(t, (uint8_t)(first + b), buf + have, info)) return MFC_READ_ERR_IO;
+      have += MFC_BLOCK_SIZE;
+      info->bytesRead = (uint16_t)have;
+
+      size_t off = 0, len = 0;
+      int found = findNdefTlv(buf, have, &off, &len);
+      if (found > 0) {
+        if (off + len > bufSize) return MFC_READ_ERR_TOO_LARGE;
+        if (off + len <= have) {
+          info->sectors++;
+          info->ndefOffset = (uint16_t)off;
+          info->ndefLen = (uint16_t)len;
+          return (int)(off + len);
+        }
+      } else if (found < 0) {
+        noNdef = true;  // secteur lu en entier (repli texte brut de l'appelant)
+      }
+    }
+    info->sectors++;
+    if (noNdef) return MFC_READ_ERR_NO_NDEF;
+  }
+  entry->noMad = false;
+  return MFC_READ_ERR_NO_NDEF;
+}
+
+bool MfcReader_ReadBlock(const MfcTransport* t, const MfcKey* keys, size_t keyCount, MfcKeyCache* cache,
+                         const uint8_t* uid, size_t uidLen, uint8_t block, uint8_t out[MFC_BLOCK_SIZE]) {
+  if (!cache) return false;
+  MfcKeyCacheEntry* entry = MfcKeyCache_Get(cache, uid, uidLen);
+  if (entry->dataKey >= keyCount) return false;
+  const MfcKey* key = &keys[entry->dataKey];
+  return t->auth(t->ctx, key->type, block, key->key) && t->read(t->ctx, block, out);
+}
@@ -0,0 +1,143 @@
+#include "ntag_reader.h"
+#include <string.h>
+
+NtagType NtagReader_TypeFromCc(uint8_t ccSize) {
+  switch (ccSize) {
+    case 0x06: return NTAG_TYPE_ULTRALIGHT;
+    case 0x12: return NTAG_TYPE_NTAG213;
+    case 0x3E: return NTAG_TYPE_NTAG215;
+    case 0x6D: return NTAG_TYPE_NTAG216;
+    default: return NTAG_TYPE_UNKNOWN;
+  }
+}
+
+const char* NtagReader_TypeName(NtagType type) {
+  switch (type) {
+    case NTAG_TYPE_ULTRALIGHT: return "ULTRALIGHT";
+    case NTAG_TYPE_NTAG213: return "NTAG213";
+    case NTAG_TYPE_NTAG215: return "NTAG215";
+    case NTAG_TYPE_NTAG216: return "NTAG216";
+    default: return "UNKNOWN";
+  }
+}
+
+// TLV NDEF dans buf[0..have): 1 trouvé, 0 octets manquants, -1 absent (Terminator)
+static int findNdefTlv(const uint8_t* buf, size_t have, size_t* valueOff, size_t* valueLen) {
+  size_t i = 0;
+  while (i < have) {
+    uint8_t t = buf[i];
+    if (t == 0x00) {  // NULL TLV
+      i++;
+      continue;
+    }
+    if (t == 0xFE) return -1;
+    if (i + 1 >= have) return 0;
+    size_t len = buf[i + 1];
+    size_t hdr = 2;
+    if (len == 0xFF) {
+      if (i + 3 >= have) return 0;
+      len = ((size_t)buf[i + 2] << 8) | buf[i + 3];
+      hdr = 4;
+    }
+    if (t == 0x03) {
+      *valueOff = i + hdr;
+      *valueLen = len;
+      return 1;
+    }
+    i += hdr + len;  // Lock / Memory Control TLV
+  }
+  return 0;
+}
+
+static int transceive(const NtagTransport* t, NtagReadInfo* info, const uint8_t* cmd, size_t cmdLen,
+                      uint8_t* resp, size_t respMax) {
+  info->transactions++;
+  int r = t->transceive(t->ctx, cmd, cmdLen, resp, respMax);
+  if (r > 0) info->bytesRead += (uint16_t)r;
+  return r;
+}
+
+static bool readPage4(const NtagTransport* t, NtagReadInfo* info, uint8_t page, uint8_t* out16) {
+  uint8_t cmd[2] = { NTAG_CMD_READ, page };
+  return transceive(t, info, cmd, sizeof(cmd), out16, 16) == 16;
+}
+
+// Lit 'pages' pages à partir de 'first' dans out (pages entières)
+static bool readRange(const NtagTransport* t, NtagReadInfo* info, uint16_t first, uint16_t pages, uint8_t* out) {
+  while (pages > 0) {
+    if (info->fastRead) {
+      uint16_t n = pages > NTAG_FAST_READ_MAX_PAGES ? NTAG_FAST_READ_MAX_PAGES : pages;
+      uint8_t cmd[3] = { NTAG_CMD_FAST_READ, (uint8_t)first, (uint8_t)(first + n - 1) };
+      int want = n * NTAG_PAGE_SIZE;
+      if (transceive(t, info, cmd, sizeof(cmd), out, (size_t)want) == want) {
+        out += want;
+        first += n;
+        pages -= n;
+        continue;
+      }
+      // FAST_READ non supporté (Ultralight C...): le NAK renvoie le tag en IDLE
+      info->fastRead = false;
+      if (!t->reactivate || !t->reactivate(t->ctx)) return false;
+      continue;
+    }
+    uint8_t tmp[16];
+    if (!readPage4(t, info, (uint8_t)first, tmp)) return false;
+    uint16_t n = pages > 4 ? 4 : pages;
+    memcpy(out, tmp, n * NTAG_PAGE_SIZE);
+    out += n * NTAG_PAGE_SIZE;
+    first += n;
+    pages -= n;
+  }
+  return true;
+}
+
+int NtagReader_ReadNdef(const NtagTransport* t, uint8_t* buf, size_t bufSize, NtagReadInfo* info) {
+  NtagReadInfo local;
+  if (!info) info = &local;
+  memset(info, 0, sizeof(*info));
+  if (!t || !t->transceive || !buf) return NTAG_READ_ERR_IO;
+
+  // Pages 3..6: CC puis début de la zone de données
+  uint8_t first[16];
+  if (!readPage4(t, info, 3, first)) return NTAG_READ_ERR_IO;
+  if (first[0] != NTAG_CC_MAGIC || first[2] == 0) return NTAG_READ_ERR_CC;
+  info->type = NtagReader_TypeFromCc(first[2]);
+  info->dataBytes = (uint16_t)(first[2] * 8);
+  if (bufSize < 12) return NTAG_READ_ERR_TOO_LARGE;
+  memcpy(buf, first + 4, 12);
+  size_t have = 12;
+
+  size_t off = 0;
+  size_t len = 0;
+  for (;;) {
+    int found = findNdefTlv(buf, have, &off, &len);
+    if (found < 0) return NTAG_READ_ERR_NO_NDEF;
+    if (found > 0) break;
+    // En-tête TLV à cheval: 4 pages de plus
+    if (have >= info->dataBytes) return NTAG_READ_ERR_NO_NDEF;
+    if (have + 16 > bufSize) return NTAG_READ_ERR_TOO_LARGE;
+    if (!readPage4(t, info, (uint8_t)(NTAG_FIRST_DATA_PAGE + have / NTAG_PAGE_SIZE), buf + have)) {
+      return NTAG_READ_ERR_IO;
+    }
+    have += 16;
+  }
+
+  size_t needed = off + len;
+  if (needed > info->dataBytes) return NTAG_READ_ERR_NO_NDEF;
+  size_t pagesNeeded = (needed + NTAG_PAGE_SIZE - 1) / NTAG_PAGE_SIZE;
+  if (pagesNeeded * NTAG_PAGE_SIZE > bufSize) return NTAG_READ_ERR_TOO_LARGE;
+
+  size_t pagesHave = have / NTAG_PAGE_SIZE;
+  if (pagesNeeded > pagesHave) {
+    uint16_t remaining = (uint16_t)(pagesNeeded - pagesHave);
+    // Un seul READ suffit jusqu'à 4 pages
+    info->fastRead = remaining > 4;
+    if (!readRange(t, info, (uint16_t)(NTAG_FIRST_DATA_PAGE + pagesHave), remaining, buf + have)) {
+      return NTAG_READ_ERR_IO;
+    }
+  }
+
+  info->ndefOffset = (uint16_t)off;
+  info->ndefLen = (uint16_t)len;
+  return (int)needed;
+}
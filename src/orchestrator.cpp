@@ -6,6 +6,15 @@
 #include "services/http_service.h"
 #include "order_manager.h"
 #include "supervision_service.h"
+#include "security_config.h"
+#include "order_progress.h"
+#include "qr_token_cache.h"
+#include "qr_offline_token.h"
+#include "services/token_verifier.h"
+#include "services/nfc_auth.h"
+#include "qr_spent.h"
+#include <Preferences.h>
+#include <time.h>
 
 static QueueHandle_t orchestratorQueueHandle = nullptr;
 static TaskHandle_t orchestratorTaskHandle = nullptr;
@@ -18,17 +27,152 @@ enum OrderWorkflowState {
   WORKFLOW_DELIVERING = 2,
   WORKFLOW_UPDATING_QUANTITIES = 3,
   WORKFLOW_CONFIRMING_DELIVERY = 4,
-  WORKFLOW_COMPLETED = 5
+  WORKFLOW_COMPLETED = 5,
+  WORKFLOW_RECONCILING = 6     // rapprochement backend d'une vente acceptée hors ligne
 };
 
 static OrderWorkflowState currentWorkflowState = WORKFLOW_IDLE;
 
+// Tokens QR récents et token du workflow en cours
+static QrTokenCache qrTokenCache;
+static uint64_t currentQrTokenHash = 0;
+static bool qrTokenPending = false;
+
+// Ventes acceptées sur token signé, en attente de rapprochement backend (validation puis
+// mises à jour de quantités et confirmation comme une commande en ligne). Conservées en NVS
+// jusqu'au rapprochement (NVS_NAMESPACE_OFFLINE).
+struct OfflineSale {
+  char token[sizeof(((OrchestratorEvent*)nullptr)->payload)];
+  char orderId[QR_OFFLINE_ID_MAX + 1];
+  uint8_t vendedSlots[MAX_ORDER_ITEMS];
+  uint8_t vendedCount;
+  bool complete;
+  uint32_t nextAttemptMs;
+};
+
+static OfflineSale offlineSales[OFFLINE_SALES_MAX];
+static int offlineSaleCount = 0;
+static bool currentOrderOffline = false;
+static char currentOfflineToken[sizeof(((OrchestratorEvent*)nullptr)->payload)];
+static uint32_t reconcileSentMs = 0;
+static uint32_t lastBusyMs = 0;
+
+// Commandes servies sur token signé (NVS): rejeu refusé jusqu'à l'expiration du token
+static QrSpentSet qrSpent;
+static uint64_t currentSpentHash = 0;   // réservation de la commande en cours, 0 si aucune
+static Preferences offlinePrefs;
+
 static void orchestratorTask(void* pvParameters);
+static void pumpOrderProgress();
+static void pumpOfflineSales();
+static void handleReconcileResponse(const HttpResponse& resp);
+static void acceptOfflineToken(const char* token, uint64_t tokenHash, const QrOfflineOrder* offline);
+
+static bool saveSpentSet() {
+  offlinePrefs.begin(NVS_NAMESPACE_OFFLINE, false);
+  bool ok = offlinePrefs.putBytes("spent", &qrSpent, sizeof(qrSpent)) == sizeof(qrSpent);
+  offlinePrefs.end();
+  return ok;
+}
+
+static void saveOfflineSales() {
+  offlinePrefs.begin(NVS_NAMESPACE_OFFLINE, false);
+  size_t len = sizeof(OfflineSale) * offlineSaleCount;
+  bool ok = true;
+  if (offlineSaleCount == 0) {
+    offlinePrefs.remove("sales");
+  } else {
+    ok = offlinePrefs.putBytes("sales", offlineSales, len) == len;
+  }
+  offlinePrefs.end();
+  if (!ok) LOG_PRINTF("[ORCH] Error: offline sales journal not saved to NVS\n");
+}
+
+// Registre et journal relus au démarrage; bloc d'un autre format (taille) ignoré
+static void loadOfflineState() {
+  offlinePrefs.begin(NVS_NAMESPACE_OFFLINE, true);
+  size_t spentLen = offlinePrefs.getBytes("spent", &qrSpent, sizeof(qrSpent));
+  size_t salesLen = offlinePrefs.getBytes("sales", offlineSales, sizeof(offlineSales));
+  offlinePrefs.end();
+  if (!QrSpent_IsValid(&qrSpent, spentLen)) QrSpent_Init(&qrSpent);
+  offlineSaleCount = salesLen % sizeof(OfflineSale) == 0 ? (int)(salesLen / sizeof(OfflineSale)) : 0;
+  for (int i = 0; i < offlineSaleCount; i++) {
+    OfflineSale* sale = &offlineSales[i];
+    sale->token[sizeof(sale->token) - 1] = '\0';
+    sale->orderId[sizeof(sale->orderId) - 1] = '\0';
+    if (sale->vendedCount > MAX_ORDER_ITEMS) sale->vendedCount = MAX_ORDER_ITEMS;
+    sale->nextAttemptMs = millis();
+  }
+  if (offlineSaleCount > 0 || qrSpent.count > 0) {
+    LOG_PRINTF("[ORCH] NVS: %d offline sale(s) pending reconciliation, %lu signed order(s) spent\n",
+               offlineSaleCount, (unsigned long)qrSpent.count);
+  }
+}
+
+// Commande déjà servie sur cette machine: registre NVS ou journal pas encore rapproché
+static bool isOfflineOrderSpent(const char* orderId) {
+  if (QrSpent_Contains(&qrSpent, QrTokenCache_Hash(orderId, strlen(orderId)))) return true;
+  for (int i = 0; i < offlineSaleCount; i++) {
+    if (strcmp(offlineSales[i].orderId, orderId) == 0) return true;
+  }
+  return false;
+}
+
+// Réservation écrite en NVS avant l'envoi à la NUCLEO (quelques ms, contre un aller-retour backend):
+// un redémarrage pendant la livraison ne rouvre pas le token
+static bool reserveSpentOrder(const QrOfflineOrder* offline) {
+  uint64_t idHash = QrTokenCache_Hash(offline->orderId, strlen(offline->orderId));
+  if (!QrSpent_Add(&qrSpent, idHash, offline->expiresAt + QR_SPENT_RETENTION_MARGIN_S, (uint32_t)time(nullptr))) {
+    LOG_PRINTF("[ORCH] Signed order registry full (%d)\n", QR_SPENT_CAPACITY);
+    return false;
+  }
+  if (!saveSpentSet()) {
+    LOG_PRINTF("[ORCH] Error: signed order registry not saved to NVS\n");
+    QrSpent_Remove(&qrSpent, idHash);
+    return false;
+  }
+  currentSpentHash = idHash;
+  return true;
+}
+
+// Fin de la commande en cours: réservation conservée si quelque chose a été livré
+static void settleSpentOrder(bool delivered) {
+  if (currentSpentHash == 0) return;
+  if (!delivered && QrSpent_Remove(&qrSpent, currentSpentHash)) saveSpentSet();
+  currentSpentHash = 0;
+}
+
+// Mémorise le résultat du token en cours (MISS: oublié, le prochain scan repasse par le backend)
+static void rememberQrToken(QrTokenOutcome outcome) {
+  if (outcome != QR_TOKEN_CACHE_IN_PROGRESS) settleSpentOrder(outcome == QR_TOKEN_CACHE_CONSUMED);
+  if (!qrTokenPending) return;
+  uint32_t ttl = QR_TOKEN_CACHE_IN_PROGRESS_TTL_MS;
+  if (outcome == QR_TOKEN_CACHE_REJECTED) ttl = QR_TOKEN_CACHE_REJECTED_TTL_MS;
+  if (outcome == QR_TOKEN_CACHE_CONSUMED) ttl = QR_TOKEN_CACHE_CONSUMED_TTL_MS;
+  QrTokenCache_Store(&qrTokenCache, currentQrTokenHash, outcome, millis(), ttl);
+  if (outcome != QR_TOKEN_CACHE_IN_PROGRESS) qrTokenPending = false;
+}
+
+// Envoie la commande courante à la NUCLEO et passe en livraison
+static bool dispatchCurrentOrder() {
+  String deliveryCommands = OrderManager::GenerateDeliveryCommands();
+  if (deliveryCommands.length() == 0) {
+    return false;
+  }
+  UartService_SendLine(("ORDER_START:" + deliveryCommands).c_str());
+  currentWorkflowState = WORKFLOW_DELIVERING;
+  return true;
+}
 
 QueueHandle_t Orchestrator_GetQueue() {
   return orchestratorQueueHandle;
 }
 
+bool Orchestrator_IsIdle() {
+  return currentWorkflowState == WORKFLOW_IDLE &&
+         (!orchestratorQueueHandle || uxQueueMessagesWaiting(orchestratorQueueHandle) == 0);
+}
+
 void StartTaskOrchestrator() {
   if (!orchestratorQueueHandle) {
     orchestratorQueueHandle = xQueueCreate(ORCHESTRATOR_QUEUE_LENGTH, sizeof(OrchestratorEvent));
@@ -38,6 +182,9 @@ void StartTaskOrchestrator() {
     httpResponseQueue = xQueueCreate(5, sizeof(HttpResponse));
   }
 
+  QrTokenCache_Init(&qrTokenCache);
+  loadOfflineState();
+
   // Initialiser le service de supervision
   SupervisionService::Initialize();
 
@@ -60,7 +207,7 @@ static void orchestratorTask(void* pvParameters) {
   for (;;) {
     // Vérifier les réponses HTTP en attente (non bloquant)
     if (xQueueReceive(httpResponseQueue, &httpResp, 0) == pdTRUE) {
-      Serial.printf("[ORCH] HTTP Response: Status=%d, Content=%s\n", httpResp.statusCode, httpResp.payload);
+      LOG_PRINTF("[ORCH] HTTP Response: Status=%d, Content=%s\n", httpResp.statusCode, httpResp.payload);
       
       switch (currentWorkflowState) {
         case WORKFLOW_VALIDATING_TOKEN:
@@ -71,14 +218,12 @@ static void orchestratorTask(void* pvParameters) {
               OrderManager::SetCurrentOrder(&order);
               
               // Générer et envoyer les commandes de livraison à NUCLEO
-              String deliveryCommands = OrderManager::GenerateDeliveryCommands();
-              if (deliveryCommands.length() > 0) {
-                UartService_SendLine(("ORDER_START:" + deliveryCommands).c_str());
-                currentWorkflowState = WORKFLOW_DELIVERING;
-                Serial.println("[ORCH] Order validated, delivery commands sent to NUCLEO");
+              if (dispatchCurrentOrder()) {
+                LOG_PRINTF("[ORCH] Order validated, delivery commands sent to NUCLEO\n");
               } else {
-                Serial.println("[ORCH] Error: Could not generate delivery commands");
+                LOG_PRINTF("[ORCH] Error: Could not generate delivery commands\n");
                 UartService_SendLine("QR_TOKEN_ERROR");
+                rememberQrToken(QR_TOKEN_CACHE_MISS);
                 SupervisionService::SendErrorNotification(
                   SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE,
                   "Failed to generate delivery commands for validated order"
@@ -87,8 +232,9 @@ static void orchestratorTask(void* pvParameters) {
                 OrderManager::ClearCurrentOrder();
               }
             } else {
-              Serial.println("[ORCH] Error: Could not parse order data from response");
+              LOG_PRINTF("[ORCH] Error: Could not parse order data from response\n");
               UartService_SendLine("QR_TOKEN_INVALID");
+              rememberQrToken(QR_TOKEN_CACHE_MISS);
               SupervisionService::SendErrorNotification(
                 SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE,
                 "Failed to parse order data from QR token validation response"
@@ -96,53 +242,50 @@ static void orchestratorTask(void* pvParameters) {
               currentWorkflowState = WORKFLOW_IDLE;
             }
           } else {
-            Serial.printf("[ORCH] QR Token invalide ou erreur: %d\n", httpResp.statusCode);
+            LOG_PRINTF("[ORCH] QR Token invalide ou erreur: %d\n", httpResp.statusCode);
             UartService_SendLine("QR_TOKEN_INVALID");
+            // Refus explicite du backend: mémorisé; erreur serveur ou transport: pas de cache
+            bool rejected = httpResp.statusCode >= 400 && httpResp.statusCode < 500;
+            rememberQrToken(rejected ? QR_TOKEN_CACHE_REJECTED : QR_TOKEN_CACHE_MISS);
             currentWorkflowState = WORKFLOW_IDLE;
           }
           break;
           
-        case WORKFLOW_UPDATING_QUANTITIES:
-          if (httpResp.statusCode == 200) {
-            Serial.println("[ORCH] Quantities updated successfully, confirming delivery");
-            // Confirmer la livraison au backend
-            OrderData* order = OrderManager::GetCurrentOrder();
-            if (order) {
-              String deliveryData = OrderManager::GenerateDeliveryConfirmationData();
-              if (deliveryData.length() > 0) {
-                HttpService_ConfirmDelivery(order->order_id, order->machine_id, order->timestamp, deliveryData.c_str(), httpResponseQueue, 10000);
-                currentWorkflowState = WORKFLOW_CONFIRMING_DELIVERY;
-                Serial.println("[ORCH] Delivery confirmation request sent");
-              } else {
-                Serial.println("[ORCH] Error: Could not generate delivery confirmation data");
-                currentWorkflowState = WORKFLOW_IDLE;
-                OrderManager::ClearCurrentOrder();
-              }
-            } else {
-              Serial.println("[ORCH] Error: No active order for delivery confirmation");
-              currentWorkflowState = WORKFLOW_IDLE;
-            }
+        case WORKFLOW_DELIVERING:
+        case WORKFLOW_UPDATING_QUANTITIES: {
+          // Réponse à la mise à jour de quantité de l'item en cours (une seule à la fois)
+          OrderData* order = OrderManager::GetCurrentOrder();
+          int idx = OrderProgress_OnUpdateResponse(OrderManager::GetProgress(), httpResp.statusCode);
+          if (!order || idx < 0) {
+            LOG_PRINTF("[ORCH] Unexpected HTTP response in state %d\n", currentWorkflowState);
+          } else if (httpResp.statusCode == 200) {
+            LOG_PRINTF("[ORCH] Quantity updated for slot %d\n", order->items[idx].slot_number);
           } else {
-            Serial.printf("[ORCH] Quantity update failed: %d\n", httpResp.statusCode);
-            currentWorkflowState = WORKFLOW_IDLE;
-            OrderManager::ClearCurrentOrder();
+            LOG_PRINTF("[ORCH] Quantity update failed for slot %d: %d\n", order->items[idx].slot_number, httpResp.statusCode);
           }
           break;
+        }
           
         case WORKFLOW_CONFIRMING_DELIVERY:
           if (httpResp.statusCode == 200) {
-            Serial.println("[ORCH] Delivery confirmed successfully - Workflow completed!");
-            // Le backend gère automatiquement la mise à jour du stock et du statut
-            currentWorkflowState = WORKFLOW_COMPLETED;
+            LOG_PRINTF("[ORCH] Delivery confirmed successfully - Workflow completed!\n");
+            // Le backend gère automatiquement la mise à jour du stock et du statut.
+            // Retour direct au repos: aucune autre réponse HTTP n'est attendue pour cette commande
+            OrderManager::ClearCurrentOrder();
+            currentWorkflowState = WORKFLOW_IDLE;
           } else {
-            Serial.printf("[ORCH] Delivery confirmation failed: %d\n", httpResp.statusCode);
+            LOG_PRINTF("[ORCH] Delivery confirmation failed: %d\n", httpResp.statusCode);
             currentWorkflowState = WORKFLOW_IDLE;
             OrderManager::ClearCurrentOrder();
           }
           break;
           
+        case WORKFLOW_RECONCILING:
+          handleReconcileResponse(httpResp);
+          break;
+          
         case WORKFLOW_COMPLETED:
-          Serial.println("[ORCH] Workflow completed, cleaning up and returning to idle");
+          LOG_PRINTF("[ORCH] Workflow completed, cleaning up and returning to idle\n");
           OrderManager::ClearCurrentOrder();
           currentWorkflowState = WORKFLOW_IDLE;
           break;
@@ -150,7 +293,7 @@ static void orchestratorTask(void* pvParameters) {
 
           
         default:
-          Serial.printf("[ORCH] Unexpected HTTP response in state %d\n", currentWorkflowState);
+          LOG_PRINTF("[ORCH] Unexpected HTTP response in state %d\n", currentWorkflowState);
           break;
       }
     }
@@ -158,88 +301,364 @@ static void orchestratorTask(void* pvParameters) {
     if (xQueueReceive(orchestratorQueueHandle, &evt, pdMS_TO_TICKS(100)) == pdTRUE) {
       switch (evt.type) {
         case ORCH_EVT_NFC_UID_READ:
-          Serial.print("[ORCH] NFC UID: ");
-          Serial.println(evt.payload);
+          LOG_PRINTF("[ORCH] NFC UID: %s\n", evt.payload);
           UartService_SendLine((String("NFC_UID:") + evt.payload).c_str());
           // TODO: envoyer au backend (WS/HTTP), puis transmettre à la NUCLEO via UART si autorisé
           break;
+        case ORCH_EVT_NFC_AUTH:
+          LOG_PRINTF("[ORCH] NFC auth: %s\n", evt.payload);
+          UartService_SendLine((String("NFC_AUTH:") + evt.payload).c_str());
+          break;
         case ORCH_EVT_NFC_DATA:
-          Serial.print("[ORCH] NFC TEXT: ");
-          Serial.println(evt.payload);
+          LOG_PRINTF("[ORCH] NFC TEXT: %s\n", evt.payload);
           UartService_SendLine((String("NFC_TEXT:") + evt.payload).c_str());
           break;
         case ORCH_EVT_NFC_ERROR:
-          Serial.print("[ORCH] NFC Error: ");
-          Serial.println(evt.payload);
+          LOG_PRINTF("[ORCH] NFC Error: %s\n", evt.payload);
           UartService_SendLine((String("NFC_ERR:") + evt.payload).c_str());
           break;
         case ORCH_EVT_STATE_PAYING:
           if (!WifiService_IsReady()) {
-            Serial.println("[ORCH] PAYING ignored: no network");
+            LOG_PRINTF("[ORCH] PAYING ignored: no network\n");
             break;
           }
-          Serial.println("[ORCH] State=PAYING -> Trigger NFC scan");
+          LOG_PRINTF("[ORCH] State=PAYING -> Trigger NFC scan\n");
           if (!NfcService_TriggerScan()) {
-            Serial.println("[ORCH] NFC busy");
+            LOG_PRINTF("[ORCH] NFC busy\n");
           }
           break;
-        case ORCH_EVT_QR_TOKEN_READ:
-          Serial.printf("[ORCH] QR Token reçu: %s\n", evt.payload);
+        case ORCH_EVT_QR_TOKEN_READ: {
+          LOG_PRINTF("[ORCH] QR Token reçu: %s\n", evt.payload);
+          uint32_t lookupStartUs = micros();
+          uint64_t tokenHash = QrTokenCache_Hash(evt.payload, strlen(evt.payload));
+          const char* cachedReply = QrTokenCache_Reply(QrTokenCache_Lookup(&qrTokenCache, tokenHash, millis()));
+          if (cachedReply) {
+            UartService_SendLine(cachedReply);
+            LOG_PRINTF("[ORCH] QR Token déjà traité: %s (cache, %lu us)\n", cachedReply, (unsigned long)(micros() - lookupStartUs));
+            break;
+          }
           if (currentWorkflowState != WORKFLOW_IDLE) {
-            Serial.printf("[ORCH] QR Token ignoré: workflow en cours (état %d)\n", currentWorkflowState);
+            LOG_PRINTF("[ORCH] QR Token ignoré: workflow en cours (état %d)\n", currentWorkflowState);
             UartService_SendLine("QR_TOKEN_BUSY");
             break;
           }
+          if (QrOffline_IsSigned(evt.payload, strlen(evt.payload)) && TokenVerifier_IsReady()) {
+            uint32_t verifyStartUs = micros();
+            QrOfflineOrder offline;
+            QrOfflineResult result = TokenVerifier_Check(evt.payload, &offline);
+            LOG_PRINTF("[ORCH] Token signé: %s (%lu us)\n", QrOffline_ResultName(result), (unsigned long)(micros() - verifyStartUs));
+            if (result == QR_OFFLINE_OK && isOfflineOrderSpent(offline.orderId)) {
+              LOG_PRINTF("[ORCH] Commande %s déjà servie (token signé rejoué)\n", offline.orderId);
+              UartService_SendLine("QR_TOKEN_INVALID");
+              QrTokenCache_Store(&qrTokenCache, tokenHash, QR_TOKEN_CACHE_CONSUMED, millis(), QR_TOKEN_CACHE_CONSUMED_TTL_MS);
+              break;
+            }
+            if (result == QR_OFFLINE_OK) {
+              // Livraison immédiate, réseau présent ou non: rapprochement backend après la livraison
+              if (reserveSpentOrder(&offline)) {
+                acceptOfflineToken(evt.payload, tokenHash, &offline);
+                break;
+              }
+              if (!WifiService_IsReady()) {
+                UartService_SendLine("QR_TOKEN_ERROR");
+                break;
+              }
+              // Registre plein ou NVS indisponible: validation backend avant livraison, sans réservation
+            } else if (result != QR_OFFLINE_NO_CLOCK) {
+              UartService_SendLine("QR_TOKEN_INVALID");
+              QrTokenCache_Store(&qrTokenCache, tokenHash, QR_TOKEN_CACHE_REJECTED, millis(), QR_TOKEN_CACHE_REJECTED_TTL_MS);
+              break;
+            }
+            // Heure pas encore synchronisée: validation backend comme un token classique
+          }
           if (!WifiService_IsReady()) {
-            Serial.println("[ORCH] QR Token ignoré: pas de réseau");
+            LOG_PRINTF("[ORCH] QR Token ignoré: pas de réseau\n");
             UartService_SendLine("QR_TOKEN_NO_NETWORK");
             break;
           }
-          Serial.println("[ORCH] Validation du QR Token...");
+          LOG_PRINTF("[ORCH] Validation du QR Token...\n");
+          // Radio éveillée avant la première requête de la transaction
+          WifiService_SetTransactionActive(true);
           if (HttpService_ValidateQRToken(evt.payload, httpResponseQueue, 10000)) {
             currentWorkflowState = WORKFLOW_VALIDATING_TOKEN;
+            currentQrTokenHash = tokenHash;
+            qrTokenPending = true;
+            rememberQrToken(QR_TOKEN_CACHE_IN_PROGRESS);
           } else {
-            Serial.println("[ORCH] Erreur envoi requête validation QR");
+            LOG_PRINTF("[ORCH] Erreur envoi requête validation QR\n");
             UartService_SendLine("QR_TOKEN_ERROR");
           }
           break;
+        }
+          
+        case ORCH_EVT_VEND_COMPLETED:
+        case ORCH_EVT_VEND_FAILED: {
+          if (currentWorkflowState != WORKFLOW_DELIVERING) {
+            LOG_PRINTF("[ORCH] Unexpected item status in state %d: %s\n", currentWorkflowState, evt.payload);
+            break;
+          }
+          OrderProgress* progress = OrderManager::GetProgress();
+          int idx = (evt.type == ORCH_EVT_VEND_COMPLETED)
+            ? OrderProgress_OnVendCompleted(progress, evt.payload)
+            : OrderProgress_OnVendFailed(progress, evt.payload);
+          if (idx < 0) {
+            LOG_PRINTF("[ORCH] Item status does not match the order: %s\n", evt.payload);
+          } else {
+            LOG_PRINTF("[ORCH] Item %d/%d: %s\n", idx + 1, progress->count, evt.payload);
+          }
+          break;
+        }
           
         case ORCH_EVT_DELIVERY_COMPLETED:
-          Serial.printf("[ORCH] Delivery completed: %s\n", evt.payload);
+          LOG_PRINTF("[ORCH] Delivery completed: %s\n", evt.payload);
           if (currentWorkflowState == WORKFLOW_DELIVERING) {
-            // Mettre à jour les quantités de stock
-            if (OrderManager::UpdateAllQuantities(httpResponseQueue, 10000)) {
-              currentWorkflowState = WORKFLOW_UPDATING_QUANTITIES;
-              Serial.println("[ORCH] Quantity update request sent");
-            } else {
-              Serial.println("[ORCH] Error: Could not send quantity update request");
-              currentWorkflowState = WORKFLOW_IDLE;
-              OrderManager::ClearCurrentOrder();
-            }
+            // Items restants: mises à jour envoyées puis confirmation (pumpOrderProgress)
+            OrderProgress_OnDeliveryEnd(OrderManager::GetProgress(), true, nullptr);
+            currentWorkflowState = WORKFLOW_UPDATING_QUANTITIES;
           } else {
-            Serial.printf("[ORCH] Unexpected delivery completion in state %d\n", currentWorkflowState);
+            LOG_PRINTF("[ORCH] Unexpected delivery completion in state %d\n", currentWorkflowState);
           }
           break;
           
         case ORCH_EVT_DELIVERY_FAILED:
-          Serial.printf("[ORCH] Delivery failed: %s\n", evt.payload);
+          LOG_PRINTF("[ORCH] Delivery failed: %s\n", evt.payload);
           if (currentWorkflowState == WORKFLOW_DELIVERING) {
-            Serial.println("[ORCH] Cleaning up failed order");
             SupervisionService::SendErrorNotification(
               SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE,
               "Physical delivery failed - NUCLEO reported delivery failure: " + String(evt.payload)
             );
-            currentWorkflowState = WORKFLOW_IDLE;
-            OrderManager::ClearCurrentOrder();
             UartService_SendLine("ORDER_FAILED");
+            // Les items déjà livrés restent à mettre à jour et à confirmer (livraison partielle)
+            const char* reason = strchr(evt.payload, ':');
+            OrderProgress_OnDeliveryEnd(OrderManager::GetProgress(), false, reason ? reason + 1 : evt.payload);
+            currentWorkflowState = WORKFLOW_UPDATING_QUANTITIES;
           }
           break;
         default:
-          Serial.println("[ORCH] Événement inconnu");
+          LOG_PRINTF("[ORCH] Événement inconnu\n");
           break;
       }
     }
+    
+    pumpOrderProgress();
+    pumpOfflineSales();
+    // Pages de l'index NFC entre deux commandes, après le délai du service HTTP
+    NfcAuth_Pump(currentWorkflowState == WORKFLOW_IDLE && millis() - lastBusyMs >= HTTP_REQUEST_COOLDOWN_MS);
+    // Modem sleep dès le retour au repos (rapprochement hors ligne en tâche de fond compris)
+    WifiService_SetTransactionActive(currentWorkflowState != WORKFLOW_IDLE && currentWorkflowState != WORKFLOW_RECONCILING);
+  }
+}
+
+// Token signé vérifié localement: livraison immédiate, rapprochement backend après la livraison
+static void acceptOfflineToken(const char* token, uint64_t tokenHash, const QrOfflineOrder* offline) {
+  OrderData order;
+  if (!OrderManager::BuildOfflineOrder(offline, &order)) {
+    UartService_SendLine("QR_TOKEN_INVALID");
+    settleSpentOrder(false);
+    return;
+  }
+  OrderManager::SetCurrentOrder(&order);
+  if (!dispatchCurrentOrder()) {
+    LOG_PRINTF("[ORCH] Error: Could not generate delivery commands\n");
+    UartService_SendLine("QR_TOKEN_ERROR");
+    settleSpentOrder(false);
+    OrderManager::ClearCurrentOrder();
+    return;
+  }
+  currentOrderOffline = true;
+  strncpy(currentOfflineToken, token, sizeof(currentOfflineToken) - 1);
+  currentOfflineToken[sizeof(currentOfflineToken) - 1] = '\0';
+  currentQrTokenHash = tokenHash;
+  qrTokenPending = true;
+  rememberQrToken(QR_TOKEN_CACHE_IN_PROGRESS);
+  LOG_PRINTF("[ORCH] Offline order accepted, delivery commands sent to NUCLEO\n");
+}
+
+// Fin de livraison d'une commande hors ligne: mise en attente du rapprochement backend
+static void finishOfflineOrder(const OrderData* order, const OrderProgress* progress) {
+  if (OrderProgress_DeliveredTotal(progress) == 0) {
+    LOG_PRINTF("[ORCH] Nothing delivered, offline order dropped\n");
+    rememberQrToken(QR_TOKEN_CACHE_MISS);
+  } else {
+    rememberQrToken(QR_TOKEN_CACHE_CONSUMED);
+    if (offlineSaleCount == OFFLINE_SALES_MAX) {
+      SupervisionService::SendErrorNotification(
+        SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE,
+        "Offline sales journal full, dropping unreconciled order " + String(offlineSales[0].orderId)
+      );
+      memmove(&offlineSales[0], &offlineSales[1], sizeof(OfflineSale) * (OFFLINE_SALES_MAX - 1));
+      offlineSaleCount--;
+    }
+    OfflineSale* sale = &offlineSales[offlineSaleCount++];
+    memset(sale, 0, sizeof(*sale));
+    memcpy(sale->token, currentOfflineToken, sizeof(sale->token));
+    strncpy(sale->orderId, order->order_id, sizeof(sale->orderId) - 1);
+    for (int i = 0; i < progress->count; i++) {
+      if (progress->items[i].outcome == ORDER_ITEM_VENDED) sale->vendedSlots[sale->vendedCount++] = (uint8_t)progress->items[i].slot;
+    }
+    sale->complete = !progress->deliveryFailed;
+    sale->nextAttemptMs = millis();
+    LOG_PRINTF("[ORCH] Offline sale %s journaled (%d unit(s)), %d pending reconciliation\n",
+               sale->orderId, OrderProgress_DeliveredTotal(progress), offlineSaleCount);
+    saveOfflineSales();
   }
+  currentOrderOffline = false;
+  currentWorkflowState = WORKFLOW_IDLE;
+  OrderManager::ClearCurrentOrder();
 }
 
+static void dropOfflineSale() {
+  if (offlineSaleCount == 0) return;
+  memmove(&offlineSales[0], &offlineSales[1], sizeof(OfflineSale) * (offlineSaleCount - 1));
+  offlineSaleCount--;
+  saveOfflineSales();
+}
 
+// Validation backend d'une vente hors ligne: la commande renvoyée (product_id, machine_id) reprend
+// le circuit normal avec les items déjà livrés
+static void handleReconcileResponse(const HttpResponse& resp) {
+  OfflineSale* sale = &offlineSales[0];
+  currentWorkflowState = WORKFLOW_IDLE;
+  if (offlineSaleCount == 0) return;
+  
+  OrderData order;
+  bool parsed = resp.statusCode == 200 && OrderManager::ParseOrderFromJSON(resp.payload, &order);
+  if (parsed && strcmp(order.order_id, sale->orderId) == 0) {
+    OrderManager::SetCurrentOrder(&order);
+    OrderProgress* progress = OrderManager::GetProgress();
+    char line[24];
+    for (int i = 0; i < sale->vendedCount; i++) {
+      snprintf(line, sizeof(line), "VEND_COMPLETED:%u", sale->vendedSlots[i]);
+      OrderProgress_OnVendCompleted(progress, line);
+    }
+    OrderProgress_OnDeliveryEnd(progress, sale->complete, "OFFLINE");
+    LOG_PRINTF("[ORCH] Offline sale %s reconciled, %d unit(s) to confirm\n", sale->orderId, OrderProgress_DeliveredTotal(progress));
+    dropOfflineSale();
+    currentWorkflowState = WORKFLOW_UPDATING_QUANTITIES;
+    return;
+  }
+  
+  if (parsed || (resp.statusCode >= 400 && resp.statusCode < 500)) {
+    // Marchandise déjà remise: seule la supervision peut régulariser
+    SupervisionService::SendErrorNotification(
+      SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE,
+      "Offline sale rejected by backend: order " + String(sale->orderId) + ", status " + String(resp.statusCode)
+    );
+    dropOfflineSale();
+    return;
+  }
+  LOG_PRINTF("[ORCH] Offline sale reconciliation failed (%d), retry later\n", resp.statusCode);
+  sale->nextAttemptMs = millis() + OFFLINE_RECONCILE_RETRY_MS;
+}
+
+// Rapprochement des ventes hors ligne, une à la fois, quand le workflow est au repos et le réseau présent
+static void pumpOfflineSales() {
+  uint32_t now = millis();
+  if (currentWorkflowState == WORKFLOW_RECONCILING) {
+    if (now - reconcileSentMs >= ORDER_UPDATE_RESPONSE_TIMEOUT_MS) {
+      LOG_PRINTF("[ORCH] Offline sale reconciliation response lost\n");
+      offlineSales[0].nextAttemptMs = now + OFFLINE_RECONCILE_RETRY_MS;
+      currentWorkflowState = WORKFLOW_IDLE;
+    }
+    lastBusyMs = now;
+    return;
+  }
+  if (currentWorkflowState != WORKFLOW_IDLE) {
+    lastBusyMs = now;
+    return;
+  }
+  // Laisser passer le délai entre requêtes du service HTTP après la dernière commande
+  if (offlineSaleCount == 0 || !WifiService_IsReady() || now - lastBusyMs < HTTP_REQUEST_COOLDOWN_MS) {
+    return;
+  }
+  OfflineSale* sale = &offlineSales[0];
+  if ((int32_t)(now - sale->nextAttemptMs) < 0) {
+    return;
+  }
+  
+  LOG_PRINTF("[ORCH] Reconciling offline sale %s\n", sale->orderId);
+  if (HttpService_ValidateQRToken(sale->token, httpResponseQueue, ORDER_HTTP_TIMEOUT_MS)) {
+    reconcileSentMs = now;
+    currentWorkflowState = WORKFLOW_RECONCILING;
+  } else {
+    sale->nextAttemptMs = now + OFFLINE_RECONCILE_RETRY_MS;
+  }
+}
+
+// Mises à jour de quantités au fil de la livraison, puis confirmation une fois tout réglé
+static void pumpOrderProgress() {
+  if (currentWorkflowState != WORKFLOW_DELIVERING && currentWorkflowState != WORKFLOW_UPDATING_QUANTITIES) {
+    return;
+  }
+  OrderData* order = OrderManager::GetCurrentOrder();
+  OrderProgress* progress = OrderManager::GetProgress();
+  if (!order || !progress) {
+    currentWorkflowState = WORKFLOW_IDLE;
+    return;
+  }
+  
+  // Commande hors ligne: product_id inconnus, mises à jour et confirmation après rapprochement
+  if (currentOrderOffline) {
+    if (currentWorkflowState == WORKFLOW_UPDATING_QUANTITIES) {
+      finishOfflineOrder(order, progress);
+    }
+    return;
+  }
+  
+  uint32_t now = millis();
+  if (OrderProgress_CheckTimeout(progress, now, ORDER_UPDATE_RESPONSE_TIMEOUT_MS)) {
+    LOG_PRINTF("[ORCH] Quantity update response lost\n");
+  }
+  
+  int idx = OrderProgress_NextUpdate(progress, now);
+  if (idx >= 0 && !OrderManager::SendItemQuantityUpdate(idx, httpResponseQueue, ORDER_HTTP_TIMEOUT_MS)) {
+    LOG_PRINTF("[ORCH] Error: Could not send quantity update request\n");
+    OrderProgress_OnUpdateResponse(progress, 0);
+  }
+  
+  if (currentWorkflowState != WORKFLOW_UPDATING_QUANTITIES || !OrderProgress_IsSettled(progress)) {
+    return;
+  }
+  
+  if (OrderProgress_DeliveredTotal(progress) == 0) {
+    LOG_PRINTF("[ORCH] Nothing delivered, cleaning up failed order\n");
+    rememberQrToken(QR_TOKEN_CACHE_MISS);
+    currentWorkflowState = WORKFLOW_IDLE;
+    OrderManager::ClearCurrentOrder();
+    return;
+  }
+  if (!OrderProgress_CanRequest(progress, now)) {
+    return;
+  }
+  
+  // Marchandise remise: le token ne doit plus redéclencher de validation
+  rememberQrToken(QR_TOKEN_CACHE_CONSUMED);
+  if (progress->updatesFailed > 0) {
+    LOG_PRINTF("[ORCH] %u quantity update(s) failed, confirming delivery anyway\n", progress->updatesFailed);
+  }
+  String deliveryData = OrderManager::GenerateDeliveryConfirmationData();
+  if (deliveryData.length() > 0 &&
+      HttpService_ConfirmDelivery(order->order_id, order->machine_id, order->timestamp, deliveryData.c_str(), httpResponseQueue, ORDER_HTTP_TIMEOUT_MS)) {
+    OrderProgress_MarkRequest(progress, now);
+    currentWorkflowState = WORKFLOW_CONFIRMING_DELIVERY;
+    LOG_PRINTF("[ORCH] Delivery confirmation request sent (%d unit(s)%s)\n",
+               OrderProgress_DeliveredTotal(progress), progress->deliveryFailed ? ", partial" : "");
+  } else {
+    LOG_PRINTF("[ORCH] Error: Could not send delivery confirmation\n");
+    currentWorkflowState = WORKFLOW_IDLE;
+    OrderManager::ClearCurrentOrder();
+  }
+}
+
+
+
+
+void Orchestrator_DebugInfo() {
+  Serial.printf("[INFO] Offline QR tokens: %s, %d sale(s) pending reconciliation, %lu/%d signed order(s) spent\n",
+                TokenVerifier_IsReady() ? "enabled" : "disabled", offlineSaleCount,
+                (unsigned long)qrSpent.count, QR_SPENT_CAPACITY);
+  Serial.printf("[INFO] QR token cache: %u/%d, hits=%lu, misses=%lu, expired=%lu, evicted=%lu\n",
+                (unsigned)QrTokenCache_Count(&qrTokenCache, millis()), QR_TOKEN_CACHE_CAPACITY,
+                (unsigned long)qrTokenCache.hits, (unsigned long)qrTokenCache.misses,
+                (unsigned long)qrTokenCache.expired, (unsigned long)qrTokenCache.evicted);
+}
@@ -1,10 +1,12 @@
 #include "order_manager.h"
 #include <ArduinoJson.h>
 #include "services/http_service.h"
+#include "security_config.h"
 
 // Variables statiques
 OrderData OrderManager::current_order = {};
 bool OrderManager::has_active_order = false;
+OrderProgress OrderManager::progress = {};
 
 bool OrderManager::ParseOrderFromJSON(const char* json_response, OrderData* order) {
   if (!json_response || !order) return false;
@@ -71,12 +73,37 @@ bool OrderManager::ParseOrderFromJSON(const char* json_response, OrderData* orde
   return order->is_valid;
 }
 
+bool OrderManager::BuildOfflineOrder(const QrOfflineOrder* offline, OrderData* order) {
+  if (!offline || !order) return false;
+  
+  memset(order, 0, sizeof(OrderData));
+  strncpy(order->order_id, offline->orderId, MAX_ORDER_ID_LENGTH - 1);
+  strncpy(order->machine_id, offline->machineId, MAX_MACHINE_ID_LENGTH - 1);
+  strncpy(order->status, "OFFLINE", 15);
+  order->item_count = min((int)offline->itemCount, MAX_ORDER_ITEMS);
+  for (int i = 0; i < order->item_count; i++) {
+    order->items[i].slot_number = offline->items[i].slot;
+    order->items[i].quantity = offline->items[i].quantity;
+  }
+  // Bornes déjà contrôlées par QrOffline_ParsePayload; product_id inconnu hors ligne
+  order->is_valid = order->item_count > 0 && strlen(order->order_id) > 0;
+  
+  Serial.printf("[ORDER] Offline order: %s (%d items)\n", order->order_id, order->item_count);
+  return order->is_valid;
+}
+
 void OrderManager::SetCurrentOrder(const OrderData* order) {
   if (!order) return;
   
   memcpy(&current_order, order, sizeof(OrderData));
   has_active_order = order->is_valid;
   
+  // Suivi de livraison: la validation du token vient d'occuper le service HTTP
+  OrderProgress_Begin(&progress, HTTP_REQUEST_COOLDOWN_MS, millis());
+  for (int i = 0; i < current_order.item_count; i++) {
+    OrderProgress_AddItem(&progress, current_order.items[i].slot_number, current_order.items[i].quantity);
+  }
+  
   Serial.printf("[ORDER] Set current order: %s\n", current_order.order_id);
   PrintOrderDetails(&current_order);
 }
@@ -92,6 +119,7 @@ bool OrderManager::HasActiveOrder() {
 void OrderManager::ClearCurrentOrder() {
   memset(&current_order, 0, sizeof(OrderData));
   has_active_order = false;
+  OrderProgress_Begin(&progress, 0, 0);
   Serial.println("[ORDER] Cleared current order");
 }
 
@@ -113,8 +141,10 @@ String OrderManager::GenerateDeliveryCommands() {
     // slot_number = channel du multiplexeur (1-99)
     // quantity = nombre d'unités à livrer
     // product_id = identifiant du produit pour traçabilité
-    commands += "VEND " + String(item.slot_number) + " " + 
-                String(item.quantity) + " " + String(item.product_id);
+    commands += "VEND " + String(item.slot_number) + " " + String(item.quantity);
+    if (item.product_id[0]) {
+      commands += " " + String(item.product_id);
+    }
     
     if (i < current_order.item_count - 1) {
       commands += "\n"; // Séparateur pour plusieurs commandes
@@ -144,7 +174,7 @@ String OrderManager::GenerateStockUpdateData() {
     JsonObject item = items.createNestedObject();
     item["product_id"] = current_order.items[i].product_id;
     item["slot_number"] = current_order.items[i].slot_number;
-    item["quantity_delivered"] = current_order.items[i].quantity;
+    item["quantity_delivered"] = progress.items[i].delivered;
   }
   
   String json_string;
@@ -165,12 +195,14 @@ String OrderManager::GenerateDeliveryConfirmationData() {
   doc["machine_id"] = current_order.machine_id;
   doc["timestamp"] = current_order.timestamp;
   
+  // Livraison partielle: seuls les items effectivement livrés sont confirmés
   JsonArray items = doc.createNestedArray("items_delivered");
   for (int i = 0; i < current_order.item_count; i++) {
+    if (progress.items[i].delivered <= 0) continue;
     JsonObject item = items.createNestedObject();
     item["product_id"] = current_order.items[i].product_id;
     item["slot_number"] = current_order.items[i].slot_number;
-    item["quantity"] = current_order.items[i].quantity;
+    item["quantity"] = progress.items[i].delivered;
   }
   
   String json_string;
@@ -180,32 +212,29 @@ String OrderManager::GenerateDeliveryConfirmationData() {
   return json_string;
 }
 
-bool OrderManager::UpdateAllQuantities(QueueHandle_t responseQueue, uint32_t timeoutMs) {
+OrderProgress* OrderManager::GetProgress() {
+  return has_active_order ? &progress : nullptr;
+}
+
+bool OrderManager::SendItemQuantityUpdate(int index, QueueHandle_t responseQueue, uint32_t timeoutMs) {
   if (!has_active_order || !current_order.is_valid) {
     Serial.println("[ORDER] No active order for quantity update");
     return false;
   }
+  if (index < 0 || index >= current_order.item_count) return false;
   
-  Serial.printf("[ORDER] Updating quantities for %d items\n", current_order.item_count);
+  const OrderItem& item = current_order.items[index];
+  int delivered = progress.items[index].delivered;
   
-  // Pour chaque item de la commande, envoyer une requête de mise à jour des quantités
-  // Note: Pour l'instant, on envoie seulement le premier item
-  // TODO: Implémenter une file de requêtes pour traiter tous les items séquentiellement
-  if (current_order.item_count > 0) {
-    const OrderItem& item = current_order.items[0];
-    
-    Serial.printf("[ORDER] Updating quantity for product %s, slot %d\n", 
-                  item.product_id, item.slot_number);
-    
-    return HttpService_UpdateQuantities(current_order.machine_id, 
-                                       item.product_id, 
-                                       item.quantity, 
-                                       item.slot_number, 
-                                       responseQueue, 
-                                       timeoutMs);
-  }
+  Serial.printf("[ORDER] Updating quantity for product %s, slot %d (%d delivered)\n", 
+                item.product_id, item.slot_number, delivered);
   
-  return false;
+  return HttpService_UpdateQuantities(current_order.machine_id, 
+                                     item.product_id, 
+                                     delivered, 
+                                     item.slot_number, 
+                                     responseQueue, 
+                                     timeoutMs);
 }
 
 bool OrderManager::ValidateOrder(const OrderData* order) {
@@ -0,0 +1,107 @@
+#include "qr_offline_token.h"
+#include <string.h>
+
+bool QrOffline_IsSigned(const char* token, size_t len) {
+  const size_t n = sizeof(QR_OFFLINE_TOKEN_PREFIX) - 1;
+  return token && len > n && memcmp(token, QR_OFFLINE_TOKEN_PREFIX, n) == 0;
+}
+
+static int b64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  if (c == '-') return 62;
+  if (c == '_') return 63;
+  return -1;
+}
+
+int QrOffline_Base64UrlDecode(const char* in, size_t len, uint8_t* out, size_t outMax) {
+  if (!in || !out || len % 4 == 1) return -1;
+  uint32_t acc = 0;
+  int bits = 0;
+  size_t n = 0;
+  for (size_t i = 0; i < len; i++) {
+    int v = b64Value(in[i]);
+    if (v < 0) return -1;
+    acc = (acc << 6) | (uint32_t)v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      if (n >= outMax) return -1;
+      out[n++] = (uint8_t)(acc >> bits);
+    }
+  }
+  return (int)n;
+}
+
+static bool readId(const uint8_t* p, size_t len, size_t* pos, char* out) {
+  if (*pos >= len) return false;
+  size_t n = p[(*pos)++];
+  if (n == 0 || n > QR_OFFLINE_ID_MAX || n > len - *pos) return false;
+  for (size_t i = 0; i < n; i++) {
+    uint8_t c = p[*pos + i];
+    if (c < 0x21 || c > 0x7E || c == '"' || c == '\\') return false;  // réutilisé tel quel dans le JSON
+  }
+  memcpy(out, p + *pos, n);
+  out[n] = '\0';
+  *pos += n;
+  return true;
+}
+
+QrOfflineResult QrOffline_ParsePayload(const uint8_t* p, size_t len, QrOfflineOrder* out) {
+  if (!p || !out || len < 5 || p[0] != QR_OFFLINE_TOKEN_VERSION) return QR_OFFLINE_MALFORMED;
+  memset(out, 0, sizeof(*out));
+  out->expiresAt = ((uint32_t)p[1] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 8) | p[4];
+  size_t pos = 5;
+  if (!readId(p, len, &pos, out->orderId) || !readId(p, len, &pos, out->machineId)) return QR_OFFLINE_MALFORMED;
+  if (pos >= len) return QR_OFFLINE_MALFORMED;
+  uint8_t count = p[pos++];
+  if (count == 0 || count > QR_OFFLINE_MAX_ITEMS || len - pos != (size_t)count * 2) return QR_OFFLINE_MALFORMED;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t slot = p[pos++];
+    uint8_t qty = p[pos++];
+    // Mêmes bornes que OrderManager::ValidateOrder
+    if (slot < 1 || slot > 99 || qty < 1 || qty > 10) return QR_OFFLINE_MALFORMED;
+    out->items[i].slot = slot;
+    out->items[i].quantity = qty;
+  }
+  out->itemCount = count;
+  return QR_OFFLINE_OK;
+}
+
+QrOfflineResult QrOffline_Verify(const char* token, size_t len, uint32_t nowUnix, const char* machineId,
+                                 QrOfflineVerifyFn verify, void* ctx, QrOfflineOrder* out) {
+  if (!QrOffline_IsSigned(token, len)) return QR_OFFLINE_NOT_SIGNED;
+  if (!verify || !out) return QR_OFFLINE_MALFORMED;
+
+  const size_t prefix = sizeof(QR_OFFLINE_TOKEN_PREFIX) - 1;
+  uint8_t raw[QR_OFFLINE_PAYLOAD_MAX + QR_OFFLINE_SIGNATURE_SIZE];
+  int n = QrOffline_Base64UrlDecode(token + prefix, len - prefix, raw, sizeof(raw));
+  if (n <= QR_OFFLINE_SIGNATURE_SIZE) return QR_OFFLINE_MALFORMED;
+  size_t payloadLen = (size_t)n - QR_OFFLINE_SIGNATURE_SIZE;
+
+  QrOfflineOrder order;
+  QrOfflineResult r = QrOffline_ParsePayload(raw, payloadLen, &order);
+  if (r != QR_OFFLINE_OK) return r;
+  if (!verify(ctx, raw, payloadLen, raw + payloadLen, QR_OFFLINE_SIGNATURE_SIZE)) return QR_OFFLINE_BAD_SIGNATURE;
+
+  if (nowUnix < QR_OFFLINE_MIN_UNIX_TIME) return QR_OFFLINE_NO_CLOCK;
+  if (nowUnix >= order.expiresAt) return QR_OFFLINE_EXPIRED;
+  if (!machineId || !machineId[0] || strcmp(machineId, order.machineId) != 0) return QR_OFFLINE_WRONG_MACHINE;
+
+  memcpy(out, &order, sizeof(order));
+  return QR_OFFLINE_OK;
+}
+
+const char* QrOffline_ResultName(QrOfflineResult r) {
+  switch (r) {
+    case QR_OFFLINE_OK: return "OK";
+    case QR_OFFLINE_NOT_SIGNED: return "NOT_SIGNED";
+    case QR_OFFLINE_MALFORMED: return "MALFORMED";
+    case QR_OFFLINE_BAD_SIGNATURE: return "BAD_SIGNATURE";
+    case QR_OFFLINE_EXPIRED: return "EXPIRED";
+    case QR_OFFLINE_WRONG_MACHINE: return "WRONG_MACHINE";
+    case QR_OFFLINE_NO_CLOCK: return "NO_CLOCK";
+    default: return "?";
+  }
+}
@@ -0,0 +1,64 @@
+#include "qr_spent.h"
+#include <string.h>
+
+void QrSpent_Init(QrSpentSet* s) {
+  if (!s) return;
+  memset(s, 0, sizeof(*s));
+}
+
+bool QrSpent_IsValid(const QrSpentSet* s, size_t len) {
+  return s && len == sizeof(*s) && s->count <= QR_SPENT_CAPACITY;
+}
+
+static int find(const QrSpentSet* s, uint64_t idHash) {
+  for (uint32_t i = 0; i < s->count; i++) {
+    if (s->entries[i].idHash == idHash) return (int)i;
+  }
+  return -1;
+}
+
+static void removeAt(QrSpentSet* s, uint32_t i) {
+  s->entries[i] = s->entries[--s->count];
+  memset(&s->entries[s->count], 0, sizeof(QrSpentEntry));
+}
+
+bool QrSpent_Contains(const QrSpentSet* s, uint64_t idHash) {
+  return s && find(s, idHash) >= 0;
+}
+
+bool QrSpent_Add(QrSpentSet* s, uint64_t idHash, uint32_t expiresAt, uint32_t nowUnix) {
+  if (!s) return false;
+  int i = find(s, idHash);
+  if (i >= 0) {
+    if (expiresAt > s->entries[i].expiresAt) s->entries[i].expiresAt = expiresAt;
+    return true;
+  }
+  QrSpent_Purge(s, nowUnix);
+  if (s->count == QR_SPENT_CAPACITY) return false;
+  s->entries[s->count].idHash = idHash;
+  s->entries[s->count].expiresAt = expiresAt;
+  s->count++;
+  return true;
+}
+
+bool QrSpent_Remove(QrSpentSet* s, uint64_t idHash) {
+  if (!s) return false;
+  int i = find(s, idHash);
+  if (i < 0) return false;
+  removeAt(s, (uint32_t)i);
+  return true;
+}
+
+int QrSpent_Purge(QrSpentSet* s, uint32_t nowUnix) {
+  if (!s) return 0;
+  int removed = 0;
+  for (uint32_t i = 0; i < s->count;) {
+    if (nowUnix > s->entries[i].expiresAt) {
+      removeAt(s, i);
+      removed++;
+    } else {
+      i++;
+    }
+  }
+  return removed;
+}
@@ -0,0 +1,48 @@
+#include "rate_limiter.h"
+
+bool RateLimit_TryAcquire(RateLimiter* rl, RateLimitId id, uint32_t nowMs) {
+  if (!rl || (unsigned)id >= RATE_LIMIT_COUNT) return false;
+  const RateLimitRule* rule = &rl->rules[id];
+  RateLimitBucket* b = &rl->buckets[id];
+  uint32_t burst = rule->burst ? rule->burst : 1;
+  // Avance maximale de tat sur l'horloge pour accepter encore une demande
+  uint32_t tolerance = (burst - 1) * rule->intervalMs;
+
+  uint32_t tat = __atomic_load_n(&b->tat, __ATOMIC_RELAXED);
+  for (;;) {
+    uint32_t ahead = tat - nowMs;
+    // Seau plein: jamais utilisé (0), tat passé, ou hors de portée après ~24 jours sans demande
+    if (tat == 0 || (int32_t)ahead < 0 || ahead > tolerance + rule->intervalMs) ahead = 0;
+    if (ahead > tolerance) {
+      __atomic_fetch_add(&b->rejected, 1, __ATOMIC_RELAXED);
+      return false;
+    }
+    uint32_t next = nowMs + ahead + rule->intervalMs;
+    if (next == 0) next = 1;    // 0 réservé au seau plein
+    if (__atomic_compare_exchange_n(&b->tat, &tat, next, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+      __atomic_fetch_add(&b->accepted, 1, __ATOMIC_RELAXED);
+      return true;
+    }
+    // Autre tâche passée entre temps: tat rechargé par le CAS, recalcul
+  }
+}
+
+void RateLimit_Reset(RateLimiter* rl, RateLimitId id) {
+  if (!rl || (unsigned)id >= RATE_LIMIT_COUNT) return;
+  __atomic_store_n(&rl->buckets[id].tat, 0, __ATOMIC_RELEASE);
+}
+
+uint32_t RateLimit_Accepted(const RateLimiter* rl, RateLimitId id) {
+  if (!rl || (unsigned)id >= RATE_LIMIT_COUNT) return 0;
+  return __atomic_load_n(&rl->buckets[id].accepted, __ATOMIC_RELAXED);
+}
+
+uint32_t RateLimit_Rejected(const RateLimiter* rl, RateLimitId id) {
+  if (!rl || (unsigned)id >= RATE_LIMIT_COUNT) return 0;
+  return __atomic_load_n(&rl->buckets[id].rejected, __ATOMIC_RELAXED);
+}
+
+const char* RateLimit_Name(RateLimitId id) {
+  static const char* const names[RATE_LIMIT_COUNT] = { "NFC", "UART", "HTTP", "WIFI" };
+  return (unsigned)id < RATE_LIMIT_COUNT ? names[id] : "?";
+}
@@ -0,0 +1,334 @@
+#include "rc522_drv.h"
+#include <string.h>
+
+// Octet d'adresse SPI: bit 7 = lecture, adresse sur les bits 6..1
+#define RC522_SPI_READ(reg)  ((uint8_t)(0x80 | (((reg) << 1) & 0x7E)))
+#define RC522_SPI_WRITE(reg) ((uint8_t)(((reg) << 1) & 0x7E))
+
+typedef struct {
+  uint32_t t0;
+  uint32_t transactions;
+  uint32_t bytes;
+} OpMark;
+
+static uint32_t nowUs(Rc522Drv* d) {
+  return d->t->micros ? d->t->micros(d->t->ctx) : 0;
+}
+
+static bool driverReady(Rc522Drv* d) {
+  return d && d->t && d->t->transfer;
+}
+
+static void opBegin(Rc522Drv* d, OpMark* m) {
+  m->t0 = nowUs(d);
+  m->transactions = d->transactions;
+  m->bytes = d->bytes;
+}
+
+static int opEnd(Rc522Drv* d, Rc522Op op, const OpMark* m, int status) {
+  Rc522OpStats* s = &d->ops[op];
+  s->calls++;
+  if (status < 0) s->errors++;
+  s->transactions += d->transactions - m->transactions;
+  s->bytes += d->bytes - m->bytes;
+  s->lastUs = nowUs(d) - m->t0;
+  s->totalUs += s->lastUs;
+  return status;
+}
+
+static bool transfer(Rc522Drv* d, const uint8_t* tx, uint8_t* rx, size_t len) {
+  d->transactions++;
+  d->bytes += (uint32_t)len;
+  return d->t->transfer(d->t->ctx, tx, rx, len);
+}
+
+void Rc522Drv_Init(Rc522Drv* d, const Rc522Transport* t) {
+  if (!d) return;
+  memset(d, 0, sizeof(*d));
+  d->t = t;
+  d->timeoutUs = RC522_DRV_TIMEOUT_US;
+}
+
+const char* Rc522Drv_OpName(Rc522Op op) {
+  switch (op) {
+    case RC522_OP_REQA: return "REQA";
+    case RC522_OP_SELECT: return "SELECT";
+    case RC522_OP_READ: return "READ";
+    case RC522_OP_TRANSCEIVE: return "TRANSCEIVE";
+    case RC522_OP_HALT: return "HALT";
+    default: return "?";
+  }
+}
+
+uint8_t Rc522Drv_ReadReg(Rc522Drv* d, uint8_t reg) {
+  uint8_t value = 0;
+  Rc522Drv_ReadRegs(d, &reg, &value, 1);
+  return value;
+}
+
+bool Rc522Drv_WriteReg(Rc522Drv* d, uint8_t reg, uint8_t value) {
+  if (!driverReady(d)) return false;
+  uint8_t tx[2] = { RC522_SPI_WRITE(reg), value };
+  return transfer(d, tx, nullptr, sizeof(tx));
+}
+
+bool Rc522Drv_ReadRegs(Rc522Drv* d, const uint8_t* regs, uint8_t* out, size_t n) {
+  if (!driverReady(d) || !regs || !out || n == 0 || n > RC522_FIFO_SIZE) return false;
+  // Adresse i émise pendant que la valeur i-1 est reçue; 0x00 termine la lecture
+  uint8_t tx[RC522_FIFO_SIZE + 1];
+  uint8_t rx[RC522_FIFO_SIZE + 1];
+  for (size_t i = 0; i < n; i++) tx[i] = RC522_SPI_READ(regs[i]);
+  tx[n] = 0x00;
+  if (!transfer(d, tx, rx, n + 1)) return false;
+  memcpy(out, rx + 1, n);
+  return true;
+}
+
+bool Rc522Drv_WriteFifo(Rc522Drv* d, const uint8_t* data, size_t n) {
+  if (!driverReady(d) || !data || n == 0 || n > RC522_FIFO_SIZE) return false;
+  uint8_t tx[RC522_FIFO_SIZE + 1];
+  tx[0] = RC522_SPI_WRITE(RC522_REG_FIFO_DATA);
+  memcpy(tx + 1, data, n);
+  return transfer(d, tx, nullptr, n + 1);
+}
+
+bool Rc522Drv_ReadFifo(Rc522Drv* d, uint8_t* out, size_t n) {
+  if (!driverReady(d) || !out || n == 0 || n > RC522_FIFO_SIZE) return false;
+  uint8_t tx[RC522_FIFO_SIZE + 1];
+  uint8_t rx[RC522_FIFO_SIZE + 1];
+  memset(tx, RC522_SPI_READ(RC522_REG_FIFO_DATA), n);
+  tx[n] = 0x00;
+  if (!transfer(d, tx, rx, n + 1)) return false;
+  memcpy(out, rx + 1, n);
+  return true;
+}
+
+bool Rc522Drv_CheckFifo(Rc522Drv* d) {
+  uint8_t pattern[RC522_FIFO_SIZE];
+  uint8_t back[RC522_FIFO_SIZE];
+  for (size_t i = 0; i < sizeof(pattern); i++) pattern[i] = (uint8_t)(0x5A + i * 37);
+  bool ok = Rc522Drv_WriteReg(d, RC522_REG_COMMAND, RC522_CMD_IDLE) &&
+            Rc522Drv_WriteReg(d, RC522_REG_FIFO_LEVEL, 0x80) &&
+            Rc522Drv_WriteFifo(d, pattern, sizeof(pattern)) &&
+            (Rc522Drv_ReadReg(d, RC522_REG_FIFO_LEVEL) & 0x7F) == sizeof(pattern) &&
+            Rc522Drv_ReadFifo(d, back, sizeof(back)) &&
+            memcmp(pattern, back, sizeof(back)) == 0;
+  Rc522Drv_WriteReg(d, RC522_REG_FIFO_LEVEL, 0x80);
+  return ok;
+}
+
+uint16_t Rc522Drv_CrcA(const uint8_t* data, size_t len) {
+  uint16_t crc = 0x6363;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t b = (uint8_t)(data[i] ^ (crc & 0xFF));
+    b = (uint8_t)(b ^ (b << 4));
+    crc = (uint16_t)((crc >> 8) ^ ((uint16_t)b << 8) ^ ((uint16_t)b << 3) ^ (b >> 4));
+  }
+  return crc;
+}
+
+// Commande Transceive ou Transmit. Scrutation: ComIrq, Error, FIFOLevel et Control en
+// une transaction, la réponse est lue dès RxIRq sans relire les registres d'état.
+static int exchange(Rc522Drv* d, uint8_t command, const uint8_t* tx, size_t txLen, uint8_t txLastBits,
+                    uint8_t rxAlign, uint8_t* rx, size_t rxMax, uint8_t* rxLastBits) {
+  if (!driverReady(d)) return RC522_ERR_IO;
+  if (!tx || txLen == 0 || txLen > RC522_FIFO_SIZE) return RC522_ERR_PROTOCOL;
+  uint8_t framing = (uint8_t)(((rxAlign & 0x07) << 4) | (txLastBits & 0x07));
+  bool ok = Rc522Drv_WriteReg(d, RC522_REG_COMMAND, RC522_CMD_IDLE) &&
+            Rc522Drv_WriteReg(d, RC522_REG_COM_IRQ, 0x7F) &&
+            Rc522Drv_WriteReg(d, RC522_REG_FIFO_LEVEL, 0x80) &&
+            Rc522Drv_WriteFifo(d, tx, txLen) &&
+            Rc522Drv_WriteReg(d, RC522_REG_BIT_FRAMING, framing) &&
+            Rc522Drv_WriteReg(d, RC522_REG_COMMAND, command);
+  if (ok && command == RC522_CMD_TRANSCEIVE) {
+    ok = Rc522Drv_WriteReg(d, RC522_REG_BIT_FRAMING, (uint8_t)(0x80 | framing));  // StartSend
+  }
+  if (!ok) return RC522_ERR_IO;
+
+  static const uint8_t statusRegs[4] = {
+    RC522_REG_COM_IRQ, RC522_REG_ERROR, RC522_REG_FIFO_LEVEL, RC522_REG_CONTROL
+  };
+  uint8_t status[4];
+  uint8_t doneIrq = command == RC522_CMD_TRANSMIT ? RC522_COM_TX_IRQ : (RC522_COM_RX_IRQ | RC522_COM_IDLE_IRQ);
+  uint32_t t0 = nowUs(d);
+  for (uint32_t polls = 0;; polls++) {
+    if (!Rc522Drv_ReadRegs(d, statusRegs, status, sizeof(status))) return RC522_ERR_IO;
+    if (status[0] & doneIrq) break;
+    if (status[0] & RC522_COM_TIMER_IRQ) return RC522_ERR_TIMEOUT;
+    if (d->t->micros ? (nowUs(d) - t0) > d->timeoutUs : polls >= RC522_DRV_MAX_POLLS) return RC522_ERR_TIMEOUT;
+  }
+  if (command == RC522_CMD_TRANSMIT) return 0;
+
+  if (status[1] & (RC522_ERRREG_BUFFER_OVFL | RC522_ERRREG_PARITY | RC522_ERRREG_PROTOCOL)) return RC522_ERR_PROTOCOL;
+  size_t n = status[2] & 0x7F;
+  if (rxLastBits) *rxLastBits = status[3] & 0x07;
+  if (n > rxMax) return RC522_ERR_NO_ROOM;
+  if (n > 0 && (!rx || !Rc522Drv_ReadFifo(d, rx, n))) return RC522_ERR_IO;
+  if (status[1] & RC522_ERRREG_COLL) return RC522_ERR_COLLISION;
+  return (int)n;
+}
+
+static int exchangeCrc(Rc522Drv* d, const uint8_t* cmd, size_t len, uint8_t* resp, size_t respMax) {
+  uint8_t frame[RC522_FIFO_SIZE];
+  uint8_t rx[RC522_FIFO_SIZE];
+  if (!cmd || len == 0 || len + 2 > sizeof(frame)) return RC522_ERR_PROTOCOL;
+  memcpy(frame, cmd, len);
+  uint16_t crc = Rc522Drv_CrcA(cmd, len);
+  frame[len] = (uint8_t)(crc & 0xFF);
+  frame[len + 1] = (uint8_t)(crc >> 8);
+
+  uint8_t lastBits = 0;
+  int n = exchange(d, RC522_CMD_TRANSCEIVE, frame, len + 2, 0, 0, rx, sizeof(rx), &lastBits);
+  if (n < 0) return n;
+  if (n == 1 && lastBits == 4) {
+    return (rx[0] & 0x0F) == 0x0A ? 0 : RC522_ERR_NAK;  // ACK / NAK sur 4 bits
+  }
+  if (n < 3 || lastBits != 0) return RC522_ERR_PROTOCOL;
+  crc = Rc522Drv_CrcA(rx, (size_t)n - 2);
+  if (rx[n - 2] != (uint8_t)(crc & 0xFF) || rx[n - 1] != (uint8_t)(crc >> 8)) return RC522_ERR_CRC;
+  size_t m = (size_t)n - 2;
+  if (m > respMax || (m > 0 && !resp)) return RC522_ERR_NO_ROOM;
+  memcpy(resp, rx, m);
+  return (int)m;
+}
+
+int Rc522Drv_Transceive(Rc522Drv* d, const uint8_t* tx, size_t txLen, uint8_t txLastBits, uint8_t rxAlign,
+                        uint8_t* rx, size_t rxMax, uint8_t* rxLastBits) {
+  if (!driverReady(d)) return RC522_ERR_IO;
+  OpMark m;
+  opBegin(d, &m);
+  int n = exchange(d, RC522_CMD_TRANSCEIVE, tx, txLen, txLastBits, rxAlign, rx, rxMax, rxLastBits);
+  return opEnd(d, RC522_OP_TRANSCEIVE, &m, n);
+}
+
+int Rc522Drv_TransceiveCrc(Rc522Drv* d, const uint8_t* cmd, size_t len, uint8_t* resp, size_t respMax) {
+  if (!driverReady(d)) return RC522_ERR_IO;
+  OpMark m;
+  opBegin(d, &m);
+  return opEnd(d, RC522_OP_TRANSCEIVE, &m, exchangeCrc(d, cmd, len, resp, respMax));
+}
+
+static int request(Rc522Drv* d, uint8_t cmd, uint8_t atqa[2]) {
+  if (!driverReady(d) || !atqa) return RC522_ERR_IO;
+  OpMark m;
+  opBegin(d, &m);
+  uint8_t lastBits = 0;
+  int n = exchange(d, RC522_CMD_TRANSCEIVE, &cmd, 1, 7, 0, atqa, 2, &lastBits);  // trame courte 7 bits
+  // Collision sur l'ATQA: plusieurs cartes, résolue par l'anticollision
+  if (n == RC522_ERR_COLLISION) return opEnd(d, RC522_OP_REQA, &m, RC522_OK);
+  if (n < 0) return opEnd(d, RC522_OP_REQA, &m, n);
+  return opEnd(d, RC522_OP_REQA, &m, (n == 2 && lastBits == 0) ? RC522_OK : RC522_ERR_PROTOCOL);
+}
+
+int Rc522Drv_RequestA(Rc522Drv* d, uint8_t atqa[2]) {
+  return request(d, RC522_PICC_REQA, atqa);
+}
+
+int Rc522Drv_WakeupA(Rc522Drv* d, uint8_t atqa[2]) {
+  return request(d, RC522_PICC_WUPA, atqa);
+}
+
+// Un niveau de cascade: anticollision (bits connus renvoyés, collision -> bit à 1) puis SELECT.
+// CollPos est compté depuis le premier bit du premier octet reçu, aligné (RxAlign) sur
+// l'octet du CLn en cours: position absolue = octets connus * 8 + CollPos.
+static int selectLevel(Rc522Drv* d, uint8_t sel, uint8_t cl[5], uint8_t* sak) {
+  uint8_t buf[7] = { sel, 0, 0, 0, 0, 0, 0 };  // SEL, NVB, UID CLn (4) + BCC
+  uint8_t rx[5];
+  uint8_t known = 0;                           // bits du CLn déjà connus
+  for (int guard = 0; known < 40; guard++) {
+    if (guard > 32) return RC522_ERR_PROTOCOL;
+    uint8_t bytes = known / 8;
+    uint8_t bits = known % 8;
+    buf[1] = (uint8_t)(((2 + bytes) << 4) | bits);
+    size_t txLen = 2 + bytes + (bits ? 1 : 0);
+    int n = exchange(d, RC522_CMD_TRANSCEIVE, buf, txLen, bits, bits, rx, sizeof(rx), nullptr);
+    if (n < 0 && n != RC522_ERR_COLLISION) return n;
+
+    uint8_t validBits = 40;
+    if (n == RC522_ERR_COLLISION) {
+      uint8_t coll = Rc522Drv_ReadReg(d, RC522_REG_COLL);
+      if (coll & RC522_COLL_POS_NOT_VALID) return RC522_ERR_COLLISION;
+      uint8_t pos = coll & 0x1F;
+      if (pos == 0) pos = 32;
+      validBits = (uint8_t)(bytes * 8 + pos);
+      if (validBits <= known || validBits > 40) return RC522_ERR_PROTOCOL;
+    } else if (n != 5 - (int)bytes) {
+      return RC522_ERR_PROTOCOL;
+    }
+
+    // Bits reçus fusionnés après les bits connus
+    uint8_t lastByte = (uint8_t)((validBits - 1) / 8);
+    for (uint8_t i = bytes; i <= lastByte; i++) {
+      uint8_t v = rx[i - bytes];
+      if (i == bytes && bits) v = (uint8_t)((buf[2 + i] & ((1 << bits) - 1)) | (v & ~((1 << bits) - 1)));
+      buf[2 + i] = v;
+    }
+    if (validBits < 40) {
+      // Collision: on choisit le bit à 1, les bits suivants sont inconnus
+      uint8_t bit = (uint8_t)((validBits - 1) % 8);
+      buf[2 + lastByte] = (uint8_t)((buf[2 + lastByte] & ((1 << bit) - 1)) | (1 << bit));
+    }
+    known = validBits;
+  }
+  if ((buf[2] ^ buf[3] ^ buf[4] ^ buf[5]) != buf[6]) return RC522_ERR_PROTOCOL;  // BCC
+
+  buf[1] = 0x70;  // NVB: 7 octets, SELECT
+  uint8_t sakBuf[1];
+  int n = exchangeCrc(d, buf, sizeof(buf), sakBuf, sizeof(sakBuf));
+  if (n < 0) return n;
+  if (n != 1) return RC522_ERR_PROTOCOL;
+  memcpy(cl, buf + 2, 5);
+  *sak = sakBuf[0];
+  return RC522_OK;
+}
+
+int Rc522Drv_Select(Rc522Drv* d, Rc522Uid* uid) {
+  if (!driverReady(d) || !uid) return RC522_ERR_IO;
+  static const uint8_t sels[3] = { RC522_PICC_SEL_CL1, RC522_PICC_SEL_CL2, RC522_PICC_SEL_CL3 };
+  OpMark m;
+  opBegin(d, &m);
+  uid->size = 0;
+  // ValuesAfterColl = 0: bits reçus après une collision remis à zéro
+  if (!Rc522Drv_WriteReg(d, RC522_REG_COLL, 0x00)) return opEnd(d, RC522_OP_SELECT, &m, RC522_ERR_IO);
+  for (int level = 0; level < 3; level++) {
+    uint8_t cl[5];
+    uint8_t sak = 0;
+    int r = selectLevel(d, sels[level], cl, &sak);
+    if (r < 0) return opEnd(d, RC522_OP_SELECT, &m, r);
+    if (sak & 0x04) {
+      // UID incomplet: CT + 3 octets, niveau suivant
+      if (cl[0] != RC522_PICC_CASCADE_TAG) return opEnd(d, RC522_OP_SELECT, &m, RC522_ERR_PROTOCOL);
+      memcpy(uid->bytes + uid->size, cl + 1, 3);
+      uid->size += 3;
+      continue;
+    }
+    memcpy(uid->bytes + uid->size, cl, 4);
+    uid->size += 4;
+    uid->sak = sak;
+    return opEnd(d, RC522_OP_SELECT, &m, RC522_OK);
+  }
+  return opEnd(d, RC522_OP_SELECT, &m, RC522_ERR_PROTOCOL);
+}
+
+int Rc522Drv_Read(Rc522Drv* d, uint8_t block, uint8_t out[16]) {
+  if (!driverReady(d) || !out) return RC522_ERR_IO;
+  OpMark m;
+  opBegin(d, &m);
+  uint8_t cmd[2] = { RC522_PICC_READ, block };
+  int n = exchangeCrc(d, cmd, sizeof(cmd), out, 16);
+  if (n >= 0 && n != 16) n = RC522_ERR_PROTOCOL;
+  return opEnd(d, RC522_OP_READ, &m, n < 0 ? n : RC522_OK);
+}
+
+int Rc522Drv_HaltA(Rc522Drv* d) {
+  if (!driverReady(d)) return RC522_ERR_IO;
+  OpMark m;
+  opBegin(d, &m);
+  uint8_t frame[4] = { RC522_PICC_HLTA, 0x00, 0, 0 };
+  uint16_t crc = Rc522Drv_CrcA(frame, 2);
+  frame[2] = (uint8_t)(crc & 0xFF);
+  frame[3] = (uint8_t)(crc >> 8);
+  // Pas de réponse en cas de succès: fin d'émission suffit
+  int r = exchange(d, RC522_CMD_TRANSMIT, frame, sizeof(frame), 0, 0, nullptr, 0, nullptr);
+  return opEnd(d, RC522_OP_HALT, &m, r);
+}
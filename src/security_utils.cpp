@@ -2,14 +2,27 @@
 #include <Arduino.h>
 #include <mbedtls/md.h>
 #include <mbedtls/aes.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/pkcs5.h>
+#include "cred_crypto.h"
+#include "char_class.h"
 
 // =============================================================================
 // VARIABLES GLOBALES DE SÉCURITÉ
 // =============================================================================
 
 static LogLevel currentLogLevel = DEFAULT_LOG_LEVEL;
-static unsigned long lastRateLimitCheck[10] = {0}; // Support 10 services différents
-static char rateLimitServices[10][10] = {"NFC", "UART", "HTTP", "WIFI", "QR", "", "", "", "", ""};
+// Seaux initialisés à la compilation, dans l'ordre de RateLimitId
+static RateLimiter rateLimiter = {
+    {
+        { NFC_SCAN_COOLDOWN_MS, NFC_SCAN_BURST },
+        { UART_COMMAND_COOLDOWN_MS, UART_COMMAND_BURST },
+        { HTTP_REQUEST_COOLDOWN_MS, HTTP_REQUEST_BURST },
+        { WIFI_SAVE_COOLDOWN_MS, WIFI_SAVE_BURST },
+    },
+    {}
+};
+static_assert(RATE_LIMIT_COUNT == 4, "rateLimiter: une règle par RateLimitId");
 
 // =============================================================================
 // GESTION DU NIVEAU DE LOG
@@ -40,6 +53,17 @@ String maskSensitiveData(const String& data, int visibleChars) {
     return masked;
 }
 
+size_t maskSensitiveDataTo(const char* data, size_t len, size_t visibleChars, char* out, size_t outSize) {
+    if (!out || outSize == 0) return 0;
+    if (!data) len = 0;
+    if (len >= outSize) len = outSize - 1;
+    size_t visible = (!MASK_SENSITIVE_DATA || len <= visibleChars) ? len : visibleChars;
+    memcpy(out, data, visible);
+    memset(out + visible, '*', len - visible);
+    out[len] = '\0';
+    return len;
+}
+
 String maskUID(const String& uid) {
     return maskSensitiveData(uid, UID_MASK_LENGTH);
 }
@@ -56,83 +80,54 @@ String maskPassword(const String& password) {
 // VALIDATION D'ENTRÉES SÉCURISÉE
 // =============================================================================
 
-bool isValidChar(char c, const char* allowedChars) {
-    if (!allowedChars) return false;
-    return strchr(allowedChars, c) != nullptr;
-}
-
-bool isValidString(const char* str, const char* allowedChars, size_t maxLength) {
-    if (!str || !allowedChars) return false;
-    
-    size_t len = strlen(str);
-    if (len == 0 || len > maxLength) return false;
-    
-    for (size_t i = 0; i < len; i++) {
-        if (!isValidChar(str[i], allowedChars)) {
-            return false;
-        }
-    }
-    return true;
-}
+// Classes générées à la compilation à partir des listes ALLOWED_*_CHARS (char_class.h)
+static constexpr CharClass SSID_CHARS = CharClass_FromChars(ALLOWED_SSID_CHARS);
+static constexpr CharClass URL_CHARS = CharClass_FromChars(ALLOWED_URL_CHARS);
+static constexpr CharClass NFC_CHARS = CharClass_FromChars(ALLOWED_NFC_CHARS);
 
 bool isValidUrl(const char* url) {
     if (!url) return false;
     
-    // Vérifier la longueur
-    if (strlen(url) > MAX_URL_LENGTH) return false;
-    
     // Vérifier le protocole
     if (strncmp(url, "http://", 7) != 0 && strncmp(url, "https://", 8) != 0) {
         return false;
     }
     
-    // Vérifier les caractères autorisés
-    return isValidString(url, ALLOWED_URL_CHARS, MAX_URL_LENGTH);
+    // Vérifier la longueur et les caractères autorisés en un seul parcours
+    return CharClass_Matches(&URL_CHARS, url, 1, MAX_URL_LENGTH);
 }
 
 bool isValidSSID(const char* ssid) {
-    if (!ssid) return false;
-    return isValidString(ssid, ALLOWED_SSID_CHARS, MAX_SSID_LENGTH);
+    return CharClass_Matches(&SSID_CHARS, ssid, 1, MAX_SSID_LENGTH);
 }
 
 bool isValidNFCData(const char* data) {
-    if (!data) return false;
-    return isValidString(data, ALLOWED_NFC_CHARS, MAX_NFC_DATA_LENGTH);
+    return CharClass_Matches(&NFC_CHARS, data, 1, MAX_NFC_DATA_LENGTH);
 }
 
 // =============================================================================
 // RATE LIMITING
 // =============================================================================
 
-int findServiceIndex(const char* serviceName) {
-    for (int i = 0; i < 10; i++) {
-        if (strcmp(rateLimitServices[i], serviceName) == 0) {
-            return i;
-        }
-        if (strlen(rateLimitServices[i]) == 0) {
-            // Slot libre, l'assigner
-            strncpy((char*)rateLimitServices[i], serviceName, 9);
-            rateLimitServices[i][9] = '\0';
-            return i;
-        }
+bool rateLimitCheck(RateLimitId id) {
+    if (RateLimit_TryAcquire(&rateLimiter, id, millis())) {
+        return true;
     }
-    return -1; // Pas de slot libre
+    SECURE_LOG_ERROR("RATE", "Rate limit exceeded for %s (%lu rejected)",
+                     RateLimit_Name(id), (unsigned long)RateLimit_Rejected(&rateLimiter, id));
+    return false;
 }
 
-bool rateLimitCheck(const char* service, unsigned long cooldownMs) {
-    if (!service) return false;
-    
-    int index = findServiceIndex(service);
-    if (index < 0) return false; // Pas de slot disponible
-    
-    unsigned long now = millis();
-    if (now - lastRateLimitCheck[index] < cooldownMs) {
-        SECURE_LOG_ERROR("RATE", "Rate limit exceeded for %s", service);
-        return false;
+void rateLimitDebugInfo() {
+    for (int i = 0; i < RATE_LIMIT_COUNT; i++) {
+        RateLimitId id = (RateLimitId)i;
+        Serial.printf("[RATE] %-4s %lu/%lu ms, accepted=%lu, rejected=%lu\n",
+                      RateLimit_Name(id),
+                      (unsigned long)rateLimiter.rules[i].burst,
+                      (unsigned long)rateLimiter.rules[i].intervalMs,
+                      (unsigned long)RateLimit_Accepted(&rateLimiter, id),
+                      (unsigned long)RateLimit_Rejected(&rateLimiter, id));
     }
-    
-    lastRateLimitCheck[index] = now;
-    return true;
 }
 
 // =============================================================================
@@ -182,55 +177,7 @@ bool deriveKey(const char* password, const char* salt, uint8_t* key, size_t keyL
     return true;
 }
 
-// Chiffrement AES simple
-bool encryptData(const char* plaintext, const uint8_t* key, char* ciphertext, size_t maxLen) {
-    if (!plaintext || !key || !ciphertext) return false;
-    
-    mbedtls_aes_context aes;
-    mbedtls_aes_init(&aes);
-    
-    if (mbedtls_aes_setkey_enc(&aes, key, 256) != 0) {
-        mbedtls_aes_free(&aes);
-        return false;
-    }
-    
-    size_t len = strlen(plaintext);
-    if (len + 16 > maxLen) { // AES block size
-        mbedtls_aes_free(&aes);
-        return false;
-    }
-    
-    // Padding simple (PKCS7)
-    uint8_t padded[256];
-    memcpy(padded, plaintext, len);
-    uint8_t padValue = 16 - (len % 16);
-    for (int i = 0; i < padValue; i++) {
-        padded[len + i] = padValue;
-    }
-    len += padValue;
-    
-    // Chiffrer par blocs de 16 bytes
-    for (size_t i = 0; i < len; i += 16) {
-        if (mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, 
-                                  padded + i, (uint8_t*)ciphertext + i) != 0) {
-            mbedtls_aes_free(&aes);
-            return false;
-        }
-    }
-    
-    mbedtls_aes_free(&aes);
-    
-    // Convertir en hex pour stockage
-    char* hex = ciphertext;
-    for (size_t i = 0; i < len && (i * 2 + 1) < maxLen; i++) {
-        sprintf(hex + i * 2, "%02x", (uint8_t)ciphertext[i]);
-    }
-    hex[len * 2] = '\0';
-    
-    return true;
-}
-
-// Déchiffrement AES simple
+// Déchiffrement de l'ancien format (AES-ECB en hexadécimal), migration seulement
 bool decryptData(const char* ciphertext, const uint8_t* key, char* plaintext, size_t maxLen) {
     if (!ciphertext || !key || !plaintext) return false;
     
@@ -243,19 +190,13 @@ bool decryptData(const char* ciphertext, const uint8_t* key, char* plaintext, si
     }
     
     // Convertir hex vers bytes
-    size_t hexLen = strlen(ciphertext);
-    if (hexLen % 2 != 0 || hexLen > 512) {
+    uint8_t encrypted[256];
+    size_t encLen;
+    if (!CredBlob_HexDecode(ciphertext, encrypted, sizeof(encrypted), &encLen) || encLen % 16 != 0) {
         mbedtls_aes_free(&aes);
         return false;
     }
     
-    uint8_t encrypted[256];
-    size_t encLen = hexLen / 2;
-    
-    for (size_t i = 0; i < encLen; i++) {
-        sscanf(ciphertext + i * 2, "%2hhx", &encrypted[i]);
-    }
-    
     // Déchiffrer par blocs
     uint8_t decrypted[256];
     for (size_t i = 0; i < encLen; i += 16) {
@@ -286,6 +227,173 @@ bool decryptData(const char* ciphertext, const uint8_t* key, char* plaintext, si
     return true;
 }
 
+// =============================================================================
+// CREDENTIALS WI-FI (PBKDF2 + HKDF + AES-256-GCM)
+// =============================================================================
+
+// mbedtls passe par les accélérateurs SHA et AES de l'ESP32 (CONFIG_MBEDTLS_HARDWARE_*).
+// Appelé depuis la tâche Wi-Fi seulement (chargement, portail): pas de verrou.
+static uint8_t credMasterKey[CRED_KEY_SIZE];
+static bool credMasterReady = false;
+static CredCryptoStats credStats;
+
+bool credKeyInit() {
+    if (credMasterReady) return true;
+    uint64_t mac = ESP.getEfuseMac();
+    uint8_t secret[6];
+    for (int i = 0; i < 6; i++) {
+        secret[i] = (uint8_t)(mac >> (8 * i));
+    }
+    
+    uint32_t start = micros();
+    mbedtls_md_context_t ctx;
+    mbedtls_md_init(&ctx);
+    const mbedtls_md_info_t* info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    bool ok = info && mbedtls_md_setup(&ctx, info, 1) == 0 &&
+              mbedtls_pkcs5_pbkdf2_hmac(&ctx, secret, sizeof(secret),
+                                        (const uint8_t*)PASSWORD_SALT, strlen(PASSWORD_SALT),
+                                        CRED_PBKDF2_ITERATIONS, sizeof(credMasterKey), credMasterKey) == 0;
+    mbedtls_md_free(&ctx);
+    SECURE_ZERO(secret, sizeof(secret));
+    if (!ok) {
+        SECURE_ZERO(credMasterKey, sizeof(credMasterKey));
+        SECURE_LOG_ERROR("SEC", "Credential master key derivation failed");
+        return false;
+    }
+    credStats.masterKeyUs = micros() - start;
+    credMasterReady = true;
+    return true;
+}
+
+// HKDF-Expand (RFC 5869) sur un seul bloc: T(1) = HMAC(clé maître, "dpm-wifi:" | SSID | 0x01).
+// La clé maître sort de PBKDF2 (déjà uniforme): pas d'étape Extract.
+static bool credNetworkKey(const char* ssid, uint8_t* key) {
+    if (!credKeyInit()) return false;
+    uint32_t start = micros();
+    static const char prefix[] = "dpm-wifi:";
+    uint8_t label[sizeof(prefix) + 33];
+    size_t ssidLen = strnlen(ssid, 32);
+    memcpy(label, prefix, sizeof(prefix) - 1);
+    memcpy(label + sizeof(prefix) - 1, ssid, ssidLen);
+    size_t len = sizeof(prefix) - 1 + ssidLen;
+    label[len++] = 0x01;
+    bool ok = mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), credMasterKey, sizeof(credMasterKey),
+                              label, len, key) == 0;
+    credStats.lastKeyUs = micros() - start;
+    return ok;
+}
+
+bool credEncrypt(const char* ssid, const char* password, uint8_t* blob, size_t maxLen, size_t* outLen) {
+    if (!ssid || !password || !blob || !outLen) return false;
+    size_t passLen = strlen(password);
+    uint8_t format = (WIFI_CREDS_ENCRYPTION_ENABLED && passLen > 0) ? CRED_FORMAT_AES_GCM : CRED_FORMAT_PLAIN;
+    CredBlob view;
+    size_t size = CredBlob_Layout(blob, maxLen, format, passLen, &view);
+    if (size == 0) return false;
+    
+    if (format == CRED_FORMAT_PLAIN) {
+        memcpy(view.data, password, passLen);
+        *outLen = size;
+        return true;
+    }
+    
+    uint8_t key[CRED_KEY_SIZE];
+    if (!credNetworkKey(ssid, key)) return false;
+    
+    // Nonce aléatoire (générateur matériel, radio active pendant le portail)
+    esp_fill_random(view.nonce, CRED_NONCE_SIZE);
+    uint32_t start = micros();
+    mbedtls_gcm_context gcm;
+    mbedtls_gcm_init(&gcm);
+    bool ok = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, CRED_KEY_SIZE * 8) == 0 &&
+              mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, passLen, view.nonce, CRED_NONCE_SIZE,
+                                        (const uint8_t*)ssid, strlen(ssid), (const uint8_t*)password,
+                                        view.data, CRED_TAG_SIZE, view.tag) == 0;
+    mbedtls_gcm_free(&gcm);
+    credStats.lastCipherUs = micros() - start;
+    credStats.encrypts++;
+    SECURE_ZERO(key, sizeof(key));
+    
+    if (ok) *outLen = size;
+    return ok;
+}
+
+bool credDecrypt(const char* ssid, uint8_t* blob, size_t len, char* password, size_t maxLen) {
+    if (!ssid || !blob || !password) return false;
+    CredBlob view;
+    if (!CredBlob_Parse(blob, len, &view) || view.dataLen >= maxLen) return false;
+    
+    if (view.format == CRED_FORMAT_PLAIN) {
+        memcpy(password, view.data, view.dataLen);
+        password[view.dataLen] = '\0';
+        return true;
+    }
+    
+    uint8_t key[CRED_KEY_SIZE];
+    if (!credNetworkKey(ssid, key)) return false;
+    
+    uint32_t start = micros();
+    mbedtls_gcm_context gcm;
+    mbedtls_gcm_init(&gcm);
+    int rc = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, CRED_KEY_SIZE * 8);
+    if (rc == 0) {
+        rc = mbedtls_gcm_auth_decrypt(&gcm, view.dataLen, view.nonce, CRED_NONCE_SIZE,
+                                      (const uint8_t*)ssid, strlen(ssid), view.tag, CRED_TAG_SIZE,
+                                      view.data, (uint8_t*)password);
+    }
+    mbedtls_gcm_free(&gcm);
+    credStats.lastCipherUs = micros() - start;
+    credStats.decrypts++;
+    SECURE_ZERO(key, sizeof(key));
+    
+    if (rc != 0) {
+        if (rc == MBEDTLS_ERR_GCM_AUTH_FAILED) credStats.authFailures++;
+        SECURE_ZERO(password, maxLen);
+        return false;
+    }
+    password[view.dataLen] = '\0';
+    return true;
+}
+
+const CredCryptoStats* credCryptoStats() {
+    return &credStats;
+}
+
+// Chemin complet d'un mot de passe de 63 caractères: ancienne dérivation (1000 SHA-256
+// chaînés à chaque chargement) contre clé réseau + GCM. Clé maître comptée à part (une fois).
+void credBenchmark() {
+    static const char ssid[] = "DPM-BENCH";
+    char password[CRED_PASS_MAX];
+    memset(password, 'p', 63);
+    password[63] = '\0';
+    uint8_t key[NVS_ENCRYPTION_KEY_SIZE];
+    uint8_t blob[CRED_BLOB_MAX];
+    char plain[CRED_PASS_MAX];
+    size_t len = 0;
+    
+    uint32_t start = micros();
+    bool ok = deriveKey(PASSWORD_SALT, ssid, key, sizeof(key));
+    uint32_t legacyUs = micros() - start;
+    
+    ok = ok && credKeyInit();
+    CredCryptoStats saved = credStats;      // compteurs réels non affectés par la mesure
+    start = micros();
+    ok = ok && credEncrypt(ssid, password, blob, sizeof(blob), &len);
+    uint32_t encryptUs = micros() - start;
+    start = micros();
+    ok = ok && credDecrypt(ssid, blob, len, plain, sizeof(plain)) && strcmp(plain, password) == 0;
+    uint32_t decryptUs = micros() - start;
+    
+    Serial.printf("[SEC] Credential bench %s: legacy derive=%lu us, master key (PBKDF2 x%d, once)=%lu us, "
+                  "encrypt=%lu us, decrypt=%lu us (key %lu us + GCM %lu us), blob=%u bytes\n",
+                  ok ? "ok" : "FAILED", (unsigned long)legacyUs, CRED_PBKDF2_ITERATIONS,
+                  (unsigned long)credStats.masterKeyUs, (unsigned long)encryptUs, (unsigned long)decryptUs,
+                  (unsigned long)credStats.lastKeyUs, (unsigned long)credStats.lastCipherUs, (unsigned)len);
+    credStats = saved;
+    SECURE_ZERO(key, sizeof(key));
+    SECURE_ZERO(plain, sizeof(plain));
+}
+
 // =============================================================================
 // MONITORING ET DIAGNOSTICS
 // =============================================================================
@@ -304,8 +412,9 @@ void checkSystemSecurity() {
     
     // Vérifier les stack overflows (basique)
     if (uxTaskGetStackHighWaterMark(NULL) < 512) {
-        SECURE_LOG_ERROR("SEC", "Stack overflow risk detected");
-        logSecurityEvent("STACK_RISK", "Low stack space");
+        // Moins de 512 octets de pile: ni formatage ni logSecurityEvent, écriture synchrone d'une
+        // chaîne fixe (la tâche risque de ne pas survivre jusqu'au passage de la tâche de journal)
+        LogService_PanicWrite("[ERR][SEC] Security event: STACK_RISK - Low stack space\n");
     }
 }
 
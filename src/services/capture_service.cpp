@@ -0,0 +1,104 @@
+#include "services/capture_service.h"
+#include "config.h"
+#include "security_config.h"
+#include "services/log_service.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <esp_heap_caps.h>
+
+static UartCapture capture;
+static SemaphoreHandle_t captureMutex = nullptr;
+static volatile bool captureActive = false;
+static bool captureInPsram = false;
+
+static bool allocateBuffer() {
+  if (capture.data) return true;
+  size_t size = UART_CAPTURE_PSRAM_BYTES;
+  uint8_t* buf = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  captureInPsram = (buf != nullptr);
+  if (!buf) {
+    // Pas de PSRAM: buffer réduit en RAM interne
+    size = UART_CAPTURE_INTERNAL_BYTES;
+    buf = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+  }
+  if (!buf) return false;
+  UartCapture_Init(&capture, buf, size);
+  return true;
+}
+
+bool CaptureService_Start() {
+#if UART_CAPTURE_ENABLED
+  if (!captureMutex) captureMutex = xSemaphoreCreateMutex();
+  if (!captureMutex) return false;
+  xSemaphoreTake(captureMutex, portMAX_DELAY);
+  bool ok = allocateBuffer();
+  xSemaphoreGive(captureMutex);
+  if (!ok) {
+    SECURE_LOG_ERROR("CAP", "Capture buffer allocation failed");
+    return false;
+  }
+  captureActive = true;
+  SECURE_LOG_INFO("CAP", "Capture started (%u bytes, %s)", (unsigned)capture.capacity, captureInPsram ? "PSRAM" : "internal RAM");
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CaptureService_Stop() {
+  captureActive = false;
+}
+
+bool CaptureService_IsActive() {
+  return captureActive;
+}
+
+void CaptureService_Clear() {
+  if (!captureMutex) return;
+  xSemaphoreTake(captureMutex, portMAX_DELAY);
+  UartCapture_Clear(&capture);
+  xSemaphoreGive(captureMutex);
+}
+
+void CaptureService_Record(UartCaptureChannel channel, UartCaptureDir dir, const uint8_t* data, size_t len) {
+  if (!captureActive) return;
+  xSemaphoreTake(captureMutex, portMAX_DELAY);
+  UartCapture_Record(&capture, (uint8_t)channel, (uint8_t)dir, millis(), data, len);
+  xSemaphoreGive(captureMutex);
+}
+
+static void writeConsole(void* ctx, const uint8_t* data, size_t len) {
+  (void)ctx;
+  Serial.write(data, len);
+}
+
+void CaptureService_Dump() {
+  if (!captureMutex || !capture.data) {
+    Serial.println("[CAP] No capture");
+    return;
+  }
+  // Enregistrement suspendu pendant le vidage (buffer figé)
+  bool wasActive = captureActive;
+  captureActive = false;
+  xSemaphoreTake(captureMutex, portMAX_DELAY);
+  // Console réservée: aucune ligne de journal au milieu des octets binaires
+  LogService_LockConsole();
+  Serial.flush();
+  Serial.printf("[CAP] DUMP %u\n", (unsigned)UartCapture_DumpSize(&capture));
+  UartCapture_Dump(&capture, writeConsole, nullptr);
+  Serial.print("\n[CAP] END\n");
+  LogService_UnlockConsole();
+  xSemaphoreGive(captureMutex);
+  captureActive = wasActive;
+}
+
+void CaptureService_DebugInfo() {
+  Serial.printf("[CAP] %s, Buffer=%u/%u bytes (%s), Records=%lu, Captured=%lu bytes, Dropped=%lu\n",
+                captureActive ? "ON" : "OFF",
+                (unsigned)capture.used,
+                (unsigned)capture.capacity,
+                captureInPsram ? "PSRAM" : "internal",
+                (unsigned long)capture.records,
+                (unsigned long)capture.bytesCaptured,
+                (unsigned long)capture.dropped);
+}
@@ -59,7 +59,7 @@ static void httpTask(void* pv) {
     }
     
     // Rate limiting
-    if (!rateLimitCheck("HTTP", HTTP_REQUEST_COOLDOWN_MS)) {
+    if (!rateLimitCheck(RATE_LIMIT_HTTP)) {
       SECURE_LOG_ERROR("HTTP", "Request rate limited");
       continue;
     }
@@ -83,6 +83,7 @@ static void httpTask(void* pv) {
     
     // Monitoring sécurité avant la requête
     checkSystemSecurity();
+    uint32_t requestStartMs = millis();
     
     if (req.method == HTTP_METHOD_GET) {
       SECURE_LOG_INFO("HTTP", "GET request to %s", maskSensitiveData(String(req.url), 30).c_str());
@@ -150,10 +151,12 @@ static void httpTask(void* pv) {
     if (req.responseQueue) {
       xQueueSend(req.responseQueue, &resp, 0);
     } else {
+      // Réponse d'une commande CLI: corps complet, en synchrone
       Serial.printf("[HTTP] Status=%d Len=%d\n", resp.statusCode, resp.contentLength);
       if (resp.contentLength > 0) Serial.println(resp.payload);
     }
-    (void)ok;
+    // Latence par mode d'énergie Wi-Fi (modem sleep ou radio éveillée)
+    if (ok) WifiService_RecordRequestLatency(millis() - requestStartMs);
   }
 }
 
@@ -201,8 +204,8 @@ bool HttpService_ValidateQRToken(const char* qrToken, QueueHandle_t responseQueu
   // URL de l'endpoint de validation depuis la configuration
   String validationUrl = EnvConfig::GetValidateTokenUrl();
   
-  Serial.printf("[HTTP] Validation QR token: %s\n", qrToken);
-  Serial.printf("[HTTP] Using endpoint: %s\n", validationUrl.c_str());
+  LOG_PRINTF("[HTTP] Validation QR token: %s\n", qrToken);
+  LOG_PRINTF("[HTTP] Using endpoint: %s\n", validationUrl.c_str());
   
   return HttpService_Post(validationUrl.c_str(), "application/json", jsonBody, responseQueue, timeoutMs);
 }
@@ -213,8 +216,8 @@ bool HttpService_UpdateStock(const char* stockData, QueueHandle_t responseQueue,
   // URL de l'endpoint de mise à jour du stock depuis la configuration
   String stockUrl = EnvConfig::GetStockUpdateUrl();
   
-  Serial.printf("[HTTP] Updating stock with data: %s\n", stockData);
-  Serial.printf("[HTTP] Using endpoint: %s\n", stockUrl.c_str());
+  LOG_PRINTF("[HTTP] Updating stock with data: %s\n", stockData);
+  LOG_PRINTF("[HTTP] Using endpoint: %s\n", stockUrl.c_str());
   
   return HttpService_Post(stockUrl.c_str(), "application/json", stockData, responseQueue, timeoutMs);
 }
@@ -229,8 +232,8 @@ bool HttpService_UpdateOrderStatus(const char* orderId, const char* newStatus, Q
   // URL de l'endpoint de mise à jour du statut depuis la configuration
   String statusUrl = EnvConfig::GetOrderStatusUrl();
   
-  Serial.printf("[HTTP] Updating order %s status to: %s\n", orderId, newStatus);
-  Serial.printf("[HTTP] Using endpoint: %s\n", statusUrl.c_str());
+  LOG_PRINTF("[HTTP] Updating order %s status to: %s\n", orderId, newStatus);
+  LOG_PRINTF("[HTTP] Using endpoint: %s\n", statusUrl.c_str());
   
   return HttpService_Post(statusUrl.c_str(), "application/json", jsonBody, responseQueue, timeoutMs);
 }
@@ -247,10 +250,10 @@ bool HttpService_ConfirmDelivery(const char* orderId, const char* machineId, con
   // URL de l'endpoint de confirmation de livraison depuis la configuration
   String deliveryUrl = EnvConfig::GetDeliveryConfirmUrl();
   
-  Serial.printf("[HTTP] Confirming delivery for order: %s\n", orderId);
-  Serial.printf("[HTTP] Machine: %s, Timestamp: %s\n", machineId, timestamp);
-  Serial.printf("[HTTP] Items delivered: %s\n", itemsDeliveredJson);
-  Serial.printf("[HTTP] Using endpoint: %s\n", deliveryUrl.c_str());
+  LOG_PRINTF("[HTTP] Confirming delivery for order: %s\n", orderId);
+  LOG_PRINTF("[HTTP] Machine: %s, Timestamp: %s\n", machineId, timestamp);
+  LOG_PRINTF("[HTTP] Items delivered: %s\n", itemsDeliveredJson);
+  LOG_PRINTF("[HTTP] Using endpoint: %s\n", deliveryUrl.c_str());
   
   return HttpService_Post(deliveryUrl.c_str(), "application/json", jsonBody, responseQueue, timeoutMs);
 }
@@ -267,9 +270,9 @@ bool HttpService_UpdateQuantities(const char* machineId, const char* productId,
   // URL de l'endpoint de mise à jour des quantités depuis la configuration
   String quantitiesUrl = EnvConfig::GetUpdateQuantitiesUrl();
   
-  Serial.printf("[HTTP] Updating quantities for product: %s\n", productId);
-  Serial.printf("[HTTP] Machine: %s, Slot: %d, Quantity: %d\n", machineId, slotNumber, quantity);
-  Serial.printf("[HTTP] Using endpoint: %s\n", quantitiesUrl.c_str());
+  LOG_PRINTF("[HTTP] Updating quantities for product: %s\n", productId);
+  LOG_PRINTF("[HTTP] Machine: %s, Slot: %d, Quantity: %d\n", machineId, slotNumber, quantity);
+  LOG_PRINTF("[HTTP] Using endpoint: %s\n", quantitiesUrl.c_str());
   
   return HttpService_Post(quantitiesUrl.c_str(), "application/json", jsonBody, responseQueue, timeoutMs);
 }
@@ -0,0 +1,95 @@
+#include "services/log_service.h"
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <esp_system.h>
+
+static LogRing logRing;
+static TaskHandle_t logTaskHandle = nullptr;
+static SemaphoreHandle_t consoleMutex = nullptr;
+static volatile bool logRunning = false;
+static uint32_t reportedDrops = 0;
+static uint32_t maxLatencyMs = 0;   // attente maximale d'un message dans la file
+
+// Consommateur unique: appelé mutex console pris
+static void drainLocked() {
+  static LogRecord rec;
+  static char line[LOG_LINE_MAX];
+  while (LogRing_Pop(&logRing, &rec)) {
+    uint32_t latency = millis() - rec.timeMs;
+    if (latency > maxLatencyMs) maxLatencyMs = latency;
+    size_t len = LogRing_Format(&rec, line, sizeof(line));
+    Serial.write((const uint8_t*)line, len);
+  }
+  uint32_t dropped = LogRing_Dropped(&logRing);
+  if (dropped != reportedDrops) {
+    Serial.printf("[LOG] %lu message(s) perdu(s)\n", (unsigned long)(dropped - reportedDrops));
+    reportedDrops = dropped;
+  }
+}
+
+static void logTask(void* pv) {
+  (void)pv;
+  for (;;) {
+    xSemaphoreTake(consoleMutex, portMAX_DELAY);
+    drainLocked();
+    xSemaphoreGive(consoleMutex);
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+  }
+}
+
+void LogService_Init() {
+  if (logTaskHandle) return;
+  LogRing_Init(&logRing);
+  if (!consoleMutex) consoleMutex = xSemaphoreCreateMutex();
+  if (!consoleMutex) return;
+  if (xTaskCreate(logTask, "log_service", LOG_TASK_STACK_SIZE, nullptr, LOG_TASK_PRIORITY, &logTaskHandle) != pdPASS) {
+    logTaskHandle = nullptr;
+    return;
+  }
+  // Messages encore en file écrits avant esp_restart()
+  esp_register_shutdown_handler(LogService_Flush);
+  logRunning = true;
+}
+
+bool LogService_IsRunning() {
+  return logRunning;
+}
+
+LogRing* LogService_Ring() {
+  return &logRing;
+}
+
+void LogService_Flush() {
+  if (!logRunning) return;
+  // Attente bornée: la tâche qui détient la console peut être celle qui a planté
+  if (xSemaphoreTake(consoleMutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+  drainLocked();
+  Serial.flush();
+  xSemaphoreGive(consoleMutex);
+}
+
+void LogService_PanicWrite(const char* msg) {
+  if (!msg) return;
+  bool locked = consoleMutex && xSemaphoreTake(consoleMutex, 0) == pdTRUE;
+  if (locked && logRunning) drainLocked();
+  Serial.write((const uint8_t*)msg, strlen(msg));
+  Serial.flush();
+  if (locked) xSemaphoreGive(consoleMutex);
+}
+
+void LogService_LockConsole() {
+  if (consoleMutex) xSemaphoreTake(consoleMutex, portMAX_DELAY);
+}
+
+void LogService_UnlockConsole() {
+  if (consoleMutex) xSemaphoreGive(consoleMutex);
+}
+
+void LogService_DebugInfo() {
+  Serial.printf("[LOG] %s, Written=%lu, Dropped=%lu, Max latency=%lu ms\n",
+                logRunning ? "async" : "sync",
+                (unsigned long)LogRing_Written(&logRing),
+                (unsigned long)LogRing_Dropped(&logRing),
+                (unsigned long)maxLatencyMs);
+}
@@ -0,0 +1,292 @@
+#include "services/nfc_auth.h"
+#include "services/http_service.h"
+#include "services/wifi_service.h"
+#include "config.h"
+#include "env_config.h"
+#include "security_config.h"
+#include "freertos/semphr.h"
+#include <esp_partition.h>
+
+// Partition coupée en deux emplacements: l'index courant est lu dans l'un pendant
+// que la fusion du delta écrit l'autre. Échange sous mutex une fois l'image vérifiée.
+static const esp_partition_t* partition = nullptr;
+static const uint8_t* mapped = nullptr;
+static spi_flash_mmap_handle_t mapHandle;
+static uint32_t slotSize = 0;
+
+static SemaphoreHandle_t indexMutex = nullptr;
+static NfcAuthIndex active;          // écrit par la tâche orchestrateur sous indexMutex
+static int activeSlot = -1;
+
+// Emplacement cible: secteurs effacés d'avance au repos, sinon à la première écriture
+typedef struct {
+  uint32_t base;
+  uint32_t erasedEnd;
+} SlotWriter;
+
+static SlotWriter writer;
+
+// Session de synchronisation (une page HTTP à la fois)
+static QueueHandle_t responseQueue = nullptr;
+static HttpResponse response;        // hors pile de la tâche orchestrateur
+static NfcAuthMerge merge;
+static bool mergeOpen = false;
+static bool requestPending = false;
+static uint32_t sessionFrom = 0;
+static uint32_t sessionTo = 0;
+static uint32_t requestMs = 0;
+static uint64_t requestAfter = 0;    // curseur envoyé, renvoyé dans l'en-tête de la page
+static bool requestHasAfter = false;
+static uint32_t nextRequestMs = 0;
+
+typedef struct {
+  uint32_t lookups;
+  uint32_t lastLookupUs;
+  uint32_t maxLookupUs;
+  uint32_t syncs;                    // images écrites
+  uint32_t pages;
+  uint32_t failures;
+  uint32_t lastSyncMs;               // première page -> échange
+  uint32_t sessionStartMs;
+} NfcAuthStats;
+
+static NfcAuthStats stats;
+
+static uint32_t sectorAlign(uint32_t n) {
+  return (n + SPI_FLASH_SEC_SIZE - 1) & ~(uint32_t)(SPI_FLASH_SEC_SIZE - 1);
+}
+
+static bool slotWrite(void* ctx, uint32_t offset, const uint8_t* data, size_t len) {
+  SlotWriter* w = (SlotWriter*)ctx;
+  uint32_t end = offset + (uint32_t)len;
+  if (end > w->erasedEnd) {
+    uint32_t eraseEnd = sectorAlign(end);
+    if (esp_partition_erase_range(partition, w->base + w->erasedEnd, eraseEnd - w->erasedEnd) != ESP_OK) {
+      return false;
+    }
+    w->erasedEnd = eraseEnd;
+  }
+  return esp_partition_write(partition, w->base + offset, data, len) == ESP_OK;
+}
+
+static void resetWriter() {
+  int target = activeSlot == 0 ? 1 : 0;
+  writer.base = (uint32_t)target * slotSize;
+  writer.erasedEnd = 0;
+}
+
+bool NfcAuth_Init() {
+  if (!indexMutex) indexMutex = xSemaphoreCreateMutex();
+  NfcAuthIndex_Clear(&active);
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, NFC_AUTH_PARTITION_LABEL);
+  if (!partition) {
+    Serial.println("[NFCAUTH] Partition " NFC_AUTH_PARTITION_LABEL " not found, local authorization disabled");
+    return false;
+  }
+  const void* ptr = nullptr;
+  esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &ptr, &mapHandle);
+  if (err != ESP_OK) {
+    Serial.printf("[NFCAUTH] mmap failed: %s\n", esp_err_to_name(err));
+    partition = nullptr;
+    return false;
+  }
+  mapped = (const uint8_t*)ptr;
+  slotSize = (partition->size / 2) & ~(uint32_t)(SPI_FLASH_SEC_SIZE - 1);
+
+  // Image complète (CRC) de génération la plus haute; une écriture interrompue est ignorée
+  for (int slot = 0; slot < 2; slot++) {
+    NfcAuthIndex idx;
+    if (!NfcAuthIndex_Open(&idx, mapped + slot * slotSize, slotSize, true)) continue;
+    if (activeSlot < 0 || idx.generation > active.generation) {
+      active = idx;
+      activeSlot = slot;
+    }
+  }
+  resetWriter();
+  responseQueue = xQueueCreate(1, sizeof(HttpResponse));
+  Serial.printf("[NFCAUTH] %lu KB per slot (%lu cards max), index %s\n",
+                (unsigned long)(slotSize / 1024),
+                (unsigned long)NfcAuthIndex_Capacity(slotSize),
+                activeSlot < 0 ? "empty" : "loaded");
+  if (activeSlot >= 0) {
+    Serial.printf("[NFCAUTH] Slot %c: version %lu, %lu cards\n",
+                  'A' + activeSlot, (unsigned long)active.version, (unsigned long)active.count);
+  }
+  return true;
+}
+
+bool NfcAuth_IsLoaded() {
+  return active.version > 0;
+}
+
+int NfcAuth_Lookup(const uint8_t* uid, size_t uidLen) {
+  if (!indexMutex) return NFC_AUTH_ABSENT;
+  uint32_t t0 = micros();
+  uint64_t hash = NfcAuthIndex_HashUid(uid, uidLen);
+  xSemaphoreTake(indexMutex, portMAX_DELAY);
+  int flags = NfcAuthIndex_Lookup(&active, hash);
+  xSemaphoreGive(indexMutex);
+  uint32_t us = micros() - t0;
+  stats.lookups++;
+  stats.lastLookupUs = us;
+  if (us > stats.maxLookupUs) stats.maxLookupUs = us;
+  return flags;
+}
+
+static void endSession(bool failed, const char* reason) {
+  if (failed) {
+    stats.failures++;
+    Serial.printf("[NFCAUTH] Sync aborted: %s\n", reason);
+  }
+  // Emplacement cible partiellement écrit: réeffacé avant la prochaine image
+  if (mergeOpen) resetWriter();
+  mergeOpen = false;
+  nextRequestMs = millis() + (failed ? NFC_AUTH_RETRY_MS : NFC_AUTH_SYNC_INTERVAL_MS);
+}
+
+// Nouvelle image vérifiée puis publiée; l'ancienne devient l'emplacement cible
+static void commitSession() {
+  uint32_t generation = activeSlot < 0 ? 1 : active.generation + 1;
+  if (!NfcAuthMerge_Finish(&merge, generation, sessionTo)) {
+    endSession(true, "flash write");
+    return;
+  }
+  int target = activeSlot == 0 ? 1 : 0;
+  NfcAuthIndex next;
+  if (!NfcAuthIndex_Open(&next, mapped + target * slotSize, slotSize, true)) {
+    endSession(true, "image check");
+    return;
+  }
+  xSemaphoreTake(indexMutex, portMAX_DELAY);
+  active = next;
+  activeSlot = target;
+  xSemaphoreGive(indexMutex);
+
+  stats.syncs++;
+  stats.lastSyncMs = millis() - stats.sessionStartMs;
+  Serial.printf("[NFCAUTH] Version %lu -> %lu (%s): %lu cards, +%lu/-%lu, slot %c, %lu ms\n",
+                (unsigned long)sessionFrom, (unsigned long)sessionTo,
+                sessionFrom == 0 ? "snapshot" : "delta",
+                (unsigned long)active.count,
+                (unsigned long)merge.puts, (unsigned long)merge.removes,
+                'A' + activeSlot, (unsigned long)stats.lastSyncMs);
+  mergeOpen = false;
+  resetWriter();
+  nextRequestMs = millis() + NFC_AUTH_SYNC_INTERVAL_MS;
+}
+
+static void handlePage() {
+  // Page tronquée par le tampon de réponse: des opérations manqueraient silencieusement
+  if (response.statusCode != 200 || response.contentLength >= (int)sizeof(response.payload) - 1) {
+    endSession(true, response.statusCode == 200 ? "page too large" : "HTTP error");
+    return;
+  }
+  NfcAuthPage page;
+  if (!NfcAuthSync_ParseHeader(response.payload, &page)) {
+    endSession(true, "malformed page");
+    return;
+  }
+  // Réponse tardive d'une requête abandonnée ("response lost"): ignorée, la bonne page est attendue
+  if (page.hasAfter != requestHasAfter || (page.hasAfter && page.after != requestAfter)) {
+    Serial.println("[NFCAUTH] Late page ignored (cursor mismatch)");
+    requestPending = true;
+    return;
+  }
+  stats.pages++;
+
+  if (!mergeOpen) {
+    if (page.from == page.to && page.to == active.version) {
+      endSession(false, nullptr);  // à jour
+      return;
+    }
+    if (page.from != 0 && page.from != active.version) {
+      endSession(true, "delta base mismatch");
+      return;
+    }
+    sessionFrom = page.from;
+    sessionTo = page.to;
+    stats.sessionStartMs = millis();
+    NfcAuthMerge_Begin(&merge, page.from ? &active : nullptr, slotWrite, &writer, slotSize);
+    mergeOpen = true;
+  } else if (page.from != sessionFrom || page.to != sessionTo) {
+    endSession(true, "version changed during sync");
+    return;
+  }
+
+  NfcAuthResult res = NfcAuthSync_ApplyPage(&merge, response.payload, &page);
+  if (res != NFC_AUTH_OK) {
+    endSession(true, res == NFC_AUTH_ERR_FULL ? "slot full" : res == NFC_AUTH_ERR_IO ? "flash write" : "bad page");
+    return;
+  }
+  if (page.more) {
+    nextRequestMs = millis() + HTTP_REQUEST_COOLDOWN_MS;
+    return;
+  }
+  commitSession();
+}
+
+static void sendRequest(uint32_t now) {
+  char url[MAX_URL_LENGTH];
+  String base = EnvConfig::GetNfcAuthUrl();
+  requestHasAfter = mergeOpen && merge.hasOp;
+  requestAfter = requestHasAfter ? merge.lastOp : 0;
+  if (requestHasAfter) {
+    snprintf(url, sizeof(url), "%s?since=%lu&after=%010llX", base.c_str(),
+             (unsigned long)sessionFrom, (unsigned long long)merge.lastOp);
+  } else {
+    snprintf(url, sizeof(url), "%s?since=%lu", base.c_str(),
+             (unsigned long)(mergeOpen ? sessionFrom : active.version));
+  }
+  // Réponse d'une requête précédente restée dans la file: jamais prise pour celle-ci
+  xQueueReset(responseQueue);
+  if (HttpService_Get(url, responseQueue, NFC_AUTH_HTTP_TIMEOUT_MS)) {
+    requestPending = true;
+    requestMs = now;
+  } else {
+    endSession(true, "HTTP queue full");
+  }
+}
+
+void NfcAuth_Pump(bool workflowIdle) {
+  if (!partition) return;
+  uint32_t now = millis();
+  if (requestPending) {
+    if (xQueueReceive(responseQueue, &response, 0) == pdTRUE) {
+      requestPending = false;
+      handlePage();
+    } else if (now - requestMs >= NFC_AUTH_RESPONSE_TIMEOUT_MS) {
+      requestPending = false;
+      endSession(true, "response lost");
+    }
+    return;
+  }
+
+  if (!workflowIdle) return;
+
+  // Effacement anticipé de l'emplacement cible, un secteur par appel, sur la taille de l'image courante
+  if (!mergeOpen && writer.erasedEnd < sectorAlign(NfcAuthIndex_ImageSize(active.count))) {
+    if (esp_partition_erase_range(partition, writer.base + writer.erasedEnd, SPI_FLASH_SEC_SIZE) == ESP_OK) {
+      writer.erasedEnd += SPI_FLASH_SEC_SIZE;
+    }
+    return;
+  }
+
+  if (!WifiService_IsReady() || (int32_t)(now - nextRequestMs) < 0) return;
+  sendRequest(now);
+}
+
+void NfcAuth_DebugInfo() {
+  if (!partition) {
+    Serial.println("[INFO] NFC auth index: no partition");
+    return;
+  }
+  Serial.printf("[INFO] NFC auth index: version %lu, %lu cards, slot %c (gen %lu), %lu/%lu bytes\n",
+                (unsigned long)active.version, (unsigned long)active.count,
+                activeSlot < 0 ? '-' : 'A' + activeSlot, (unsigned long)active.generation,
+                (unsigned long)NfcAuthIndex_ImageSize(active.count), (unsigned long)slotSize);
+  Serial.printf("[INFO] NFC auth lookups: n=%lu, last=%lu us, max=%lu us\n",
+                (unsigned long)stats.lookups, (unsigned long)stats.lastLookupUs, (unsigned long)stats.maxLookupUs);
+  Serial.printf("[INFO] NFC auth sync: images=%lu, pages=%lu, failures=%lu, last=%lu ms%s\n",
+                (unsigned long)stats.syncs, (unsigned long)stats.pages, (unsigned long)stats.failures,
+                (unsigned long)stats.lastSyncMs, mergeOpen ? ", in progress" : "");
+}
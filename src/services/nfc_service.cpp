@@ -6,6 +6,19 @@
 #include <MFRC522.h>
 #include <string.h>
 #include "orchestrator.h"
+#include "rc522_irq.h"
+#include "rc522_drv.h"
+#include "ntag_reader.h"
+#include "mfc_reader.h"
+#include "ndef.h"
+#include "nfc_duty.h"
+#include "nfc_read_cache.h"
+#include "services/nfc_auth.h"
+
+// Bits de notification de la tâche NFC
+#define NFC_NOTIFY_SCAN 0x01
+#define NFC_NOTIFY_IRQ  0x02
+#define NFC_NOTIFY_BG   0x04   // changement de mode de fond ou de budget
 
 static TaskHandle_t nfcTaskHandle = nullptr;
 static QueueHandle_t orchestratorQueueHandle = nullptr;
@@ -13,6 +26,70 @@ static MFRC522* mfrc522 = nullptr;
 static volatile bool nfcBusy = false;
 static uint8_t rc522Version = 0;
 
+// Détection par interruption (RC522 IRQ -> GPIO), repli polling sinon
+static bool irqMode = false;
+static Rc522Bus rc522Bus;
+static volatile uint32_t irqCount = 0;
+
+// Échanges carte (SELECT, READ, FAST_READ, HLTA) par rafales SPI, hors bibliothèque MFRC522
+static uint32_t rc522SpiHz = RC522_SPI_HZ;
+static Rc522Drv rc522Drv;
+
+typedef struct {
+  uint32_t windows;
+  uint32_t detections;
+  uint32_t waits;          // REQA armés (IRQ) ou PICC_IsNewCardPresent (polling)
+  uint32_t irqWakeups;
+  uint32_t lastDetectMs;   // ouverture de fenêtre -> carte détectée
+  uint64_t busyUs;         // temps CPU passé dans l'attente de carte
+} NfcWaitStats;
+
+static NfcWaitStats waitStats;
+
+// Détection de fond: salves RF espacées selon nfc_duty.h, champ éteint entre deux.
+// Demandes (CLI) appliquées par la tâche NFC, seule à piloter le RC522.
+static volatile bool bgRequested = NFC_BG_ENABLED;
+static volatile uint16_t bgBudgetPermille = NFC_BG_BUDGET_PERMILLE;
+static bool bgEnabled = false;
+static NfcDuty bgDuty;
+
+// Anti-rebond partagé entre fenêtre de scan et détection de fond
+static String lastUidHex;
+static unsigned long lastReadMs = 0;
+
+// Tap -> texte par type de tag Type 2 (dernière lecture)
+typedef struct {
+  uint32_t reads;
+  uint32_t lastUs;
+  uint16_t lastBytes;
+  uint8_t lastTransactions;
+  bool lastFastRead;
+} NfcTypeStats;
+
+static NfcTypeStats typeStats[NTAG_TYPE_NTAG216 + 1];
+
+// MIFARE Classic: table de clés (config.h) et dernière clé acceptée par préfixe d'UID
+typedef struct {
+  uint32_t reads;
+  uint32_t lastUs;
+  uint16_t lastBytes;
+  uint8_t lastSectors;
+  uint8_t lastAuths;
+  uint8_t lastAuthFailures;
+  bool lastMad;
+} NfcClassicStats;
+
+static const MfcKey mfcKeys[] = MFC_KEYS;
+static MfcKeyCache mfcKeyCache;
+static NfcClassicStats classicStats;
+
+// Texte déjà lu par UID, validé par une page ou un bloc relu (taps répétés d'une même carte)
+static NfcReadCache readCache;
+static uint32_t readCacheLastUs = 0;
+
+// Zone de données du dernier tag lu (NTAG ou Classic), hors pile de la tâche NFC
+static uint8_t tagMem[MFC_READER_MAX_BYTES > NTAG_READER_MAX_BYTES ? MFC_READER_MAX_BYTES : NTAG_READER_MAX_BYTES];
+
 static void nfcTask(void* pvParameters);
 
 static void sendEvent(OrchestratorEventType type, const char* message) {
@@ -24,6 +101,71 @@ static void sendEvent(OrchestratorEventType type, const char* message) {
   xQueueSend(orchestratorQueueHandle, &evt, 0);
 }
 
+static uint8_t rc522BusRead(void* ctx, uint8_t reg) {
+  return ((MFRC522*)ctx)->PCD_ReadRegister((MFRC522::PCD_Register)(reg << 1));
+}
+
+static void rc522BusWrite(void* ctx, uint8_t reg, uint8_t value) {
+  ((MFRC522*)ctx)->PCD_WriteRegister((MFRC522::PCD_Register)(reg << 1), value);
+}
+
+// Une transaction = CS bas, rafale d'octets dans le tampon du contrôleur SPI, CS haut
+static bool rc522SpiTransfer(void* ctx, const uint8_t* tx, uint8_t* rx, size_t len) {
+  SPI.beginTransaction(SPISettings(rc522SpiHz, MSBFIRST, SPI_MODE0));
+  digitalWrite(RC522_SS, LOW);
+  SPI.transferBytes(tx, rx, (uint32_t)len);
+  digitalWrite(RC522_SS, HIGH);
+  SPI.endTransaction();
+  return true;
+}
+
+static uint32_t rc522Micros(void* ctx) {
+  return micros();
+}
+
+static const Rc522Transport rc522Transport = { rc522SpiTransfer, rc522Micros, nullptr };
+
+// Horloge SPI la plus haute validée par un aller-retour FIFO de 64 octets
+static void setupBurstDriver() {
+  static const uint32_t clocks[] = { RC522_SPI_HZ, 8000000, RC522_SPI_SAFE_HZ };
+  Rc522Drv_Init(&rc522Drv, &rc522Transport);
+  for (size_t i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++) {
+    rc522SpiHz = clocks[i];
+    if (Rc522Drv_CheckFifo(&rc522Drv)) break;
+  }
+  Serial.printf("[NFC] SPI bursts at %lu Hz\n", (unsigned long)rc522SpiHz);
+}
+
+static void IRAM_ATTR rc522IrqIsr() {
+  irqCount++;
+  BaseType_t woken = pdFALSE;
+  if (nfcTaskHandle) {
+    xTaskNotifyFromISR(nfcTaskHandle, NFC_NOTIFY_IRQ, eSetBits, &woken);
+  }
+  if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+// Vérifie que la broche IRQ est câblée: un calcul CRC doit l'activer
+static bool setupIrq() {
+#if RC522_IRQ >= 0
+  pinMode(RC522_IRQ, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(RC522_IRQ), rc522IrqIsr, FALLING);
+
+  uint32_t before = irqCount;
+  Rc522Irq_ProbeBegin(&rc522Bus);
+  delay(5);
+  bool fired = (irqCount != before);
+  Rc522Irq_ProbeEnd(&rc522Bus);
+  Rc522Irq_Disable(&rc522Bus);
+  if (!fired) {
+    detachInterrupt(digitalPinToInterrupt(RC522_IRQ));
+  }
+  return fired;
+#else
+  return false;
+#endif
+}
+
 void StartTaskNfcService(QueueHandle_t orchestratorQueue) {
   orchestratorQueueHandle = orchestratorQueue;
 
@@ -34,6 +176,14 @@ void StartTaskNfcService(QueueHandle_t orchestratorQueue) {
     Serial.println("[NFC] RC522 init done");
     rc522Version = mfrc522->PCD_ReadRegister(MFRC522::VersionReg);
     Serial.printf("[NFC] Version: 0x%02X\n", rc522Version);
+    rc522Bus.read = rc522BusRead;
+    rc522Bus.write = rc522BusWrite;
+    rc522Bus.ctx = mfrc522;
+    setupBurstDriver();
+    MfcKeyCache_Init(&mfcKeyCache);
+    NfcReadCache_Init(&readCache);
+    irqMode = setupIrq();
+    Serial.printf("[NFC] Card detection: %s\n", irqMode ? "IRQ" : "polling");
   }
 
   if (!nfcTaskHandle) {
@@ -53,12 +203,93 @@ void NfcService_DebugInfo() {
                 nfcBusy ? "YES" : "NO",
                 (int)NFC_SCAN_TIMEOUT_MS,
                 rc522Version);
+  Serial.printf("[NFC] Detection=%s, windows=%lu, cards=%lu, last=%lu ms\n",
+                irqMode ? "IRQ" : "polling",
+                (unsigned long)waitStats.windows,
+                (unsigned long)waitStats.detections,
+                (unsigned long)waitStats.lastDetectMs);
+  if (irqMode) {
+    Serial.printf("[NFC] Wait: rearms=%lu, irq=%lu (total %lu), busy=%lu us, spi=%lu\n",
+                  (unsigned long)waitStats.waits,
+                  (unsigned long)waitStats.irqWakeups,
+                  (unsigned long)irqCount,
+                  (unsigned long)waitStats.busyUs,
+                  (unsigned long)rc522Bus.transfers);
+  } else {
+    // Transactions SPI non comptées: PICC_IsNewCardPresent relit ComIrqReg en boucle
+    Serial.printf("[NFC] Wait: polls=%lu, busy=%lu us\n",
+                  (unsigned long)waitStats.waits,
+                  (unsigned long)waitStats.busyUs);
+  }
+  if (bgEnabled) {
+    uint32_t now = millis();
+    uint32_t duty = NfcDuty_DutyPermille(&bgDuty, now);
+    Serial.printf("[NFC] Background: interval=%lu ms, bursts=%lu, cards=%lu, RF duty=%lu.%lu %% (budget %u.%u %%)\n",
+                  (unsigned long)NfcDuty_IntervalMs(&bgDuty, now),
+                  (unsigned long)bgDuty.bursts,
+                  (unsigned long)bgDuty.detections,
+                  (unsigned long)(duty / 10), (unsigned long)(duty % 10),
+                  (unsigned)(bgDuty.cfg.budgetPermille / 10), (unsigned)(bgDuty.cfg.budgetPermille % 10));
+    // Borne haute: la carte a pu être posée juste après la salve précédente
+    Serial.printf("[NFC] Background latency: last<=%lu ms, avg<=%lu ms, max<=%lu ms\n",
+                  (unsigned long)bgDuty.lastLatencyMs,
+                  (unsigned long)NfcDuty_AvgLatencyMs(&bgDuty),
+                  (unsigned long)bgDuty.maxLatencyMs);
+  } else {
+    Serial.println("[NFC] Background: OFF");
+  }
+  for (int op = 0; op < RC522_OP_COUNT; op++) {
+    const Rc522OpStats& st = rc522Drv.ops[op];
+    if (st.calls == 0) continue;
+    Serial.printf("[NFC] %s: n=%lu, err=%lu, last=%lu us, avg=%lu us, spi=%lu tx / %lu bytes per op\n",
+                  Rc522Drv_OpName((Rc522Op)op),
+                  (unsigned long)st.calls,
+                  (unsigned long)st.errors,
+                  (unsigned long)st.lastUs,
+                  (unsigned long)(st.totalUs / st.calls),
+                  (unsigned long)(st.transactions / st.calls),
+                  (unsigned long)(st.bytes / st.calls));
+  }
+  for (int t = 0; t <= NTAG_TYPE_NTAG216; t++) {
+    const NfcTypeStats& st = typeStats[t];
+    if (st.reads == 0) continue;
+    Serial.printf("[NFC] %s: reads=%lu, tap->text=%lu us, %u bytes in %u exchanges%s\n",
+                  NtagReader_TypeName((NtagType)t),
+                  (unsigned long)st.reads,
+                  (unsigned long)st.lastUs,
+                  (unsigned)st.lastBytes,
+                  (unsigned)st.lastTransactions,
+                  st.lastFastRead ? " (FAST_READ)" : "");
+  }
+  if (classicStats.reads > 0) {
+    Serial.printf("[NFC] MIFARE Classic: reads=%lu, tap->text=%lu us, %u bytes in %u sectors, auth=%u (%u refused)%s\n",
+                  (unsigned long)classicStats.reads,
+                  (unsigned long)classicStats.lastUs,
+                  (unsigned)classicStats.lastBytes,
+                  (unsigned)classicStats.lastSectors,
+                  (unsigned)classicStats.lastAuths,
+                  (unsigned)classicStats.lastAuthFailures,
+                  classicStats.lastMad ? " (MAD)" : "");
+  }
+  Serial.printf("[NFC] Read cache: hits=%lu, misses=%lu, stale=%lu, expired=%lu, last hit tap->text=%lu us\n",
+                (unsigned long)readCache.hits,
+                (unsigned long)readCache.misses,
+                (unsigned long)readCache.stale,
+                (unsigned long)readCache.expired,
+                (unsigned long)readCacheLastUs);
 }
 
 void StopTaskNfcService() {
   if (nfcTaskHandle) {
-    vTaskDelete(nfcTaskHandle);
+    TaskHandle_t handle = nfcTaskHandle;
     nfcTaskHandle = nullptr;
+    vTaskDelete(handle);
+    if (irqMode) Rc522Irq_Disable(&rc522Bus);
+    if (bgEnabled) {
+      // Champ rallumé comme après PCD_Init; le mode de fond reprend au redémarrage
+      mfrc522->PCD_AntennaOn();
+      bgEnabled = false;
+    }
     nfcBusy = false;
     Serial.println("[NFC] service stopped");
   }
@@ -74,7 +305,7 @@ TaskHandle_t NfcService_GetTaskHandle() {
 
 bool NfcService_TriggerScan() {
   // Rate limiting pour éviter le spam NFC
-  if (!rateLimitCheck("NFC", NFC_SCAN_COOLDOWN_MS)) {
+  if (!rateLimitCheck(RATE_LIMIT_NFC)) {
     SECURE_LOG_ERROR("NFC", "Scan rate limited");
     return false;
   }
@@ -91,10 +322,24 @@ bool NfcService_TriggerScan() {
   
   SECURE_LOG_INFO("NFC", "Scan triggered");
   logSecurityEvent("NFC_SCAN_TRIGGERED", "User initiated");
-  xTaskNotifyGive(nfcTaskHandle);
+  xTaskNotify(nfcTaskHandle, NFC_NOTIFY_SCAN, eSetBits);
   return true;
 }
 
+void NfcService_SetBackground(bool enabled) {
+  bgRequested = enabled;
+  if (nfcTaskHandle) xTaskNotify(nfcTaskHandle, NFC_NOTIFY_BG, eSetBits);
+}
+
+bool NfcService_IsBackground() {
+  return bgRequested;
+}
+
+void NfcService_SetBackgroundBudget(uint16_t permille) {
+  bgBudgetPermille = permille;
+  if (nfcTaskHandle) xTaskNotify(nfcTaskHandle, NFC_NOTIFY_BG, eSetBits);
+}
+
 static String uidToHex(const MFRC522::Uid& uid) {
   char buffer[2 * 10 + 1]; // UID jusqu'à 10 octets
   size_t index = 0;
@@ -106,142 +351,83 @@ static String uidToHex(const MFRC522::Uid& uid) {
   return String(buffer);
 }
 
-// ---- Helpers NDEF ----
+// ---- Helpers NDEF (itérateur sans copie de lib/dpm_core) ----
+// Premier record Text, sinon premier URI, limité à la taille d'un payload d'événement
 static bool parseTlvAndExtractNdefText(const uint8_t* mem, size_t totalLen, String& outText) {
-  size_t i = 0;
-  while (i < totalLen) {
-    uint8_t t = mem[i++];
-    if (t == 0x00) { // NULL TLV
-      continue;
-    }
-    if (t == 0xFE) { // Terminator TLV
-      break;
-    }
-    if (i >= totalLen) break;
-    uint16_t L = mem[i++];
-    if (L == 0xFF) {
-      if (i + 1 >= totalLen) break;
-      L = ((uint16_t)mem[i] << 8) | mem[i + 1];
-      i += 2;
-    }
-    if (i + L > totalLen) break;
-
-    if (t == 0x03) { // NDEF Message TLV
-      // Parse first NDEF record as Text (TNF=0x01, type 'T')
-      const uint8_t* p = mem + i;
-      const uint8_t* end = p + L;
-      if (p >= end) return false;
-      uint8_t hdr = *p++;
-      bool sr = (hdr & 0x10) != 0;
-      bool il = (hdr & 0x08) != 0;
-      uint8_t tnf = (hdr & 0x07);
-      if (p >= end) return false;
-      uint8_t typeLen = *p++;
-      uint32_t payloadLen = 0;
-      if (sr) {
-        if (p >= end) return false;
-        payloadLen = *p++;
-      } else {
-        if (p + 4 > end) return false;
-        payloadLen = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
-        p += 4;
-      }
-      uint8_t idLen = 0;
-      if (il) {
-        if (p >= end) return false;
-        idLen = *p++;
-      }
-      if (p + typeLen > end) return false;
-      const uint8_t* typePtr = p;
-      p += typeLen;
-      if (il) {
-        if (p + idLen > end) return false;
-        p += idLen;
-      }
-      if (p + payloadLen > end) return false;
-
-      if (tnf == 0x01 && typeLen == 1 && typePtr[0] == 'T' && payloadLen >= 1) {
-        uint8_t status = p[0];
-        uint8_t langLen = status & 0x3F;
-        bool utf16 = (status & 0x80) != 0;
-        if (utf16) {
-          // Non supporté: afficher brut en hex si besoin
-          return false;
-        }
-        if (1 + langLen > payloadLen) return false;
-        const uint8_t* txt = p + 1 + langLen;
-        uint32_t txtLen = payloadLen - 1 - langLen;
-        // Limiter la taille pour notre payload
-        char buf[120];
-        uint32_t n = (txtLen < sizeof(buf) - 1) ? txtLen : (sizeof(buf) - 1);
-        memcpy(buf, txt, n);
-        buf[n] = '\0';
-        outText = String(buf);
-        return true;
-      }
-      // Si pas un Text record, ignorer (on pourrait parser d'autres records au besoin)
-    }
-
-    i += L; // avancer au TLV suivant
+  char buf[120];
+  NdefRecord rec;
+  NdefText text;
+  NdefUri uri;
+  if (Ndef_FindRecord(mem, totalLen, NDEF_TNF_WELL_KNOWN, "T", &rec) && Ndef_ParseText(&rec, &text)) {
+    Ndef_TextToUtf8(&text, buf, sizeof(buf));
+  } else if (Ndef_FindRecord(mem, totalLen, NDEF_TNF_WELL_KNOWN, "U", &rec) && Ndef_ParseUri(&rec, &uri)) {
+    Ndef_UriToString(&uri, buf, sizeof(buf));
+  } else {
+    return false;
   }
-  return false;
+  outText = String(buf);
+  return true;
 }
 
-static bool readUltralightText(MFRC522& reader, String& outText) {
-  auto ulRead16 = [&](byte startPage, uint8_t* out16) -> bool {
-    uint8_t cmd[2] = { 0x30, startPage }; // READ command for Ultralight (reads 4 pages = 16 bytes)
-    uint8_t resBuf[18];
-    byte resLen = sizeof(resBuf);
-    MFRC522::StatusCode sc = reader.PCD_TransceiveData(cmd, 2, resBuf, &resLen, nullptr, 0, true);
-    if (sc != MFRC522::STATUS_OK || resLen < 16) return false;
-    memcpy(out16, resBuf, 16);
-    return true;
-  };
+// Transport NtagReader: CRC_A ajouté et vérifié par le pilote, réponse sans CRC
+static int ntagTransceive(void* ctx, const uint8_t* cmd, size_t cmdLen, uint8_t* resp, size_t respMax) {
+  return Rc522Drv_TransceiveCrc((Rc522Drv*)ctx, cmd, cmdLen, resp, respMax);
+}
 
-  uint8_t mem[192];
-  size_t total = 0;
-  for (byte page = 4; page < 40 && (total + 16) <= sizeof(mem); page += 4) {
-    uint8_t tmp[16];
-    if (!ulRead16(page, tmp)) {
-      break;
-    }
-    memcpy(&mem[total], tmp, 16);
-    total += 16;
-  }
-  if (total == 0) return false;
-  return parseTlvAndExtractNdefText(mem, total, outText);
+// Après un NAK le tag repasse en IDLE: WUPA + SELECT
+static bool ntagReactivate(void* ctx) {
+  Rc522Drv* drv = (Rc522Drv*)ctx;
+  uint8_t atqa[2];
+  Rc522Uid uid;
+  if (Rc522Drv_WakeupA(drv, atqa) != RC522_OK) return false;
+  return Rc522Drv_Select(drv, &uid) == RC522_OK;
 }
 
-static bool readClassicText(MFRC522& reader, String& outText) {
-  MFRC522::MIFARE_Key key;
-  for (byte i = 0; i < 6; i++) key.keyByte[i] = 0xFF; // clé A par défaut
+// Ultralight / NTAG21x: CC + longueur du TLV NDEF, puis FAST_READ des pages utiles.
+// *memLen: octets lus depuis la page 4 (0 en échec)
+static bool readUltralightText(String& outText, NtagReadInfo* info, size_t* memLen) {
+  NtagTransport transport = { ntagTransceive, ntagReactivate, &rc522Drv };
+  int n = NtagReader_ReadNdef(&transport, tagMem, sizeof(tagMem), info);
+  *memLen = n > 0 ? (size_t)n : 0;
+  if (n <= 0) return false;
+  return parseTlvAndExtractNdefText(tagMem, (size_t)n, outText);
+}
 
-  // Lire blocs 4..6 (secteur 1 data)
-  uint8_t mem[48];
-  size_t total = 0;
-  for (byte block = 4; block <= 6; block++) {
-    MFRC522::StatusCode res = reader.PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block, &key, &reader.uid);
-    if (res != MFRC522::STATUS_OK) {
-      reader.PCD_StopCrypto1();
-      return false;
-    }
-    byte buffer[18];
-    byte size = sizeof(buffer);
-    res = reader.MIFARE_Read(block, buffer, &size);
-    if (res != MFRC522::STATUS_OK || size < 16) {
-      reader.PCD_StopCrypto1();
-      return false;
-    }
-    memcpy(&mem[total], buffer, 16);
-    total += 16;
-  }
-  reader.PCD_StopCrypto1();
-  if (total == 0) return false;
+// Transport MfcReader: authentification Crypto1 par la bibliothèque (UID recopié par readCard),
+// READ par le pilote (chiffrement assuré par le RC522 une fois Crypto1 actif)
+static bool mfcAuth(void* ctx, uint8_t keyType, uint8_t block, const uint8_t key[6]) {
+  MFRC522::MIFARE_Key k;
+  memcpy(k.keyByte, key, sizeof(k.keyByte));
+  return mfrc522->PCD_Authenticate((MFRC522::PICC_Command)keyType, block, &k, &mfrc522->uid) == MFRC522::STATUS_OK;
+}
+
+static bool mfcRead(void* ctx, uint8_t block, uint8_t out[16]) {
+  return Rc522Drv_Read((Rc522Drv*)ctx, block, out) == RC522_OK;
+}
+
+// Clé refusée: la carte ne répond plus, Crypto1 arrêté puis WUPA + SELECT
+static bool mfcReactivate(void* ctx) {
+  mfrc522->PCD_StopCrypto1();
+  return ntagReactivate(ctx);
+}
+
+// MIFARE Classic 1K/4K: MAD puis secteurs NDEF, une authentification par secteur.
+// *memLen: octets lus depuis info->firstBlock (0 en échec)
+static bool readClassicText(String& outText, uint8_t sectorCount, MfcReadInfo* info, size_t* memLen) {
+  MfcTransport transport = { mfcAuth, mfcRead, mfcReactivate, &rc522Drv };
+  int n = MfcReader_ReadNdef(&transport, mfcKeys, sizeof(mfcKeys) / sizeof(mfcKeys[0]), &mfcKeyCache,
+                             mfrc522->uid.uidByte, mfrc522->uid.size, sectorCount,
+                             tagMem, sizeof(tagMem), info);
+  *memLen = n > 0 ? (size_t)n : 0;
 
   // 1) Essayer NDEF TLV (si la carte est encodée NDEF)
-  if (parseTlvAndExtractNdefText(mem, total, outText)) {
-    return true;
-  }
+  if (n > 0) return parseTlvAndExtractNdefText(tagMem, (size_t)n, outText);
+  if (n != MFC_READ_ERR_NO_NDEF || info->mad) return false;
+  *memLen = info->bytesRead;
+
+  // Carte sans MAD: premier secteur lu, rendu en entier par le lecteur
+  const uint8_t* mem = tagMem;
+  size_t total = info->bytesRead > 48 ? 48 : info->bytesRead;
 
   // 2) Fallback: si contenu ASCII brut (comme dans ton dump), l'extraire
   String ascii;
@@ -268,80 +454,283 @@ static bool readClassicText(MFRC522& reader, String& outText) {
   return false;
 }
 
-static void nfcTask(void* pvParameters) {
-  for (;;) {
-    // Attente passive d'une notification pour démarrer un scan
-    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-
-    nfcBusy = true;
-    Serial.println("[NFC] Scan window opened");
-
-    // Fenêtre de scan limitée dans le temps
-    const unsigned long startMs = millis();
-    bool found = false;
-    String lastUidHex;
-    unsigned long lastReadMs = 0;
-
-    while ((millis() - startMs) < NFC_SCAN_TIMEOUT_MS) {
-      if (mfrc522 && mfrc522->PICC_IsNewCardPresent() && mfrc522->PICC_ReadCardSerial()) {
-        String uidHex = uidToHex(mfrc522->uid);
-        unsigned long now = millis();
-        bool isBounce = (uidHex == lastUidHex) && ((now - lastReadMs) < NFC_DEBOUNCE_MS);
-
-        if (!isBounce) {
-          lastUidHex = uidHex;
-          lastReadMs = now;
-          
-          // Validation et masquage de l'UID
-          if (!isValidNFCData(uidHex.c_str())) {
-            SECURE_LOG_ERROR("NFC", "Invalid UID format detected");
-            continue;
-          }
-          
-          String maskedUID = maskUID(uidHex);
-          SECURE_LOG_INFO("NFC", "Valid card detected: %s", maskedUID.c_str());
-          logSecurityEvent("NFC_CARD_READ", ("UID: " + maskedUID).c_str());
-          
-          sendEvent(ORCH_EVT_NFC_UID_READ, uidHex.c_str());
-
-          // Essayer de lire un enregistrement texte NDEF
-          String text;
-          bool ok = false;
-          // Déterminer type de PICC
-          byte sak = mfrc522->PICC_GetType(mfrc522->uid.sak);
-          MFRC522::PICC_Type piccType = mfrc522->PICC_GetType(mfrc522->uid.sak);
-          (void)sak;
-          if (piccType == MFRC522::PICC_TYPE_MIFARE_UL) {
-            ok = readUltralightText(*mfrc522, text);
-          } else if (piccType == MFRC522::PICC_TYPE_MIFARE_1K || piccType == MFRC522::PICC_TYPE_MIFARE_4K) {
-            ok = readClassicText(*mfrc522, text);
-          }
-          if (ok) {
-            sendEvent(ORCH_EVT_NFC_DATA, text.c_str());
-          }
-
-          found = true;
-          mfrc522->PICC_HaltA();
-          mfrc522->PCD_StopCrypto1();
-          break;
-        }
-
-        mfrc522->PICC_HaltA();
-        mfrc522->PCD_StopCrypto1();
+// Carte déjà lue: page 4 (Type 2) ou premier bloc NDEF avec la clé mémorisée (Classic) relu
+// et comparé. true si le contenu mémorisé est repris (*ok: texte disponible).
+static bool readCachedText(MFRC522::PICC_Type piccType, const Rc522Uid& uid, String& outText, bool* ok) {
+  NfcReadCacheEntry* entry = NfcReadCache_Find(&readCache, uid.bytes, uid.size, millis(), NFC_READ_CACHE_TTL_MS);
+  if (!entry) return false;
+
+  uint8_t probe[NFC_READ_CACHE_PROBE_SIZE];
+  bool probed;
+  if (piccType == MFRC522::PICC_TYPE_MIFARE_UL) {
+    const uint8_t cmd[2] = { NTAG_CMD_READ, entry->probeAddr };
+    probed = Rc522Drv_TransceiveCrc(&rc522Drv, cmd, sizeof(cmd), probe, sizeof(probe)) == (int)sizeof(probe);
+  } else {
+    MfcTransport transport = { mfcAuth, mfcRead, mfcReactivate, &rc522Drv };
+    probed = MfcReader_ReadBlock(&transport, mfcKeys, sizeof(mfcKeys) / sizeof(mfcKeys[0]), &mfcKeyCache,
+                                 uid.bytes, uid.size, entry->probeAddr, probe);
+  }
+  if (!NfcReadCache_Validate(&readCache, entry, probed ? probe : nullptr, sizeof(probe))) {
+    // NAK ou clé refusée: carte muette jusqu'à la réactivation, puis lecture complète
+    if (!probed) {
+      if (piccType == MFRC522::PICC_TYPE_MIFARE_UL) ntagReactivate(&rc522Drv);
+      else mfcReactivate(&rc522Drv);
+    }
+    return false;
+  }
+  *ok = entry->hasText;
+  if (entry->hasText) outText = entry->text;
+  return true;
+}
+
+// REQA émis puis sommeil jusqu'à l'IRQ (ATQA reçu) ou la période de réarmement.
+// Aucune transaction SPI pendant l'attente.
+static bool waitCardIrq(unsigned long startMs) {
+  Rc522Irq_Enable(&rc522Bus);
+  bool present = false;
+  while (!present && (millis() - startMs) < NFC_SCAN_TIMEOUT_MS) {
+    // IRQ levées par les échanges précédents (lecture de carte)
+    xTaskNotifyWait(0, NFC_NOTIFY_IRQ, nullptr, 0);
+
+    uint32_t t0 = micros();
+    Rc522Irq_ArmReqa(&rc522Bus);
+    waitStats.waits++;
+    waitStats.busyUs += micros() - t0;
+
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, NFC_NOTIFY_IRQ, &bits, pdMS_TO_TICKS(NFC_IRQ_REARM_MS));
+
+    t0 = micros();
+    if (bits & NFC_NOTIFY_IRQ) {
+      waitStats.irqWakeups++;
+      present = Rc522Irq_CardResponded(&rc522Bus);
+    }
+    Rc522Irq_Clear(&rc522Bus);
+    waitStats.busyUs += micros() - t0;
+  }
+  // Pas d'IRQ pendant la lecture de la carte (anticollision, READ...)
+  Rc522Irq_Disable(&rc522Bus);
+  return present;
+}
+
+static bool waitCardPolling(unsigned long startMs) {
+  while ((millis() - startMs) < NFC_SCAN_TIMEOUT_MS) {
+    uint32_t t0 = micros();
+    bool present = mfrc522->PICC_IsNewCardPresent();
+    waitStats.waits++;
+    waitStats.busyUs += micros() - t0;
+    if (present) return true;
+    vTaskDelay(pdMS_TO_TICKS(NFC_POLL_INTERVAL_MS));
+  }
+  return false;
+}
+
+// true si une carte a répondu au REQA avant la fin de la fenêtre
+static bool waitCard(unsigned long startMs) {
+  if (!mfrc522) return false;
+  return irqMode ? waitCardIrq(startMs) : waitCardPolling(startMs);
+}
+
+// Carte ayant répondu au REQA: sélection, UID puis texte NDEF selon le type.
+// false si rebond (même UID dans NFC_DEBOUNCE_MS), carte restée posée depuis la salve précédente
+// (background), UID invalide ou sélection impossible.
+static bool readCard(bool background) {
+  uint32_t tapUs = micros();
+  Rc522Uid uid;
+  if (Rc522Drv_Select(&rc522Drv, &uid) != RC522_OK) return false;
+  // UID retenu aussi en fenêtre de scan: la carte lue n'est pas resignalée par les salves suivantes
+  bool resting = bgEnabled && NfcDuty_CardPresent(&bgDuty, uid.bytes, uid.size);
+  if (background && resting) {
+    Rc522Drv_HaltA(&rc522Drv);
+    return false;
+  }
+  // UID recopié pour l'authentification MIFARE Classic (bibliothèque)
+  mfrc522->uid.size = uid.size;
+  memcpy(mfrc522->uid.uidByte, uid.bytes, uid.size);
+  mfrc522->uid.sak = uid.sak;
+
+  String uidHex = uidToHex(mfrc522->uid);
+  unsigned long now = millis();
+  bool isBounce = (uidHex == lastUidHex) && ((now - lastReadMs) < NFC_DEBOUNCE_MS);
+  bool read = false;
+
+  if (!isBounce) {
+    lastUidHex = uidHex;
+    lastReadMs = now;
+    waitStats.detections++;
+
+    // Validation et masquage de l'UID
+    if (!isValidNFCData(uidHex.c_str())) {
+      SECURE_LOG_ERROR("NFC", "Invalid UID format detected");
+    } else {
+      String maskedUID = maskUID(uidHex);
+      SECURE_LOG_INFO("NFC", "Valid card detected: %s", maskedUID.c_str());
+      logSecurityEvent("NFC_CARD_READ", ("UID: " + maskedUID).c_str());
+
+      sendEvent(ORCH_EVT_NFC_UID_READ, uidHex.c_str());
+
+      // Autorisation locale (index flash synchronisé), sans aller-retour backend
+      int authFlags = NFC_AUTH_ABSENT;
+      if (NfcAuth_IsLoaded()) {
+        authFlags = NfcAuth_Lookup(uid.bytes, uid.size);
+        sendEvent(ORCH_EVT_NFC_AUTH, NfcAuthIndex_RoleName(authFlags));
       }
 
-      vTaskDelay(pdMS_TO_TICKS(30));
+      // Essayer de lire un enregistrement texte NDEF selon le type de PICC
+      String text;
+      bool ok = false;
+      MFRC522::PICC_Type piccType = mfrc522->PICC_GetType(mfrc522->uid.sak);
+      bool classic = piccType == MFRC522::PICC_TYPE_MIFARE_1K || piccType == MFRC522::PICC_TYPE_MIFARE_4K;
+      size_t memLen = 0;
+      if (authFlags >= 0 && (authFlags & NFC_AUTH_FLAG_BLOCKED)) {
+        SECURE_LOG_ERROR("NFC", "Blocked card: %s", maskedUID.c_str());  // contenu non lu
+      } else if ((classic || piccType == MFRC522::PICC_TYPE_MIFARE_UL) && readCachedText(piccType, uid, text, &ok)) {
+        readCacheLastUs = micros() - tapUs;
+      } else if (piccType == MFRC522::PICC_TYPE_MIFARE_UL) {
+        NtagReadInfo info;
+        ok = readUltralightText(text, &info, &memLen);
+        NfcReadCache_Store(&readCache, uid.bytes, uid.size, NTAG_FIRST_DATA_PAGE, tagMem, memLen,
+                           ok ? text.c_str() : nullptr, millis());
+        NfcTypeStats& st = typeStats[info.type];
+        st.reads++;
+        st.lastUs = micros() - tapUs;
+        st.lastBytes = info.bytesRead;
+        st.lastTransactions = info.transactions;
+        st.lastFastRead = info.fastRead;
+      } else if (classic) {
+        MfcReadInfo info;
+        uint8_t sectors = piccType == MFRC522::PICC_TYPE_MIFARE_4K ? MFC_SECTORS_4K : MFC_SECTORS_1K;
+        ok = readClassicText(text, sectors, &info, &memLen);
+        NfcReadCache_Store(&readCache, uid.bytes, uid.size, info.firstBlock, tagMem, memLen,
+                           ok ? text.c_str() : nullptr, millis());
+        classicStats.reads++;
+        classicStats.lastUs = micros() - tapUs;
+        classicStats.lastBytes = info.bytesRead;
+        classicStats.lastSectors = info.sectors;
+        classicStats.lastAuths = info.auths;
+        classicStats.lastAuthFailures = info.authFailures;
+        classicStats.lastMad = info.mad;
+      }
+      if (ok) {
+        sendEvent(ORCH_EVT_NFC_DATA, text.c_str());
+      }
+      read = true;
     }
+  }
+
+  Rc522Drv_HaltA(&rc522Drv);
+  mfrc522->PCD_StopCrypto1();
+  return read;
+}
+
+static void scanWindow() {
+  nfcBusy = true;
+  waitStats.windows++;
+  Serial.println("[NFC] Scan window opened");
+
+  uint32_t rfStartUs = micros();
+  if (bgEnabled) {
+    mfrc522->PCD_AntennaOn();
+    vTaskDelay(pdMS_TO_TICKS(NFC_BG_SETTLE_MS));
+  }
 
-    if (!found) {
-      sendEvent(ORCH_EVT_NFC_ERROR, "TIMEOUT");
-      Serial.println("[NFC] TIMEOUT");
+  // Fenêtre de scan limitée dans le temps
+  const unsigned long startMs = millis();
+  bool found = false;
+  lastUidHex = "";
+  lastReadMs = 0;
+
+  while (waitCard(startMs)) {
+    if (readCard(false)) {
+      waitStats.lastDetectMs = millis() - startMs;
+      found = true;
+      break;
     }
+  }
 
-    nfcBusy = false;
-    Serial.println("[NFC] Scan window closed");
-    // Boucle: retour à l'attente d'une nouvelle notification
+  if (!found) {
+    sendEvent(ORCH_EVT_NFC_ERROR, "TIMEOUT");
+    Serial.println("[NFC] TIMEOUT");
+  }
+
+  if (bgEnabled) {
+    mfrc522->PCD_AntennaOff();
+    NfcDuty_AddRfOn(&bgDuty, micros() - rfStartUs);
+    NfcDuty_MarkActivity(&bgDuty, millis());
+  }
+
+  nfcBusy = false;
+  Serial.println("[NFC] Scan window closed");
+}
+
+// Salve de détection: champ allumé, REQA, ATQA attendu, champ éteint.
+// Attente active de l'ATQA (quelques centaines de us): dormir un tick FreeRTOS
+// laisserait le champ allumé plus longtemps que l'échange lui-même.
+static void backgroundBurst() {
+  uint32_t startMs = millis();
+  uint32_t t0 = micros();
+  mfrc522->PCD_AntennaOn();
+  vTaskDelay(pdMS_TO_TICKS(NFC_BG_SETTLE_MS));
+
+  Rc522Irq_ArmReqa(&rc522Bus);
+  delayMicroseconds(NFC_BG_ATQA_US);
+  bool present = Rc522Irq_CardResponded(&rc522Bus);
+  Rc522Irq_Clear(&rc522Bus);
+
+  // Champ coupé entre les salves: une carte restée posée repart de IDLE et répond à chaque REQA.
+  // Signalée une seule fois tant qu'elle répond; une salve sans ATQA la considère retirée.
+  bool reported = false;
+  if (present) {
+    reported = readCard(true);
+  } else {
+    NfcDuty_CardGone(&bgDuty);
   }
+  mfrc522->PCD_AntennaOff();
+  NfcDuty_RecordBurst(&bgDuty, startMs, micros() - t0, reported);
 }
 
+// Applique les demandes NfcService_SetBackground / SetBackgroundBudget
+static void applyBackgroundRequest() {
+  bool requested = bgRequested;
+  if (requested && !bgEnabled) {
+    NfcDutyConfig cfg = {
+      NFC_BG_IDLE_INTERVAL_MS,
+      NFC_BG_ACTIVE_INTERVAL_MS,
+      NFC_BG_ACTIVE_HOLD_MS,
+      NFC_BG_BURST_US,
+      bgBudgetPermille
+    };
+    NfcDuty_Init(&bgDuty, &cfg, millis());
+    mfrc522->PCD_AntennaOff();
+    bgEnabled = true;
+    Serial.println("[NFC] Background detection ON");
+  } else if (!requested && bgEnabled) {
+    mfrc522->PCD_AntennaOn();
+    bgEnabled = false;
+    Serial.println("[NFC] Background detection OFF");
+  }
+  if (bgEnabled && bgDuty.cfg.budgetPermille != bgBudgetPermille) {
+    NfcDuty_SetBudget(&bgDuty, bgBudgetPermille);
+  }
+}
 
+static void nfcTask(void* pvParameters) {
+  for (;;) {
+    applyBackgroundRequest();
+
+    // Attente passive d'une notification (scan, changement de mode) ou de la prochaine salve
+    TickType_t wait = portMAX_DELAY;
+    if (bgEnabled) wait = pdMS_TO_TICKS(NfcDuty_NextBurstDelayMs(&bgDuty, millis()));
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, 0xFFFFFFFF, &bits, wait);
+
+    if (bits & NFC_NOTIFY_SCAN) {
+      scanWindow();
+      continue;
+    }
+    if (bgEnabled && !bgRequested) continue;  // arrêt demandé pendant l'attente
+    if (bgEnabled && NfcDuty_NextBurstDelayMs(&bgDuty, millis()) == 0) {
+      backgroundBurst();
+    }
+  }
+}
@@ -1,88 +1,119 @@
 #include "services/qr_service.h"
 #include "config.h"
 #include "orchestrator.h"
+#include "qr_scan.h"
+#include "services/capture_service.h"
+#include "driver/uart.h"
+
+#define QR_UART_NUM UART_NUM_2
 
 static TaskHandle_t qrTaskHandle = nullptr;
 static volatile bool hexDumpEnabled = false;
 static QueueHandle_t orchestratorQueueHandle = nullptr;
+static QueueHandle_t qrUartQueue = nullptr;
+static QrScanAssembler scan;
 
-static void qrTask(void* pvParameters) {
-  String line;
-  line.reserve(256);
-  unsigned long lastByteMs = 0;
-  const unsigned long interCharFlushMs = 40; // si pas de fin de ligne, flush après un court silence
+static void handleLine(const char* line, size_t len) {
+  Serial.printf("[QR] %.*s\n", (int)len, line);
 
-  for (;;) {
-    while (Serial2.available() > 0) {
-      uint8_t b = (uint8_t)Serial2.read();
-      lastByteMs = millis();
-      if (hexDumpEnabled) {
-        Serial.printf("%02X ", b);
-        // Fin de ligne: si pause, on passe à la ligne
-        continue;
-      }
-      char c = (char)b;
-      if (c == '\n' || c == '\r') {
-        if (line.length() > 0) {
-          Serial.print("[QR] ");
-          Serial.println(line);
-          
-          // Détecter et traiter les tokens QR
-          if (line.startsWith("qr_") && line.indexOf("_") != line.lastIndexOf("_")) {
-            Serial.println("[QR] Token QR détecté, envoi à l'orchestrateur");
-            if (orchestratorQueueHandle) {
-              OrchestratorEvent evt{};
-              evt.type = ORCH_EVT_QR_TOKEN_READ;
-              line.toCharArray(evt.payload, sizeof(evt.payload) - 1);
-              evt.payload[sizeof(evt.payload) - 1] = '\0';
-              xQueueSend(orchestratorQueueHandle, &evt, 0);
-            }
-          }
-          
-          line = "";
-        }
-      } else {
-        line += c;
-        if (line.length() > 250) {
-          // éviter dépassement
-          Serial.print("[QR] (tronc) ");
-          Serial.println(line);
-          line = "";
-        }
-      }
+  // Détecter et traiter les tokens QR
+  if (QrScan_IsToken(line, len)) {
+    Serial.println("[QR] Token QR détecté, envoi à l'orchestrateur");
+    if (orchestratorQueueHandle) {
+      OrchestratorEvent evt{};
+      evt.type = ORCH_EVT_QR_TOKEN_READ;
+      size_t n = len < sizeof(evt.payload) - 1 ? len : sizeof(evt.payload) - 1;
+      memcpy(evt.payload, line, n);
+      evt.payload[n] = '\0';
+      xQueueSend(orchestratorQueueHandle, &evt, 0);
     }
-    // Flush par timeout inter-caractère si pas de fin de ligne
-    if (!hexDumpEnabled && line.length() > 0 && (millis() - lastByteMs) > interCharFlushMs) {
-      Serial.print("[QR] ");
-      Serial.println(line);
-      
-      // Détecter et traiter les tokens QR même en cas de timeout
-      if (line.startsWith("qr_") && line.indexOf("_") != line.lastIndexOf("_")) {
-        Serial.println("[QR] Token QR détecté (timeout), envoi à l'orchestrateur");
-        if (orchestratorQueueHandle) {
-          OrchestratorEvent evt{};
-          evt.type = ORCH_EVT_QR_TOKEN_READ;
-          line.toCharArray(evt.payload, sizeof(evt.payload) - 1);
-          evt.payload[sizeof(evt.payload) - 1] = '\0';
-          xQueueSend(orchestratorQueueHandle, &evt, 0);
-        }
+  }
+}
+
+// idle: le bloc se termine sur un silence (RX timeout), il clôt la ligne en cours
+static void processChunk(const uint8_t* data, size_t n, bool idle) {
+  if (hexDumpEnabled) {
+    for (size_t i = 0; i < n; i++) Serial.printf("%02X ", data[i]);
+    if (idle) Serial.println();
+    return;
+  }
+  uint32_t truncated = scan.truncated;
+  size_t off = 0;
+  do {
+    const char* line;
+    size_t len;
+    off += QrScan_Push(&scan, data + off, n - off, idle, &line, &len);
+    if (line) handleLine(line, len);
+  } while (off < n);
+  if (scan.truncated != truncated) Serial.println("[QR] (tronc) ligne trop longue ignorée");
+}
+
+// Lit 'size' octets du driver dans un buffer fixe et les passe au découpage sans copie
+static void readAndDispatch(size_t size, bool idle) {
+  static uint8_t rx[128];
+  while (size > 0) {
+    size_t want = size < sizeof(rx) ? size : sizeof(rx);
+    int n = uart_read_bytes(QR_UART_NUM, rx, want, 0);
+    if (n <= 0) break;
+    size -= (size_t)n;
+    CaptureService_Record(UART_CAPTURE_CH_QR, UART_CAPTURE_RX, rx, (size_t)n);
+    processChunk(rx, (size_t)n, idle && size == 0);
+  }
+  // Octets déjà lus par un événement précédent: clôturer quand même la ligne en attente
+  if (idle && size > 0) processChunk(rx, 0, true);
+}
+
+static void qrTask(void* pvParameters) {
+  uart_event_t event;
+  for (;;) {
+    // Aucun réveil sans activité: le driver signale fin de ligne, silence ou débordement
+    if (xQueueReceive(qrUartQueue, &event, portMAX_DELAY) != pdTRUE) continue;
+    switch (event.type) {
+      case UART_DATA:
+        readAndDispatch(event.size, event.timeout_flag);
+        break;
+      case UART_PATTERN_DET: {
+        // -1: motif déjà consommé par un UART_DATA ou file de positions pleine -> tout lire
+        int pos = uart_pattern_pop_pos(QR_UART_NUM);
+        size_t buffered = 0;
+        uart_get_buffered_data_len(QR_UART_NUM, &buffered);
+        readAndDispatch(pos >= 0 ? (size_t)pos + 1 : buffered, false);
+        break;
       }
-      
-      line = "";
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL:
+        Serial.println("[QR] RX overflow, buffer vidé");
+        uart_flush_input(QR_UART_NUM);
+        xQueueReset(qrUartQueue);
+        QrScan_Init(&scan);
+        break;
+      default:
+        break;
     }
-
-    vTaskDelay(pdMS_TO_TICKS(5));
   }
 }
 
 void StartTaskQrService(QueueHandle_t orchestratorQueue) {
   orchestratorQueueHandle = orchestratorQueue;
   
-  // Initialiser l'UART2 pour le scanner (D16/D17)
-  const uint32_t fixedBaud = 115200;
-  Serial2.begin(fixedBaud, SERIAL_8N1, QR_UART_RX_PIN, QR_UART_TX_PIN);
-  Serial.printf("[QR] UART2 start @ %lu bps (RX=%d, TX=%d)\n", (unsigned long)fixedBaud, QR_UART_RX_PIN, QR_UART_TX_PIN);
-  if (!qrTaskHandle) {
+  // Initialiser l'UART2 pour le scanner (D16/D17) via le driver IDF
+  if (!qrUartQueue) {
+    uart_config_t cfg = {};
+    cfg.baud_rate = QR_UART_BAUDRATE;
+    cfg.data_bits = UART_DATA_8_BITS;
+    cfg.parity = UART_PARITY_DISABLE;
+    cfg.stop_bits = UART_STOP_BITS_1;
+    cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    uart_driver_install(QR_UART_NUM, QR_UART_RX_BUFFER_BYTES, 0, QR_UART_EVENT_QUEUE_LEN, &qrUartQueue, 0);
+    uart_param_config(QR_UART_NUM, &cfg);
+    uart_set_pin(QR_UART_NUM, QR_UART_TX_PIN, QR_UART_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    uart_enable_pattern_det_baud_intr(QR_UART_NUM, QR_UART_PATTERN_CHR, 1, 9, 0, 0);
+    uart_pattern_queue_reset(QR_UART_NUM, QR_UART_EVENT_QUEUE_LEN);
+    uart_set_rx_timeout(QR_UART_NUM, QR_UART_RX_TIMEOUT_SYMBOLS);
+    QrScan_Init(&scan);
+  }
+  Serial.printf("[QR] UART2 start @ %lu bps (RX=%d, TX=%d)\n", (unsigned long)QR_UART_BAUDRATE, QR_UART_RX_PIN, QR_UART_TX_PIN);
+  if (!qrTaskHandle && qrUartQueue) {
     xTaskCreate(qrTask, "qr_service", 4096, nullptr, 1, &qrTaskHandle);
   }
 }
@@ -93,13 +124,23 @@ void StopTaskQrService() {
     qrTaskHandle = nullptr;
     Serial.println("[QR] service stopped");
   }
+  if (qrUartQueue) {
+    uart_driver_delete(QR_UART_NUM);
+    qrUartQueue = nullptr;
+  }
 }
 
 bool QrService_IsRunning() {
   return qrTaskHandle != nullptr;
 }
 
+size_t QrService_Write(const uint8_t* data, size_t len) {
+  if (!qrUartQueue || !data || len == 0) return 0;
+  int n = uart_write_bytes(QR_UART_NUM, (const char*)data, len);
+  if (n <= 0) return 0;
+  CaptureService_Record(UART_CAPTURE_CH_QR, UART_CAPTURE_TX, data, (size_t)n);
+  return (size_t)n;
+}
+
 void QrService_SetHexDump(bool enable) { hexDumpEnabled = enable; }
 bool QrService_GetHexDump() { return hexDumpEnabled; }
-
-
@@ -0,0 +1,127 @@
+#include "services/token_verifier.h"
+#include "env_config.h"
+#include "security_config.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/md.h"
+#include <time.h>
+
+// Clé publique chargée une fois: groupe et point prêts pour chaque vérification
+struct VerifierKey {
+  mbedtls_ecp_group grp;
+  mbedtls_ecp_point q;
+  bool loaded;
+};
+
+static VerifierKey provisionedKey;
+
+// Vecteur de mesure (clé de test dédiée, sans lien avec la clé de production)
+static const char* benchPublicKey = "BD9Pyzr_bemgScUiubQAxAa97tU0vJojN1jXtZ0GC_7toO_Oqbld8IPS1rfgyCTRcOCq5Aqh7hKUraJJqKZfx2s";
+static const char* benchMachineId = "BENCH-01";
+static const char* benchToken =
+  "qrs_AfSGVwAOb3JkXzhmM2EyYzFkOWUIQkVOQ0gtMDEDAwEMAhsBGXArAmes1rz4uEHsdN5sf7A1BmfeDHVN4uRbs-rwQV1UgkIBYGFPg0YtCU4fFI_IPfyyYAHW4jf1GPZ6UNuzsA";
+static const uint32_t benchNowUnix = 1750000000u;
+
+static void keyFree(VerifierKey* k) {
+  if (!k->loaded) return;
+  mbedtls_ecp_point_free(&k->q);
+  mbedtls_ecp_group_free(&k->grp);
+  k->loaded = false;
+}
+
+static bool keyLoad(VerifierKey* k, const char* b64) {
+  keyFree(k);
+  uint8_t raw[QR_OFFLINE_PUBLIC_KEY_SIZE + 1];
+  int n = b64 ? QrOffline_Base64UrlDecode(b64, strlen(b64), raw, sizeof(raw)) : -1;
+  if (n != QR_OFFLINE_PUBLIC_KEY_SIZE) return false;
+
+  mbedtls_ecp_group_init(&k->grp);
+  mbedtls_ecp_point_init(&k->q);
+  k->loaded = true;
+  if (mbedtls_ecp_group_load(&k->grp, MBEDTLS_ECP_DP_SECP256R1) != 0 ||
+      mbedtls_ecp_point_read_binary(&k->grp, &k->q, raw, (size_t)n) != 0 ||
+      mbedtls_ecp_check_pubkey(&k->grp, &k->q) != 0) {
+    keyFree(k);
+    return false;
+  }
+  return true;
+}
+
+// QrOfflineVerifyFn: SHA-256 puis ECDSA (accélérateurs SHA et MPI de l'ESP32 via mbedtls)
+static bool verifySignature(void* ctx, const uint8_t* msg, size_t msgLen, const uint8_t* sig, size_t sigLen) {
+  VerifierKey* k = (VerifierKey*)ctx;
+  if (!k || !k->loaded || sigLen != QR_OFFLINE_SIGNATURE_SIZE) return false;
+
+  uint8_t hash[32];
+  if (mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), msg, msgLen, hash) != 0) return false;
+
+  mbedtls_mpi r, s;
+  mbedtls_mpi_init(&r);
+  mbedtls_mpi_init(&s);
+  bool ok = mbedtls_mpi_read_binary(&r, sig, 32) == 0 &&
+            mbedtls_mpi_read_binary(&s, sig + 32, 32) == 0 &&
+            mbedtls_ecdsa_verify(&k->grp, hash, sizeof(hash), &k->q, &r, &s) == 0;
+  mbedtls_mpi_free(&r);
+  mbedtls_mpi_free(&s);
+  return ok;
+}
+
+bool TokenVerifier_Init() {
+  const char* key = EnvConfig::GetQrPublicKey();
+  if (!key || !key[0]) {
+    SECURE_LOG_INFO("QRSIG", "No QR_TOKEN_PUBLIC_KEY, signed tokens go through the backend");
+    keyFree(&provisionedKey);
+    return false;
+  }
+  // Sans affectation, un même token serait servi une fois sur chaque machine pendant une coupure
+  const char* machineId = EnvConfig::GetMachineId();
+  if (!machineId || !machineId[0]) {
+    SECURE_LOG_ERROR("QRSIG", "QR_TOKEN_PUBLIC_KEY without MACHINE_ID, offline verification disabled");
+    keyFree(&provisionedKey);
+    return false;
+  }
+  if (!keyLoad(&provisionedKey, key)) {
+    SECURE_LOG_ERROR("QRSIG", "Invalid QR_TOKEN_PUBLIC_KEY (expected base64url P-256 point, 65 bytes)");
+    return false;
+  }
+  SECURE_LOG_INFO("QRSIG", "Offline token verification enabled");
+  return true;
+}
+
+bool TokenVerifier_IsReady() {
+  return provisionedKey.loaded;
+}
+
+QrOfflineResult TokenVerifier_Check(const char* token, QrOfflineOrder* out) {
+  if (!token) return QR_OFFLINE_MALFORMED;
+  return QrOffline_Verify(token, strlen(token), (uint32_t)time(nullptr), EnvConfig::GetMachineId(),
+                          verifySignature, &provisionedKey, out);
+}
+
+void TokenVerifier_Benchmark(int iterations) {
+  if (iterations <= 0) iterations = 20;
+  VerifierKey key = {};
+  if (!keyLoad(&key, benchPublicKey)) {
+    Serial.println("[QRSIG] Benchmark: test key load failed");
+    return;
+  }
+
+  QrOfflineOrder order;
+  size_t len = strlen(benchToken);
+  uint32_t t0 = micros();
+  int ok = 0;
+  for (int i = 0; i < iterations; i++) {
+    if (QrOffline_Verify(benchToken, len, benchNowUnix, benchMachineId, verifySignature, &key, &order) == QR_OFFLINE_OK) ok++;
+  }
+  uint32_t t1 = micros();
+  // Décodage et contrôles seuls (signature supposée valide) pour isoler le coût ECDSA
+  auto accept = [](void*, const uint8_t*, size_t, const uint8_t*, size_t) { return true; };
+  for (int i = 0; i < iterations; i++) {
+    QrOffline_Verify(benchToken, len, benchNowUnix, benchMachineId, accept, nullptr, &order);
+  }
+  uint32_t t2 = micros();
+  keyFree(&key);
+
+  Serial.printf("[QRSIG] Benchmark: %d/%d valid, verify %lu us/token (parse %lu us), CPU %lu MHz\n",
+                ok, iterations, (unsigned long)((t1 - t0) / iterations),
+                (unsigned long)((t2 - t1) / iterations), (unsigned long)getCpuFrequencyMhz());
+}
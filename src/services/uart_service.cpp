@@ -8,23 +8,103 @@
 #include <HardwareSerial.h>
 #include "services/wifi_service.h"
 #include "uart_parser.h"
+#include "uart_frame.h"
+#include "uart_baud.h"
+#include "uart_line.h"
+#include "uart_tx.h"
+#include "services/capture_service.h"
+#include "freertos/semphr.h"
 
 static TaskHandle_t uartTaskHandle = nullptr;
+static TaskHandle_t uartTxTaskHandle = nullptr;
 static QueueHandle_t orchestratorQueueHandle = nullptr;
 static HardwareSerial SerialNucleo(1);
 
+// Mode de liaison courant (texte par défaut, binaire après négociation)
+enum UartLinkMode {
+  UART_LINK_TEXT = 0,
+  UART_LINK_BINARY = 1
+};
+
+static volatile UartLinkMode linkMode = UART_LINK_TEXT;
+static UartFrameLink frameLink;
+static UartFrameDecoder frameDecoder;
+static SemaphoreHandle_t linkMutex = nullptr;
+static uint32_t frameErrors = 0;
+static UartLineAssembler lineAssembler;
+// Détection d'une ligne texte PROTO:TEXT pendant le mode binaire (repli côté NUCLEO)
+static char shadowLine[sizeof(UART_PROTO_FALLBACK_TEXT)];
+static size_t shadowLen = 0;
+static bool shadowAtBoundary = false;   // ligne commencée entre deux trames, pas dans un payload
+// La ligne de bascule est coupée au '\r' de "\r\n": le '\n' restant ne fait pas partie de la première trame
+static bool frameSkipLf = false;
+
+// Émission: une seule tâche écrit sur SerialNucleo (hors négociation, sous linkMutex)
+static QueueHandle_t txQueue = nullptr;          // messages (blocs ORDER_START gardés contigus)
+static QueueHandle_t txPriorityQueue = nullptr;  // réponses ACK/NAK/ERR
+static SemaphoreHandle_t txProducerMutex = nullptr;
+static UartTxStats txStats;
+static bool txInBlock = false;                   // bloc multi-lignes en cours d'émission
+
+// Négociation du débit
+static UartBaudState baudState;
+static volatile uint32_t hwRxErrors = 0;      // erreurs de trame/parité signalées par le driver
+static uint32_t hwRxErrorsSeen = 0;
+static volatile bool downgradeRequested = false;
+static uint32_t lastDowngradeMs = 0;
+static uint32_t lastRxMs = 0;
+// Lignes métier (VEND_*, DELIVERY_*...) reçues pendant la négociation, traitées à sa sortie
+static char deferredLines[UART_NEGOTIATION_DEFER_LINES][UART_LINE_MAX + 1];
+static size_t deferredLens[UART_NEGOTIATION_DEFER_LINES];
+static uint8_t deferredCount = 0;
+
 static void uartTask(void* pvParameters);
+static void uartTxTask(void* pvParameters);
+static void handleIncomingLine(const char* line, size_t len);
+static void fallbackToText(const char* reason);
+
+// Appelé depuis la tâche d'événements du driver UART
+static void onNucleoRxError(hardwareSerial_error_t err) {
+  if (err == UART_FRAME_ERROR || err == UART_PARITY_ERROR) {
+    hwRxErrors++;
+  }
+}
 
 void StartTaskUartService(QueueHandle_t orchestratorQueue) {
   orchestratorQueueHandle = orchestratorQueue;
 
+  // Buffer TX driver: une écriture groupée ne bloque pas la tâche d'émission
+  SerialNucleo.setTxBufferSize(2 * UART_TX_BATCH_MAX);
   // Config pins si nécessaire (selon board) + begin
   SerialNucleo.begin(UART_BAUDRATE, SERIAL_8N1, UART_RX_PIN, UART_TX_PIN);
+  SerialNucleo.onReceiveError(onNucleoRxError);
+  UartBaud_Init(&baudState, UART_BAUDRATE, UART_BAUD_MAX);
   SECURE_LOG_INFO("UART1", "Started @ %lu bps (RX=%d, TX=%d)", (unsigned long)UART_BAUDRATE, UART_RX_PIN, UART_TX_PIN);
 #if UART0_FALLBACK_ENABLED
   SECURE_LOG_INFO("UART0", "USB monitor active @ 115200 (RX0/TX0)");
 #endif
 
+  if (!linkMutex) {
+    linkMutex = xSemaphoreCreateMutex();
+  }
+  if (!txQueue) {
+    txQueue = xQueueCreate(UART_TX_QUEUE_LENGTH, sizeof(UartTxLine));
+    txPriorityQueue = xQueueCreate(UART_TX_PRIORITY_QUEUE_LENGTH, sizeof(UartTxLine));
+    txProducerMutex = xSemaphoreCreateMutex();
+    UartTxStats_Init(&txStats);
+  }
+
+  if (!uartTxTaskHandle) {
+    xTaskCreate(
+      uartTxTask,
+      "uart_tx",
+      UART_TX_TASK_STACK_SIZE,
+      nullptr,
+      UART_TX_TASK_PRIORITY,
+      &uartTxTaskHandle
+    );
+  }
+
   if (!uartTaskHandle) {
     xTaskCreate(
       uartTask,
@@ -35,147 +115,677 @@ void StartTaskUartService(QueueHandle_t orchestratorQueue) {
       &uartTaskHandle
     );
   }
+  // Négociation du débit puis du protocole: faite au démarrage de la tâche UART
 }
 
-void UartService_SendLine(const char* line) {
-  if (!line) return;
-  SerialNucleo.println(line);
+// Ligne de contrôle écrite directement (négociation), hors tâche d'émission: linkMutex pris
+static void writeControlLine(const char* line) {
+  char buf[64];
+  int n = snprintf(buf, sizeof(buf), "%s\r\n", line);
+  if (n <= 0 || (size_t)n >= sizeof(buf)) return;
+  SerialNucleo.write((const uint8_t*)buf, (size_t)n);
+  CaptureService_Record(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, (const uint8_t*)buf, (size_t)n);
 }
 
-static void publishEvent(OrchestratorEventType type, const char* payload) {
-  if (!orchestratorQueueHandle) return;
-  OrchestratorEvent evt{};
-  evt.type = type;
-  if (payload) {
-    strncpy(evt.payload, payload, sizeof(evt.payload) - 1);
-    evt.payload[sizeof(evt.payload) - 1] = '\0';
-  } else {
-    evt.payload[0] = '\0';
+// ---- Négociation du débit ----
+
+static void deferLine(const char* line, size_t len) {
+  if (deferredCount >= UART_NEGOTIATION_DEFER_LINES) {
+    SECURE_LOG_ERROR("UART1", "Line lost during negotiation (%u chars)", (unsigned)len);
+    return;
   }
-  xQueueSend(orchestratorQueueHandle, &evt, 0);
+  memcpy(deferredLines[deferredCount], line, len + 1);
+  deferredLens[deferredCount++] = len;
 }
 
-static void handleIncomingLine(const String& line) {
-  // Rate limiting UART
-  if (!rateLimitCheck("UART", UART_COMMAND_COOLDOWN_MS)) {
-    SECURE_LOG_ERROR("UART", "Command rate limited");
-    UartService_SendLine("ERR:RATE_LIMIT");
-    return;
+// Réponses attendues par la négociation (BAUD_OK, écho TRAIN, refus ERR:...)
+static bool isNegotiationReply(const char* line, size_t len) {
+  size_t argOffset = 0;
+  UartMsgType type = UartLine_Classify(line, len, &argOffset);
+  return type == UART_MSG_BAUD_OK || type == UART_MSG_BAUD_TRAIN || strncmp(line, "ERR:", 4) == 0;
+}
+
+// Consomme les octets reçus jusqu'à une réponse de négociation (copiée dans out si fourni).
+// Les autres lignes complètes sont différées, pas perdues. Tâche UART, linkMutex pris.
+static bool readNegotiationReply(char* out, size_t outSize) {
+  while (SerialNucleo.available() > 0) {
+    uint8_t b = (uint8_t)SerialNucleo.read();
+    const char* line;
+    size_t len;
+    UartLine_Push(&lineAssembler, &b, 1, &line, &len);
+    if (!line) continue;
+    char rec[UART_LINE_MAX + 1];
+    memcpy(rec, line, len);
+    rec[len] = '\n';
+    CaptureService_Record(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, (const uint8_t*)rec, len + 1);
+    if (!isNegotiationReply(line, len)) {
+      deferLine(line, len);
+    } else if (out) {
+      snprintf(out, outSize, "%s", line);
+      return true;
+    }
   }
-  
-  // Validation de la ligne
-  if (line.length() > MAX_UART_LINE_LENGTH) {
-    SECURE_LOG_ERROR("UART", "Line too long: %d chars", line.length());
-    UartService_SendLine("ERR:LINE_TOO_LONG");
-    return;
+  return false;
+}
+
+// Lecture bloquante d'une réponse, réservée à la négociation (tâche UART uniquement)
+static bool readLineTimeout(char* out, size_t outSize, uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while ((millis() - start) < timeoutMs) {
+    if (readNegotiationReply(out, outSize)) return true;
+    vTaskDelay(pdMS_TO_TICKS(2));
   }
-  
-  // Log sécurisé (masquer données sensibles)
-  String maskedLine = line;
-  if (line.startsWith("STATE:PAYING") || line.startsWith("NFC_")) {
-    maskedLine = maskSensitiveData(line, 12);
-  }
-  SECURE_LOG_INFO("UART", "Processing: %s", maskedLine.c_str());
-  
-  // Traitement spécial pour les réponses de livraison
-  if (line.startsWith("DELIVERY_COMPLETED")) {
-    SECURE_LOG_INFO("UART", "Delivery completed successfully");
-    publishEvent(ORCH_EVT_DELIVERY_COMPLETED, line.c_str());
-    return;
+  return false;
+}
+
+static void switchBaudRate(uint32_t baud) {
+  // Lignes complètes reçues à l'ancien débit: gardées
+  readNegotiationReply(nullptr, 0);
+  SerialNucleo.flush();
+  SerialNucleo.updateBaudRate(baud);
+  vTaskDelay(pdMS_TO_TICKS(UART_BAUD_SWITCH_DELAY_MS));
+  // Octets reçus pendant la bascule: inexploitables
+  while (SerialNucleo.available() > 0) SerialNucleo.read();
+  UartLine_Init(&lineAssembler);
+  hwRxErrorsSeen = hwRxErrors;
+}
+
+// Traite les lignes différées, linkMutex rendu (un handler peut le reprendre)
+static void dispatchDeferredLines() {
+  char line[UART_LINE_MAX + 1];
+  while (deferredCount > 0) {
+    size_t len = deferredLens[0];
+    memcpy(line, deferredLines[0], len + 1);
+    deferredCount--;
+    memmove(deferredLines[0], deferredLines[1], deferredCount * sizeof(deferredLines[0]));
+    memmove(deferredLens, deferredLens + 1, deferredCount * sizeof(deferredLens[0]));
+    char masked[UART_LINE_MAX + 1];
+    maskSensitiveDataTo(line, len, 10, masked, sizeof(masked));
+    SECURE_LOG_INFO("UART1", "Received during negotiation: %s", masked);
+    handleIncomingLine(line, len);
   }
-  
-  if (line.startsWith("DELIVERY_FAILED")) {
-    SECURE_LOG_ERROR("UART", "Delivery failed: %s", line.c_str());
-    publishEvent(ORCH_EVT_DELIVERY_FAILED, line.c_str());
-    return;
+}
+
+enum BaudTryResult {
+  BAUD_TRY_OK = 0,
+  BAUD_TRY_REFUSED,       // pas de BAUD_OK: NUCLEO ancienne ou débit refusé
+  BAUD_TRY_TRAIN_FAILED   // motif d'entraînement corrompu à ce débit
+};
+
+// Appelé avec linkMutex pris: aucune autre tâche n'écrit pendant la bascule
+static BaudTryResult tryBaudRate(uint32_t baud) {
+  char line[48];
+  char echo[48];
+  UartBaud_FormatProposal(line, sizeof(line), baud);
+  writeControlLine(line);
+  if (!readLineTimeout(echo, sizeof(echo), UART_BAUD_REPLY_TIMEOUT_MS) || !UartBaud_IsAccept(echo, baud)) {
+    return BAUD_TRY_REFUSED;
   }
-  
-  // Traitement des confirmations de commande
-  if (line.startsWith("ORDER_ACK")) {
-    SECURE_LOG_INFO("UART", "Order acknowledged by NUCLEO");
-    return;
+
+  const uint32_t previous = baudState.currentBaud;
+  switchBaudRate(baud);
+  uint8_t good = 0;
+  for (uint8_t seq = 0; seq < UART_BAUD_TRAIN_LINES; seq++) {
+    UartBaud_FormatTrainingLine(line, sizeof(line), seq);
+    writeControlLine(line);
+    if (readLineTimeout(echo, sizeof(echo), UART_BAUD_TRAIN_TIMEOUT_MS) && UartBaud_CheckTrainingLine(echo, seq)) {
+      good++;
+    }
   }
-  
-  if (line.startsWith("ORDER_NAK")) {
-    SECURE_LOG_ERROR("UART", "Order rejected by NUCLEO: %s", line.c_str());
-    publishEvent(ORCH_EVT_DELIVERY_FAILED, line.c_str());
-    return;
+  if (UartBaud_TrainingPassed(good, UART_BAUD_TRAIN_LINES) && hwRxErrors == hwRxErrorsSeen) {
+    writeControlLine(UART_BAUD_COMMIT);
+    UartBaud_OnUpgradeSucceeded(&baudState, baud);
+    return BAUD_TRY_OK;
   }
-  
-  // Traitement des statuts de livraison par item
-  if (line.startsWith("VEND_COMPLETED")) {
-    SECURE_LOG_INFO("UART", "Vending completed for item: %s", line.c_str());
-    return;
+
+  // Sans BAUD_COMMIT, la NUCLEO revient d'elle-même au débit précédent
+  SECURE_LOG_WARN("UART1", "Training failed @ %lu bps (%u/%u echoes)", (unsigned long)baud, (unsigned)good, (unsigned)UART_BAUD_TRAIN_LINES);
+  switchBaudRate(previous);
+  UartBaud_OnUpgradeFailed(&baudState, baud);
+  return BAUD_TRY_TRAIN_FAILED;
+}
+
+// Essaie les débits candidats du plus rapide au plus lent
+static void negotiateBaudRate() {
+  xSemaphoreTake(linkMutex, portMAX_DELAY);
+  uint32_t baud;
+  while ((baud = UartBaud_NextCandidate(&baudState)) != 0) {
+    BaudTryResult r = tryBaudRate(baud);
+    if (r == BAUD_TRY_OK) {
+      SECURE_LOG_INFO("UART1", "Baud rate upgraded to %lu bps", (unsigned long)baud);
+      break;
+    }
+    if (r == BAUD_TRY_REFUSED) {
+      SECURE_LOG_INFO("UART1", "Baud upgrade to %lu refused, staying @ %lu bps",
+                      (unsigned long)baud, (unsigned long)baudState.currentBaud);
+      break;
+    }
   }
-  
-  if (line.startsWith("VEND_FAILED")) {
-    SECURE_LOG_ERROR("UART", "Vending failed for item: %s", line.c_str());
-    return;
+  xSemaphoreGive(linkMutex);
+  dispatchDeferredLines();
+}
+
+// Retour au débit de base après une rafale d'erreurs (ou sur BAUD_RESET de la NUCLEO)
+static void downgradeBaudRate(bool notifyPeer) {
+  downgradeRequested = false;
+  if (baudState.currentBaud == baudState.baseBaud) return;
+  if (linkMode == UART_LINK_BINARY) {
+    fallbackToText("baud rate downgrade");
   }
-  
-  // Traitement des messages de supervision
-  if (line.startsWith("SUPERVISION_ERROR:")) {
-    String jsonPayload = line.substring(18); // Enlever "SUPERVISION_ERROR:"
-    SECURE_LOG_INFO("UART", "Supervision error received from NUCLEO");
-    
-    // Transmettre la notification au backend via le service de supervision
-    // Le JSON contient déjà le format attendu par l'API
-    SupervisionService::SendErrorNotification(
-      SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE,
-      "NUCLEO supervision error: " + jsonPayload
-    );
+  xSemaphoreTake(linkMutex, portMAX_DELAY);
+  if (notifyPeer) {
+    writeControlLine(UART_BAUD_RESET);
+  }
+  SECURE_LOG_WARN("UART1", "Link errors @ %lu bps, back to %lu bps",
+                  (unsigned long)baudState.currentBaud, (unsigned long)baudState.baseBaud);
+  UartBaud_OnDowngrade(&baudState);
+  switchBaudRate(baudState.baseBaud);
+  xSemaphoreGive(linkMutex);
+  lastDowngradeMs = millis();
+  dispatchDeferredLines();
+}
+
+static void noteLinkError(UartBaudErrorKind kind) {
+  if (UartBaud_RecordError(&baudState, kind, millis())) {
+    downgradeRequested = true;
+  }
+}
+
+// Négociation complète: débit puis protocole binaire
+static void negotiateLink() {
+#if UART_BAUD_NEGOTIATION_ENABLED
+  negotiateBaudRate();
+#endif
+#if UART_BINARY_PROTOCOL_ENABLED
+  // Proposer le protocole binaire; une NUCLEO texte ignore ou répond ERR:UNKNOWN_CMD
+  UartService_SendLine(UART_PROTO_OFFER_BIN);
+#endif
+}
+
+// ---- Protocole binaire tramé ----
+
+// acceptLine: réponse texte à écrire juste avant la bascule (offre venant de la NUCLEO)
+static void enterBinaryMode(const char* acceptLine) {
+  xSemaphoreTake(linkMutex, portMAX_DELAY);
+  if (acceptLine) writeControlLine(acceptLine);
+  UartFrameLink_Init(&frameLink);
+  UartFrameDecoder_Init(&frameDecoder);
+  frameSkipLf = true;
+  linkMode = UART_LINK_BINARY;
+  xSemaphoreGive(linkMutex);
+  if (uartTxTaskHandle) xTaskNotifyGive(uartTxTaskHandle);
+  SECURE_LOG_INFO("UART1", "Binary framed protocol active");
+}
+
+// Lignes de la fenêtre jamais acquittées, réémises en texte dans l'ordre avant tout message
+// encore en file (un bloc ORDER_START...ORDER_END arrive entier). linkMutex pris.
+static unsigned resendUnackedAsText() {
+  uint8_t buf[UART_FRAME_MAX_PAYLOAD + 2];
+  size_t len;
+  unsigned count = 0;
+  while (UartFrameLink_TakeUnacked(&frameLink, buf, sizeof(buf) - 2, &len)) {
+    buf[len++] = '\r';
+    buf[len++] = '\n';
+    SerialNucleo.write(buf, len);
+    CaptureService_Record(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, buf, len);
+    count++;
+  }
+  return count;
+}
+
+static void fallbackToText(const char* reason) {
+  UartLine_Init(&lineAssembler);
+  xSemaphoreTake(linkMutex, portMAX_DELAY);
+  linkMode = UART_LINK_TEXT;
+  // La NUCLEO ne lit du texte qu'après PROTO:TEXT: réémission juste derrière
+  writeControlLine(UART_PROTO_FALLBACK_TEXT);
+  unsigned resent = resendUnackedAsText();
+  xSemaphoreGive(linkMutex);
+  SECURE_LOG_WARN("UART1", "Fallback to text protocol: %s (%u line(s) resent)", reason, resent);
+}
+
+// Traite un octet reçu en mode binaire
+static void handleFrameByte(uint8_t b) {
+  if (frameSkipLf) {
+    frameSkipLf = false;
+    if (b == '\n') return;
+  }
+  if (b == '\n' || b == '\r') {
+    // Un payload "PROTO:TEXT" suivi d'un octet de CRC 0x0A/0x0D ne compte pas: la ligne doit
+    // commencer à une frontière de trame (décodeur vide)
+    if (shadowAtBoundary && shadowLen == sizeof(shadowLine) - 1 &&
+        memcmp(shadowLine, UART_PROTO_FALLBACK_TEXT, shadowLen) == 0) {
+      shadowLen = 0;
+      UartLine_Init(&lineAssembler);
+      UartFrameDecoder_Init(&frameDecoder);
+      xSemaphoreTake(linkMutex, portMAX_DELAY);
+      linkMode = UART_LINK_TEXT;
+      unsigned resent = resendUnackedAsText();
+      xSemaphoreGive(linkMutex);
+      SECURE_LOG_WARN("UART1", "NUCLEO requested text protocol (%u line(s) resent)", resent);
+      return;
+    }
+    shadowLen = 0;
+  } else if (b == 0x00 || shadowLen >= sizeof(shadowLine) - 1) {
+    shadowLen = 0;
+  } else {
+    if (shadowLen == 0) shadowAtBoundary = (frameDecoder.len == 0);
+    shadowLine[shadowLen++] = (char)b;
+  }
+
+  UartFrame frame;
+  UartFrameStatus st = UartFrameDecoder_Push(&frameDecoder, b, &frame);
+  if (st == UART_FRAME_NONE) return;
+  if (st != UART_FRAME_OK) {
+    frameErrors++;
+    noteLinkError(UART_BAUD_ERR_CRC);
+    SECURE_LOG_WARN("UART1", "Frame rejected (status=%d)", (int)st);
     return;
   }
-  
-  UartResult r = UartParser_HandleLine(line.c_str(), WifiService_IsReady());
+
+  xSemaphoreTake(linkMutex, portMAX_DELAY);
+  bool deliver = UartFrameLink_OnFrame(&frameLink, &frame);
+  xSemaphoreGive(linkMutex);
+  // ACK à émettre / fenêtre libérée
+  xTaskNotifyGive(uartTxTaskHandle);
+  if (deliver) {
+    char line[UART_FRAME_MAX_PAYLOAD + 1];
+    memcpy(line, frame.payload, frame.len);
+    line[frame.len] = '\0';
+    char masked[UART_FRAME_MAX_PAYLOAD + 1];
+    maskSensitiveDataTo(line, frame.len, 10, masked, sizeof(masked));
+    SECURE_LOG_INFO("UART1", "Received frame #%u: %s", (unsigned)frame.seq, masked);
+    handleIncomingLine(line, frame.len);
+  }
+}
+
+// ---- Émission ----
+
+// Enfile toutes les lignes d'un message ou aucune; ne bloque jamais sur l'écriture driver
+static bool enqueueLines(const char* text, uint8_t flags) {
+  QueueHandle_t q = (flags & UART_TX_FLAG_PRIORITY) ? txPriorityQueue : txQueue;
+  size_t count = UartTx_CountLines(text);
+  if (!q || count == 0) {
+    txStats.dropped++;
+    SECURE_LOG_ERROR("UART1", "TX line rejected (empty or > %d chars)", UART_TX_LINE_MAX);
+    return false;
+  }
+
+  xSemaphoreTake(txProducerMutex, portMAX_DELAY);
+  bool fits = uxQueueSpacesAvailable(q) >= count;
+  if (fits) {
+    const char* cursor = text;
+    const uint32_t now = millis();
+    UartTxLine line;
+    while (UartTx_NextLine(&cursor, flags, now, &line)) {
+      xQueueSend(q, &line, 0);
+    }
+    UartTxStats_OnDepth(&txStats, (uint16_t)(uxQueueMessagesWaiting(txQueue) + uxQueueMessagesWaiting(txPriorityQueue)));
+  } else {
+    txStats.dropped += count;
+  }
+  xSemaphoreGive(txProducerMutex);
+
+  if (!fits) {
+    SECURE_LOG_ERROR("UART1", "TX queue full, %u line(s) dropped", (unsigned)count);
+    return false;
+  }
+  xTaskNotifyGive(uartTxTaskHandle);
+  return true;
+}
+
+// Réponse à une commande NUCLEO: passe devant les messages en attente
+static void sendReply(const char* line) {
+  enqueueLines(line, UART_TX_FLAG_PRIORITY);
+}
+
+void UartService_SendLine(const char* line) {
+  if (!line) return;
+  enqueueLines(line, 0);
+}
+
+// Ligne suivante: réponses prioritaires d'abord, sauf au milieu d'un bloc multi-lignes
+static bool txNextLine(UartTxLine* out) {
+  if (!txInBlock && xQueueReceive(txPriorityQueue, out, 0) == pdTRUE) return true;
+  if (xQueueReceive(txQueue, out, 0) != pdTRUE) return false;
+  txInBlock = (out->flags & UART_TX_FLAG_CONTINUED) != 0;
+  return true;
+}
+
+static void txWriteBatch(UartTxBatch* batch) {
+  if (batch->len == 0) return;
+  uint32_t start = micros();
+  SerialNucleo.write(batch->data, batch->len);
+  CaptureService_Record(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, batch->data, batch->len);
+  UartTxStats_OnWrite(&txStats, batch, millis(), micros() - start);
+  UartTxBatch_Reset(batch);
+}
+
+static void txFillText(UartTxBatch* batch) {
+  UartTxLine line;
+  while (txNextLine(&line)) {
+    if (!UartTxBatch_AppendLine(batch, &line)) {
+      txWriteBatch(batch);
+      UartTxBatch_AppendLine(batch, &line);
+    }
+  }
+}
+
+static void txFillBinary(UartTxBatch* batch) {
+  // Une ligne par trame, dans la limite de la fenêtre (les autres attendent les ACK en file)
+  UartTxLine line;
+  while (UartFrameLink_InFlight(&frameLink) < UART_FRAME_WINDOW_SIZE && txNextLine(&line)) {
+    // Ligne texte plus longue qu'une trame (NFC_TEXT long): rien à découper côté NUCLEO
+    if (!UartFrameLink_Send(&frameLink, (const uint8_t*)line.text, line.len)) {
+      txStats.dropped++;
+      SECURE_LOG_ERROR("UART1", "TX line too long for a frame (%u > %d chars)", (unsigned)line.len, UART_FRAME_MAX_PAYLOAD);
+      continue;
+    }
+    UartTxBatch_Track(batch, line.enqueuedMs);
+  }
+  // Trames prêtes: nouvelles, retransmises, ACK
+  uint8_t wire[UART_FRAME_ENCODED_MAX];
+  size_t n;
+  while ((n = UartFrameLink_Poll(&frameLink, millis(), wire, sizeof(wire))) > 0) {
+    if (!UartTxBatch_AppendBytes(batch, wire, n)) {
+      txWriteBatch(batch);
+      UartTxBatch_AppendBytes(batch, wire, n);
+    }
+  }
+}
+
+static void uartTxTask(void* pvParameters) {
+  static UartTxBatch batch;
+  UartTxBatch_Reset(&batch);
+
+  for (;;) {
+    // En binaire, réveil périodique pour les retransmissions
+    ulTaskNotifyTake(pdTRUE, linkMode == UART_LINK_BINARY ? pdMS_TO_TICKS(UART_TX_BINARY_POLL_MS) : portMAX_DELAY);
+
+    xSemaphoreTake(linkMutex, portMAX_DELAY);
+    if (linkMode == UART_LINK_BINARY) {
+      txFillBinary(&batch);
+    } else {
+      txFillText(&batch);
+    }
+    txWriteBatch(&batch);
+    xSemaphoreGive(linkMutex);
+
+    UartTxStats_OnDepth(&txStats, (uint16_t)(uxQueueMessagesWaiting(txQueue) + uxQueueMessagesWaiting(txPriorityQueue)));
+  }
+}
+
+uint32_t UartService_GetBaudRate() {
+  return baudState.currentBaud ? baudState.currentBaud : UART_BAUDRATE;
+}
+
+void UartService_DebugInfo() {
+  Serial.printf("[UART1] Mode=%s, InFlight=%u, Sent=%lu, Recv=%lu, Retx=%lu, Dup=%lu, Errors=%lu\n",
+                linkMode == UART_LINK_BINARY ? "BINARY" : "TEXT",
+                (unsigned)UartFrameLink_InFlight(&frameLink),
+                (unsigned long)frameLink.framesSent,
+                (unsigned long)frameLink.framesReceived,
+                (unsigned long)frameLink.retransmits,
+                (unsigned long)frameLink.duplicates,
+                (unsigned long)frameErrors);
+  Serial.printf("[UART1] TX depth=%u (max %u), Lines=%lu, Batches=%lu, Dropped=%lu, Latency=%lu/%lu/%lu ms (last/avg/max), Write=%lu/%lu us (last/max)\n",
+                (unsigned)txStats.depth,
+                (unsigned)txStats.depthMax,
+                (unsigned long)txStats.lines,
+                (unsigned long)txStats.batches,
+                (unsigned long)txStats.dropped,
+                (unsigned long)txStats.latencyLastMs,
+                (unsigned long)txStats.latencyAvgMs,
+                (unsigned long)txStats.latencyMaxMs,
+                (unsigned long)txStats.writeLastUs,
+                (unsigned long)txStats.writeMaxUs);
+  Serial.printf("[UART1] Baud=%lu (max %lu), FramingErr=%lu, CrcErr=%lu, Upgrades=%lu, Downgrades=%lu\n",
+                (unsigned long)baudState.currentBaud,
+                (unsigned long)baudState.maxBaud,
+                (unsigned long)baudState.framingErrors,
+                (unsigned long)baudState.crcErrors,
+                (unsigned long)baudState.upgrades,
+                (unsigned long)baudState.downgrades);
+}
+
+static void publishEvent(OrchestratorEventType type, const char* payload, size_t len) {
+  if (!orchestratorQueueHandle) return;
+  OrchestratorEvent evt{};
+  evt.type = type;
+  if (payload) {
+    if (len > sizeof(evt.payload) - 1) len = sizeof(evt.payload) - 1;
+    memcpy(evt.payload, payload, len);
+    evt.payload[len] = '\0';
+  } else {
+    evt.payload[0] = '\0';
+  }
+  xQueueSend(orchestratorQueueHandle, &evt, 0);
+}
+
+// ---- Traitement des lignes NUCLEO ----
+// Les handlers reçoivent une vue (ligne nul-terminée, longueur) sur le buffer de réception.
+
+static void onProtoAcceptBin(const char* line, size_t len) {
+  (void)line; (void)len;
+#if UART_BINARY_PROTOCOL_ENABLED
+  if (linkMode == UART_LINK_TEXT) enterBinaryMode(nullptr);
+#endif
+}
+
+static void onProtoOfferBin(const char* line, size_t len) {
+  (void)line; (void)len;
+#if UART_BINARY_PROTOCOL_ENABLED
+  if (linkMode == UART_LINK_TEXT) {
+    enterBinaryMode(UART_PROTO_ACCEPT_BIN);
+  }
+#else
+  sendReply(UART_PROTO_FALLBACK_TEXT);
+#endif
+}
+
+static void onBaudReset(const char* line, size_t len) {
+  (void)line; (void)len;
+  downgradeBaudRate(false);
+}
+
+// PROTO:TEXT, BAUD_OK / TRAIN tardifs: rien à faire hors négociation
+static void onIgnored(const char* line, size_t len) {
+  (void)line; (void)len;
+}
+
+static void onDeliveryCompleted(const char* line, size_t len) {
+  SECURE_LOG_INFO("UART", "Delivery completed successfully");
+  publishEvent(ORCH_EVT_DELIVERY_COMPLETED, line, len);
+}
+
+static void onDeliveryFailed(const char* line, size_t len) {
+  SECURE_LOG_ERROR("UART", "Delivery failed: %s", line);
+  publishEvent(ORCH_EVT_DELIVERY_FAILED, line, len);
+}
+
+static void onOrderAck(const char* line, size_t len) {
+  (void)line; (void)len;
+  SECURE_LOG_INFO("UART", "Order acknowledged by NUCLEO");
+}
+
+static void onOrderNak(const char* line, size_t len) {
+  SECURE_LOG_ERROR("UART", "Order rejected by NUCLEO: %s", line);
+  publishEvent(ORCH_EVT_DELIVERY_FAILED, line, len);
+}
+
+static void onVendCompleted(const char* line, size_t len) {
+  SECURE_LOG_INFO("UART", "Vending completed for item: %s", line);
+  publishEvent(ORCH_EVT_VEND_COMPLETED, line, len);
+}
+
+static void onVendFailed(const char* line, size_t len) {
+  SECURE_LOG_ERROR("UART", "Vending failed for item: %s", line);
+  publishEvent(ORCH_EVT_VEND_FAILED, line, len);
+}
+
+static void onSupervisionError(const char* line, size_t len) {
+  static const size_t prefixLen = sizeof("SUPERVISION_ERROR:") - 1;
+  SECURE_LOG_INFO("UART", "Supervision error received from NUCLEO");
+
+  // Transmettre la notification au backend via le service de supervision
+  // Le JSON contient déjà le format attendu par l'API
+  String message("NUCLEO supervision error: ");
+  message.concat(line + prefixLen, len - prefixLen);
+  SupervisionService::SendErrorNotification(SUPERVISION_ERROR_CRITICAL_SERVICE_FAILURE, message);
+}
+
+static void onParserLine(const char* line, size_t len) {
+  (void)len;
+  UartResult r = UartParser_HandleLine(line, WifiService_IsReady());
   switch (r) {
     case UART_ACK:
-      publishEvent(ORCH_EVT_STATE_PAYING, nullptr);
-      UartService_SendLine("ACK:STATE:PAYING");
+      publishEvent(ORCH_EVT_STATE_PAYING, nullptr, 0);
+      sendReply("ACK:STATE:PAYING");
       SECURE_LOG_INFO("UART", "ACK sent for payment state");
       break;
     case UART_NAK:
-      UartService_SendLine("NAK:STATE:PAYING:NO_NET");
+      sendReply("NAK:STATE:PAYING:NO_NET");
       SECURE_LOG_INFO("UART", "NAK sent - no network");
       break;
     case UART_ERR_TOO_LONG:
-      UartService_SendLine("ERR:LINE_TOO_LONG");
+      sendReply("ERR:LINE_TOO_LONG");
       SECURE_LOG_ERROR("UART", "Line length error");
       break;
     case UART_ERR_BAD_CHAR:
-      UartService_SendLine("ERR:BAD_CHAR");
+      noteLinkError(UART_BAUD_ERR_CRC);
+      sendReply("ERR:BAD_CHAR");
       SECURE_LOG_ERROR("UART", "Invalid character detected");
       break;
     case UART_UNKNOWN:
     default:
-      UartService_SendLine("ERR:UNKNOWN_CMD");
+      sendReply("ERR:UNKNOWN_CMD");
       SECURE_LOG_ERROR("UART", "Unknown command");
       break;
   }
 }
 
+typedef void (*UartLineHandler)(const char* line, size_t len);
+
+enum UartLineKind {
+  UART_LINE_CONTROL = 0,  // contrôle de liaison: ni rate limiting ni validation
+  UART_LINE_REPORT,       // compte rendu d'une commande en cours: validation, jamais limité
+                          // (un VEND_FAILED refusé serait confirmé livré au backend)
+  UART_LINE_COMMAND       // commande métier: rate limiting + validation
+};
+
+struct UartLineRoute {
+  UartLineHandler handler;
+  UartLineKind kind;
+};
+
+// Indexée par UartMsgType (même ordre que uart_line.h)
+static const UartLineRoute lineRoutes[UART_MSG_COUNT] = {
+  { onParserLine,        UART_LINE_COMMAND },  // UART_MSG_UNKNOWN
+  { onProtoAcceptBin,    UART_LINE_CONTROL },  // UART_MSG_PROTO_ACCEPT_BIN
+  { onProtoOfferBin,     UART_LINE_CONTROL },  // UART_MSG_PROTO_OFFER_BIN
+  { onIgnored,           UART_LINE_CONTROL },  // UART_MSG_PROTO_TEXT
+  { onBaudReset,         UART_LINE_CONTROL },  // UART_MSG_BAUD_RESET
+  { onIgnored,           UART_LINE_CONTROL },  // UART_MSG_BAUD_OK
+  { onIgnored,           UART_LINE_CONTROL },  // UART_MSG_BAUD_TRAIN
+  { onDeliveryCompleted, UART_LINE_REPORT  },  // UART_MSG_DELIVERY_COMPLETED
+  { onDeliveryFailed,    UART_LINE_REPORT  },  // UART_MSG_DELIVERY_FAILED
+  { onOrderAck,          UART_LINE_REPORT  },  // UART_MSG_ORDER_ACK
+  { onOrderNak,          UART_LINE_REPORT  },  // UART_MSG_ORDER_NAK
+  { onVendCompleted,     UART_LINE_REPORT  },  // UART_MSG_VEND_COMPLETED
+  { onVendFailed,        UART_LINE_REPORT  },  // UART_MSG_VEND_FAILED
+  { onSupervisionError,  UART_LINE_COMMAND },  // UART_MSG_SUPERVISION_ERROR
+};
+
+static void handleIncomingLine(const char* line, size_t len) {
+  size_t argOffset = 0;
+  UartMsgType type = UartLine_Classify(line, len, &argOffset);
+  const UartLineRoute& route = lineRoutes[type];
+
+  // Négociation de la liaison: non soumise au rate limiting
+  if (route.kind != UART_LINE_CONTROL) {
+    // Rate limiting UART (commandes seulement)
+    if (route.kind == UART_LINE_COMMAND && !rateLimitCheck(RATE_LIMIT_UART)) {
+      SECURE_LOG_ERROR("UART", "Command rate limited");
+      sendReply("ERR:RATE_LIMIT");
+      return;
+    }
+
+    // Validation de la ligne
+    if (len > MAX_UART_LINE_LENGTH) {
+      SECURE_LOG_ERROR("UART", "Line too long: %u chars", (unsigned)len);
+      sendReply("ERR:LINE_TOO_LONG");
+      return;
+    }
+
+    // Log sécurisé (masquer données sensibles)
+    if (strncmp(line, "STATE:PAYING", 12) == 0 || strncmp(line, "NFC_", 4) == 0) {
+      char masked[MAX_UART_LINE_LENGTH + 1];
+      maskSensitiveDataTo(line, len, 12, masked, sizeof(masked));
+      SECURE_LOG_INFO("UART", "Processing: %s", masked);
+    } else {
+      SECURE_LOG_INFO("UART", "Processing: %s", line);
+    }
+  }
+
+  route.handler(line, len);
+}
+
 static void uartTask(void* pvParameters) {
-  String buffer;
-  buffer.reserve(128);
+  uint8_t rx[64];
+  UartLine_Init(&lineAssembler);
+
+  negotiateLink();
 
   for (;;) {
-    while (SerialNucleo.available() > 0) {
-      char c = (char)SerialNucleo.read();
-      if (c == '\n' || c == '\r') {
-        if (buffer.length() > 0) {
-          // Log sécurisé sans révéler les données sensibles
-          String maskedBuffer = maskSensitiveData(buffer, 10);
-          SECURE_LOG_INFO("UART1", "Received: %s", maskedBuffer.c_str());
-          handleIncomingLine(buffer);
-          buffer = "";
+    int avail;
+    while ((avail = SerialNucleo.available()) > 0) {
+      size_t n = SerialNucleo.read(rx, (size_t)avail < sizeof(rx) ? (size_t)avail : sizeof(rx));
+      lastRxMs = millis();
+      CaptureService_Record(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, rx, n);
+      size_t off = 0;
+      while (off < n) {
+        // Le mode peut changer au milieu d'un bloc (PROTO:BIN1 suivi de trames)
+        if (linkMode == UART_LINK_BINARY) {
+          handleFrameByte(rx[off++]);
+          continue;
         }
-      } else {
-        buffer += c;
-        if (buffer.length() > 120) {
-          buffer = ""; // éviter débordement
+        const char* line;
+        size_t len;
+        off += UartLine_Push(&lineAssembler, rx + off, n - off, &line, &len);
+        if (line) {
+          // Log sécurisé sans révéler les données sensibles
+          char masked[UART_LINE_MAX + 1];
+          maskSensitiveDataTo(line, len, 10, masked, sizeof(masked));
+          SECURE_LOG_INFO("UART1", "Received: %s", masked);
+          handleIncomingLine(line, len);
         }
       }
     }
+    // Retransmissions et ACK: émis par la tâche uart_tx
+    if (linkMode == UART_LINK_BINARY && frameLink.failed) {
+      fallbackToText("retransmissions exhausted");
+    }
+
+    // Erreurs matérielles remontées par le driver depuis le dernier tour
+    uint32_t hwErrors = hwRxErrors;
+    while (hwRxErrorsSeen != hwErrors) {
+      hwRxErrorsSeen++;
+      noteLinkError(UART_BAUD_ERR_FRAMING);
+    }
+    if (downgradeRequested) {
+      downgradeBaudRate(true);
+    }
+#if UART_BAUD_NEGOTIATION_ENABLED
+    // Nouvel essai après un repli, uniquement liaison au repos et aucune commande en cours
+    // (un VEND_* ou DELIVERY_* attendu ne doit pas tomber pendant la bascule)
+    if (lastDowngradeMs != 0 && baudState.currentBaud == baudState.baseBaud &&
+        (millis() - lastDowngradeMs) >= UART_BAUD_RETRY_INTERVAL_MS &&
+        (millis() - lastRxMs) >= UART_BAUD_RETRY_QUIET_MS && Orchestrator_IsIdle() &&
+        uxQueueMessagesWaiting(txQueue) == 0 && UartBaud_NextCandidate(&baudState) != 0) {
+      lastDowngradeMs = 0;
+      negotiateLink();
+    }
+#endif
     vTaskDelay(pdMS_TO_TICKS(10));
   }
 }
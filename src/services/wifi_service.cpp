@@ -1,15 +1,74 @@
 #include <Arduino.h>
 #include "services/wifi_service.h"
 #include "security_config.h"
+#include "config.h"
+#include "env_config.h"
+#include "wifi_fast_connect.h"
+#include "wifi_reconnect.h"
+#include "wifi_power.h"
+#include "wifi_networks.h"
+#include "cred_crypto.h"
 #include <WiFi.h>
 #include <WebServer.h>
 #include <Preferences.h>
 
 static TaskHandle_t wifiTaskHandle = nullptr;
-static volatile bool networkReady = false;
+static EventGroupHandle_t wifiEvents = nullptr;
 static WebServer server(80);
 static Preferences prefs;
 static volatile bool credsUpdated = false;
+static bool timeSyncStarted = false;
+static bool portalActive = false;
+static volatile bool reconnectEnabled = true;   // false après WifiService_Disconnect
+static volatile uint16_t lastDisconnectReason = 0;
+static WifiReconnect reconnect;
+static volatile int forgetRequest = -1;         // WifiService_ForgetNetwork, traité par wifiTask
+
+// Réseaux connus (wifi_networks.h), mots de passe chiffrés en NVS à part
+static WifiNetworkList networks;
+static int currentNetwork = -1;                 // réseau de la connexion en cours
+static bool latencySaved = false;               // latence backend enregistrée pour cette connexion
+
+// Notifications de la tâche par le callback d'événements
+#define WIFI_NOTIFY_UP    (1u << 0)
+#define WIFI_NOTIFY_DOWN  (1u << 1)
+
+// Joignabilité du backend
+typedef struct {
+  bool ok;
+  uint32_t nextCheckMs;
+  uint32_t lastLatencyMs;
+  uint32_t checks;
+  uint32_t failures;
+} WifiBackendCheck;
+
+static WifiBackendCheck backend;
+
+static WifiPower power;
+static SemaphoreHandle_t powerMutex = nullptr;
+
+static void recordLatency(WifiPowerSample kind, uint32_t ms) {
+  if (!powerMutex) return;
+  xSemaphoreTake(powerMutex, portMAX_DELAY);
+  WifiPower_Record(&power, kind, ms);
+  xSemaphoreGive(powerMutex);
+}
+
+// Temps de mise en réseau: démarrage -> prêt, coupure -> prêt
+typedef struct {
+  uint32_t bootReadyMs;         // 0: jamais prêt
+  uint32_t lastConnectMs;       // dernière tentative (connexion directe + balayage)
+  uint32_t dropStartMs;
+  uint32_t lastRecoveryMs;
+  uint32_t drops;
+  uint32_t fastAttempts;
+  uint32_t fastSuccesses;
+  bool lastFast;
+  bool staticIp;
+  uint32_t credLoadUs;          // dernier mot de passe lu et déchiffré (NVS + clé + GCM)
+} WifiConnectStats;
+
+static WifiConnectStats connectStats;
 
 static void handleRoot() {
   String html =
@@ -18,14 +77,93 @@ static void handleRoot() {
     "<form method='POST' action='/save'>"
     "SSID: <input name='ssid'/><br/>"
     "Mot de passe: <input name='pass' type='password'/><br/>"
+    "Priorit&eacute; (0-9): <input name='prio' type='number' min='0' max='9' value='5'/><br/>"
     "<button type='submit'>Enregistrer</button>"
     "</form>"
+    "<p>" + String(networks.count) + "/" + String(WIFI_NETWORKS_MAX) + " r&eacute;seaux enregistr&eacute;s</p>"
     "</body></html>";
   server.send(200, "text/html", html);
 }
 
+// Mot de passe d'un emplacement: blob binaire (cred_crypto.h)
+static void credKey(int index, char* key) {
+  snprintf(key, 8, "cred%d", index);
+}
+
+// Ancien format: AES-ECB en hexadécimal et indicateur de chiffrement
+static void legacyKeys(int index, char* passKey, char* encKey) {
+  snprintf(passKey, 8, "pass%d", index);
+  snprintf(encKey, 8, "enc%d", index);
+}
+
+// Mot de passe de l'ancien format réécrit en blob (prefs ouvert en écriture)
+static bool migrateLegacyPassword(int index, const char* ssid, const String& stored, bool encrypted) {
+  char password[128];
+  bool ok;
+  if (encrypted && stored.length() > 0) {
+    uint8_t legacyKey[NVS_ENCRYPTION_KEY_SIZE];
+    ok = deriveKey(PASSWORD_SALT, ssid, legacyKey, sizeof(legacyKey)) &&
+         decryptData(stored.c_str(), legacyKey, password, sizeof(password));
+    SECURE_ZERO(legacyKey, sizeof(legacyKey));
+  } else {
+    ok = stored.length() < sizeof(password);
+    if (ok) strcpy(password, stored.c_str());
+  }
+  uint8_t blob[CRED_BLOB_MAX];
+  size_t len = 0;
+  char key[8];
+  credKey(index, key);
+  ok = ok && credEncrypt(ssid, password, blob, sizeof(blob), &len) && prefs.putBytes(key, blob, len) == len;
+  SECURE_ZERO(password, sizeof(password));
+  SECURE_ZERO(blob, sizeof(blob));
+  return ok;
+}
+
+static void saveNetworkList() {
+  prefs.begin(NVS_NAMESPACE_SECURE, false);
+  prefs.putBytes("nets", &networks, sizeof(networks));
+  prefs.end();
+}
+
+// Liste des réseaux; l'ancien enregistrement à SSID unique est repris tel quel
+static void loadNetworkList() {
+  prefs.begin(NVS_NAMESPACE_SECURE, false);
+  size_t n = prefs.getBytes("nets", &networks, sizeof(networks));
+  if (n != sizeof(networks) || !WifiNetworks_IsValid(&networks)) {
+    WifiNetworks_Init(&networks);
+    String ssid = prefs.getString("ssid", "");
+    int index = ssid.isEmpty() ? -1 : WifiNetworks_Add(&networks, ssid.c_str(), WIFI_NET_DEFAULT_PRIORITY);
+    if (index >= 0 &&
+        migrateLegacyPassword(index, ssid.c_str(), prefs.getString("pass_enc", ""), prefs.getBool("encrypted", false))) {
+      prefs.putBytes("nets", &networks, sizeof(networks));
+      prefs.remove("ssid");
+      prefs.remove("pass_enc");
+      prefs.remove("encrypted");
+      SECURE_LOG_INFO("WIFI", "Migrated saved network %s", maskSSID(ssid).c_str());
+    } else if (index >= 0) {
+      WifiNetworks_Init(&networks);
+      SECURE_LOG_ERROR("WIFI", "Failed to migrate saved network %s", maskSSID(ssid).c_str());
+    }
+  }
+  // Mots de passe encore à l'ancien format (hexadécimal): réécrits en blob une fois
+  for (uint8_t i = 0; i < networks.count; i++) {
+    char key[8], passKey[8], encKey[8];
+    credKey(i, key);
+    legacyKeys(i, passKey, encKey);
+    if (prefs.isKey(key) || !prefs.isKey(passKey)) continue;
+    if (migrateLegacyPassword(i, networks.nets[i].ssid, prefs.getString(passKey, ""), prefs.getBool(encKey, false))) {
+      prefs.remove(passKey);
+      prefs.remove(encKey);
+      SECURE_LOG_INFO("WIFI", "Password of network #%u converted to binary format", (unsigned)i);
+    } else {
+      SECURE_LOG_ERROR("WIFI", "Failed to convert password of network #%u", (unsigned)i);
+    }
+  }
+  prefs.end();
+}
+
 // Sauvegarde sécurisée des credentials WiFi
-static bool saveWifiCredentials(const String& ssid, const String& password) {
+static bool saveWifiCredentials(const String& ssid, const String& password, uint8_t priority) {
   // Validation des entrées
   if (!isValidSSID(ssid.c_str())) {
     SECURE_LOG_ERROR("WIFI", "Invalid SSID rejected");
@@ -37,94 +175,111 @@ static bool saveWifiCredentials(const String& ssid, const String& password) {
     return false;
   }
   
-  // Générer la clé de chiffrement
-  uint8_t encKey[NVS_ENCRYPTION_KEY_SIZE];
-  if (!deriveKey(PASSWORD_SALT, ssid.c_str(), encKey, sizeof(encKey))) {
-    SECURE_LOG_ERROR("WIFI", "Failed to derive encryption key");
+  // Chiffrer le mot de passe (AES-256-GCM, clé dérivée du SSID)
+  uint8_t blob[CRED_BLOB_MAX];
+  size_t blobLen = 0;
+  if (!credEncrypt(ssid.c_str(), password.c_str(), blob, sizeof(blob), &blobLen)) {
+    SECURE_LOG_ERROR("WIFI", "Failed to encrypt password");
     return false;
   }
   
-  // Chiffrer le mot de passe
-  char encryptedPassword[256];
-  if (WIFI_CREDS_ENCRYPTION_ENABLED && password.length() > 0) {
-    if (!encryptData(password.c_str(), encKey, encryptedPassword, sizeof(encryptedPassword))) {
-      SECURE_LOG_ERROR("WIFI", "Failed to encrypt password");
-      return false;
-    }
-  } else {
-    strncpy(encryptedPassword, password.c_str(), sizeof(encryptedPassword) - 1);
-    encryptedPassword[sizeof(encryptedPassword) - 1] = '\0';
-  }
+  // Emplacement dans la liste (liste pleine: le réseau le moins prioritaire est remplacé)
+  int index = WifiNetworks_Add(&networks, ssid.c_str(), priority);
+  char key[8];
+  credKey(index, key);
   
   // Sauvegarder dans NVS sécurisé
   prefs.begin(NVS_NAMESPACE_SECURE, false);
-  bool success = prefs.putString("ssid", ssid) && 
-                 prefs.putString("pass_enc", encryptedPassword) &&
-                 prefs.putBool("encrypted", WIFI_CREDS_ENCRYPTION_ENABLED);
+  bool success = index >= 0 &&
+                 prefs.putBytes(key, blob, blobLen) == blobLen &&
+                 prefs.putBytes("nets", &networks, sizeof(networks));
   prefs.end();
   
   if (success) {
-    SECURE_LOG_INFO("WIFI", "Credentials saved securely for SSID: %s", maskSSID(ssid).c_str());
+    SECURE_LOG_INFO("WIFI", "Credentials saved securely for SSID: %s (slot %d, priority %u)",
+                    maskSSID(ssid).c_str(), index, (unsigned)priority);
     logSecurityEvent("WIFI_CREDS_SAVED", ("SSID: " + maskSSID(ssid)).c_str());
   } else {
     SECURE_LOG_ERROR("WIFI", "Failed to save credentials");
   }
   
   // Nettoyer la mémoire
-  SECURE_ZERO(encKey, sizeof(encKey));
-  SECURE_ZERO(encryptedPassword, sizeof(encryptedPassword));
+  SECURE_ZERO(blob, sizeof(blob));
   
   return success;
 }
 
-// Chargement sécurisé des credentials WiFi
-static bool loadWifiCredentials(String& ssid, String& password) {
-  prefs.begin(NVS_NAMESPACE_SECURE, true);
-  
-  ssid = prefs.getString("ssid", "");
-  String encryptedPassword = prefs.getString("pass_enc", "");
-  bool isEncrypted = prefs.getBool("encrypted", false);
+// Chargement sécurisé du mot de passe d'un réseau de la liste
+static bool loadWifiCredentials(int index, String& password) {
+  if (index < 0 || index >= networks.count) {
+    return false;
+  }
+  const char* ssid = networks.nets[index].ssid;
+  char key[8];
+  credKey(index, key);
   
+  uint32_t start = micros();
+  uint8_t blob[CRED_BLOB_MAX];
+  prefs.begin(NVS_NAMESPACE_SECURE, true);
+  size_t len = prefs.getBytes(key, blob, sizeof(blob));
   prefs.end();
   
-  if (ssid.isEmpty()) {
+  // Déchiffrer et authentifier (blob altéré ou d'un autre SSID refusé)
+  char decryptedPassword[CRED_PASS_MAX + 1];
+  bool ok = len > 0 && credDecrypt(ssid, blob, len, decryptedPassword, sizeof(decryptedPassword));
+  SECURE_ZERO(blob, sizeof(blob));
+  if (!ok) {
+    SECURE_LOG_ERROR("WIFI", "Failed to decrypt password");
     return false;
   }
+  connectStats.credLoadUs = micros() - start;
   
-  // Déchiffrer le mot de passe si nécessaire
-  if (isEncrypted && encryptedPassword.length() > 0) {
-    uint8_t encKey[NVS_ENCRYPTION_KEY_SIZE];
-    if (!deriveKey(PASSWORD_SALT, ssid.c_str(), encKey, sizeof(encKey))) {
-      SECURE_LOG_ERROR("WIFI", "Failed to derive decryption key");
-      return false;
-    }
-    
-    char decryptedPassword[128];
-    if (!decryptData(encryptedPassword.c_str(), encKey, decryptedPassword, sizeof(decryptedPassword))) {
-      SECURE_LOG_ERROR("WIFI", "Failed to decrypt password");
-      SECURE_ZERO(encKey, sizeof(encKey));
-      return false;
-    }
-    
-    password = String(decryptedPassword);
-    
-    // Nettoyer la mémoire
-    SECURE_ZERO(encKey, sizeof(encKey));
-    SECURE_ZERO(decryptedPassword, sizeof(decryptedPassword));
-  } else {
-    password = encryptedPassword;
-  }
+  password = String(decryptedPassword);
+  
+  // Nettoyer la mémoire
+  SECURE_ZERO(decryptedPassword, sizeof(decryptedPassword));
   
-  SECURE_LOG_INFO("WIFI", "Credentials loaded for SSID: %s", maskSSID(ssid).c_str());
   return true;
 }
 
+static void forgetNetwork(int index) {
+  if (index < 0 || index >= networks.count) {
+    Serial.printf("[WIFI] No saved network #%d\n", index);
+    return;
+  }
+  String ssid = networks.nets[index].ssid;
+  int movedFrom;
+  WifiNetworks_Remove(&networks, index, &movedFrom);
+  if (currentNetwork == index) currentNetwork = -1;
+  char key[8];
+  int freed = index;
+  prefs.begin(NVS_NAMESPACE_SECURE, false);
+  if (movedFrom >= 0) {
+    // Le dernier réseau prend l'emplacement libéré: son mot de passe suit (lié au SSID, pas à l'emplacement)
+    char fromKey[8];
+    uint8_t blob[CRED_BLOB_MAX];
+    credKey(movedFrom, fromKey);
+    credKey(index, key);
+    size_t len = prefs.getBytes(fromKey, blob, sizeof(blob));
+    if (len > 0) prefs.putBytes(key, blob, len);
+    SECURE_ZERO(blob, sizeof(blob));
+    if (currentNetwork == movedFrom) currentNetwork = index;
+    freed = movedFrom;
+  }
+  credKey(freed, key);
+  prefs.remove(key);
+  prefs.putBytes("nets", &networks, sizeof(networks));
+  prefs.end();
+  Serial.printf("[WIFI] Network %s forgotten\n", maskSSID(ssid).c_str());
+}
+
 static void handleSave() {
   String ssid = server.hasArg("ssid") ? server.arg("ssid") : "";
   String pass = server.hasArg("pass") ? server.arg("pass") : "";
+  long prio = server.hasArg("prio") ? server.arg("prio").toInt() : WIFI_NET_DEFAULT_PRIORITY;
   
   // Rate limiting pour éviter le spam
-  if (!rateLimitCheck("WIFI", 5000)) { // 5 secondes minimum entre tentatives
+  if (!rateLimitCheck(RATE_LIMIT_WIFI)) {
     server.send(429, "text/plain", "Trop de tentatives, veuillez patienter");
     return;
   }
@@ -134,8 +289,13 @@ static void handleSave() {
     return;
   }
   
+  if (prio < 0 || prio > WIFI_NET_PRIORITY_MAX) {
+    server.send(400, "text/plain", "Priorite invalide (0-9)");
+    return;
+  }
+  
   // Validation et sauvegarde sécurisée
-  if (!saveWifiCredentials(ssid, pass)) {
+  if (!saveWifiCredentials(ssid, pass, (uint8_t)prio)) {
     server.send(500, "text/plain", "Erreur lors de la sauvegarde");
     return;
   }
@@ -144,41 +304,164 @@ static void handleSave() {
   credsUpdated = true;
 }
 
-static bool testConnectSaved(uint32_t timeoutMs) {
-  String ssid, password;
+static bool loadFastRecord(WifiFastRecord* rec) {
+  prefs.begin(NVS_NAMESPACE_WIFI_FAST, true);
+  size_t n = prefs.getBytes("link", rec, sizeof(*rec));
+  prefs.end();
+  return n == sizeof(*rec);
+}
+
+static void saveFastRecord(const WifiFastRecord* rec) {
+  prefs.begin(NVS_NAMESPACE_WIFI_FAST, false);
+  prefs.putBytes("link", rec, sizeof(*rec));
+  prefs.end();
+}
+
+// IP fixe (.env WIFI_STATIC_IP, réseau de plus haute priorité seulement), sinon dernier bail
+// si WIFI_FAST_REUSE_IP, sinon DHCP
+static void applyIpConfig(int index, const WifiFastRecord* rec) {
+  WifiStaticIp cfg;
+  const char* staticIp = EnvConfig::GetWifiStaticIp();
+  bool primary = true;
+  for (uint8_t i = 0; i < networks.count; i++) {
+    if (networks.nets[i].priority > networks.nets[index].priority) primary = false;
+  }
+  if (primary && staticIp[0] && WifiFast_ParseStaticIp(staticIp, &cfg)) {
+    WiFi.config(IPAddress(cfg.ip), IPAddress(cfg.gateway), IPAddress(cfg.mask),
+                IPAddress(cfg.dns1), IPAddress(cfg.dns2));
+    connectStats.staticIp = true;
+  } else if (WIFI_FAST_REUSE_IP && rec && rec->ip) {
+    WiFi.config(IPAddress(rec->ip), IPAddress(rec->gateway), IPAddress(rec->mask),
+                IPAddress(rec->dns1), IPAddress(rec->dns2));
+    connectStats.staticIp = true;
+  } else {
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    connectStats.staticIp = false;
+  }
+}
+
+static bool waitConnected(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (millis() - start < timeoutMs) {
+    if (WiFi.status() == WL_CONNECTED) return true;
+    delay(WIFI_CONNECT_POLL_MS);
+  }
+  return false;
+}
+
+// Une tentative sur un réseau de la liste (BSSID et canal connus: pas de balayage du pilote)
+static bool tryNetwork(int index, const uint8_t* bssid, uint8_t channel, const WifiFastRecord* rec, uint32_t timeoutMs) {
+  String password;
+  if (!loadWifiCredentials(index, password)) return false;
+  const char* ssid = networks.nets[index].ssid;
+  SECURE_LOG_INFO("WIFI", "Connecting to '%s' (channel %u, %lu ms)...", maskSSID(String(ssid)).c_str(),
+                  (unsigned)channel, (unsigned long)timeoutMs);
+  applyIpConfig(index, rec);
+  WiFi.begin(ssid, password.c_str(), channel, bssid);
+  bool connected = waitConnected(timeoutMs);
   
-  // Charger les credentials de manière sécurisée
-  if (!loadWifiCredentials(ssid, password)) {
+  // Nettoyer les credentials de la mémoire
+  SECURE_ZERO((void*)password.c_str(), password.length());
+  
+  if (!connected) {
+    WifiNetworks_OnFailed(&networks, index);
+    logSecurityEvent("WIFI_CONNECT_FAILED", ("SSID: " + maskSSID(String(ssid))).c_str());
+    WiFi.disconnect();
+  }
+  return connected;
+}
+
+// Balayage puis réseaux visibles du plus rapide au plus lent (priorité d'abord)
+static int connectRanked(uint32_t timeoutMs, uint32_t start) {
+  int16_t found = WiFi.scanNetworks(false, false, false, WIFI_NET_SCAN_DWELL_MS);
+  WifiScanEntry scan[WIFI_NET_SCAN_MAX];
+  size_t scanCount = 0;
+  for (int16_t i = 0; i < found && scanCount < WIFI_NET_SCAN_MAX; i++) {
+    String ssid = WiFi.SSID(i);
+    if (WifiNetworks_Find(&networks, ssid.c_str()) < 0) continue;
+    WifiScanEntry* e = &scan[scanCount++];
+    strncpy(e->ssid, ssid.c_str(), sizeof(e->ssid) - 1);
+    e->ssid[sizeof(e->ssid) - 1] = '\0';
+    e->rssi = (int8_t)WiFi.RSSI(i);
+    e->channel = (uint8_t)WiFi.channel(i);
+    memcpy(e->bssid, WiFi.BSSID(i), sizeof(e->bssid));
+  }
+  WiFi.scanDelete();
+  WifiCandidate candidates[WIFI_NETWORKS_MAX];
+  size_t n = WifiNetworks_Rank(&networks, scan, scanCount, candidates, WIFI_NETWORKS_MAX);
+  SECURE_LOG_INFO("WIFI", "Scan: %d AP, %u known network(s) in range", (int)found, (unsigned)n);
+  for (size_t c = 0; c < n; c++) {
+    uint32_t elapsed = millis() - start;
+    if (elapsed >= timeoutMs) break;
+    uint32_t budget = timeoutMs - elapsed;
+    // Laisser du temps aux suivants
+    if (c + 1 < n && budget > WIFI_NET_ATTEMPT_TIMEOUT_MS) budget = WIFI_NET_ATTEMPT_TIMEOUT_MS;
+    const WifiScanEntry* e = &scan[candidates[c].scanIndex];
+    if (tryNetwork(candidates[c].index, e->bssid, e->channel, nullptr, budget)) return candidates[c].index;
+  }
+  return -1;
+}
+
+// Connexion directe au dernier BSSID sur son canal, sinon balayage et réseaux classés
+static bool testConnectSaved(uint32_t timeoutMs) {
+  if (networks.count == 0) {
     SECURE_LOG_INFO("WIFI", "No saved credentials found");
     return false;
   }
   
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid.c_str(), password.c_str());
-  
+  WiFi.mode(portalActive ? WIFI_AP_STA : WIFI_STA);
   uint32_t start = millis();
-  SECURE_LOG_INFO("WIFI", "Connecting to '%s'...", maskSSID(ssid).c_str());
+  WifiRc_OnAttempt(&reconnect, start);
+  WifiFastRecord rec;
+  bool haveRec = loadFastRecord(&rec);
+  int fastIndex = -1;
+  for (uint8_t i = 0; WIFI_FAST_CONNECT_ENABLED && haveRec && i < networks.count; i++) {
+    if (WifiFast_IsUsable(&rec, networks.nets[i].ssid)) fastIndex = i;
+  }
+  int index = -1;
+  bool viaFast = false;
   
-  while (millis() - start < timeoutMs) {
-    if (WiFi.status() == WL_CONNECTED) {
-      SECURE_LOG_INFO("WIFI", "Connected successfully, IP=%s", WiFi.localIP().toString().c_str());
-      logSecurityEvent("WIFI_CONNECTED", ("SSID: " + maskSSID(ssid)).c_str());
-      
-      // Nettoyer les credentials de la mémoire
-      SECURE_ZERO((void*)password.c_str(), password.length());
-      
-      return true;
+  if (fastIndex >= 0) {
+    connectStats.fastAttempts++;
+    uint32_t budget = WIFI_FAST_CONNECT_TIMEOUT_MS < timeoutMs ? WIFI_FAST_CONNECT_TIMEOUT_MS : timeoutMs;
+    if (tryNetwork(fastIndex, rec.bssid, rec.channel, &rec, budget)) {
+      connectStats.fastSuccesses++;
+      viaFast = true;
+      index = fastIndex;
+    } else {
+      SECURE_LOG_WARN("WIFI", "Fast connect failed, scanning");
+      WifiFast_OnFailure(&rec);
+      saveFastRecord(&rec);
     }
-    delay(200);
   }
   
-  SECURE_LOG_ERROR("WIFI", "Connection failed to %s", maskSSID(ssid).c_str());
-  logSecurityEvent("WIFI_CONNECT_FAILED", ("SSID: " + maskSSID(ssid)).c_str());
+  if (index < 0) index = connectRanked(timeoutMs, start);
+  connectStats.lastConnectMs = millis() - start;
+  connectStats.lastFast = viaFast;
   
-  // Nettoyer les credentials de la mémoire
-  SECURE_ZERO((void*)password.c_str(), password.length());
-  
-  return false;
+  if (index >= 0) {
+    String ssid = networks.nets[index].ssid;
+    SECURE_LOG_INFO("WIFI", "Connected successfully to %s in %lu ms (%s), IP=%s",
+                    maskSSID(ssid).c_str(), (unsigned long)connectStats.lastConnectMs,
+                    viaFast ? "fast" : "scan", WiFi.localIP().toString().c_str());
+    logSecurityEvent("WIFI_CONNECTED", ("SSID: " + maskSSID(ssid)).c_str());
+    WifiNetworks_OnConnected(&networks, index);
+    currentNetwork = index;
+    latencySaved = false;
+    
+    // Lien mémorisé pour la connexion suivante (écriture NVS seulement s'il a changé)
+    WifiFastRecord fresh;
+    WifiFast_Fill(&fresh, ssid.c_str(), WiFi.BSSID(), (uint8_t)WiFi.channel(),
+                  (uint32_t)WiFi.localIP(), (uint32_t)WiFi.gatewayIP(), (uint32_t)WiFi.subnetMask(),
+                  (uint32_t)WiFi.dnsIP(0), (uint32_t)WiFi.dnsIP(1));
+    if (!haveRec || !WifiFast_SameLink(&rec, &fresh)) saveFastRecord(&fresh);
+  } else {
+    SECURE_LOG_ERROR("WIFI", "No saved network reachable (%u saved)", (unsigned)networks.count);
+    WifiRc_OnDisconnected(&reconnect, lastDisconnectReason, millis());
+  }
+  // Échecs, RSSI et connexions de chaque réseau
+  saveNetworkList();
+  return index >= 0;
 }
 
 static void startSoftAP() {
@@ -191,48 +474,254 @@ static void startSoftAP() {
   server.on("/", HTTP_GET, handleRoot);
   server.on("/save", HTTP_POST, handleSave);
   server.begin();
+  portalActive = true;
+}
+
+// Callback du pilote (tâche d'événements Arduino): bits publiés immédiatement,
+// la machine à états est traitée par wifiTask
+static void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  uint32_t notify;
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      xEventGroupSetBits(wifiEvents, WIFI_EVT_LINK_UP);
+      notify = WIFI_NOTIFY_UP;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      lastDisconnectReason = info.wifi_sta_disconnected.reason;
+      xEventGroupClearBits(wifiEvents, WIFI_EVT_LINK_UP | WIFI_EVT_BACKEND_OK | WIFI_EVT_READY);
+      notify = WIFI_NOTIFY_DOWN;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      xEventGroupClearBits(wifiEvents, WIFI_EVT_LINK_UP | WIFI_EVT_BACKEND_OK | WIFI_EVT_READY);
+      notify = WIFI_NOTIFY_DOWN;
+      break;
+    default:
+      return;
+  }
+  if (wifiTaskHandle) xTaskNotify(wifiTaskHandle, notify, eSetBits);
+}
+
+static bool linkUp() {
+  return (xEventGroupGetBits(wifiEvents) & WIFI_EVT_LINK_UP) != 0;
+}
+
+static void onLinkDown(uint32_t now) {
+  uint16_t reason = lastDisconnectReason;
+  if (reconnect.state == WIFI_RC_CONNECTED) {
+    connectStats.dropStartMs = now;
+    connectStats.drops++;
+    Serial.printf("[WIFI] Link lost (reason %u)\n", (unsigned)reason);
+  }
+  backend.ok = false;
+  WifiRc_OnDisconnected(&reconnect, reason, now);
+}
+
+static void onLinkUp(uint32_t now) {
+  WifiRc_OnGotIp(&reconnect);
+  if (!timeSyncStarted) {
+    // Heure Unix pour l'expiration des tokens QR signés (conservée ensuite hors réseau)
+    configTime(0, 0, "pool.ntp.org", "time.google.com");
+    timeSyncStarted = true;
+  }
+  if (portalActive) {
+    // Reconnecté sans passer par le portail
+    WiFi.softAPdisconnect(true);
+    portalActive = false;
+  }
+  backend.nextCheckMs = now;
+}
+
+// Événements accumulés pendant l'attente (ou une connexion bloquante): l'état final
+// du lien fait foi, une coupure suivie d'un retour compte comme coupure puis connexion
+static void handleLinkEvents(uint32_t notified) {
+  uint32_t now = millis();
+  bool up = linkUp();
+  if ((notified & WIFI_NOTIFY_DOWN) && (!up || reconnect.state == WIFI_RC_CONNECTED)) onLinkDown(now);
+  if (up && reconnect.state != WIFI_RC_CONNECTED) onLinkUp(now);
+}
+
+static void publishReady(bool ready) {
+  bool wasReady = (xEventGroupGetBits(wifiEvents) & WIFI_EVT_READY) != 0;
+  if (ready == wasReady) return;
+  if (!ready) {
+    xEventGroupClearBits(wifiEvents, WIFI_EVT_READY);
+    return;
+  }
+  xEventGroupSetBits(wifiEvents, WIFI_EVT_READY);
+  uint32_t now = millis();
+  if (connectStats.bootReadyMs == 0) {
+    connectStats.bootReadyMs = now;
+    Serial.printf("[WIFI] Network ready %lu ms after boot\n", (unsigned long)now);
+  } else if (connectStats.drops > 0) {
+    connectStats.lastRecoveryMs = now - connectStats.dropStartMs;
+    Serial.printf("[WIFI] Network ready %lu ms after dropout\n", (unsigned long)connectStats.lastRecoveryMs);
+  }
+}
+
+// Connexion TCP à l'hôte de l'API (sans requête HTTP): DNS, route et pare-feu
+static void checkBackend(uint32_t now) {
+  bool ok = true;
+  if (WIFI_BACKEND_CHECK_ENABLED) {
+    char host[96];
+    uint16_t port;
+    ok = false;
+    if (WifiRc_ParseHost(EnvConfig::GetApiBaseUrl(), host, sizeof(host), &port)) {
+      WiFiClient client;
+      uint32_t t0 = millis();
+      ok = client.connect(host, port, WIFI_BACKEND_CHECK_TIMEOUT_MS);
+      client.stop();
+      backend.lastLatencyMs = millis() - t0;
+      if (ok) {
+        recordLatency(WIFI_POWER_SAMPLE_TCP, backend.lastLatencyMs);
+        // Latence du réseau courant, écrite en NVS une fois par connexion
+        WifiNetworks_RecordLatency(&networks, currentNetwork, backend.lastLatencyMs);
+        if (!latencySaved && currentNetwork >= 0) {
+          saveNetworkList();
+          latencySaved = true;
+        }
+      }
+    }
+    backend.checks++;
+    if (!ok) {
+      backend.failures++;
+      if (backend.ok || backend.failures == 1) SECURE_LOG_WARN("WIFI", "Backend unreachable");
+    }
+  }
+  backend.ok = ok;
+  backend.nextCheckMs = now + (ok ? WIFI_BACKEND_CHECK_INTERVAL_MS : WIFI_BACKEND_RETRY_MS);
+  // Coupure pendant le test: le callback a déjà tout effacé
+  if (!linkUp()) return;
+  if (ok) {
+    xEventGroupSetBits(wifiEvents, WIFI_EVT_BACKEND_OK);
+  } else {
+    xEventGroupClearBits(wifiEvents, WIFI_EVT_BACKEND_OK);
+  }
+  publishReady(ok);
+}
+
+// Tentative en tâche de fond: même point d'accès juste après une coupure, ensuite balayage
+// et réseaux connus classés (bascule vers un autre réseau sans portail)
+static void startReconnect() {
+  if (reconnect.failures == 0 && currentNetwork >= 0) {
+    WiFi.reconnect();
+    WifiRc_OnAttempt(&reconnect, millis());
+  } else if (!testConnectSaved(WIFI_CONNECT_TIMEOUT_MS) && networks.count == 0) {
+    reconnect.state = WIFI_RC_IDLE;   // credentials effacés
+    return;
+  }
+  SECURE_LOG_INFO("WIFI", "Reconnect attempt %lu (failures=%lu)",
+                  (unsigned long)reconnect.attempts, (unsigned long)reconnect.failures);
+}
+
+static uint32_t untilMs(uint32_t deadlineMs, uint32_t now) {
+  int32_t remaining = (int32_t)(deadlineMs - now);
+  return remaining > 0 ? (uint32_t)remaining : 0;
 }
 
 static void wifiTask(void* pv) {
+  const WifiRcConfig rcCfg = { WIFI_RECONNECT_BASE_MS, WIFI_RECONNECT_MAX_MS, WIFI_CONNECT_TIMEOUT_MS };
+  WifiRc_Init(&reconnect, &rcCfg, esp_random());
+  // Reconnexion gérée ici (délai exponentiel) et non par le pilote
+  WiFi.setAutoReconnect(false);
+  WiFi.onEvent(onWifiEvent);
+  WiFi.setSleep(power.mode == WIFI_POWER_AWAKE ? WIFI_PS_NONE : WIFI_PS_MIN_MODEM);
+  loadNetworkList();
+  if (CRED_BENCH_ENABLED) credBenchmark();
+
   // 1) Essayer creds NVS
-  if (!testConnectSaved(10000)) {
-    // 2) Lancer SoftAP portail
+  if (!testConnectSaved(WIFI_CONNECT_TIMEOUT_MS) && networks.count == 0) {
+    // 2) Aucun réseau enregistré: lancer SoftAP portail. Sinon les tentatives continuent
+    //    en tâche de fond sur tous les réseaux connus, portail après WIFI_RECONNECT_PORTAL_AFTER échecs
     startSoftAP();
   }
-  // Boucle principale: si STA connecte, networkReady=true; sinon, process portail
   for (;;) {
-    if (WiFi.status() == WL_CONNECTED) {
-      networkReady = true;
-    } else {
-      networkReady = false;
+    uint32_t now = millis();
+    uint32_t waitMs = portalActive ? WIFI_PORTAL_POLL_MS : WIFI_TASK_IDLE_WAIT_MS;
+    uint32_t rcDelay = WifiRc_NextDelayMs(&reconnect, now);
+    if (rcDelay < waitMs) waitMs = rcDelay;
+    if (reconnect.state == WIFI_RC_CONNECTED && untilMs(backend.nextCheckMs, now) < waitMs) {
+      waitMs = untilMs(backend.nextCheckMs, now);
+    }
+    uint32_t notified = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &notified, pdMS_TO_TICKS(waitMs));
+    handleLinkEvents(notified);
+
+    if (portalActive) server.handleClient();
+    if (forgetRequest >= 0) {
+      forgetNetwork(forgetRequest);
+      forgetRequest = -1;
     }
-    server.handleClient();
-    vTaskDelay(pdMS_TO_TICKS(20));
     // Si de nouvelles creds ont ete enregistrees, retenter la connexion une fois
-    if (!networkReady && credsUpdated) {
+    if (credsUpdated) {
       credsUpdated = false;
-      if (testConnectSaved(8000)) {
-        Serial.println("[WIFI] Connecte apres provisioning");
-        WiFi.softAPdisconnect(true);
-      } else {
-        Serial.println("[WIFI] Echec connexion apres provisioning");
+      reconnectEnabled = true;
+      if (!linkUp()) {
+        if (testConnectSaved(8000)) {
+          Serial.println("[WIFI] Connecte apres provisioning");
+        } else {
+          Serial.println("[WIFI] Echec connexion apres provisioning");
+        }
       }
+      continue;
+    }
+
+    now = millis();
+    if (reconnect.state == WIFI_RC_CONNECTED) {
+      if (untilMs(backend.nextCheckMs, now) == 0) checkBackend(now);
+    } else if (reconnectEnabled && WifiRc_ShouldAttempt(&reconnect, now)) {
+      if (!portalActive && reconnect.failures >= WIFI_RECONNECT_PORTAL_AFTER) {
+        SECURE_LOG_WARN("WIFI", "Still offline after %lu attempts, starting portal", (unsigned long)reconnect.failures);
+        startSoftAP();
+      }
+      startReconnect();
     }
   }
 }
 
 void StartTaskWifiService() {
+  if (!wifiEvents) wifiEvents = xEventGroupCreate();
+  if (!powerMutex) {
+    WifiPower_Init(&power, WIFI_POWER_MODEM_SLEEP, WIFI_PS_SLEEP_CURRENT_MA, WIFI_PS_AWAKE_CURRENT_MA, millis());
+    powerMutex = xSemaphoreCreateMutex();
+  }
   if (!wifiTaskHandle) {
     xTaskCreate(wifiTask, "wifi_service", 6144, nullptr, 2, &wifiTaskHandle);
   }
 }
 
-bool WifiService_IsReady() { return networkReady; }
+bool WifiService_IsReady() {
+  return wifiEvents && (xEventGroupGetBits(wifiEvents) & WIFI_EVT_READY);
+}
+
+bool WifiService_Wait(uint32_t bits, uint32_t timeoutMs) {
+  if (!wifiEvents) return false;
+  TickType_t ticks = timeoutMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+  return (xEventGroupWaitBits(wifiEvents, bits, pdFALSE, pdTRUE, ticks) & bits) == bits;
+}
+
+void WifiService_SetTransactionActive(bool active) {
+  if (!WIFI_POWER_POLICY_ENABLED || !powerMutex) return;
+  WifiPowerMode mode = WifiPower_ModeFor(active);
+  xSemaphoreTake(powerMutex, portMAX_DELAY);
+  bool changed = WifiPower_SetMode(&power, mode, millis());
+  xSemaphoreGive(powerMutex);
+  // Appliqué avant l'envoi de la requête qui ouvre la transaction
+  if (changed) WiFi.setSleep(mode == WIFI_POWER_AWAKE ? WIFI_PS_NONE : WIFI_PS_MIN_MODEM);
+}
+
+void WifiService_RecordRequestLatency(uint32_t ms) {
+  recordLatency(WIFI_POWER_SAMPLE_HTTP, ms);
+}
+
+void WifiService_ForgetNetwork(int index) {
+  forgetRequest = index;
+  if (wifiTaskHandle) xTaskNotify(wifiTaskHandle, 0, eNoAction);
+}
 
 void WifiService_Disconnect() {
   Serial.println("[WIFI] Disconnect requested");
+  reconnectEnabled = false;
   WiFi.disconnect(true, true); // clear config & disconnect
-  networkReady = false;
   startSoftAP();
 }
 
@@ -243,6 +732,68 @@ void WifiService_DebugStatus() {
                 st == WL_CONNECTED ? "CONNECTED" : "NOT_CONNECTED",
                 WiFi.localIP().toString().c_str(),
                 WiFi.softAPgetStationNum() > 0 ? "ON" : "OFF");
+  Serial.printf("[WIFI] Ready after boot=%lu ms, last connect=%lu ms (%s, %s), fast=%lu/%lu, drops=%lu, last recovery=%lu ms\n",
+                (unsigned long)connectStats.bootReadyMs,
+                (unsigned long)connectStats.lastConnectMs,
+                connectStats.lastFast ? "fast" : "scan",
+                connectStats.staticIp ? "static IP" : "DHCP",
+                (unsigned long)connectStats.fastSuccesses,
+                (unsigned long)connectStats.fastAttempts,
+                (unsigned long)connectStats.drops,
+                (unsigned long)connectStats.lastRecoveryMs);
+  const CredCryptoStats* cred = credCryptoStats();
+  Serial.printf("[WIFI] Credentials load=%lu us (key %lu us, GCM %lu us), master key=%lu us, decrypts=%lu, auth failures=%lu\n",
+                (unsigned long)connectStats.credLoadUs,
+                (unsigned long)cred->lastKeyUs,
+                (unsigned long)cred->lastCipherUs,
+                (unsigned long)cred->masterKeyUs,
+                (unsigned long)cred->decrypts,
+                (unsigned long)cred->authFailures);
+  static const char* const states[] = { "IDLE", "CONNECTING", "CONNECTED", "BACKOFF" };
+  Serial.printf("[WIFI] Reconnect state=%s, failures=%lu, attempts=%lu, disconnects=%lu, last reason=%u, auth failures=%lu, next in %lu ms\n",
+                states[reconnect.state],
+                (unsigned long)reconnect.failures,
+                (unsigned long)reconnect.attempts,
+                (unsigned long)reconnect.disconnects,
+                (unsigned)reconnect.lastReason,
+                (unsigned long)reconnect.authFailures,
+                (unsigned long)(reconnect.state == WIFI_RC_BACKOFF ? WifiRc_NextDelayMs(&reconnect, millis()) : 0));
+  Serial.printf("[WIFI] Backend %s, latency=%lu ms, checks=%lu, failures=%lu, ready=%s\n",
+                backend.ok ? "reachable" : "unreachable",
+                (unsigned long)backend.lastLatencyMs,
+                (unsigned long)backend.checks,
+                (unsigned long)backend.failures,
+                WifiService_IsReady() ? "yes" : "no");
+  for (uint8_t i = 0; i < networks.count; i++) {
+    const WifiNetwork* n = &networks.nets[i];
+    Serial.printf("[WIFI] #%u%s %s prio=%u rssi=%d dBm latency=%u ms connects=%u failures=%u\n",
+                  (unsigned)i, (int)i == currentNetwork ? "*" : " ", maskSSID(String(n->ssid)).c_str(),
+                  (unsigned)n->priority, (int)n->lastRssi, (unsigned)n->latencyMs,
+                  (unsigned)n->connects, (unsigned)n->failures);
+  }
+  if (!powerMutex) return;
+  xSemaphoreTake(powerMutex, portMAX_DELAY);
+  WifiPower snapshot = power;
+  xSemaphoreGive(powerMutex);
+  uint32_t now = millis();
+  static const char* const modes[] = { "modem sleep", "PS_NONE" };
+  for (int m = 0; m < WIFI_POWER_MODES; m++) {
+    const WifiPowerModeStats* st = &snapshot.modes[m];
+    Serial.printf("[WIFI] Power %-11s%s time=%lu s, entries=%lu, HTTP avg=%lu ms max=%lu ms (n=%lu), TCP avg=%lu ms (n=%lu), %u mA\n",
+                  modes[m], snapshot.mode == m ? "*" : " ",
+                  (unsigned long)(WifiPower_TimeMs(&snapshot, (WifiPowerMode)m, now) / 1000),
+                  (unsigned long)st->entries,
+                  (unsigned long)WifiPower_AvgLatencyMs(&snapshot, (WifiPowerMode)m, WIFI_POWER_SAMPLE_HTTP),
+                  (unsigned long)st->latency[WIFI_POWER_SAMPLE_HTTP].maxMs,
+                  (unsigned long)st->latency[WIFI_POWER_SAMPLE_HTTP].count,
+                  (unsigned long)WifiPower_AvgLatencyMs(&snapshot, (WifiPowerMode)m, WIFI_POWER_SAMPLE_TCP),
+                  (unsigned long)st->latency[WIFI_POWER_SAMPLE_TCP].count,
+                  (unsigned)snapshot.currentMa[m]);
+  }
+  uint32_t deciMa = WifiPower_AvgCurrentDeciMa(&snapshot, now);
+  Serial.printf("[WIFI] Power policy %s, estimated average current %lu.%lu mA\n",
+                WIFI_POWER_POLICY_ENABLED ? "on" : "off",
+                (unsigned long)(deciMa / 10), (unsigned long)(deciMa % 10));
 }
 
 
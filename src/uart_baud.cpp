@@ -0,0 +1,101 @@
+#include "uart_baud.h"
+#include <string.h>
+#include <stdio.h>
+
+// Débits candidats, du plus rapide au plus lent
+static const uint32_t candidateRates[] = { 2000000, 921600, 460800, 230400 };
+static const size_t candidateCount = sizeof(candidateRates) / sizeof(candidateRates[0]);
+
+// Motif d'entraînement: transitions de bits variées (0x55, 0x2A, 0x33, 0x4C, 0x7E, 0x21, 0x70, 0x4F)
+static const char trainingPattern[] = "U*3L~!pOU*3L~!pO";
+
+// Candidat immédiatement inférieur à 'baud' (ou le débit de base)
+static uint32_t rateBelow(const UartBaudState* st, uint32_t baud) {
+  for (size_t i = 0; i < candidateCount; i++) {
+    if (candidateRates[i] < baud && candidateRates[i] > st->baseBaud) return candidateRates[i];
+  }
+  return st->baseBaud;
+}
+
+void UartBaud_Init(UartBaudState* st, uint32_t baseBaud, uint32_t maxBaud) {
+  if (!st) return;
+  memset(st, 0, sizeof(*st));
+  st->baseBaud = baseBaud;
+  st->currentBaud = baseBaud;
+  st->maxBaud = maxBaud;
+}
+
+uint32_t UartBaud_NextCandidate(const UartBaudState* st) {
+  if (!st) return 0;
+  for (size_t i = 0; i < candidateCount; i++) {
+    if (candidateRates[i] <= st->maxBaud && candidateRates[i] > st->currentBaud) return candidateRates[i];
+  }
+  return 0;
+}
+
+size_t UartBaud_FormatProposal(char* out, size_t outSize, uint32_t baud) {
+  if (!out || outSize == 0) return 0;
+  int n = snprintf(out, outSize, "%s%lu", UART_BAUD_PROPOSE_PREFIX, (unsigned long)baud);
+  return (n > 0 && (size_t)n < outSize) ? (size_t)n : 0;
+}
+
+bool UartBaud_IsAccept(const char* line, uint32_t baud) {
+  if (!line) return false;
+  char expected[24];
+  snprintf(expected, sizeof(expected), "%s%lu", UART_BAUD_ACCEPT_PREFIX, (unsigned long)baud);
+  return strcmp(line, expected) == 0;
+}
+
+size_t UartBaud_FormatTrainingLine(char* out, size_t outSize, uint8_t seq) {
+  if (!out || outSize == 0) return 0;
+  int n = snprintf(out, outSize, "%s%02u:%s", UART_BAUD_TRAIN_PREFIX, (unsigned)seq, trainingPattern);
+  return (n > 0 && (size_t)n < outSize) ? (size_t)n : 0;
+}
+
+bool UartBaud_CheckTrainingLine(const char* line, uint8_t seq) {
+  if (!line) return false;
+  char expected[40];
+  if (UartBaud_FormatTrainingLine(expected, sizeof(expected), seq) == 0) return false;
+  return strcmp(line, expected) == 0;
+}
+
+bool UartBaud_TrainingPassed(uint8_t goodEchoes, uint8_t sent) {
+  if (sent == 0 || goodEchoes > sent) return false;
+  return (uint8_t)(sent - goodEchoes) <= UART_BAUD_TRAIN_MAX_ERRORS;
+}
+
+void UartBaud_OnUpgradeSucceeded(UartBaudState* st, uint32_t baud) {
+  if (!st) return;
+  st->currentBaud = baud;
+  st->windowErrors = 0;
+  st->upgrades++;
+}
+
+void UartBaud_OnUpgradeFailed(UartBaudState* st, uint32_t baud) {
+  if (!st) return;
+  st->maxBaud = rateBelow(st, baud);
+}
+
+bool UartBaud_RecordError(UartBaudState* st, UartBaudErrorKind kind, uint32_t nowMs) {
+  if (!st) return false;
+  if (kind == UART_BAUD_ERR_FRAMING) st->framingErrors++;
+  else st->crcErrors++;
+
+  if (st->windowErrors == 0 || (uint32_t)(nowMs - st->windowStartMs) > UART_BAUD_ERROR_WINDOW_MS) {
+    st->windowStartMs = nowMs;
+    st->windowErrors = 0;
+  }
+  st->windowErrors++;
+  if (st->windowErrors < UART_BAUD_ERROR_THRESHOLD) return false;
+  st->windowErrors = 0;
+  // Déjà au débit de base: rien de plus sûr à proposer
+  return st->currentBaud != st->baseBaud;
+}
+
+void UartBaud_OnDowngrade(UartBaudState* st) {
+  if (!st) return;
+  st->maxBaud = rateBelow(st, st->currentBaud);
+  st->currentBaud = st->baseBaud;
+  st->windowErrors = 0;
+  st->downgrades++;
+}
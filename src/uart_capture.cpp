@@ -0,0 +1,217 @@
+#include "uart_capture.h"
+#include <string.h>
+
+void UartCapture_Init(UartCapture* c, uint8_t* buffer, size_t capacity) {
+  if (!c) return;
+  memset(c, 0, sizeof(*c));
+  c->data = buffer;
+  c->capacity = buffer ? capacity : 0;
+}
+
+void UartCapture_Clear(UartCapture* c) {
+  if (!c) return;
+  c->head = 0;
+  c->tail = 0;
+  c->used = 0;
+  c->records = 0;
+  c->dropped = 0;
+  c->bytesCaptured = 0;
+}
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static uint8_t ringAt(const UartCapture* c, size_t pos) {
+  return c->data[pos % c->capacity];
+}
+
+// Varint lu dans le buffer circulaire à partir de *pos
+static uint32_t ringVarint(const UartCapture* c, size_t* pos) {
+  uint32_t v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    uint8_t b = ringAt(c, (*pos)++);
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) break;
+  }
+  return v;
+}
+
+static void ringWrite(UartCapture* c, const uint8_t* data, size_t len) {
+  size_t first = c->capacity - c->head;
+  if (first > len) first = len;
+  memcpy(c->data + c->head, data, first);
+  if (len > first) memcpy(c->data, data + first, len - first);
+  c->head = (c->head + len) % c->capacity;
+  c->used += len;
+}
+
+// Libère le plus ancien enregistrement; t0 passe à l'enregistrement suivant
+static void evictOldest(UartCapture* c) {
+  size_t pos = c->tail + 1;
+  ringVarint(c, &pos);
+  uint32_t len = ringVarint(c, &pos);
+  size_t size = (pos - c->tail) + len;
+  c->tail = (c->tail + size) % c->capacity;
+  c->used -= size;
+  c->records--;
+  c->dropped++;
+  if (c->records > 0) {
+    size_t next = c->tail + 1;
+    c->tailMs += ringVarint(c, &next);
+  }
+}
+
+static bool recordChunk(UartCapture* c, uint8_t tag, uint32_t nowMs, const uint8_t* data, size_t len) {
+  uint8_t hdr[UART_CAPTURE_RECORD_OVERHEAD];
+  size_t h = 0;
+  hdr[h++] = tag;
+  h += putVarint(hdr + h, c->records > 0 ? nowMs - c->lastMs : 0);
+  h += putVarint(hdr + h, (uint32_t)len);
+  if (h + len > c->capacity) {
+    c->dropped++;
+    return false;
+  }
+  while (c->capacity - c->used < h + len) evictOldest(c);
+  if (c->records == 0) c->tailMs = nowMs;
+  ringWrite(c, hdr, h);
+  ringWrite(c, data, len);
+  c->records++;
+  c->lastMs = nowMs;
+  c->bytesCaptured += (uint32_t)len;
+  return true;
+}
+
+bool UartCapture_Record(UartCapture* c, uint8_t channel, uint8_t dir, uint32_t nowMs,
+                        const uint8_t* data, size_t len) {
+  if (!c || !c->data || !data || len == 0) return false;
+  uint8_t tag = (uint8_t)(((channel & 0x3F) << 1) | (dir & 0x01));
+  bool ok = true;
+  while (len > 0) {
+    size_t chunk = len > UART_CAPTURE_RECORD_MAX ? UART_CAPTURE_RECORD_MAX : len;
+    ok = recordChunk(c, tag, nowMs, data, chunk) && ok;
+    data += chunk;
+    len -= chunk;
+  }
+  return ok;
+}
+
+static void putU16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void putU32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t getU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t UartCapture_DumpSize(const UartCapture* c) {
+  return c ? UART_CAPTURE_HEADER_SIZE + c->used : 0;
+}
+
+size_t UartCapture_Dump(const UartCapture* c, UartCaptureWriteFn write, void* ctx) {
+  if (!c || !write) return 0;
+  uint8_t hdr[UART_CAPTURE_HEADER_SIZE];
+  memcpy(hdr, UART_CAPTURE_MAGIC, 4);
+  hdr[4] = UART_CAPTURE_VERSION;
+  hdr[5] = 0;
+  putU16(hdr + 6, c->dropped > 0xFFFF ? 0xFFFF : (uint16_t)c->dropped);
+  putU32(hdr + 8, c->tailMs);
+  putU32(hdr + 12, (uint32_t)c->used);
+  write(ctx, hdr, sizeof(hdr));
+
+  if (c->used > 0) {
+    size_t first = c->capacity - c->tail;
+    if (first > c->used) first = c->used;
+    write(ctx, c->data + c->tail, first);
+    if (c->used > first) write(ctx, c->data, c->used - first);
+  }
+  return sizeof(hdr) + c->used;
+}
+
+bool UartCapture_OpenDump(UartCaptureReader* r, const uint8_t* dump, size_t len) {
+  if (!r || !dump || len < UART_CAPTURE_HEADER_SIZE) return false;
+  if (memcmp(dump, UART_CAPTURE_MAGIC, 4) != 0 || dump[4] != UART_CAPTURE_VERSION) return false;
+  size_t body = getU32(dump + 12);
+  if (body > len - UART_CAPTURE_HEADER_SIZE) return false;
+  r->data = dump + UART_CAPTURE_HEADER_SIZE;
+  r->len = body;
+  r->offset = 0;
+  r->timeMs = getU32(dump + 8);
+  r->count = 0;
+  r->dropped = (uint16_t)(dump[6] | (dump[7] << 8));
+  return true;
+}
+
+static bool readVarint(UartCaptureReader* r, uint32_t* out) {
+  uint32_t v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (r->offset >= r->len) return false;
+    uint8_t b = r->data[r->offset++];
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      *out = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool UartCapture_Next(UartCaptureReader* r, UartCaptureRecord* rec) {
+  if (!r || !rec || r->offset >= r->len) return false;
+  uint8_t tag = r->data[r->offset++];
+  uint32_t delta, len;
+  if (!readVarint(r, &delta) || !readVarint(r, &len)) return false;
+  if (len > r->len - r->offset) return false;
+  if (r->count > 0) r->timeMs += delta;
+  rec->channel = tag >> 1;
+  rec->dir = tag & 0x01;
+  rec->timeMs = r->timeMs;
+  rec->data = r->data + r->offset;
+  rec->len = len;
+  r->offset += len;
+  r->count++;
+  return true;
+}
+
+bool UartCapture_Replay(const uint8_t* dump, size_t len, bool originalTiming,
+                        UartReplaySinkFn sink, UartReplayWaitFn wait, void* ctx,
+                        UartReplayStats* stats) {
+  UartReplayStats local;
+  UartReplayStats* s = stats ? stats : &local;
+  memset(s, 0, sizeof(*s));
+
+  UartCaptureReader r;
+  if (!sink || !UartCapture_OpenDump(&r, dump, len)) return false;
+
+  UartCaptureRecord rec;
+  uint32_t firstMs = 0;
+  uint32_t prevMs = 0;
+  while (UartCapture_Next(&r, &rec)) {
+    if (s->records == 0) {
+      firstMs = rec.timeMs;
+    } else if (originalTiming && wait && rec.timeMs != prevMs) {
+      wait(ctx, rec.timeMs - prevMs);
+    }
+    prevMs = rec.timeMs;
+    sink(ctx, &rec);
+    s->records++;
+    s->bytes += (uint32_t)rec.len;
+  }
+  s->spanMs = s->records > 0 ? prevMs - firstMs : 0;
+  s->complete = (r.offset == r.len);
+  return s->complete;
+}
@@ -0,0 +1,235 @@
+#include "uart_frame.h"
+#include <string.h>
+
+// Table demi-octet pour le CRC-16/CCITT
+static const uint16_t crcNibble[16] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t UartFrame_Crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  if (!data) return crc;
+  for (size_t i = 0; i < len; i++) {
+    crc = (uint16_t)((crc << 4) ^ crcNibble[((crc >> 12) ^ (data[i] >> 4)) & 0x0F]);
+    crc = (uint16_t)((crc << 4) ^ crcNibble[((crc >> 12) ^ (data[i] & 0x0F)) & 0x0F]);
+  }
+  return crc;
+}
+
+size_t UartFrame_CobsEncode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize) {
+  if (!in || !out || outSize == 0) return 0;
+  size_t writeIdx = 1;
+  size_t codeIdx = 0;
+  uint8_t code = 1;
+  for (size_t readIdx = 0; readIdx < len; readIdx++) {
+    if (writeIdx >= outSize) return 0;
+    if (in[readIdx] == 0) {
+      out[codeIdx] = code;
+      code = 1;
+      codeIdx = writeIdx++;
+    } else {
+      out[writeIdx++] = in[readIdx];
+      code++;
+      if (code == 0xFF) {
+        if (writeIdx >= outSize) return 0;
+        out[codeIdx] = code;
+        code = 1;
+        codeIdx = writeIdx++;
+      }
+    }
+  }
+  out[codeIdx] = code;
+  return writeIdx;
+}
+
+size_t UartFrame_CobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize) {
+  if (!in || !out) return 0;
+  size_t r = 0;
+  size_t w = 0;
+  while (r < len) {
+    uint8_t code = in[r++];
+    if (code == 0) return 0;
+    for (uint8_t i = 1; i < code; i++) {
+      if (r >= len || w >= outSize || in[r] == 0) return 0;
+      out[w++] = in[r++];
+    }
+    if (code != 0xFF && r < len) {
+      if (w >= outSize) return 0;
+      out[w++] = 0;
+    }
+  }
+  return w;
+}
+
+size_t UartFrame_Encode(const UartFrame* frame, uint8_t* out, size_t outSize) {
+  if (!frame || !out || frame->len > UART_FRAME_MAX_PAYLOAD) return 0;
+  uint8_t raw[UART_FRAME_RAW_MAX];
+  raw[0] = frame->type;
+  raw[1] = frame->seq;
+  raw[2] = frame->ack;
+  raw[3] = frame->len;
+  memcpy(&raw[UART_FRAME_HEADER_SIZE], frame->payload, frame->len);
+  size_t rawLen = UART_FRAME_HEADER_SIZE + frame->len;
+  uint16_t crc = UartFrame_Crc16(raw, rawLen);
+  raw[rawLen++] = (uint8_t)(crc >> 8);
+  raw[rawLen++] = (uint8_t)(crc & 0xFF);
+
+  if (outSize < 2) return 0;
+  size_t n = UartFrame_CobsEncode(raw, rawLen, out, outSize - 1);
+  if (n == 0) return 0;
+  out[n++] = 0x00;
+  return n;
+}
+
+UartFrameStatus UartFrame_Decode(const uint8_t* encoded, size_t len, UartFrame* out) {
+  if (!encoded || !out) return UART_FRAME_ERR_COBS;
+  uint8_t raw[UART_FRAME_RAW_MAX];
+  size_t rawLen = UartFrame_CobsDecode(encoded, len, raw, sizeof(raw));
+  if (rawLen == 0) return UART_FRAME_ERR_COBS;
+  if (rawLen < UART_FRAME_HEADER_SIZE + UART_FRAME_CRC_SIZE) return UART_FRAME_ERR_LENGTH;
+  uint8_t payloadLen = raw[3];
+  if (payloadLen > UART_FRAME_MAX_PAYLOAD ||
+      rawLen != (size_t)(UART_FRAME_HEADER_SIZE + payloadLen + UART_FRAME_CRC_SIZE)) {
+    return UART_FRAME_ERR_LENGTH;
+  }
+  size_t crcPos = UART_FRAME_HEADER_SIZE + payloadLen;
+  uint16_t expected = (uint16_t)(((uint16_t)raw[crcPos] << 8) | raw[crcPos + 1]);
+  if (UartFrame_Crc16(raw, crcPos) != expected) return UART_FRAME_ERR_CRC;
+
+  out->type = raw[0];
+  out->seq = raw[1];
+  out->ack = raw[2];
+  out->len = payloadLen;
+  memcpy(out->payload, &raw[UART_FRAME_HEADER_SIZE], payloadLen);
+  return UART_FRAME_OK;
+}
+
+void UartFrameDecoder_Init(UartFrameDecoder* dec) {
+  if (!dec) return;
+  dec->len = 0;
+  dec->overflow = false;
+}
+
+UartFrameStatus UartFrameDecoder_Push(UartFrameDecoder* dec, uint8_t byte, UartFrame* out) {
+  if (!dec) return UART_FRAME_NONE;
+  if (byte != 0x00) {
+    if (dec->len < sizeof(dec->buf)) {
+      dec->buf[dec->len++] = byte;
+    } else {
+      dec->overflow = true;
+    }
+    return UART_FRAME_NONE;
+  }
+  // Délimiteur: fin de trame
+  if (dec->overflow) {
+    UartFrameDecoder_Init(dec);
+    return UART_FRAME_ERR_OVERFLOW;
+  }
+  if (dec->len == 0) return UART_FRAME_NONE; // délimiteurs consécutifs (resynchronisation)
+  UartFrameStatus st = UartFrame_Decode(dec->buf, dec->len, out);
+  UartFrameDecoder_Init(dec);
+  return st;
+}
+
+void UartFrameLink_Init(UartFrameLink* link) {
+  if (!link) return;
+  memset(link, 0, sizeof(*link));
+}
+
+uint8_t UartFrameLink_InFlight(const UartFrameLink* link) {
+  return link ? (uint8_t)(link->txNext - link->txBase) : 0;
+}
+
+bool UartFrameLink_TakeUnacked(UartFrameLink* link, uint8_t* out, size_t outSize, size_t* len) {
+  if (!link || !out || !len || UartFrameLink_InFlight(link) == 0) return false;
+  const UartFrameSlot* slot = &link->slots[link->txBase % UART_FRAME_WINDOW_SIZE];
+  if (slot->frame.len > outSize) return false;
+  memcpy(out, slot->frame.payload, slot->frame.len);
+  *len = slot->frame.len;
+  link->txBase++;
+  link->retries = 0;
+  return true;
+}
+
+bool UartFrameLink_Send(UartFrameLink* link, const uint8_t* payload, size_t len) {
+  if (!link || (!payload && len > 0) || len > UART_FRAME_MAX_PAYLOAD) return false;
+  if (UartFrameLink_InFlight(link) >= UART_FRAME_WINDOW_SIZE) return false;
+  UartFrameSlot* slot = &link->slots[link->txNext % UART_FRAME_WINDOW_SIZE];
+  slot->frame.type = UART_FRAME_TYPE_DATA;
+  slot->frame.seq = link->txNext;
+  slot->frame.len = (uint8_t)len;
+  if (len > 0) memcpy(slot->frame.payload, payload, len);
+  slot->pending = true;
+  slot->sentMs = 0;
+  link->txNext++;
+  return true;
+}
+
+size_t UartFrameLink_Poll(UartFrameLink* link, uint32_t nowMs, uint8_t* out, size_t outSize) {
+  if (!link || !out || link->failed) return 0;
+  uint8_t inFlight = UartFrameLink_InFlight(link);
+
+  // Go-back-N: si la plus ancienne trame expire, tout ce qui suit est réémis
+  if (inFlight > 0) {
+    UartFrameSlot* base = &link->slots[link->txBase % UART_FRAME_WINDOW_SIZE];
+    if (!base->pending && (uint32_t)(nowMs - base->sentMs) >= UART_FRAME_RETX_TIMEOUT_MS) {
+      if (link->retries >= UART_FRAME_MAX_RETRIES) {
+        link->failed = true;
+        return 0;
+      }
+      link->retries++;
+      for (uint8_t i = 0; i < inFlight; i++) {
+        link->slots[(uint8_t)(link->txBase + i) % UART_FRAME_WINDOW_SIZE].pending = true;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < inFlight; i++) {
+    UartFrameSlot* slot = &link->slots[(uint8_t)(link->txBase + i) % UART_FRAME_WINDOW_SIZE];
+    if (!slot->pending) continue;
+    slot->frame.ack = link->rxExpected; // ACK piggyback
+    size_t n = UartFrame_Encode(&slot->frame, out, outSize);
+    if (n == 0) return 0;
+    if (slot->sentMs != 0) link->retransmits++;
+    slot->pending = false;
+    slot->sentMs = nowMs ? nowMs : 1;
+    link->ackPending = false;
+    link->framesSent++;
+    return n;
+  }
+
+  if (link->ackPending) {
+    UartFrame ack = {};
+    ack.type = UART_FRAME_TYPE_ACK;
+    ack.seq = link->txNext;
+    ack.ack = link->rxExpected;
+    ack.len = 0;
+    size_t n = UartFrame_Encode(&ack, out, outSize);
+    if (n > 0) link->ackPending = false;
+    return n;
+  }
+  return 0;
+}
+
+bool UartFrameLink_OnFrame(UartFrameLink* link, const UartFrame* frame) {
+  if (!link || !frame) return false;
+
+  // ACK cumulatif: tout seq < frame->ack est acquitté
+  uint8_t acked = (uint8_t)(frame->ack - link->txBase);
+  if (acked > 0 && acked <= UartFrameLink_InFlight(link)) {
+    link->txBase = frame->ack;
+    link->retries = 0;
+  }
+
+  if (frame->type != UART_FRAME_TYPE_DATA) return false;
+
+  link->ackPending = true; // toujours (ré)acquitter une trame DATA
+  if (frame->seq != link->rxExpected) {
+    link->duplicates++;
+    return false;
+  }
+  link->rxExpected++;
+  link->framesReceived++;
+  return true;
+}
@@ -0,0 +1,105 @@
+#include "wifi_fast_connect.h"
+#include <string.h>
+
+static uint32_t crc32(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+uint32_t WifiFast_SsidHash(const char* ssid) {
+  uint32_t h = 2166136261u;
+  for (const char* p = ssid ? ssid : ""; *p; p++) {
+    h ^= (uint8_t)*p;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+void WifiFast_Seal(WifiFastRecord* r) {
+  r->crc = crc32((const uint8_t*)r, offsetof(WifiFastRecord, crc));
+}
+
+void WifiFast_Fill(WifiFastRecord* r, const char* ssid, const uint8_t bssid[6], uint8_t channel,
+                   uint32_t ip, uint32_t gateway, uint32_t mask, uint32_t dns1, uint32_t dns2) {
+  memset(r, 0, sizeof(*r));
+  r->version = WIFI_FAST_RECORD_VERSION;
+  r->channel = channel;
+  memcpy(r->bssid, bssid, sizeof(r->bssid));
+  r->ssidHash = WifiFast_SsidHash(ssid);
+  r->ip = ip;
+  r->gateway = gateway;
+  r->mask = mask;
+  r->dns1 = dns1;
+  r->dns2 = dns2;
+  WifiFast_Seal(r);
+}
+
+bool WifiFast_IsUsable(const WifiFastRecord* r, const char* ssid) {
+  static const uint8_t zero[6] = { 0 };
+  return r->version == WIFI_FAST_RECORD_VERSION &&
+         r->crc == crc32((const uint8_t*)r, offsetof(WifiFastRecord, crc)) &&
+         r->ssidHash == WifiFast_SsidHash(ssid) &&
+         r->channel >= 1 && r->channel <= 14 &&
+         memcmp(r->bssid, zero, sizeof(zero)) != 0 &&
+         r->failures < WIFI_FAST_MAX_FAILURES;
+}
+
+void WifiFast_OnFailure(WifiFastRecord* r) {
+  if (r->failures < 0xFF) r->failures++;
+  WifiFast_Seal(r);
+}
+
+bool WifiFast_SameLink(const WifiFastRecord* a, const WifiFastRecord* b) {
+  return a->version == b->version && a->channel == b->channel &&
+         memcmp(a->bssid, b->bssid, sizeof(a->bssid)) == 0 && a->ssidHash == b->ssidHash &&
+         a->ip == b->ip && a->gateway == b->gateway && a->mask == b->mask &&
+         a->dns1 == b->dns1 && a->dns2 == b->dns2 && a->failures == b->failures;
+}
+
+bool WifiFast_ParseIpv4(const char* s, size_t len, uint32_t* out) {
+  uint32_t ip = 0;
+  size_t i = 0;
+  for (int part = 0; part < 4; part++) {
+    if (part > 0) {
+      if (i >= len || s[i] != '.') return false;
+      i++;
+    }
+    uint32_t v = 0;
+    size_t digits = 0;
+    while (i < len && s[i] >= '0' && s[i] <= '9' && digits < 3) {
+      v = v * 10 + (uint32_t)(s[i] - '0');
+      i++;
+      digits++;
+    }
+    if (digits == 0 || v > 255) return false;
+    ip |= v << (8 * part);
+  }
+  if (i != len) return false;
+  *out = ip;
+  return true;
+}
+
+bool WifiFast_ParseStaticIp(const char* s, WifiStaticIp* out) {
+  uint32_t* fields[5] = { &out->ip, &out->gateway, &out->mask, &out->dns1, &out->dns2 };
+  memset(out, 0, sizeof(*out));
+  if (!s) return false;
+  int n = 0;
+  const char* p = s;
+  bool more = true;
+  while (more && n < 5) {
+    const char* end = strchr(p, ',');
+    size_t len = end ? (size_t)(end - p) : strlen(p);
+    while (len > 0 && *p == ' ') { p++; len--; }
+    while (len > 0 && p[len - 1] == ' ') len--;
+    if (!WifiFast_ParseIpv4(p, len, fields[n])) return false;
+    n++;
+    more = end != nullptr;
+    if (more) p = end + 1;
+  }
+  if (n < 3 || more) return false;
+  return out->ip != 0 && out->mask != 0;
+}
@@ -0,0 +1,112 @@
+#include "wifi_reconnect.h"
+#include <string.h>
+
+static uint32_t nextRandom(WifiReconnect* r) {
+  // xorshift32: gigue seulement, pas de qualité cryptographique requise
+  uint32_t x = r->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  r->rng = x;
+  return x;
+}
+
+void WifiRc_Init(WifiReconnect* r, const WifiRcConfig* cfg, uint32_t seed) {
+  if (!r || !cfg) return;
+  memset(r, 0, sizeof(*r));
+  r->cfg = *cfg;
+  r->state = WIFI_RC_IDLE;
+  r->rng = seed ? seed : 0x9E3779B9u;
+}
+
+uint32_t WifiRc_BackoffMs(const WifiRcConfig* cfg, uint32_t failures, uint32_t random) {
+  uint32_t delay = cfg->baseMs;
+  while (failures-- > 0 && delay < cfg->maxMs) delay *= 2;
+  if (delay > cfg->maxMs) delay = cfg->maxMs;
+  uint32_t half = delay / 2;
+  return half + random % (delay - half + 1);
+}
+
+static void scheduleRetry(WifiReconnect* r, uint32_t nowMs, bool authFailed) {
+  r->state = WIFI_RC_BACKOFF;
+  uint32_t random = nextRandom(r);
+  r->deadlineMs = nowMs + (authFailed ? WifiRc_BackoffMs(&r->cfg, 32, random)
+                                      : WifiRc_BackoffMs(&r->cfg, r->failures, random));
+}
+
+void WifiRc_OnAttempt(WifiReconnect* r, uint32_t nowMs) {
+  if (!r) return;
+  r->state = WIFI_RC_CONNECTING;
+  r->deadlineMs = nowMs + r->cfg.attemptTimeoutMs;
+  r->attempts++;
+}
+
+void WifiRc_OnGotIp(WifiReconnect* r) {
+  if (!r) return;
+  r->state = WIFI_RC_CONNECTED;
+  r->failures = 0;
+}
+
+void WifiRc_OnDisconnected(WifiReconnect* r, uint16_t reason, uint32_t nowMs) {
+  if (!r) return;
+  if (reason) r->lastReason = reason;
+  bool authFailed = reason == WIFI_RC_REASON_AUTH_FAIL;
+  if (authFailed) r->authFailures++;
+  if (r->state == WIFI_RC_CONNECTED) {
+    r->disconnects++;
+    r->failures = 0;
+    scheduleRetry(r, nowMs, authFailed);
+  } else if (r->state == WIFI_RC_CONNECTING) {
+    r->failures++;
+    scheduleRetry(r, nowMs, authFailed);
+  }
+}
+
+bool WifiRc_ShouldAttempt(WifiReconnect* r, uint32_t nowMs) {
+  if (!r) return false;
+  if (r->state == WIFI_RC_CONNECTING && (int32_t)(nowMs - r->deadlineMs) >= 0) {
+    r->failures++;
+    scheduleRetry(r, nowMs, false);
+    return false;
+  }
+  return r->state == WIFI_RC_BACKOFF && (int32_t)(nowMs - r->deadlineMs) >= 0;
+}
+
+uint32_t WifiRc_NextDelayMs(const WifiReconnect* r, uint32_t nowMs) {
+  if (!r || (r->state != WIFI_RC_BACKOFF && r->state != WIFI_RC_CONNECTING)) return UINT32_MAX;
+  int32_t remaining = (int32_t)(r->deadlineMs - nowMs);
+  return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+bool WifiRc_ParseHost(const char* url, char* host, size_t hostSize, uint16_t* port) {
+  if (!url || !host || hostSize == 0 || !port) return false;
+  const char* p;
+  uint16_t defaultPort;
+  if (strncmp(url, "https://", 8) == 0) {
+    p = url + 8;
+    defaultPort = 443;
+  } else if (strncmp(url, "http://", 7) == 0) {
+    p = url + 7;
+    defaultPort = 80;
+  } else {
+    return false;
+  }
+  size_t len = strcspn(p, ":/?#");
+  if (len == 0 || len >= hostSize) return false;
+  memcpy(host, p, len);
+  host[len] = '\0';
+  *port = defaultPort;
+  if (p[len] == ':') {
+    uint32_t v = 0;
+    const char* d = p + len + 1;
+    size_t digits = 0;
+    while (*d >= '0' && *d <= '9' && digits < 5) {
+      v = v * 10 + (uint32_t)(*d - '0');
+      d++;
+      digits++;
+    }
+    if (digits == 0 || v == 0 || v > 65535 || (*d && *d != '/' && *d != '?' && *d != '#')) return false;
+    *port = (uint16_t)v;
+  }
+  return true;
+}
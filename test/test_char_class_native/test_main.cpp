@@ -0,0 +1,126 @@
+#include <unity.h>
+#include "../../include/char_class.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+// Listes de security_config.h
+#define URL_LIST  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_./:?&=+%"
+#define SSID_LIST "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_. "
+
+static constexpr CharClass URL = CharClass_FromChars(URL_LIST);
+static constexpr CharClass SSID = CharClass_FromChars(SSID_LIST);
+
+// Construite à la compilation
+static_assert(URL.bits[1] == ((1u << ('%' - 32)) | (1u << ('&' - 32)) | (1u << ('+' - 32)) | (1u << ('-' - 32)) |
+                              (1u << ('.' - 32)) | (1u << ('/' - 32)) | (0x3FFu << 16) | (1u << (':' - 32)) |
+                              (1u << ('=' - 32)) | (1u << ('?' - 32))),
+              "bitmap URL");
+static_assert(CHAR_CLASS_PRINTABLE.bits[0] == 0 && CHAR_CLASS_PRINTABLE.bits[3] == 0x7FFFFFFFu, "plage");
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Référence: ancienne validation strchr (security_utils.cpp)
+static bool legacyValid(const char* str, const char* allowed, size_t maxLength) {
+    size_t len = strlen(str);
+    if (len == 0 || len > maxLength) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (strchr(allowed, str[i]) == nullptr) return false;
+    }
+    return true;
+}
+
+// Tests classes
+void test_class_membership() {
+    for (int c = 0; c < 256; c++) {
+        bool inList = c != 0 && strchr(URL_LIST, c) != nullptr;
+        TEST_ASSERT_EQUAL_INT(inList, CharClass_Has(&URL, (unsigned char)c));
+        TEST_ASSERT_EQUAL_INT(c >= 0x20 && c <= 0x7E, CharClass_Has(&CHAR_CLASS_PRINTABLE, (unsigned char)c));
+    }
+    constexpr CharClass high = CharClass_Union(CharClass_FromRange(0x80, 0xFF), CharClass_FromChars("\t"));
+    TEST_ASSERT_TRUE(CharClass_Has(&high, 0xC3));
+    TEST_ASSERT_TRUE(CharClass_Has(&high, '\t'));
+    TEST_ASSERT_FALSE(CharClass_Has(&high, 'a'));
+    // Le nul n'est jamais dans une classe, même avec une plage qui le couvre
+    constexpr CharClass all = CharClass_FromRange(0, 0xFF);
+    TEST_ASSERT_FALSE(CharClass_Has(&all, 0));
+}
+
+void test_span_matches_reference_at_every_alignment() {
+    // Début non aligné, mots entiers, mot fautif et limite maxLen à toutes les positions
+    char buf[96];
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len < 48; len++) {
+            for (size_t bad = 0; bad <= len; bad++) {
+                char* s = buf + offset;
+                for (size_t i = 0; i < len; i++) s[i] = (char)('a' + i % 26);
+                if (bad < len) s[bad] = '#';
+                s[len] = '\0';
+                for (size_t maxLen = 0; maxLen < 40; maxLen += 13) {
+                    size_t expected = bad < maxLen + 1 ? bad : maxLen + 1;
+                    TEST_ASSERT_EQUAL_UINT32((uint32_t)expected, (uint32_t)CharClass_Span(&SSID, s, maxLen));
+                    TEST_ASSERT_EQUAL_INT(legacyValid(s, SSID_LIST, maxLen), CharClass_Matches(&SSID, s, 1, maxLen));
+                }
+            }
+        }
+    }
+}
+
+void test_matches_bounds() {
+    TEST_ASSERT_FALSE(CharClass_Matches(&SSID, "", 1, 32));
+    TEST_ASSERT_TRUE(CharClass_Matches(&SSID, "", 0, 32));
+    TEST_ASSERT_FALSE(CharClass_Matches(&SSID, nullptr, 0, 32));
+    TEST_ASSERT_TRUE(CharClass_Matches(&CHAR_CLASS_HEX, "00112233445566778899aabbccddeeff00112233445566778899AABBCCDDEEFF", 64, 64));
+    TEST_ASSERT_FALSE(CharClass_Matches(&CHAR_CLASS_HEX, "00112233445566778899aabbccddeeff00112233445566778899AABBCCDDEEF", 64, 64));
+    TEST_ASSERT_FALSE(CharClass_Matches(&URL, "https://api.example.com/path?q=1 ", 1, 256));
+    TEST_ASSERT_FALSE(CharClass_Matches(&SSID, "Caf\xc3\xa9", 1, 32));
+}
+
+// Benchmark
+static double nsPerCall(bool (*fn)(const char*), const char* s, int iterations, int* ok) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) *ok += fn(s);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+static bool legacyUrl(const char* s) { return legacyValid(s, URL_LIST, 256); }
+static bool bytewiseUrl(const char* s) {
+    size_t len = strlen(s);
+    if (len == 0 || len > 256) return false;
+    for (size_t i = 0; i < len; i++) {
+        if (!CharClass_Has(&URL, (unsigned char)s[i])) return false;
+    }
+    return true;
+}
+static bool spanUrl(const char* s) { return CharClass_Matches(&URL, s, 1, 256); }
+
+void test_bench_url_validation() {
+    // URL de 200 caractères, majoritairement des minuscules (fin de liste pour strchr)
+    static char url[201];
+    snprintf(url, sizeof(url), "https://api.example.com/v1/orders?session=");
+    for (size_t i = strlen(url); i < 200; i++) url[i] = (char)('a' + i % 26);
+    url[200] = '\0';
+    const int iterations = 200000;
+    int ok = 0;
+    double legacyNs = nsPerCall(legacyUrl, url, iterations, &ok);
+    double bytewiseNs = nsPerCall(bytewiseUrl, url, iterations, &ok);
+    double spanNs = nsPerCall(spanUrl, url, iterations, &ok);
+    TEST_ASSERT_EQUAL_INT(3 * iterations, ok);
+    printf("[BENCH] char_class: URL 200 caractères strchr=%.0f ns, strlen + bitmap par octet=%.0f ns, bitmap par mots=%.0f ns (x%.1f)\n",
+           legacyNs, bytewiseNs, spanNs, spanNs > 0 ? legacyNs / spanNs : 0.0);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests classes
+    RUN_TEST(test_class_membership);
+    RUN_TEST(test_span_matches_reference_at_every_alignment);
+    RUN_TEST(test_matches_bounds);
+
+    // Benchmark
+    RUN_TEST(test_bench_url_validation);
+    return UNITY_END();
+}
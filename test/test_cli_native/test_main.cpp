@@ -3,7 +3,10 @@
 
 void test_help(){ TEST_ASSERT_EQUAL(CMD_HELP, parseCommand("HELP")); }
 void test_unknown(){ TEST_ASSERT_EQUAL(CMD_UNKNOWN, parseCommand("FOO")); }
+void test_cap(){ TEST_ASSERT_EQUAL(CMD_CAP, parseCommand("CAP")); }
+void test_qrbench(){ TEST_ASSERT_EQUAL(CMD_QRBENCH, parseCommand("QRBENCH")); }
+void test_nfcbg(){ TEST_ASSERT_EQUAL(CMD_NFCBG, parseCommand("NFCBG")); }
 
-int main(){ UNITY_BEGIN(); RUN_TEST(test_help); RUN_TEST(test_unknown); return UNITY_END(); }
+int main(){ UNITY_BEGIN(); RUN_TEST(test_help); RUN_TEST(test_unknown); RUN_TEST(test_cap); RUN_TEST(test_qrbench); RUN_TEST(test_nfcbg); return UNITY_END(); }
 
 
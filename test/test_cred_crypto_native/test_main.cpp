@@ -0,0 +1,129 @@
+#include <unity.h>
+#include "../../include/cred_crypto.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t buf[CRED_BLOB_MAX + 8];
+
+void setUp(void) {
+    memset(buf, 0xAA, sizeof(buf));
+}
+void tearDown(void) {}
+
+// Tests format
+void test_layout_and_parse_gcm() {
+    CredBlob out;
+    size_t size = CredBlob_Layout(buf, sizeof(buf), CRED_FORMAT_AES_GCM, 63, &out);
+    TEST_ASSERT_EQUAL_UINT32(1 + CRED_NONCE_SIZE + 63 + CRED_TAG_SIZE, (uint32_t)size);
+    TEST_ASSERT_EQUAL_UINT8(CRED_FORMAT_AES_GCM, buf[0]);
+    TEST_ASSERT_TRUE(out.nonce == buf + 1);
+    TEST_ASSERT_TRUE(out.data == buf + 1 + CRED_NONCE_SIZE);
+    TEST_ASSERT_TRUE(out.tag == buf + size - CRED_TAG_SIZE);
+
+    CredBlob in;
+    TEST_ASSERT_TRUE(CredBlob_Parse(buf, size, &in));
+    TEST_ASSERT_EQUAL_UINT32(63, (uint32_t)in.dataLen);
+    TEST_ASSERT_TRUE(in.nonce == out.nonce && in.data == out.data && in.tag == out.tag);
+
+    // Mot de passe trop long ou tampon trop petit
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)CredBlob_Layout(buf, sizeof(buf), CRED_FORMAT_AES_GCM, CRED_PASS_MAX + 1, &out));
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)CredBlob_Layout(buf, 40, CRED_FORMAT_AES_GCM, 20, &out));
+}
+
+void test_plain_format_and_open_network() {
+    CredBlob out;
+    TEST_ASSERT_EQUAL_UINT32(1, (uint32_t)CredBlob_Layout(buf, sizeof(buf), CRED_FORMAT_PLAIN, 0, &out));
+    TEST_ASSERT_NULL(out.nonce);
+    TEST_ASSERT_NULL(out.tag);
+
+    size_t size = CredBlob_Layout(buf, sizeof(buf), CRED_FORMAT_PLAIN, 8, &out);
+    memcpy(out.data, "secret12", 8);
+    CredBlob in;
+    TEST_ASSERT_TRUE(CredBlob_Parse(buf, size, &in));
+    TEST_ASSERT_EQUAL_UINT8(CRED_FORMAT_PLAIN, in.format);
+    TEST_ASSERT_EQUAL_UINT32(8, (uint32_t)in.dataLen);
+    TEST_ASSERT_EQUAL_MEMORY("secret12", in.data, 8);
+}
+
+void test_parse_rejects_corrupted_blobs() {
+    CredBlob in;
+    TEST_ASSERT_FALSE(CredBlob_Parse(buf, 0, &in));
+    // Format inconnu (ancienne valeur hexadécimale lue comme blob)
+    buf[0] = '3';
+    TEST_ASSERT_FALSE(CredBlob_Parse(buf, 40, &in));
+    // GCM plus court que nonce + tag
+    buf[0] = CRED_FORMAT_AES_GCM;
+    TEST_ASSERT_FALSE(CredBlob_Parse(buf, CRED_NONCE_SIZE + CRED_TAG_SIZE, &in));
+    TEST_ASSERT_TRUE(CredBlob_Parse(buf, 1 + CRED_NONCE_SIZE + CRED_TAG_SIZE, &in));
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)in.dataLen);
+    // Plus long que le mot de passe maximal
+    TEST_ASSERT_FALSE(CredBlob_Parse(buf, CRED_BLOB_MAX + 1, &in));
+    buf[0] = CRED_FORMAT_PLAIN;
+    TEST_ASSERT_FALSE(CredBlob_Parse(buf, 1 + CRED_PASS_MAX + 1, &in));
+}
+
+// Tests ancien format
+void test_hex_decode() {
+    uint8_t out[4];
+    size_t len = 99;
+    TEST_ASSERT_TRUE(CredBlob_HexDecode("00aFB9", out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT32(3, (uint32_t)len);
+    TEST_ASSERT_EQUAL_UINT8(0x00, out[0]);
+    TEST_ASSERT_EQUAL_UINT8(0xAF, out[1]);
+    TEST_ASSERT_EQUAL_UINT8(0xB9, out[2]);
+    TEST_ASSERT_TRUE(CredBlob_HexDecode("", out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)len);
+
+    TEST_ASSERT_FALSE(CredBlob_HexDecode("abc", out, sizeof(out), &len));
+    TEST_ASSERT_FALSE(CredBlob_HexDecode("0g", out, sizeof(out), &len));
+    TEST_ASSERT_FALSE(CredBlob_HexDecode("0102030405", out, sizeof(out), &len));
+}
+
+// Benchmark
+void test_bench_hex_decode() {
+    // Ancien chiffré d'un mot de passe de 63 caractères: 64 octets, 128 caractères hex
+    char hex[129];
+    for (int i = 0; i < 64; i++) snprintf(hex + i * 2, 3, "%02x", (unsigned)(i * 37 + 11) & 0xFF);
+    uint8_t a[64], b[64];
+    const int iterations = 20000;
+    size_t len = 0;
+    unsigned sum = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+        for (size_t i = 0; i < 64; i++) sscanf(hex + i * 2, "%2hhx", &a[i]);
+        sum += a[n & 63];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+        CredBlob_HexDecode(hex, b, sizeof(b), &len);
+        sum += b[n & 63];
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    TEST_ASSERT_EQUAL_UINT32(64, (uint32_t)len);
+    TEST_ASSERT_EQUAL_MEMORY(a, b, sizeof(a));
+    double scanfUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+    double decodeUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / iterations;
+    printf("[BENCH] cred_crypto: décodage hex 64 octets sscanf=%.3f us, direct=%.3f us (x%.1f), "
+           "blob binaire GCM %d octets au lieu de %d caractères (checksum %u)\n",
+           scanfUs, decodeUs, decodeUs > 0 ? scanfUs / decodeUs : 0.0,
+           1 + CRED_NONCE_SIZE + 63 + CRED_TAG_SIZE, 128, sum & 1);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests format
+    RUN_TEST(test_layout_and_parse_gcm);
+    RUN_TEST(test_plain_format_and_open_network);
+    RUN_TEST(test_parse_rejects_corrupted_blobs);
+
+    // Tests ancien format
+    RUN_TEST(test_hex_decode);
+
+    // Benchmark
+    RUN_TEST(test_bench_hex_decode);
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+#include <unity.h>
+#include "../../include/log_ring.h"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+static LogRing ring;
+static LogRecord rec;
+static char line[256];
+
+void setUp(void) {
+    LogRing_Init(&ring);
+}
+void tearDown(void) {}
+
+static const char* popLine() {
+    if (!LogRing_Pop(&ring, &rec)) return nullptr;
+    LogRing_Format(&rec, line, sizeof(line));
+    return line;
+}
+
+// Tests formatage
+void test_format_matches_printf() {
+    char expected[256];
+    int8_t small = -3;
+    uint16_t port = 65535;
+    unsigned long big = 4000000000ul;
+    long long huge = -1234567890123ll;
+    enum { STATE_A, STATE_B, STATE_C } state = STATE_C;
+
+    LogRing_Write(&ring, 1, "[ORCH] Item %d/%d: %s\n", 2, 5, "OK slot 3");
+    snprintf(expected, sizeof(expected), "[ORCH] Item %d/%d: %s\n", 2, 5, "OK slot 3");
+    TEST_ASSERT_EQUAL_STRING(expected, popLine());
+
+    LogRing_Write(&ring, 2, "%hhd %u %lu %lld %d", small, port, big, huge, state);
+    snprintf(expected, sizeof(expected), "%hhd %u %lu %lld %d", small, port, big, huge, (int)state);
+    TEST_ASSERT_EQUAL_STRING(expected, popLine());
+
+    LogRing_Write(&ring, 2, "|%5s|%-4d|%04X|%c|%.3s|100%%", "ab", 7, 0xBEEF, 'z', "tronque");
+    snprintf(expected, sizeof(expected), "|%5s|%-4d|%04X|%c|%.3s|100%%", "ab", 7, 0xBEEF, 'z', "tronque");
+    TEST_ASSERT_EQUAL_STRING(expected, popLine());
+
+    LogRing_Write(&ring, 3, "%.2f %e %g %zu", 3.14159, 0.00012f, 1e10, sizeof(LogRecord));
+    snprintf(expected, sizeof(expected), "%.2f %e %g %zu", 3.14159, (double)0.00012f, 1e10, sizeof(LogRecord));
+    TEST_ASSERT_EQUAL_STRING(expected, popLine());
+
+    // Promotion en int et troncature h / hh comme printf
+    LogRing_Write(&ring, 4, "%u %x %hx %hhu", -1, (int16_t)-2, -2, 300);
+    snprintf(expected, sizeof(expected), "%u %x %hx %hhu", -1, (int16_t)-2, -2, 300);
+    TEST_ASSERT_EQUAL_STRING(expected, popLine());
+
+    TEST_ASSERT_EQUAL_UINT32(4, rec.timeMs);
+    TEST_ASSERT_NULL(popLine());
+}
+
+void test_mismatched_and_missing_arguments() {
+    // Jamais de lecture d'un pointeur invalide: type incompatible ou argument absent signalés
+    LogRing_Write(&ring, 0, "%s|%d|%d", 42, "txt");
+    TEST_ASSERT_EQUAL_STRING("(?)|(?)|%d", popLine());
+    LogRing_Write(&ring, 0, "%y %d", 5);
+    TEST_ASSERT_EQUAL_STRING("%y 5", popLine());
+    LogRing_Write(&ring, 0, "fin %");
+    TEST_ASSERT_EQUAL_STRING("fin ", popLine());
+
+    // Ligne tronquée à la taille du tampon
+    char small[8];
+    LogRing_Write(&ring, 0, "%s et %d", "abcdef", 12345);
+    TEST_ASSERT_TRUE(LogRing_Pop(&ring, &rec));
+    TEST_ASSERT_EQUAL_INT(7, (int)LogRing_Format(&rec, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("abcdef ", small);
+}
+
+// Tests chaînes
+void test_strings_are_copied_at_push() {
+    char buf[32];
+    strcpy(buf, "UID 04A1B2");
+    LogRing_Write(&ring, 0, "[NFC] %s / %s / %s", buf, (const char*)nullptr, "");
+    strcpy(buf, "écrasé");
+    TEST_ASSERT_EQUAL_STRING("[NFC] UID 04A1B2 / (null) / ", popLine());
+
+    // Réponse longue: tronquée à la zone de texte, les chaînes suivantes restent vides
+    char payload[300];
+    memset(payload, 'x', sizeof(payload) - 1);
+    payload[sizeof(payload) - 1] = '\0';
+    LogRing_Write(&ring, 0, "%s|%s|%d", payload, "perdu", 9);
+    popLine();
+    TEST_ASSERT_EQUAL_INT(LOG_RING_TEXT_SIZE - 1 + 3, (int)strlen(line));
+    TEST_ASSERT_EQUAL_STRING("||9", line + LOG_RING_TEXT_SIZE - 1);
+}
+
+// Tests file
+void test_full_ring_drops_and_counts() {
+    for (int i = 0; i < LOG_RING_CAPACITY + 5; i++) LogRing_Write(&ring, (uint32_t)i, "msg %d", i);
+    TEST_ASSERT_EQUAL_UINT32(LOG_RING_CAPACITY, LogRing_Written(&ring));
+    TEST_ASSERT_EQUAL_UINT32(5, LogRing_Dropped(&ring));
+
+    // Ordre conservé, puis la file accepte de nouveau
+    TEST_ASSERT_EQUAL_STRING("msg 0", popLine());
+    TEST_ASSERT_TRUE(LogRing_Write(&ring, 100, "msg %d", 100));
+    for (int i = 1; i < LOG_RING_CAPACITY; i++) popLine();
+    TEST_ASSERT_EQUAL_STRING("msg 100", popLine());
+    TEST_ASSERT_NULL(popLine());
+
+    TEST_ASSERT_FALSE(LogRing_Push(&ring, 0, nullptr, nullptr, 0));
+    TEST_ASSERT_FALSE(LogRing_Push(&ring, 0, "x", nullptr, 1));
+}
+
+// Tests concurrence
+void test_concurrent_producers_single_consumer() {
+    // 4 tâches productrices, la tâche de vidage en parallèle: aucun message perdu sans être
+    // compté, aucun message dupliqué, ordre conservé par producteur
+    const int threads = 4, perThread = 50000;
+    std::atomic<bool> done(false);
+    int nextSeq[threads] = { 0 };
+    uint32_t popped = 0;
+    bool ordered = true;
+
+    std::thread consumer([&]() {
+        LogRecord r;
+        for (;;) {
+            bool last = done.load();
+            while (LogRing_Pop(&ring, &r)) {
+                int t = (int)r.arg[0].i, seq = (int)r.arg[1].i;
+                if (seq < nextSeq[t]) ordered = false;
+                nextSeq[t] = seq + 1;
+                popped++;
+            }
+            if (last) break;
+        }
+    });
+    std::thread pool[threads];
+    for (int i = 0; i < threads; i++) {
+        pool[i] = std::thread([i]() {
+            for (int k = 0; k < perThread; k++) {
+                LogRing_Write(&ring, 0, "[T%d] %d", i, k);
+                std::this_thread::yield();     // rythme d'une tâche réelle, sinon tout est perdu d'emblée
+            }
+        });
+    }
+    for (int i = 0; i < threads; i++) pool[i].join();
+    done = true;
+    consumer.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT32(LogRing_Written(&ring), popped);
+    TEST_ASSERT_EQUAL_UINT32(threads * perThread, LogRing_Written(&ring) + LogRing_Dropped(&ring));
+    printf("[BENCH] log_ring: %u/%d messages écrits, %u perdus (consommateur sans pause)\n",
+           (unsigned)popped, threads * perThread, (unsigned)LogRing_Dropped(&ring));
+}
+
+// Benchmark
+void test_bench_push_against_snprintf() {
+    // Coût côté appelant: dépôt dans la file contre formatage immédiat (sans l'attente UART,
+    // qui domine sur la cible: ~87 us pour 100 caractères à 115200 bauds)
+    const int iterations = 1000000;
+    char out[256];
+    const char* token = "QR-7f3a9c2e-offline";
+    size_t total = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        total += (size_t)snprintf(out, sizeof(out), "[ORCH] Token signé: %s (%lu us), état %d\n", token, (unsigned long)i, i & 7);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        LogRing_Write(&ring, (uint32_t)i, "[ORCH] Token signé: %s (%lu us), état %d\n", token, (unsigned long)i, i & 7);
+        LogRing_Pop(&ring, &rec);      // file jamais pleine, coût du vidage non compté
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        LogRing_Write(&ring, (uint32_t)i, "[ORCH] Token signé: %s (%lu us), état %d\n", token, (unsigned long)i, i & 7);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    TEST_ASSERT_TRUE(total > 0);
+    TEST_ASSERT_EQUAL_UINT32(iterations + LOG_RING_CAPACITY, LogRing_Written(&ring));
+    double printfNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    double pushPopNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations;
+    double dropNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / iterations;
+    printf("[BENCH] log_ring: snprintf=%.1f ns, dépôt + retrait=%.1f ns, dépôt file pleine=%.1f ns par message\n",
+           printfNs, pushPopNs, dropNs);
+}
+
+int main() {
+    UNITY_BEGIN();
+    // Formatage
+    RUN_TEST(test_format_matches_printf);
+    RUN_TEST(test_mismatched_and_missing_arguments);
+    // Chaînes
+    RUN_TEST(test_strings_are_copied_at_push);
+    // File
+    RUN_TEST(test_full_ring_drops_and_counts);
+    // Concurrence
+    RUN_TEST(test_concurrent_producers_single_consumer);
+    // Benchmark
+    RUN_TEST(test_bench_push_against_snprintf);
+    return UNITY_END();
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Corpus de dumps de tags (zone de données depuis la page 4, ou blocs 4..6 pour MIFARE Classic),
+// reconstitués octet par octet au format écrit par les outils courants (NXP TagWriter, Android).
+// records: appels Ndef_RecordNext attendus (fragments compris), display: texte remonté par nfc_service.
+
+// NTAG213, URL écrite par NXP TagWriter (32 octets)
+static const uint8_t ntag213_tagwriter_url[] = {
+  0x03, 0x19, 0xD1, 0x01, 0x15, 0x55, 0x04, 0x64, 0x70, 0x6D, 0x2E, 0x65, 0x78, 0x61, 0x6D, 0x70,
+  0x6C, 0x65, 0x2E, 0x63, 0x6F, 0x6D, 0x2F, 0x6D, 0x2F, 0x34, 0x32, 0xFE, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG213, record Text UTF-8 (langue fr) (32 octets)
+static const uint8_t ntag213_text_fr[] = {
+  0x03, 0x12, 0xD1, 0x01, 0x0E, 0x54, 0x02, 0x66, 0x72, 0x42, 0x6F, 0x6E, 0x6A, 0x6F, 0x75, 0x72,
+  0x20, 0x44, 0x50, 0x4D, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG215, Smart Poster (URI + titre imbriqués) (48 octets)
+static const uint8_t ntag215_smart_poster[] = {
+  0x03, 0x23, 0xD1, 0x02, 0x1E, 0x53, 0x70, 0x91, 0x01, 0x10, 0x55, 0x02, 0x64, 0x70, 0x6D, 0x2E,
+  0x65, 0x78, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x2E, 0x63, 0x6F, 0x6D, 0x51, 0x01, 0x06, 0x54, 0x02,
+  0x65, 0x6E, 0x44, 0x50, 0x4D, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG216, vCard (MIME, record long) + Android Application Record (336 octets)
+static const uint8_t ntag216_vcard_aar[] = {
+  0x03, 0xFF, 0x01, 0x45, 0x82, 0x0A, 0x00, 0x00, 0x01, 0x18, 0x74, 0x65, 0x78, 0x74, 0x2F, 0x76,
+  0x63, 0x61, 0x72, 0x64, 0x42, 0x45, 0x47, 0x49, 0x4E, 0x3A, 0x56, 0x43, 0x41, 0x52, 0x44, 0x0D,
+  0x0A, 0x56, 0x45, 0x52, 0x53, 0x49, 0x4F, 0x4E, 0x3A, 0x33, 0x2E, 0x30, 0x0D, 0x0A, 0x46, 0x4E,
+  0x3A, 0x53, 0x65, 0x72, 0x76, 0x69, 0x63, 0x65, 0x20, 0x44, 0x50, 0x4D, 0x0D, 0x0A, 0x4F, 0x52,
+  0x47, 0x3A, 0x44, 0x50, 0x4D, 0x0D, 0x0A, 0x54, 0x45, 0x4C, 0x3B, 0x54, 0x59, 0x50, 0x45, 0x3D,
+  0x57, 0x4F, 0x52, 0x4B, 0x3A, 0x2B, 0x33, 0x33, 0x31, 0x30, 0x32, 0x30, 0x33, 0x30, 0x34, 0x30,
+  0x35, 0x0D, 0x0A, 0x45, 0x4D, 0x41, 0x49, 0x4C, 0x3A, 0x73, 0x75, 0x70, 0x70, 0x6F, 0x72, 0x74,
+  0x40, 0x64, 0x70, 0x6D, 0x2E, 0x65, 0x78, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x2E, 0x63, 0x6F, 0x6D,
+  0x0D, 0x0A, 0x55, 0x52, 0x4C, 0x3A, 0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x64, 0x70,
+  0x6D, 0x2E, 0x65, 0x78, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x2E, 0x63, 0x6F, 0x6D, 0x0D, 0x0A, 0x4E,
+  0x4F, 0x54, 0x45, 0x3A, 0x44, 0x69, 0x73, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x75, 0x72,
+  0x20, 0x6D, 0x6F, 0x64, 0x75, 0x6C, 0x61, 0x69, 0x72, 0x65, 0x20, 0x2D, 0x20, 0x61, 0x73, 0x73,
+  0x69, 0x73, 0x74, 0x61, 0x6E, 0x63, 0x65, 0x20, 0x37, 0x6A, 0x2F, 0x37, 0x20, 0x64, 0x65, 0x20,
+  0x38, 0x68, 0x20, 0x61, 0x20, 0x32, 0x30, 0x68, 0x2E, 0x20, 0x53, 0x69, 0x67, 0x6E, 0x61, 0x6C,
+  0x65, 0x72, 0x20, 0x74, 0x6F, 0x75, 0x74, 0x65, 0x20, 0x70, 0x61, 0x6E, 0x6E, 0x65, 0x20, 0x61,
+  0x76, 0x65, 0x63, 0x20, 0x6C, 0x65, 0x20, 0x6E, 0x75, 0x6D, 0x65, 0x72, 0x6F, 0x20, 0x64, 0x65,
+  0x20, 0x6D, 0x61, 0x63, 0x68, 0x69, 0x6E, 0x65, 0x20, 0x69, 0x6E, 0x64, 0x69, 0x71, 0x75, 0x65,
+  0x20, 0x73, 0x75, 0x72, 0x20, 0x6C, 0x61, 0x20, 0x66, 0x61, 0x63, 0x61, 0x64, 0x65, 0x2E, 0x0D,
+  0x0A, 0x45, 0x4E, 0x44, 0x3A, 0x56, 0x43, 0x41, 0x52, 0x44, 0x0D, 0x0A, 0x54, 0x0F, 0x0B, 0x61,
+  0x6E, 0x64, 0x72, 0x6F, 0x69, 0x64, 0x2E, 0x63, 0x6F, 0x6D, 0x3A, 0x70, 0x6B, 0x67, 0x63, 0x6F,
+  0x6D, 0x2E, 0x64, 0x70, 0x6D, 0x2E, 0x61, 0x70, 0x70, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// Ultralight, record Text UTF-16 avec BOM (48 octets)
+static const uint8_t ultralight_text_utf16[] = {
+  0x03, 0x11, 0xD1, 0x01, 0x0D, 0x54, 0x82, 0x66, 0x72, 0xFE, 0xFF, 0x00, 0x43, 0x00, 0x61, 0x00,
+  0x66, 0x00, 0xE9, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG213 avec Lock Control TLV, jeton Wi-Fi (application/vnd.wfa.wsc) (96 octets)
+static const uint8_t ntag213_lock_tlv_wifi[] = {
+  0x01, 0x03, 0xA0, 0x0C, 0x34, 0x03, 0x4A, 0xD2, 0x17, 0x30, 0x61, 0x70, 0x70, 0x6C, 0x69, 0x63,
+  0x61, 0x74, 0x69, 0x6F, 0x6E, 0x2F, 0x76, 0x6E, 0x64, 0x2E, 0x77, 0x66, 0x61, 0x2E, 0x77, 0x73,
+  0x63, 0x10, 0x0E, 0x00, 0x2C, 0x10, 0x26, 0x00, 0x01, 0x01, 0x10, 0x45, 0x00, 0x07, 0x44, 0x50,
+  0x4D, 0x2D, 0x4E, 0x45, 0x54, 0x10, 0x03, 0x00, 0x02, 0x00, 0x20, 0x10, 0x0F, 0x00, 0x02, 0x00,
+  0x08, 0x10, 0x27, 0x00, 0x0C, 0x64, 0x70, 0x6D, 0x2D, 0x73, 0x65, 0x63, 0x72, 0x65, 0x74, 0x2D,
+  0x31, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// MIFARE Classic 1K, secteur 1 blocs 4..6 (NDEF MAD) (48 octets)
+static const uint8_t classic1k_sector1_url[] = {
+  0x03, 0x14, 0xD1, 0x01, 0x10, 0x55, 0x01, 0x64, 0x70, 0x6D, 0x2E, 0x65, 0x78, 0x61, 0x6D, 0x70,
+  0x6C, 0x65, 0x2E, 0x63, 0x6F, 0x6D, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG213, record Text fragmenté en 3 chunks (32 octets)
+static const uint8_t ntag213_chunked_text[] = {
+  0x03, 0x16, 0xB1, 0x01, 0x06, 0x54, 0x02, 0x65, 0x6E, 0x48, 0x65, 0x6C, 0x36, 0x00, 0x03, 0x6C,
+  0x6F, 0x20, 0x56, 0x00, 0x03, 0x44, 0x50, 0x4D, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG213 formaté, message NDEF vide (16 octets)
+static const uint8_t ntag213_empty[] = {
+  0x03, 0x00, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// NTAG213, TNF absolute URI (48 octets)
+static const uint8_t ntag213_absolute_uri[] = {
+  0x03, 0x1E, 0xD3, 0x1B, 0x00, 0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x64, 0x70, 0x6D,
+  0x2E, 0x65, 0x78, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x2E, 0x63, 0x6F, 0x6D, 0x2F, 0x61, 0x62, 0x73,
+  0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+typedef struct {
+  const char* name;
+  const uint8_t* data;
+  size_t len;
+  int records;
+  const char* display;
+} NdefCorpusEntry;
+
+static const NdefCorpusEntry kNdefCorpus[] = {
+  { "ntag213_tagwriter_url", ntag213_tagwriter_url, sizeof(ntag213_tagwriter_url), 1, "https://dpm.example.com/m/42" },
+  { "ntag213_text_fr", ntag213_text_fr, sizeof(ntag213_text_fr), 1, "Bonjour DPM" },
+  { "ntag215_smart_poster", ntag215_smart_poster, sizeof(ntag215_smart_poster), 1, NULL },
+  { "ntag216_vcard_aar", ntag216_vcard_aar, sizeof(ntag216_vcard_aar), 2, NULL },
+  { "ultralight_text_utf16", ultralight_text_utf16, sizeof(ultralight_text_utf16), 1, "Caf\xC3\xA9" },
+  { "ntag213_lock_tlv_wifi", ntag213_lock_tlv_wifi, sizeof(ntag213_lock_tlv_wifi), 1, NULL },
+  { "classic1k_sector1_url", classic1k_sector1_url, sizeof(classic1k_sector1_url), 1, "http://www.dpm.example.com" },
+  { "ntag213_chunked_text", ntag213_chunked_text, sizeof(ntag213_chunked_text), 3, NULL },
+  { "ntag213_empty", ntag213_empty, sizeof(ntag213_empty), 0, NULL },
+  { "ntag213_absolute_uri", ntag213_absolute_uri, sizeof(ntag213_absolute_uri), 1, NULL },
+};
+
+#define NDEF_CORPUS_COUNT (sizeof(kNdefCorpus) / sizeof(kNdefCorpus[0]))
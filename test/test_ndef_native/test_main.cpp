@@ -0,0 +1,248 @@
+#include <unity.h>
+#include "ndef.h"
+#include "corpus.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Texte remonté par nfc_service: premier Text, sinon premier URI
+static bool displayText(const uint8_t* mem, size_t len, char* out, size_t outSize) {
+    NdefRecord rec;
+    NdefText text;
+    NdefUri uri;
+    if (Ndef_FindRecord(mem, len, NDEF_TNF_WELL_KNOWN, "T", &rec) && Ndef_ParseText(&rec, &text)) {
+        Ndef_TextToUtf8(&text, out, outSize);
+        return true;
+    }
+    if (Ndef_FindRecord(mem, len, NDEF_TNF_WELL_KNOWN, "U", &rec) && Ndef_ParseUri(&rec, &uri)) {
+        Ndef_UriToString(&uri, out, outSize);
+        return true;
+    }
+    return false;
+}
+
+static bool inside(const uint8_t* p, size_t n, const uint8_t* mem, size_t len) {
+    return n == 0 || (p >= mem && p + n <= mem + len);
+}
+
+// Tests corpus
+void test_corpus_walk() {
+    for (size_t c = 0; c < NDEF_CORPUS_COUNT; c++) {
+        const NdefCorpusEntry& e = kNdefCorpus[c];
+        NdefTlvIter tlvs;
+        NdefTlv tlv;
+        int records = 0;
+        Ndef_TlvBegin(&tlvs, e.data, e.len);
+        while (Ndef_TlvNext(&tlvs, &tlv)) {
+            if (tlv.type != NDEF_TLV_MESSAGE) continue;
+            NdefRecordIter it;
+            NdefRecord rec;
+            Ndef_RecordBegin(&it, tlv.value, tlv.len);
+            while (Ndef_RecordNext(&it, &rec)) {
+                // Vues dans le dump, aucune copie
+                TEST_ASSERT_TRUE_MESSAGE(inside(rec.type, rec.typeLen, e.data, e.len), e.name);
+                TEST_ASSERT_TRUE_MESSAGE(inside(rec.payload, rec.payloadLen, e.data, e.len), e.name);
+                records++;
+            }
+            TEST_ASSERT_FALSE_MESSAGE(it.error, e.name);
+        }
+        TEST_ASSERT_FALSE_MESSAGE(tlvs.error, e.name);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(e.records, records, e.name);
+
+        char out[120];
+        bool shown = displayText(e.data, e.len, out, sizeof(out));
+        TEST_ASSERT_EQUAL_MESSAGE(e.display != NULL, shown, e.name);
+        if (e.display) TEST_ASSERT_EQUAL_STRING_MESSAGE(e.display, out, e.name);
+    }
+}
+
+void test_smart_poster_nested_message() {
+    NdefRecord sp;
+    TEST_ASSERT_TRUE(Ndef_FindRecord(ntag215_smart_poster, sizeof(ntag215_smart_poster),
+                                     NDEF_TNF_WELL_KNOWN, "Sp", &sp));
+    // Le payload d'un Smart Poster est lui-même un message NDEF
+    NdefRecordIter it;
+    NdefRecord rec;
+    NdefUri uri;
+    NdefText title;
+    char out[64];
+    Ndef_RecordBegin(&it, sp.payload, sp.payloadLen);
+    TEST_ASSERT_TRUE(Ndef_RecordNext(&it, &rec));
+    TEST_ASSERT_TRUE(rec.mb);
+    TEST_ASSERT_TRUE(Ndef_ParseUri(&rec, &uri));
+    Ndef_UriToString(&uri, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("https://www.dpm.example.com", out);
+    TEST_ASSERT_TRUE(Ndef_RecordNext(&it, &rec));
+    TEST_ASSERT_TRUE(rec.me);
+    TEST_ASSERT_TRUE(Ndef_ParseText(&rec, &title));
+    TEST_ASSERT_EQUAL_INT(2, title.langLen);
+    TEST_ASSERT_EQUAL_MEMORY("en", title.lang, 2);
+    TEST_ASSERT_FALSE(Ndef_RecordNext(&it, &rec));
+    TEST_ASSERT_TRUE(it.done);
+}
+
+void test_mime_long_record_and_absolute_uri() {
+    NdefRecord rec;
+    TEST_ASSERT_TRUE(Ndef_FindRecord(ntag216_vcard_aar, sizeof(ntag216_vcard_aar),
+                                     NDEF_TNF_MEDIA, "text/vcard", &rec));
+    TEST_ASSERT_TRUE(rec.payloadLen > 255);
+    TEST_ASSERT_EQUAL_MEMORY("BEGIN:VCARD", rec.payload, 11);
+    TEST_ASSERT_TRUE(Ndef_FindRecord(ntag216_vcard_aar, sizeof(ntag216_vcard_aar),
+                                     NDEF_TNF_EXTERNAL, "android.com:pkg", &rec));
+    TEST_ASSERT_EQUAL_MEMORY("com.dpm.app", rec.payload, rec.payloadLen);
+
+    NdefUri uri;
+    char out[64];
+    TEST_ASSERT_TRUE(Ndef_FindRecord(ntag213_absolute_uri, sizeof(ntag213_absolute_uri),
+                                     NDEF_TNF_ABSOLUTE_URI, "https://dpm.example.com/abs", &rec));
+    TEST_ASSERT_TRUE(Ndef_ParseUri(&rec, &uri));
+    Ndef_UriToString(&uri, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("https://dpm.example.com/abs", out);
+}
+
+void test_chunked_record_join() {
+    NdefTlvIter tlvs;
+    NdefTlv tlv;
+    Ndef_TlvBegin(&tlvs, ntag213_chunked_text, sizeof(ntag213_chunked_text));
+    TEST_ASSERT_TRUE(Ndef_TlvNext(&tlvs, &tlv));
+
+    NdefRecordIter it;
+    NdefRecord first;
+    Ndef_RecordBegin(&it, tlv.value, tlv.len);
+    TEST_ASSERT_TRUE(Ndef_RecordNext(&it, &first));
+    TEST_ASSERT_TRUE(first.chunk);
+    TEST_ASSERT_FALSE(Ndef_ParseText(&first, nullptr));
+
+    uint8_t joined[32];
+    int n = Ndef_JoinChunks(&it, &first, joined, sizeof(joined));
+    TEST_ASSERT_EQUAL_INT(12, n);
+    NdefText text;
+    char out[32];
+    TEST_ASSERT_TRUE(Ndef_ParseTextPayload(joined, (size_t)n, &text));
+    Ndef_TextToUtf8(&text, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("Hello DPM", out);
+    TEST_ASSERT_TRUE(it.done);
+
+    // Buffer trop petit
+    Ndef_RecordBegin(&it, tlv.value, tlv.len);
+    TEST_ASSERT_TRUE(Ndef_RecordNext(&it, &first));
+    TEST_ASSERT_EQUAL_INT(-1, Ndef_JoinChunks(&it, &first, joined, 8));
+}
+
+// Tests texte
+void test_utf16_and_truncation() {
+    NdefRecord rec;
+    NdefText text;
+    TEST_ASSERT_TRUE(Ndef_FindRecord(ultralight_text_utf16, sizeof(ultralight_text_utf16),
+                                     NDEF_TNF_WELL_KNOWN, "T", &rec));
+    TEST_ASSERT_TRUE(Ndef_ParseText(&rec, &text));
+    TEST_ASSERT_TRUE(text.utf16);
+
+    char out[8];
+    TEST_ASSERT_EQUAL_UINT32(5, Ndef_TextToUtf8(&text, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("Caf\xC3\xA9", out);
+    // 'é' (2 octets) ne tient pas: coupé avant, jamais au milieu
+    TEST_ASSERT_EQUAL_UINT32(3, Ndef_TextToUtf8(&text, out, 5));
+    TEST_ASSERT_EQUAL_STRING("Caf", out);
+
+    const uint8_t utf8[] = { 0x02, 'f', 'r', 'C', 'a', 'f', 0xC3, 0xA9 };
+    TEST_ASSERT_TRUE(Ndef_ParseTextPayload(utf8, sizeof(utf8), &text));
+    TEST_ASSERT_EQUAL_UINT32(3, Ndef_TextToUtf8(&text, out, 5));
+    TEST_ASSERT_EQUAL_STRING("Caf", out);
+
+    // UTF-16 LE (BOM), paire de substitution -> 4 octets UTF-8
+    const uint8_t le[] = { 0x80, 0xFF, 0xFE, 'O', 0x00, 0x3D, 0xD8, 0x00, 0xDE };
+    TEST_ASSERT_TRUE(Ndef_ParseTextPayload(le, sizeof(le), &text));
+    TEST_ASSERT_EQUAL_UINT32(5, Ndef_TextToUtf8(&text, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("O\xF0\x9F\x98\x80", out);
+}
+
+// Tests robustesse
+void test_malformed_input() {
+    NdefTlvIter tlvs;
+    NdefTlv tlv;
+    const uint8_t truncatedTlv[] = { 0x03, 0x10, 0xD1, 0x01 };
+    Ndef_TlvBegin(&tlvs, truncatedTlv, sizeof(truncatedTlv));
+    TEST_ASSERT_FALSE(Ndef_TlvNext(&tlvs, &tlv));
+    TEST_ASSERT_TRUE(tlvs.error);
+
+    NdefRecordIter it;
+    NdefRecord rec;
+    const uint8_t overflow[] = { 0xD1, 0x01, 0x20, 'T', 0x02 };        // payload au-delà du message
+    const uint8_t reserved[] = { 0xD7, 0x00, 0x00 };                    // TNF 7
+    const uint8_t unchanged[] = { 0xD6, 0x00, 0x00 };                   // TNF 6 hors fragment
+    const uint8_t meOnChunk[] = { 0xF1, 0x01, 0x01, 'T', 0x00 };        // CF + ME
+    const uint8_t longHeader[] = { 0xC1, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 'T' };
+    const uint8_t* bad[] = { overflow, reserved, unchanged, meOnChunk, longHeader };
+    const size_t badLen[] = { sizeof(overflow), sizeof(reserved), sizeof(unchanged), sizeof(meOnChunk), sizeof(longHeader) };
+    for (size_t i = 0; i < 5; i++) {
+        Ndef_RecordBegin(&it, bad[i], badLen[i]);
+        TEST_ASSERT_FALSE(Ndef_RecordNext(&it, &rec));
+        TEST_ASSERT_TRUE(it.error);
+    }
+
+    // Fragment non terminé en fin de message
+    const uint8_t openChunk[] = { 0xB1, 0x01, 0x01, 'T', 0x00 };
+    Ndef_RecordBegin(&it, openChunk, sizeof(openChunk));
+    TEST_ASSERT_TRUE(Ndef_RecordNext(&it, &rec));
+    TEST_ASSERT_FALSE(Ndef_RecordNext(&it, &rec));
+    TEST_ASSERT_TRUE(it.error);
+
+    // Code d'abréviation URI réservé
+    NdefUri uri;
+    const uint8_t rfu[] = { 0x24, 'x' };
+    TEST_ASSERT_FALSE(Ndef_ParseUriPayload(rfu, sizeof(rfu), &uri));
+    TEST_ASSERT_FALSE(Ndef_FindRecord(NULL, 0, NDEF_TNF_WELL_KNOWN, "T", &rec));
+}
+
+// Benchmark: parcours complet du corpus (TLV + records + décodage affiché)
+void test_bench_corpus_walk() {
+    const int iterations = 20000;
+    size_t records = 0;
+    size_t chars = 0;
+    char out[120];
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (size_t c = 0; c < NDEF_CORPUS_COUNT; c++) {
+            NdefTlvIter tlvs;
+            NdefTlv tlv;
+            Ndef_TlvBegin(&tlvs, kNdefCorpus[c].data, kNdefCorpus[c].len);
+            while (Ndef_TlvNext(&tlvs, &tlv)) {
+                if (tlv.type != NDEF_TLV_MESSAGE) continue;
+                NdefRecordIter it;
+                NdefRecord rec;
+                Ndef_RecordBegin(&it, tlv.value, tlv.len);
+                while (Ndef_RecordNext(&it, &rec)) records++;
+            }
+            if (displayText(kNdefCorpus[c].data, kNdefCorpus[c].len, out, sizeof(out))) chars += strlen(out);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("[BENCH] ndef: %.1f ns/tag, %.1f ns/record (%zu tags, 0 octet copié hors texte affiché)\n",
+           ns / (iterations * (double)NDEF_CORPUS_COUNT), ns / (double)records, NDEF_CORPUS_COUNT);
+    TEST_ASSERT_TRUE(records > 0 && chars > 0);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests corpus
+    RUN_TEST(test_corpus_walk);
+    RUN_TEST(test_smart_poster_nested_message);
+    RUN_TEST(test_mime_long_record_and_absolute_uri);
+    RUN_TEST(test_chunked_record_join);
+
+    // Tests texte
+    RUN_TEST(test_utf16_and_truncation);
+
+    // Tests robustesse
+    RUN_TEST(test_malformed_input);
+
+    // Benchmark
+    RUN_TEST(test_bench_corpus_walk);
+    return UNITY_END();
+}
@@ -0,0 +1,349 @@
+#include "../../include/nfc_auth_index.h"
+#include <string.h>
+
+static uint32_t rd32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static uint64_t rdHash(const uint8_t* rec) {
+  return ((uint64_t)rec[0] << 32) | ((uint64_t)rec[1] << 24) | ((uint64_t)rec[2] << 16) |
+         ((uint64_t)rec[3] << 8) | rec[4];
+}
+
+// CRC-32 (IEEE, réfléchi), bit à bit: calculé une fois par image
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+static uint32_t bucketOf(uint64_t hash) {
+  return (uint32_t)(hash >> (NFC_AUTH_HASH_BITS - NFC_AUTH_DIR_BITS));
+}
+
+uint64_t NfcAuthIndex_HashUid(const uint8_t* uid, size_t len) {
+  uint64_t h = 0xCBF29CE484222325ull;
+  for (size_t i = 0; i < len; i++) {
+    h ^= uid[i];
+    h *= 0x100000001B3ull;
+  }
+  return h >> (64 - NFC_AUTH_HASH_BITS);
+}
+
+size_t NfcAuthIndex_ImageSize(uint32_t count) {
+  return NFC_AUTH_RECORDS_OFFSET + (size_t)count * NFC_AUTH_RECORD_SIZE;
+}
+
+uint32_t NfcAuthIndex_Capacity(size_t imageBytes) {
+  if (imageBytes < NFC_AUTH_RECORDS_OFFSET) return 0;
+  return (uint32_t)((imageBytes - NFC_AUTH_RECORDS_OFFSET) / NFC_AUTH_RECORD_SIZE);
+}
+
+void NfcAuthIndex_Clear(NfcAuthIndex* idx) {
+  memset(idx, 0, sizeof(*idx));
+}
+
+bool NfcAuthIndex_Open(NfcAuthIndex* idx, const uint8_t* image, size_t size, bool checkCrc) {
+  NfcAuthIndex_Clear(idx);
+  if (!image || size < NFC_AUTH_RECORDS_OFFSET) return false;
+  if (rd32(image) != NFC_AUTH_MAGIC || (image[4] | (image[5] << 8)) != NFC_AUTH_FORMAT ||
+      image[6] != NFC_AUTH_RECORD_SIZE || image[7] != NFC_AUTH_DIR_BITS) {
+    return false;
+  }
+  uint32_t count = rd32(image + 16);
+  if (count > NfcAuthIndex_Capacity(size)) return false;
+  const uint8_t* dir = image + NFC_AUTH_HEADER_SIZE;
+  const uint8_t* records = image + NFC_AUTH_RECORDS_OFFSET;
+  if (rd32(dir + 4 * (NFC_AUTH_DIR_ENTRIES - 1)) != count) return false;
+  if (checkCrc && (crc32Update(0, dir, 4 * NFC_AUTH_DIR_ENTRIES) != rd32(image + 20) ||
+                   crc32Update(0, records, (size_t)count * NFC_AUTH_RECORD_SIZE) != rd32(image + 24))) {
+    return false;
+  }
+  idx->dir = dir;
+  idx->records = records;
+  idx->count = count;
+  idx->generation = rd32(image + 8);
+  idx->version = rd32(image + 12);
+  return true;
+}
+
+int NfcAuthIndex_Lookup(const NfcAuthIndex* idx, uint64_t hash) {
+  if (!idx || idx->count == 0) return NFC_AUTH_ABSENT;
+  hash &= NFC_AUTH_HASH_MASK;
+  uint32_t bucket = bucketOf(hash);
+  uint32_t lo = rd32(idx->dir + 4 * bucket);
+  uint32_t hi = rd32(idx->dir + 4 * (bucket + 1));
+  if (hi > idx->count) hi = idx->count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    const uint8_t* rec = idx->records + (size_t)mid * NFC_AUTH_RECORD_SIZE;
+    uint64_t h = rdHash(rec);
+    if (h == hash) return rec[5];
+    if (h < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return NFC_AUTH_ABSENT;
+}
+
+const char* NfcAuthIndex_RoleName(int flags) {
+  if (flags < 0) return "UNKNOWN";
+  if (flags & NFC_AUTH_FLAG_BLOCKED) return "BLOCKED";
+  if (flags & NFC_AUTH_FLAG_STAFF) return "STAFF";
+  if (flags & NFC_AUTH_FLAG_REFILL) return "REFILL";
+  return "ALLOWED";
+}
+
+// ---- Construction ----
+
+static bool flushRecords(NfcAuthBuilder* b) {
+  if (b->recFill == 0) return true;
+  size_t len = (size_t)b->recFill * NFC_AUTH_RECORD_SIZE;
+  uint32_t offset = NFC_AUTH_RECORDS_OFFSET + (b->count - b->recFill) * NFC_AUTH_RECORD_SIZE;
+  b->recCrc = crc32Update(b->recCrc, b->recBuf, len);
+  b->recFill = 0;
+  if (!b->write(b->ctx, offset, b->recBuf, len)) {
+    b->error = NFC_AUTH_ERR_IO;
+    return false;
+  }
+  return true;
+}
+
+static bool flushDir(NfcAuthBuilder* b) {
+  if (b->dirFill == 0) return true;
+  size_t len = (size_t)b->dirFill * 4;
+  uint32_t offset = NFC_AUTH_HEADER_SIZE + 4 * b->dirWritten;
+  b->dirCrc = crc32Update(b->dirCrc, b->dirBuf, len);
+  b->dirWritten += b->dirFill;
+  b->dirFill = 0;
+  if (!b->write(b->ctx, offset, b->dirBuf, len)) {
+    b->error = NFC_AUTH_ERR_IO;
+    return false;
+  }
+  return true;
+}
+
+// Entrées du répertoire jusqu'au seau 'bucket' inclus: premier enregistrement = count
+static bool emitDir(NfcAuthBuilder* b, uint32_t bucket) {
+  while (b->nextBucket <= bucket) {
+    wr32(b->dirBuf + 4 * b->dirFill, b->count);
+    b->dirFill++;
+    b->nextBucket++;
+    if (b->dirFill == NFC_AUTH_CHUNK_DIR && !flushDir(b)) return false;
+  }
+  return true;
+}
+
+void NfcAuthBuilder_Begin(NfcAuthBuilder* b, NfcAuthWriteFn write, void* ctx, size_t imageBytes) {
+  memset(b, 0, sizeof(*b));
+  b->write = write;
+  b->ctx = ctx;
+  b->capacity = NfcAuthIndex_Capacity(imageBytes);
+}
+
+bool NfcAuthBuilder_Add(NfcAuthBuilder* b, uint64_t hash, uint8_t flags) {
+  if (b->error != NFC_AUTH_OK) return false;
+  hash &= NFC_AUTH_HASH_MASK;
+  if (b->count > 0 && hash <= b->lastHash) {
+    b->error = NFC_AUTH_ERR_ORDER;
+    return false;
+  }
+  if (b->count >= b->capacity) {
+    b->error = NFC_AUTH_ERR_FULL;
+    return false;
+  }
+  if (!emitDir(b, bucketOf(hash))) return false;
+
+  uint8_t* rec = b->recBuf + (size_t)b->recFill * NFC_AUTH_RECORD_SIZE;
+  rec[0] = (uint8_t)(hash >> 32);
+  rec[1] = (uint8_t)(hash >> 24);
+  rec[2] = (uint8_t)(hash >> 16);
+  rec[3] = (uint8_t)(hash >> 8);
+  rec[4] = (uint8_t)hash;
+  rec[5] = flags;
+  b->recFill++;
+  b->count++;
+  b->lastHash = hash;
+  return b->recFill < NFC_AUTH_CHUNK_RECORDS || flushRecords(b);
+}
+
+bool NfcAuthBuilder_Finish(NfcAuthBuilder* b, uint32_t generation, uint32_t version) {
+  if (b->error != NFC_AUTH_OK) return false;
+  if (!emitDir(b, NFC_AUTH_DIR_ENTRIES - 1) || !flushDir(b) || !flushRecords(b)) return false;
+
+  uint8_t header[NFC_AUTH_HEADER_SIZE];
+  memset(header, 0, sizeof(header));
+  wr32(header, NFC_AUTH_MAGIC);
+  header[4] = (uint8_t)NFC_AUTH_FORMAT;
+  header[5] = (uint8_t)(NFC_AUTH_FORMAT >> 8);
+  header[6] = NFC_AUTH_RECORD_SIZE;
+  header[7] = NFC_AUTH_DIR_BITS;
+  wr32(header + 8, generation);
+  wr32(header + 12, version);
+  wr32(header + 16, b->count);
+  wr32(header + 20, b->dirCrc);
+  wr32(header + 24, b->recCrc);
+  if (!b->write(b->ctx, 0, header, sizeof(header))) {
+    b->error = NFC_AUTH_ERR_IO;
+    return false;
+  }
+  return true;
+}
+
+// ---- Fusion ----
+
+void NfcAuthMerge_Begin(NfcAuthMerge* m, const NfcAuthIndex* base, NfcAuthWriteFn write, void* ctx,
+                        size_t imageBytes) {
+  memset(m, 0, sizeof(*m));
+  NfcAuthBuilder_Begin(&m->b, write, ctx, imageBytes);
+  if (base) {
+    m->base = *base;
+  } else {
+    NfcAuthIndex_Clear(&m->base);
+  }
+}
+
+// Recopie les enregistrements de l'image courante d'empreinte < hash
+static bool copyBaseBelow(NfcAuthMerge* m, uint64_t hash, bool all) {
+  while (m->baseIdx < m->base.count) {
+    const uint8_t* rec = m->base.records + (size_t)m->baseIdx * NFC_AUTH_RECORD_SIZE;
+    uint64_t h = rdHash(rec);
+    if (!all && h >= hash) break;
+    if (!NfcAuthBuilder_Add(&m->b, h, rec[5])) return false;
+    m->baseIdx++;
+  }
+  return true;
+}
+
+static bool applyOp(NfcAuthMerge* m, uint64_t hash, bool put, uint8_t flags) {
+  if (m->b.error != NFC_AUTH_OK) return false;
+  hash &= NFC_AUTH_HASH_MASK;
+  if (m->hasOp && hash <= m->lastOp) {
+    m->b.error = NFC_AUTH_ERR_ORDER;
+    return false;
+  }
+  m->hasOp = true;
+  m->lastOp = hash;
+  if (!copyBaseBelow(m, hash, false)) return false;
+  if (m->baseIdx < m->base.count &&
+      rdHash(m->base.records + (size_t)m->baseIdx * NFC_AUTH_RECORD_SIZE) == hash) {
+    m->baseIdx++;  // remplacé ou supprimé
+  }
+  if (!put) {
+    m->removes++;
+    return true;
+  }
+  m->puts++;
+  return NfcAuthBuilder_Add(&m->b, hash, flags);
+}
+
+bool NfcAuthMerge_Put(NfcAuthMerge* m, uint64_t hash, uint8_t flags) {
+  return applyOp(m, hash, true, flags);
+}
+
+bool NfcAuthMerge_Remove(NfcAuthMerge* m, uint64_t hash) {
+  return applyOp(m, hash, false, 0);
+}
+
+bool NfcAuthMerge_Finish(NfcAuthMerge* m, uint32_t generation, uint32_t version) {
+  if (!copyBaseBelow(m, 0, true)) return false;
+  return NfcAuthBuilder_Finish(&m->b, generation, version);
+}
+
+// ---- Pages de synchronisation ----
+
+static bool parseU32(const char** p, uint32_t* out) {
+  const char* s = *p;
+  uint64_t v = 0;
+  int digits = 0;
+  while (*s >= '0' && *s <= '9') {
+    v = v * 10 + (uint64_t)(*s - '0');
+    if (v > 0xFFFFFFFFull) return false;
+    s++;
+    digits++;
+  }
+  if (digits == 0) return false;
+  *out = (uint32_t)v;
+  *p = s;
+  return true;
+}
+
+static bool parseHex(const char** p, int digits, uint64_t* out) {
+  uint64_t v = 0;
+  const char* s = *p;
+  for (int i = 0; i < digits; i++, s++) {
+    int d;
+    if (*s >= '0' && *s <= '9') d = *s - '0';
+    else if (*s >= 'a' && *s <= 'f') d = *s - 'a' + 10;
+    else if (*s >= 'A' && *s <= 'F') d = *s - 'A' + 10;
+    else return false;
+    v = (v << 4) | (uint64_t)d;
+  }
+  *out = v;
+  *p = s;
+  return true;
+}
+
+static const char* nextLine(const char* s) {
+  while (*s && *s != '\n') s++;
+  return *s ? s + 1 : s;
+}
+
+static bool lineEnd(const char* s) {
+  if (*s == '\r') s++;
+  return *s == '\n' || *s == '\0';
+}
+
+bool NfcAuthSync_ParseHeader(const char* body, NfcAuthPage* page) {
+  memset(page, 0, sizeof(*page));
+  if (!body) return false;
+  const char* p = body;
+  uint32_t more = 0;
+  if (!parseU32(&p, &page->from) || *p++ != ' ' || !parseU32(&p, &page->to) || *p++ != ' ' ||
+      !parseU32(&p, &more) || more > 1) {
+    return false;
+  }
+  if (*p == ' ') {
+    p++;
+    if (!parseHex(&p, 10, &page->after)) return false;
+    page->hasAfter = true;
+  }
+  if (!lineEnd(p)) return false;
+  page->more = more == 1;
+  return page->from <= page->to;
+}
+
+NfcAuthResult NfcAuthSync_ApplyPage(NfcAuthMerge* m, const char* body, NfcAuthPage* page) {
+  if (!NfcAuthSync_ParseHeader(body, page)) return NFC_AUTH_ERR_MALFORMED;
+  const char* p = nextLine(body);
+  while (*p) {
+    if (lineEnd(p)) {  // ligne vide
+      p = nextLine(p);
+      continue;
+    }
+    char op = *p++;
+    uint64_t hash = 0;
+    uint64_t flags = 0;
+    if ((op != '+' && op != '-') || !parseHex(&p, 10, &hash)) return NFC_AUTH_ERR_MALFORMED;
+    if (op == '+' && (*p++ != ' ' || !parseHex(&p, 2, &flags))) return NFC_AUTH_ERR_MALFORMED;
+    if (!lineEnd(p)) return NFC_AUTH_ERR_MALFORMED;
+    bool ok = op == '+' ? NfcAuthMerge_Put(m, hash, (uint8_t)flags) : NfcAuthMerge_Remove(m, hash);
+    if (!ok) return m->b.error;
+    page->ops++;
+    page->lastHash = hash;
+    p = nextLine(p);
+  }
+  return NFC_AUTH_OK;
+}
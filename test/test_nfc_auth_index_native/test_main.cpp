@@ -0,0 +1,369 @@
+#include <unity.h>
+#include "../../include/nfc_auth_index.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Emplacement flash simulé: zone effacée (0xFF), écritures comptées
+typedef struct {
+    std::vector<uint8_t> mem;
+    int writes;
+    bool failWrites;
+} FakeSlot;
+
+static bool slotWrite(void* ctx, uint32_t offset, const uint8_t* data, size_t len) {
+    FakeSlot* s = (FakeSlot*)ctx;
+    if (s->failWrites || offset + len > s->mem.size()) return false;
+    memcpy(s->mem.data() + offset, data, len);
+    s->writes++;
+    return true;
+}
+
+static void slotErase(FakeSlot* s, size_t size) {
+    s->mem.assign(size, 0xFF);
+    s->writes = 0;
+    s->failWrites = false;
+}
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ull;
+
+static uint64_t nextHash() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState & NFC_AUTH_HASH_MASK;
+}
+
+// n empreintes distinctes triées
+static std::vector<uint64_t> sortedHashes(size_t n) {
+    std::vector<uint64_t> v;
+    v.reserve(n);
+    while (v.size() < n) {
+        for (size_t i = v.size(); i < n; i++) v.push_back(nextHash());
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+    return v;
+}
+
+static uint8_t flagsFor(uint64_t h) {
+    return (uint8_t)((h % 5 == 0) ? NFC_AUTH_FLAG_BLOCKED : (h % 3 == 0) ? NFC_AUTH_FLAG_STAFF : NFC_AUTH_FLAG_REFILL);
+}
+
+static bool buildImage(FakeSlot* slot, const std::vector<uint64_t>& hashes, uint32_t version) {
+    slotErase(slot, NfcAuthIndex_ImageSize((uint32_t)hashes.size()) + 64);
+    NfcAuthBuilder b;
+    NfcAuthBuilder_Begin(&b, slotWrite, slot, slot->mem.size());
+    for (uint64_t h : hashes) {
+        if (!NfcAuthBuilder_Add(&b, h, flagsFor(h))) return false;
+    }
+    return NfcAuthBuilder_Finish(&b, 1, version);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Tests empreinte et format
+void test_hash_and_roles() {
+    const uint8_t uid[4] = { 0x04, 0xA1, 0xB2, 0xC3 };
+    uint64_t h = NfcAuthIndex_HashUid(uid, sizeof(uid));
+    TEST_ASSERT_TRUE(h <= NFC_AUTH_HASH_MASK);
+    TEST_ASSERT_TRUE(h == NfcAuthIndex_HashUid(uid, sizeof(uid)));
+    TEST_ASSERT_FALSE(h == NfcAuthIndex_HashUid(uid, 3));
+    // FNV-1a 64 de la chaîne vide: 0xCBF29CE484222325 -> 40 bits de poids fort
+    TEST_ASSERT_TRUE(NfcAuthIndex_HashUid(uid, 0) == 0xCBF29CE484ull);
+
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", NfcAuthIndex_RoleName(NFC_AUTH_ABSENT));
+    TEST_ASSERT_EQUAL_STRING("BLOCKED", NfcAuthIndex_RoleName(NFC_AUTH_FLAG_BLOCKED | NFC_AUTH_FLAG_STAFF));
+    TEST_ASSERT_EQUAL_STRING("STAFF", NfcAuthIndex_RoleName(NFC_AUTH_FLAG_STAFF | NFC_AUTH_FLAG_REFILL));
+    TEST_ASSERT_EQUAL_STRING("REFILL", NfcAuthIndex_RoleName(NFC_AUTH_FLAG_REFILL));
+    TEST_ASSERT_EQUAL_STRING("ALLOWED", NfcAuthIndex_RoleName(0));
+
+    // Emplacement de 640 Ko (partition nfcauth de 1,25 Mo en deux)
+    TEST_ASSERT_TRUE(NfcAuthIndex_Capacity(640 * 1024) > 100000);
+    TEST_ASSERT_EQUAL_UINT32(0, NfcAuthIndex_Capacity(100));
+}
+
+void test_build_open_lookup() {
+    std::vector<uint64_t> hashes = sortedHashes(5000);
+    FakeSlot slot;
+    TEST_ASSERT_TRUE(buildImage(&slot, hashes, 42));
+
+    NfcAuthIndex idx;
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&idx, slot.mem.data(), slot.mem.size(), true));
+    TEST_ASSERT_EQUAL_UINT32(5000, idx.count);
+    TEST_ASSERT_EQUAL_UINT32(42, idx.version);
+    for (uint64_t h : hashes) TEST_ASSERT_EQUAL_INT(flagsFor(h), NfcAuthIndex_Lookup(&idx, h));
+    int absent = 0;
+    for (int i = 0; i < 5000; i++) {
+        uint64_t h = nextHash();
+        if (!std::binary_search(hashes.begin(), hashes.end(), h)) {
+            TEST_ASSERT_EQUAL_INT(NFC_AUTH_ABSENT, NfcAuthIndex_Lookup(&idx, h));
+            absent++;
+        }
+    }
+    TEST_ASSERT_TRUE(absent > 4900);
+
+    // Extrêmes de l'espace d'empreintes (premier et dernier seau)
+    FakeSlot edge;
+    TEST_ASSERT_TRUE(buildImage(&edge, { 0, 1, NFC_AUTH_HASH_MASK - 1, NFC_AUTH_HASH_MASK }, 1));
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&idx, edge.mem.data(), edge.mem.size(), true));
+    TEST_ASSERT_EQUAL_INT(flagsFor(0), NfcAuthIndex_Lookup(&idx, 0));
+    TEST_ASSERT_EQUAL_INT(flagsFor(NFC_AUTH_HASH_MASK), NfcAuthIndex_Lookup(&idx, NFC_AUTH_HASH_MASK));
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_ABSENT, NfcAuthIndex_Lookup(&idx, 2));
+
+    // Index vide
+    NfcAuthIndex_Clear(&idx);
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_ABSENT, NfcAuthIndex_Lookup(&idx, hashes[0]));
+}
+
+void test_open_rejects_incomplete_or_corrupt_image() {
+    std::vector<uint64_t> hashes = sortedHashes(300);
+    FakeSlot slot;
+    TEST_ASSERT_TRUE(buildImage(&slot, hashes, 3));
+    NfcAuthIndex idx;
+
+    // Écriture interrompue avant l'en-tête
+    std::vector<uint8_t> partial = slot.mem;
+    memset(partial.data(), 0xFF, NFC_AUTH_HEADER_SIZE);
+    TEST_ASSERT_FALSE(NfcAuthIndex_Open(&idx, partial.data(), partial.size(), true));
+
+    // Enregistrement altéré: CRC
+    slot.mem[NFC_AUTH_RECORDS_OFFSET + 7] ^= 0x10;
+    TEST_ASSERT_FALSE(NfcAuthIndex_Open(&idx, slot.mem.data(), slot.mem.size(), true));
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&idx, slot.mem.data(), slot.mem.size(), false));
+
+    // Image plus grande que l'emplacement
+    TEST_ASSERT_FALSE(NfcAuthIndex_Open(&idx, slot.mem.data(), NfcAuthIndex_ImageSize(299), false));
+    TEST_ASSERT_FALSE(NfcAuthIndex_Open(&idx, nullptr, 0, false));
+}
+
+// Tests fusion des deltas
+void test_merge_put_update_remove() {
+    std::vector<uint64_t> hashes = sortedHashes(1000);
+    FakeSlot a;
+    TEST_ASSERT_TRUE(buildImage(&a, hashes, 10));
+    NfcAuthIndex base;
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&base, a.mem.data(), a.mem.size(), true));
+
+    uint64_t added = hashes[500] + 1;
+    while (std::binary_search(hashes.begin(), hashes.end(), added)) added++;
+    FakeSlot b;
+    slotErase(&b, NfcAuthIndex_ImageSize(2000));
+    NfcAuthMerge m;
+    NfcAuthMerge_Begin(&m, &base, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_TRUE(NfcAuthMerge_Remove(&m, hashes[0]));
+    TEST_ASSERT_TRUE(NfcAuthMerge_Put(&m, hashes[10], NFC_AUTH_FLAG_BLOCKED));
+    TEST_ASSERT_TRUE(NfcAuthMerge_Put(&m, added, NFC_AUTH_FLAG_STAFF));
+    TEST_ASSERT_TRUE(NfcAuthMerge_Remove(&m, hashes[999]));
+    TEST_ASSERT_TRUE(NfcAuthMerge_Finish(&m, 2, 11));
+
+    NfcAuthIndex next;
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&next, b.mem.data(), b.mem.size(), true));
+    TEST_ASSERT_EQUAL_UINT32(999, next.count);
+    TEST_ASSERT_EQUAL_UINT32(11, next.version);
+    TEST_ASSERT_EQUAL_UINT32(2, next.generation);
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_ABSENT, NfcAuthIndex_Lookup(&next, hashes[0]));
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_FLAG_BLOCKED, NfcAuthIndex_Lookup(&next, hashes[10]));
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_FLAG_STAFF, NfcAuthIndex_Lookup(&next, added));
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_ABSENT, NfcAuthIndex_Lookup(&next, hashes[999]));
+    TEST_ASSERT_EQUAL_INT(flagsFor(hashes[500]), NfcAuthIndex_Lookup(&next, hashes[500]));
+    // L'image courante reste lisible pendant et après la fusion
+    TEST_ASSERT_EQUAL_INT(flagsFor(hashes[0]), NfcAuthIndex_Lookup(&base, hashes[0]));
+
+    // Opérations non croissantes
+    slotErase(&b, NfcAuthIndex_ImageSize(2000));
+    NfcAuthMerge_Begin(&m, &base, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_TRUE(NfcAuthMerge_Put(&m, hashes[20], 0));
+    TEST_ASSERT_FALSE(NfcAuthMerge_Remove(&m, hashes[20]));
+    TEST_ASSERT_EQUAL(NFC_AUTH_ERR_ORDER, m.b.error);
+    TEST_ASSERT_FALSE(NfcAuthMerge_Finish(&m, 2, 11));
+
+    // Emplacement trop petit, écriture en échec
+    slotErase(&b, NfcAuthIndex_ImageSize(500));
+    NfcAuthMerge_Begin(&m, &base, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_FALSE(NfcAuthMerge_Finish(&m, 2, 11));
+    TEST_ASSERT_EQUAL(NFC_AUTH_ERR_FULL, m.b.error);
+    slotErase(&b, NfcAuthIndex_ImageSize(2000));
+    b.failWrites = true;
+    NfcAuthMerge_Begin(&m, &base, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_FALSE(NfcAuthMerge_Finish(&m, 2, 11));
+    TEST_ASSERT_EQUAL(NFC_AUTH_ERR_IO, m.b.error);
+}
+
+// Tests pages de synchronisation
+static std::string pageText(uint32_t from, uint32_t to, bool more, const std::vector<uint64_t>& puts,
+                            const std::vector<uint64_t>& removes, const uint64_t* after = nullptr) {
+    std::string s = std::to_string(from) + " " + std::to_string(to) + (more ? " 1" : " 0");
+    if (after) {
+        char cursor[16];
+        snprintf(cursor, sizeof(cursor), " %010llX", (unsigned long long)*after);
+        s += cursor;
+    }
+    s += "\n";
+    std::vector<std::pair<uint64_t, bool>> ops;
+    for (uint64_t h : puts) ops.push_back({ h, true });
+    for (uint64_t h : removes) ops.push_back({ h, false });
+    std::sort(ops.begin(), ops.end());
+    char line[24];
+    for (auto& op : ops) {
+        if (op.second) {
+            snprintf(line, sizeof(line), "+%010llx %02x\n", (unsigned long long)op.first, flagsFor(op.first));
+        } else {
+            snprintf(line, sizeof(line), "-%010llX\r\n", (unsigned long long)op.first);
+        }
+        s += line;
+    }
+    return s;
+}
+
+void test_sync_pages_snapshot_then_delta() {
+    NfcAuthPage page;
+    TEST_ASSERT_TRUE(NfcAuthSync_ParseHeader("7 7 0\n", &page));
+    TEST_ASSERT_EQUAL_UINT32(7, page.from);
+    TEST_ASSERT_FALSE(page.more);
+    TEST_ASSERT_FALSE(NfcAuthSync_ParseHeader("8 7 0\n", &page));
+    TEST_ASSERT_FALSE(NfcAuthSync_ParseHeader("0 7 2\n", &page));
+    TEST_ASSERT_FALSE(NfcAuthSync_ParseHeader("<html>", &page));
+    TEST_ASSERT_FALSE(page.hasAfter);
+
+    // Curseur de la requête renvoyé dans l'en-tête des pages suivantes
+    TEST_ASSERT_TRUE(NfcAuthSync_ParseHeader("0 7 1 00000000aB\r\n", &page));
+    TEST_ASSERT_TRUE(page.hasAfter);
+    TEST_ASSERT_TRUE(page.after == 0xAB);
+    TEST_ASSERT_FALSE(NfcAuthSync_ParseHeader("0 7 1 00AB\n", &page));
+    TEST_ASSERT_FALSE(NfcAuthSync_ParseHeader("0 7 1 00000000AB1\n", &page));
+    TEST_ASSERT_FALSE(NfcAuthSync_ParseHeader("0 7 1 \n", &page));
+
+    // Snapshot en 3 pages de 60 opérations (corps < 1 Ko)
+    std::vector<uint64_t> hashes = sortedHashes(180);
+    FakeSlot a;
+    slotErase(&a, NfcAuthIndex_ImageSize(1000));
+    NfcAuthMerge m;
+    NfcAuthMerge_Begin(&m, nullptr, slotWrite, &a, a.mem.size());
+    for (int p = 0; p < 3; p++) {
+        std::vector<uint64_t> part(hashes.begin() + p * 60, hashes.begin() + (p + 1) * 60);
+        uint64_t cursor = m.lastOp;
+        std::string body = pageText(0, 5, p < 2, part, {}, p > 0 ? &cursor : nullptr);
+        TEST_ASSERT_TRUE(body.size() < 1024);
+        TEST_ASSERT_EQUAL(NFC_AUTH_OK, NfcAuthSync_ApplyPage(&m, body.c_str(), &page));
+        TEST_ASSERT_EQUAL(p > 0, page.hasAfter);
+        TEST_ASSERT_TRUE(!page.hasAfter || page.after == cursor);
+        TEST_ASSERT_EQUAL_UINT16(60, page.ops);
+        TEST_ASSERT_TRUE(page.lastHash == part.back());
+        TEST_ASSERT_EQUAL(p < 2, page.more);
+    }
+    TEST_ASSERT_TRUE(NfcAuthMerge_Finish(&m, 1, page.to));
+    NfcAuthIndex idx;
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&idx, a.mem.data(), a.mem.size(), true));
+    TEST_ASSERT_EQUAL_UINT32(180, idx.count);
+    TEST_ASSERT_EQUAL_UINT32(5, idx.version);
+
+    // Delta 5 -> 6 vers l'autre emplacement
+    FakeSlot b;
+    slotErase(&b, NfcAuthIndex_ImageSize(1000));
+    NfcAuthMerge_Begin(&m, &idx, slotWrite, &b, b.mem.size());
+    uint64_t added = nextHash();
+    std::string delta = pageText(5, 6, false, { added }, { hashes[3], hashes[100] });
+    TEST_ASSERT_EQUAL(NFC_AUTH_OK, NfcAuthSync_ApplyPage(&m, delta.c_str(), &page));
+    TEST_ASSERT_TRUE(NfcAuthMerge_Finish(&m, idx.generation + 1, page.to));
+    NfcAuthIndex next;
+    TEST_ASSERT_TRUE(NfcAuthIndex_Open(&next, b.mem.data(), b.mem.size(), true));
+    TEST_ASSERT_EQUAL_UINT32(179, next.count);
+    TEST_ASSERT_EQUAL_INT(NFC_AUTH_ABSENT, NfcAuthIndex_Lookup(&next, hashes[100]));
+    TEST_ASSERT_EQUAL_INT(flagsFor(added), NfcAuthIndex_Lookup(&next, added));
+
+    // Pages invalides
+    slotErase(&b, NfcAuthIndex_ImageSize(1000));
+    NfcAuthMerge_Begin(&m, &idx, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_EQUAL(NFC_AUTH_ERR_MALFORMED, NfcAuthSync_ApplyPage(&m, "5 6 0\n+12345 01\n", &page));
+    NfcAuthMerge_Begin(&m, &idx, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_EQUAL(NFC_AUTH_ERR_MALFORMED, NfcAuthSync_ApplyPage(&m, "5 6 0\n*0000000001\n", &page));
+    NfcAuthMerge_Begin(&m, &idx, slotWrite, &b, b.mem.size());
+    TEST_ASSERT_EQUAL(NFC_AUTH_ERR_ORDER,
+                      NfcAuthSync_ApplyPage(&m, "5 6 0\n+0000000002 01\n-0000000001\n", &page));
+}
+
+// Benchmark: empreinte mémoire et temps de recherche de 10k à 100k cartes.
+// Recherche dans un seau contre dichotomie sur toute la table (même image).
+static int lookupFlat(const NfcAuthIndex* idx, uint64_t hash) {
+    uint32_t lo = 0, hi = idx->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const uint8_t* r = idx->records + (size_t)mid * NFC_AUTH_RECORD_SIZE;
+        uint64_t h = ((uint64_t)r[0] << 32) | ((uint64_t)r[1] << 24) | ((uint64_t)r[2] << 16) |
+                     ((uint64_t)r[3] << 8) | r[4];
+        if (h == hash) return r[5];
+        if (h < hash) lo = mid + 1; else hi = mid;
+    }
+    return NFC_AUTH_ABSENT;
+}
+
+void test_bench_footprint_and_lookup() {
+    const size_t sizes[] = { 10000, 25000, 50000, 100000 };
+    printf("[BENCH] nfc_auth_index RAM: index %zu o, fusion en cours %zu o\n",
+           sizeof(NfcAuthIndex), sizeof(NfcAuthMerge));
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        std::vector<uint64_t> hashes = sortedHashes(sizes[s]);
+        FakeSlot slot;
+        auto t0 = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(buildImage(&slot, hashes, 1));
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        NfcAuthIndex idx;
+        t0 = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(NfcAuthIndex_Open(&idx, slot.mem.data(), slot.mem.size(), true));
+        double openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        // Cartes présentées: moitié connues, moitié inconnues
+        std::vector<uint64_t> probes;
+        for (size_t i = 0; i < 20000; i++) probes.push_back(i % 2 ? hashes[(i * 7919) % hashes.size()] : nextHash());
+        const int rounds = 20;
+        int found = 0;
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (uint64_t h : probes) found += NfcAuthIndex_Lookup(&idx, h) >= 0;
+        }
+        double bucketNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                          (rounds * probes.size());
+        int foundFlat = 0;
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (uint64_t h : probes) foundFlat += lookupFlat(&idx, h) >= 0;
+        }
+        double flatNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+                        (rounds * probes.size());
+        TEST_ASSERT_EQUAL_INT(foundFlat, found);
+        TEST_ASSERT_TRUE(found >= rounds * (int)probes.size() / 2);
+
+        // Probabilité qu'une carte inconnue collisionne avec une entrée (empreinte 40 bits)
+        double falsePositive = (double)sizes[s] / (double)(NFC_AUTH_HASH_MASK + 1);
+        printf("[BENCH] nfc_auth_index %6zu cartes: flash %7zu o (%.2f o/carte), construction %.1f ms, "
+               "ouverture+CRC %.1f ms | recherche seau %.0f ns, dichotomie globale %.0f ns, faux positif %.1e\n",
+               sizes[s], NfcAuthIndex_ImageSize((uint32_t)sizes[s]),
+               (double)NfcAuthIndex_ImageSize((uint32_t)sizes[s]) / sizes[s], buildMs, openMs,
+               bucketNs, flatNs, falsePositive);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests empreinte et format
+    RUN_TEST(test_hash_and_roles);
+    RUN_TEST(test_build_open_lookup);
+    RUN_TEST(test_open_rejects_incomplete_or_corrupt_image);
+
+    // Tests fusion des deltas
+    RUN_TEST(test_merge_put_update_remove);
+
+    // Tests pages de synchronisation
+    RUN_TEST(test_sync_pages_snapshot_then_delta);
+
+    // Benchmark
+    RUN_TEST(test_bench_footprint_and_lookup);
+    return UNITY_END();
+}
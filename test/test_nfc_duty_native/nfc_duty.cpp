@@ -0,0 +1,100 @@
+#include "../../include/nfc_duty.h"
+#include <string.h>
+
+void NfcDuty_Init(NfcDuty* d, const NfcDutyConfig* cfg, uint32_t nowMs) {
+  if (!d || !cfg) return;
+  memset(d, 0, sizeof(*d));
+  d->cfg = *cfg;
+  d->startMs = nowMs;
+  NfcDuty_SetBudget(d, cfg->budgetPermille);
+}
+
+void NfcDuty_SetBudget(NfcDuty* d, uint16_t permille) {
+  if (!d) return;
+  if (permille < 1) permille = 1;
+  if (permille > 1000) permille = 1000;
+  d->cfg.budgetPermille = permille;
+}
+
+uint32_t NfcDuty_MinIntervalMs(const NfcDuty* d) {
+  if (!d) return 0;
+  uint64_t burstUs = d->bursts > 0 ? d->burstUsTotal / d->bursts : d->cfg.burstUs;
+  // burst / période <= budget / 1000  =>  période (ms) >= burst (us) / budget
+  return (uint32_t)((burstUs + d->cfg.budgetPermille - 1) / d->cfg.budgetPermille);
+}
+
+uint32_t NfcDuty_IntervalMs(const NfcDuty* d, uint32_t nowMs) {
+  if (!d) return 0;
+  uint32_t interval = d->cfg.idleIntervalMs;
+  if (d->hadActivity && d->cfg.activeHoldMs > 0 && d->cfg.activeIntervalMs < interval) {
+    uint32_t since = nowMs - d->lastActivityMs;
+    interval = d->cfg.activeIntervalMs;
+    if (since >= d->cfg.activeHoldMs) {
+      uint32_t steps = (since - d->cfg.activeHoldMs) / d->cfg.activeHoldMs + 1;
+      while (steps-- > 0 && interval < d->cfg.idleIntervalMs) interval *= 2;
+      if (interval > d->cfg.idleIntervalMs) interval = d->cfg.idleIntervalMs;
+    }
+  }
+  uint32_t minInterval = NfcDuty_MinIntervalMs(d);
+  return interval < minInterval ? minInterval : interval;
+}
+
+uint32_t NfcDuty_NextBurstDelayMs(const NfcDuty* d, uint32_t nowMs) {
+  if (!d || !d->hadBurst) return 0;
+  int32_t remaining = (int32_t)(d->lastBurstMs + NfcDuty_IntervalMs(d, nowMs) - nowMs);
+  return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+void NfcDuty_MarkActivity(NfcDuty* d, uint32_t nowMs) {
+  if (!d) return;
+  d->lastActivityMs = nowMs;
+  d->hadActivity = true;
+}
+
+void NfcDuty_RecordBurst(NfcDuty* d, uint32_t startMs, uint32_t rfOnUs, bool card) {
+  if (!d) return;
+  d->bursts++;
+  d->rfOnUs += rfOnUs;
+  d->burstUsTotal += rfOnUs;
+  if (card) {
+    uint32_t latency = d->hadBurst ? startMs - d->lastBurstMs : 0;
+    d->detections++;
+    d->lastLatencyMs = latency;
+    d->latencySumMs += latency;
+    if (latency > d->maxLatencyMs) d->maxLatencyMs = latency;
+    NfcDuty_MarkActivity(d, startMs);
+  }
+  d->lastBurstMs = startMs;
+  d->hadBurst = true;
+}
+
+bool NfcDuty_CardPresent(NfcDuty* d, const uint8_t* uid, uint8_t len) {
+  if (!d || !uid || len == 0 || len > NFC_DUTY_UID_MAX) return false;
+  bool same = d->presentUidLen == len && memcmp(d->presentUid, uid, len) == 0;
+  memcpy(d->presentUid, uid, len);
+  d->presentUidLen = len;
+  return same;
+}
+
+void NfcDuty_CardGone(NfcDuty* d) {
+  if (!d) return;
+  d->presentUidLen = 0;
+}
+
+void NfcDuty_AddRfOn(NfcDuty* d, uint32_t rfOnUs) {
+  if (!d) return;
+  d->rfOnUs += rfOnUs;
+}
+
+uint32_t NfcDuty_DutyPermille(const NfcDuty* d, uint32_t nowMs) {
+  if (!d) return 0;
+  uint32_t elapsedMs = nowMs - d->startMs;
+  if (elapsedMs == 0) return 0;
+  // rfOnUs / (elapsedMs * 1000) * 1000
+  return (uint32_t)(d->rfOnUs / elapsedMs);
+}
+
+uint32_t NfcDuty_AvgLatencyMs(const NfcDuty* d) {
+  if (!d || d->detections == 0) return 0;
+  return (uint32_t)(d->latencySumMs / d->detections);
+}
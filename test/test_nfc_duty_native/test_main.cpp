@@ -0,0 +1,178 @@
+#include <unity.h>
+#include "../../include/nfc_duty.h"
+#include <stdio.h>
+
+static NfcDuty duty;
+static const NfcDutyConfig cfg = { 500, 100, 10000, 6000, 50 };
+
+void setUp(void) {
+    NfcDuty_Init(&duty, &cfg, 1000);
+}
+void tearDown(void) {}
+
+// Tests cadence
+void test_idle_interval_and_first_burst() {
+    TEST_ASSERT_EQUAL_UINT32(500, NfcDuty_IntervalMs(&duty, 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, NfcDuty_NextBurstDelayMs(&duty, 1000));  // première salve immédiate
+    NfcDuty_RecordBurst(&duty, 1000, 6000, false);
+    TEST_ASSERT_EQUAL_UINT32(500, NfcDuty_NextBurstDelayMs(&duty, 1000));
+    TEST_ASSERT_EQUAL_UINT32(200, NfcDuty_NextBurstDelayMs(&duty, 1300));
+    TEST_ASSERT_EQUAL_UINT32(0, NfcDuty_NextBurstDelayMs(&duty, 1600));  // en retard
+}
+
+void test_activity_speeds_up_then_decays() {
+    // Budget 5 %, salve 6 ms: 120 ms minimum, la période active de 100 ms est relevée
+    NfcDuty_MarkActivity(&duty, 2000);
+    TEST_ASSERT_EQUAL_UINT32(120, NfcDuty_IntervalMs(&duty, 2000));
+    TEST_ASSERT_EQUAL_UINT32(120, NfcDuty_IntervalMs(&duty, 11999));
+    TEST_ASSERT_EQUAL_UINT32(200, NfcDuty_IntervalMs(&duty, 12000));  // 100 * 2
+    TEST_ASSERT_EQUAL_UINT32(400, NfcDuty_IntervalMs(&duty, 22000));
+    TEST_ASSERT_EQUAL_UINT32(500, NfcDuty_IntervalMs(&duty, 32000));  // plafonné au repos
+    TEST_ASSERT_EQUAL_UINT32(500, NfcDuty_IntervalMs(&duty, 900000));
+}
+
+void test_budget_uses_measured_burst() {
+    NfcDuty_SetBudget(&duty, 1000);
+    NfcDuty_MarkActivity(&duty, 1000);
+    TEST_ASSERT_EQUAL_UINT32(100, NfcDuty_IntervalMs(&duty, 1000));
+    NfcDuty_SetBudget(&duty, 0);  // borné à 1 ‰
+    TEST_ASSERT_EQUAL_UINT16(1, duty.cfg.budgetPermille);
+    TEST_ASSERT_EQUAL_UINT32(6000, NfcDuty_MinIntervalMs(&duty));
+
+    // Salves mesurées plus longues que l'estimation: la période s'allonge
+    NfcDuty_SetBudget(&duty, 10);
+    NfcDuty_RecordBurst(&duty, 1000, 8000, false);
+    NfcDuty_RecordBurst(&duty, 2000, 10000, false);
+    TEST_ASSERT_EQUAL_UINT32(900, NfcDuty_MinIntervalMs(&duty));
+    TEST_ASSERT_EQUAL_UINT32(900, NfcDuty_IntervalMs(&duty, 2000));
+}
+
+// Tests statistiques
+void test_duty_and_latency() {
+    NfcDuty_RecordBurst(&duty, 1000, 6000, false);
+    NfcDuty_RecordBurst(&duty, 1500, 6000, false);
+    NfcDuty_RecordBurst(&duty, 2000, 26000, true);   // carte lue dans la salve
+    NfcDuty_AddRfOn(&duty, 2000);
+    TEST_ASSERT_EQUAL_UINT32(3, duty.bursts);
+    TEST_ASSERT_EQUAL_UINT32(1, duty.detections);
+    TEST_ASSERT_EQUAL_UINT32(500, duty.lastLatencyMs);
+    TEST_ASSERT_EQUAL_UINT32(500, NfcDuty_AvgLatencyMs(&duty));
+    // 40 ms de champ sur 2 s
+    TEST_ASSERT_EQUAL_UINT32(20, NfcDuty_DutyPermille(&duty, 3000));
+    // La détection relance la cadence rapide
+    TEST_ASSERT_TRUE(NfcDuty_IntervalMs(&duty, 2000) < 500);
+
+    NfcDuty_RecordBurst(&duty, 2200, 6000, true);
+    TEST_ASSERT_EQUAL_UINT32(200, duty.lastLatencyMs);
+    TEST_ASSERT_EQUAL_UINT32(500, duty.maxLatencyMs);
+    TEST_ASSERT_EQUAL_UINT32(350, NfcDuty_AvgLatencyMs(&duty));
+    TEST_ASSERT_EQUAL_UINT32(0, NfcDuty_DutyPermille(&duty, 1000));
+}
+
+// Tests carte restée posée
+void test_resting_card_reported_once() {
+    const uint8_t a[] = { 0x04, 0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6 };
+    const uint8_t b[] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    uint32_t now = 1000;
+
+    // Première salve: carte signalée et relance de la cadence rapide
+    TEST_ASSERT_FALSE(NfcDuty_CardPresent(&duty, a, sizeof(a)));
+    NfcDuty_RecordBurst(&duty, now, 6000, true);
+    uint32_t activeInterval = NfcDuty_IntervalMs(&duty, now);
+
+    // Carte laissée sur le lecteur pendant une minute: répond à chaque salve, jamais resignalée
+    for (int i = 0; i < 600; i++) {
+        now += NfcDuty_IntervalMs(&duty, now);
+        TEST_ASSERT_TRUE(NfcDuty_CardPresent(&duty, a, sizeof(a)));
+        NfcDuty_RecordBurst(&duty, now, 6000, false);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, duty.detections);
+    TEST_ASSERT_EQUAL_UINT32(0, duty.lastLatencyMs);
+    // Ni détection ni activité: la cadence revient au repos
+    TEST_ASSERT_EQUAL_UINT32(500, NfcDuty_IntervalMs(&duty, now));
+    TEST_ASSERT_TRUE(activeInterval < 500);
+
+    // Autre carte à la place: signalée
+    TEST_ASSERT_FALSE(NfcDuty_CardPresent(&duty, b, sizeof(b)));
+    TEST_ASSERT_TRUE(NfcDuty_CardPresent(&duty, b, sizeof(b)));
+
+    // Une salve sans ATQA suffit: la carte reposée est de nouveau signalée
+    NfcDuty_CardGone(&duty);
+    TEST_ASSERT_FALSE(NfcDuty_CardPresent(&duty, b, sizeof(b)));
+
+    // UID hors bornes jamais considéré comme présent
+    uint8_t big[NFC_DUTY_UID_MAX + 1] = { 0 };
+    TEST_ASSERT_FALSE(NfcDuty_CardPresent(&duty, big, sizeof(big)));
+    TEST_ASSERT_FALSE(NfcDuty_CardPresent(&duty, big, sizeof(big)));
+    TEST_ASSERT_FALSE(NfcDuty_CardPresent(&duty, a, 0));
+}
+
+// Benchmark: une heure simulée, 40 passages de carte dont des rafales (file d'attente).
+// Champ permanent (fenêtre de scan, REQA toutes les 20 ms) contre détection de fond.
+void test_bench_duty_vs_latency() {
+    uint32_t taps[40];
+    uint32_t t = 0;
+    for (int i = 0; i < 40; i++) {
+        t += (i % 4 == 0) ? 300000u + (uint32_t)i * 7919u : 8000u + (uint32_t)i * 131u;
+        taps[i] = t;
+    }
+    const uint32_t burstUs = 6000;   // établissement du champ 5 ms + REQA/ATQA
+    const uint32_t readUs = 20000;   // anticollision + lecture NDEF
+    const uint16_t budgets[] = { 100, 50, 20, 10 };
+
+    uint64_t contLatency = 0;
+    for (int i = 0; i < 40; i++) contLatency += 20 - taps[i] % 20;
+    printf("[BENCH] nfc_duty champ permanent: duty 1000 permille, latence moy %llu ms, max 20 ms\n",
+           (unsigned long long)(contLatency / 40));
+
+    for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+        NfcDutyConfig c = cfg;
+        c.budgetPermille = budgets[b];
+        NfcDuty_Init(&duty, &c, 0);
+        uint64_t latencySum = 0;
+        uint32_t latencyMax = 0;
+        int next = 0;
+        uint32_t now = 0;
+        const uint32_t endMs = taps[39] + 60000;
+        while (now < endMs) {
+            now += NfcDuty_NextBurstDelayMs(&duty, now);
+            bool card = next < 40 && taps[next] <= now;
+            if (card) {
+                uint32_t latency = now - taps[next];
+                latencySum += latency;
+                if (latency > latencyMax) latencyMax = latency;
+                next++;
+            }
+            NfcDuty_RecordBurst(&duty, now, card ? burstUs + readUs : burstUs, card);
+            now += (burstUs + (card ? readUs : 0)) / 1000;
+        }
+        TEST_ASSERT_EQUAL_INT(40, next);
+        uint32_t dutyPm = NfcDuty_DutyPermille(&duty, now);
+        TEST_ASSERT_TRUE(dutyPm <= (uint32_t)budgets[b] + 1);
+        // Latence bornée par la période de repos, ou par celle imposée par le budget
+        uint32_t bound = NfcDuty_MinIntervalMs(&duty) > c.idleIntervalMs ? NfcDuty_MinIntervalMs(&duty) : c.idleIntervalMs;
+        TEST_ASSERT_TRUE(latencyMax <= bound);
+        printf("[BENCH] nfc_duty budget %4u permille: duty %2u permille, %lu salves, latence moy %llu ms, max %lu ms\n",
+               (unsigned)budgets[b], (unsigned)dutyPm, (unsigned long)duty.bursts,
+               (unsigned long long)(latencySum / 40), (unsigned long)latencyMax);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests cadence
+    RUN_TEST(test_idle_interval_and_first_burst);
+    RUN_TEST(test_activity_speeds_up_then_decays);
+    RUN_TEST(test_budget_uses_measured_burst);
+
+    // Tests statistiques
+    RUN_TEST(test_duty_and_latency);
+
+    // Tests carte restée posée
+    RUN_TEST(test_resting_card_reported_once);
+
+    // Benchmark
+    RUN_TEST(test_bench_duty_vs_latency);
+    return UNITY_END();
+}
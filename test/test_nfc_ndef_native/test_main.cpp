@@ -1,5 +1,6 @@
 #include <unity.h>
 #include "nfc_ndef.h"
+#include "ndef.h"
 
 void test_ndef_text_ok(){
   const uint8_t tlv[] = { 0x03, 0x0C, 0xD1, 0x01, 0x08, 0x54, 0x02, 'e','n','H','e','l','l','o', 0xFE };
@@ -7,12 +8,24 @@ void test_ndef_text_ok(){
   TEST_ASSERT_EQUAL_STRING_LEN("Hello", out, 5);
 }
 
+void test_ndef_text_utf16(){
+  const uint8_t tlv[] = { 0x03, 0x0D, 0xD1, 0x01, 0x09, 0x54, 0x82, 'e','n', 0x00,'O', 0x00,'K', 0x00,'!', 0xFE };
+  char out[16]; TEST_ASSERT_TRUE(Nfc_ParseTlvAndExtractNdefText_C(tlv, sizeof(tlv), out, sizeof(out)));
+  TEST_ASSERT_EQUAL_STRING("OK!", out);
+}
+
+void test_ndef_text_after_uri_record(){
+  const uint8_t tlv[] = { 0x03, 0x0D, 0x91, 0x01, 0x02, 0x55, 0x04, 'x', 0x51, 0x01, 0x03, 0x54, 0x00, 'h', 'i', 0xFE };
+  char out[16]; TEST_ASSERT_TRUE(Nfc_ParseTlvAndExtractNdefText_C(tlv, sizeof(tlv), out, sizeof(out)));
+  TEST_ASSERT_EQUAL_STRING("hi", out);
+  NdefRecord rec; TEST_ASSERT_TRUE(Ndef_FindRecord(tlv, sizeof(tlv), NDEF_TNF_WELL_KNOWN, "U", &rec));
+  TEST_ASSERT_EQUAL_PTR(tlv + 6, rec.payload);
+}
+
 void test_uid_hex(){
   const uint8_t uid[] = { 0xDE, 0xAD, 0xBE, 0xEF };
   char hex[2*4+1]; TEST_ASSERT_TRUE(Nfc_UidToHex_C(uid, sizeof(uid), hex, sizeof(hex)));
   TEST_ASSERT_EQUAL_STRING("DEADBEEF", hex);
 }
 
-int main(){ UNITY_BEGIN(); RUN_TEST(test_ndef_text_ok); RUN_TEST(test_uid_hex); return UNITY_END(); }
-
-
+int main(){ UNITY_BEGIN(); RUN_TEST(test_ndef_text_ok); RUN_TEST(test_ndef_text_utf16); RUN_TEST(test_ndef_text_after_uri_record); RUN_TEST(test_uid_hex); return UNITY_END(); }
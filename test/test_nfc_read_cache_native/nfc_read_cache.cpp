@@ -0,0 +1,69 @@
+#include "../../include/nfc_read_cache.h"
+#include <string.h>
+
+void NfcReadCache_Init(NfcReadCache* c) {
+  memset(c, 0, sizeof(*c));
+}
+
+static NfcReadCacheEntry* findUid(NfcReadCache* c, const uint8_t* uid, size_t uidLen) {
+  for (size_t i = 0; i < NFC_READ_CACHE_SIZE; i++) {
+    NfcReadCacheEntry* e = &c->entries[i];
+    if (e->used && e->uidLen == uidLen && memcmp(e->uid, uid, uidLen) == 0) return e;
+  }
+  return nullptr;
+}
+
+NfcReadCacheEntry* NfcReadCache_Find(NfcReadCache* c, const uint8_t* uid, size_t uidLen,
+                                     uint32_t nowMs, uint32_t ttlMs) {
+  NfcReadCacheEntry* e = uidLen <= NFC_READ_CACHE_UID_MAX ? findUid(c, uid, uidLen) : nullptr;
+  if (!e) {
+    c->misses++;
+    return nullptr;
+  }
+  if (nowMs - e->storedMs >= ttlMs) {
+    e->used = false;
+    c->expired++;
+    return nullptr;
+  }
+  e->lastUse = ++c->clock;
+  return e;
+}
+
+bool NfcReadCache_Validate(NfcReadCache* c, NfcReadCacheEntry* e, const uint8_t* probe, size_t len) {
+  if (probe && len >= e->probeLen && memcmp(probe, e->probe, e->probeLen) == 0) {
+    c->hits++;
+    return true;
+  }
+  e->used = false;
+  c->stale++;
+  return false;
+}
+
+void NfcReadCache_Store(NfcReadCache* c, const uint8_t* uid, size_t uidLen, uint8_t probeAddr,
+                        const uint8_t* mem, size_t memLen, const char* text, uint32_t nowMs) {
+  if (uidLen == 0 || uidLen > NFC_READ_CACHE_UID_MAX || memLen == 0) return;
+  NfcReadCacheEntry* e = findUid(c, uid, uidLen);
+  if (!e) {
+    // Entrée libre, sinon la moins récemment utilisée
+    e = &c->entries[0];
+    for (size_t i = 0; i < NFC_READ_CACHE_SIZE && e->used; i++) {
+      NfcReadCacheEntry* cand = &c->entries[i];
+      if (!cand->used || cand->lastUse < e->lastUse) e = cand;
+    }
+  }
+  memcpy(e->uid, uid, uidLen);
+  e->uidLen = (uint8_t)uidLen;
+  e->probeAddr = probeAddr;
+  e->probeLen = (uint8_t)(memLen < NFC_READ_CACHE_PROBE_SIZE ? memLen : NFC_READ_CACHE_PROBE_SIZE);
+  memcpy(e->probe, mem, e->probeLen);
+  e->hasText = text != nullptr;
+  if (text) {
+    strncpy(e->text, text, sizeof(e->text) - 1);
+    e->text[sizeof(e->text) - 1] = '\0';
+  } else {
+    e->text[0] = '\0';
+  }
+  e->storedMs = nowMs;
+  e->lastUse = ++c->clock;
+  e->used = true;
+}
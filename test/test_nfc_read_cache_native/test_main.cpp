@@ -0,0 +1,156 @@
+#include <unity.h>
+#include "../../include/nfc_read_cache.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static NfcReadCache cache;
+
+static const uint8_t UID_A[7] = { 0x04, 0x5A, 0x1B, 0x22, 0x91, 0x70, 0x80 };
+static const uint8_t UID_B[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+
+// Début d'un TLV NDEF Text "fr" (T, L, en-tête du record, texte)
+static const uint8_t MEM[24] = {
+    0x03, 0x14, 0xD1, 0x01, 0x10, 'T', 0x02, 'f', 'r', 'S', 'T', 'A', 'F', 'F', '-', '0',
+    '0', '4', '2', '-', 'B', 0xFE, 0x00, 0x00,
+};
+
+void setUp(void) {
+    NfcReadCache_Init(&cache);
+}
+void tearDown(void) {}
+
+// Tests lecture mémorisée
+void test_store_find_and_validate() {
+    TEST_ASSERT_NULL(NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 0, 60000));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.misses);
+
+    NfcReadCache_Store(&cache, UID_A, sizeof(UID_A), 4, MEM, sizeof(MEM), "STAFF-0042-B", 1000);
+    NfcReadCacheEntry* e = NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 2000, 60000);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL_UINT8(4, e->probeAddr);
+    TEST_ASSERT_EQUAL_UINT8(NFC_READ_CACHE_PROBE_SIZE, e->probeLen);
+
+    // Page relue identique: texte repris
+    TEST_ASSERT_TRUE(NfcReadCache_Validate(&cache, e, MEM, 16));
+    TEST_ASSERT_TRUE(e->hasText);
+    TEST_ASSERT_EQUAL_STRING("STAFF-0042-B", e->text);
+    TEST_ASSERT_EQUAL_UINT32(1, cache.hits);
+
+    // Même UID sur 4 octets (autre carte) ou autre UID: absent
+    TEST_ASSERT_NULL(NfcReadCache_Find(&cache, UID_A, 4, 2000, 60000));
+    TEST_ASSERT_NULL(NfcReadCache_Find(&cache, UID_B, sizeof(UID_B), 2000, 60000));
+}
+
+void test_rewritten_or_unreadable_tag_is_forgotten() {
+    NfcReadCache_Store(&cache, UID_A, sizeof(UID_A), 4, MEM, sizeof(MEM), "STAFF-0042-B", 0);
+    uint8_t rewritten[16];
+    memcpy(rewritten, MEM, 16);
+    rewritten[1] = 0x15;   // longueur du TLV changée
+    NfcReadCacheEntry* e = NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 10, 60000);
+    TEST_ASSERT_FALSE(NfcReadCache_Validate(&cache, e, rewritten, sizeof(rewritten)));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.stale);
+    TEST_ASSERT_NULL(NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 10, 60000));
+
+    // Lecture de la sonde en échec (NAK, clé refusée)
+    NfcReadCache_Store(&cache, UID_A, sizeof(UID_A), 4, MEM, sizeof(MEM), "STAFF-0042-B", 0);
+    e = NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 10, 60000);
+    TEST_ASSERT_FALSE(NfcReadCache_Validate(&cache, e, nullptr, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, cache.stale);
+
+    // Message plus court que la sonde: seuls les octets lus comptent
+    NfcReadCache_Store(&cache, UID_B, sizeof(UID_B), 8, MEM, 5, nullptr, 0);
+    e = NfcReadCache_Find(&cache, UID_B, sizeof(UID_B), 10, 60000);
+    TEST_ASSERT_FALSE(e->hasText);
+    TEST_ASSERT_EQUAL_UINT8(5, e->probeLen);
+    uint8_t page[16];
+    memcpy(page, MEM, 5);
+    memset(page + 5, 0xAA, sizeof(page) - 5);
+    TEST_ASSERT_TRUE(NfcReadCache_Validate(&cache, e, page, sizeof(page)));
+    TEST_ASSERT_FALSE(NfcReadCache_Validate(&cache, e, page, 4));
+}
+
+void test_ttl_and_lru_eviction() {
+    NfcReadCache_Store(&cache, UID_A, sizeof(UID_A), 4, MEM, sizeof(MEM), "A", 0xFFFFF000u);
+    // Expiration à travers le débordement de millis()
+    TEST_ASSERT_NOT_NULL(NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 0x00000F00u, 0x2000));
+    TEST_ASSERT_NULL(NfcReadCache_Find(&cache, UID_A, sizeof(UID_A), 0x00001000u, 0x2000));
+    TEST_ASSERT_EQUAL_UINT32(1, cache.expired);
+
+    // Remplissage puis une entrée de plus: la moins récemment utilisée sort
+    uint8_t uid[4] = { 0x10, 0, 0, 0 };
+    for (uint8_t i = 0; i < NFC_READ_CACHE_SIZE; i++) {
+        uid[1] = i;
+        NfcReadCache_Store(&cache, uid, 4, 4, MEM, sizeof(MEM), "x", 0);
+    }
+    uid[1] = 0;
+    TEST_ASSERT_NOT_NULL(NfcReadCache_Find(&cache, uid, 4, 1, 60000));   // la plus ancienne, rafraîchie
+    NfcReadCache_Store(&cache, UID_B, sizeof(UID_B), 4, MEM, sizeof(MEM), "B", 1);
+    TEST_ASSERT_NOT_NULL(NfcReadCache_Find(&cache, uid, 4, 1, 60000));
+    uid[1] = 1;
+    TEST_ASSERT_NULL(NfcReadCache_Find(&cache, uid, 4, 1, 60000));
+    TEST_ASSERT_NOT_NULL(NfcReadCache_Find(&cache, UID_B, sizeof(UID_B), 1, 60000));
+
+    // Nouvelle lecture du même UID: entrée remplacée sur place
+    NfcReadCache_Store(&cache, UID_B, sizeof(UID_B), 8, MEM, sizeof(MEM), "B2", 2);
+    int count = 0;
+    for (int i = 0; i < NFC_READ_CACHE_SIZE; i++) {
+        const NfcReadCacheEntry* e = &cache.entries[i];
+        if (e->used && e->uidLen == sizeof(UID_B) && memcmp(e->uid, UID_B, sizeof(UID_B)) == 0) count++;
+    }
+    TEST_ASSERT_EQUAL_INT(1, count);
+    TEST_ASSERT_EQUAL_STRING("B2", NfcReadCache_Find(&cache, UID_B, sizeof(UID_B), 3, 60000)->text);
+}
+
+// Benchmark: coût CPU du tap répété et échanges RF évités.
+// Modèle RC522 à 106 kbit/s (voir test_mfc_reader_native): READ ~2.5 ms, FAST_READ 15 pages ~5 ms,
+// AUTH ~2 ms. Lecture complète NTAG: READ page 3 puis FAST_READ du reste du message;
+// MIFARE Classic Forum: AUTH + 2 READ (MAD) puis AUTH + READ par bloc de données.
+void test_bench_repeat_tap() {
+    uint8_t uid[7];
+    memcpy(uid, UID_A, sizeof(uid));
+    for (uint8_t i = 0; i < NFC_READ_CACHE_SIZE; i++) {
+        uid[6] = i;
+        NfcReadCache_Store(&cache, uid, sizeof(uid), 4, MEM, sizeof(MEM), "STAFF-0042-B", 0);
+    }
+    const int iterations = 200000;
+    volatile int hits = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        uid[6] = (uint8_t)(i % NFC_READ_CACHE_SIZE);
+        NfcReadCacheEntry* e = NfcReadCache_Find(&cache, uid, sizeof(uid), 1000, 60000);
+        if (e && NfcReadCache_Validate(&cache, e, MEM, 16)) hits = hits + 1;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    TEST_ASSERT_EQUAL(iterations, hits);
+    printf("[BENCH] nfc_read_cache: %.1f ns/tap répété (recherche + comparaison, %d entrées)\n",
+           ns, NFC_READ_CACHE_SIZE);
+
+    const size_t sizes[] = { 24, 120, 400 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t len = sizes[s];
+        size_t rest = len > 12 ? len - 12 : 0;
+        int fastReads = (int)((rest + 59) / 60);
+        double ntagMs = 2.5 + 5.0 * fastReads;
+        int blocks = (int)((len + 15) / 16);
+        int sectors = (blocks + 2) / 3;
+        double classicMs = (2.0 + 2 * 2.5) + 2.0 * sectors + 2.5 * blocks;
+        printf("[BENCH] nfc_read_cache %3zu o: NTAG %d échanges %.1f ms -> 1 READ 2.5 ms | "
+               "Classic %d AUTH + %d READ %.1f ms -> 1 AUTH + 1 READ 4.5 ms\n",
+               len, 1 + fastReads, ntagMs, 1 + sectors, 2 + blocks, classicMs);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests lecture mémorisée
+    RUN_TEST(test_store_find_and_validate);
+    RUN_TEST(test_rewritten_or_unreadable_tag_is_forgotten);
+    RUN_TEST(test_ttl_and_lru_eviction);
+
+    // Benchmark
+    RUN_TEST(test_bench_repeat_tap);
+    return UNITY_END();
+}
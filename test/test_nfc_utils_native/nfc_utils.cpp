@@ -1,6 +1,10 @@
 #include "../../include/nfc_utils.h"
+#include "../../include/char_class.h"
 #include <string.h>
 
+// TAB, LF, CR: conservés comme espaces
+static constexpr CharClass TEXT_SPACES = CharClass_FromChars("\t\n\r");
+
 bool Nfc_IsValidUidLength_C(size_t length) {
     // Longueurs UID valides selon ISO14443
     return (length == 4 || length == 7 || length == 10);
@@ -60,11 +64,11 @@ bool Nfc_ExtractAsciiText_C(const uint8_t* data, size_t dataLen, char* output, s
         
         if (byte == 0x00) break; // Fin de chaîne
         
-        if (byte >= 0x20 && byte <= 0x7E) {
+        if (CharClass_Has(&CHAR_CLASS_PRINTABLE, byte)) {
             // Caractère ASCII imprimable
             output[outputIndex++] = (char)byte;
             validChars++;
-        } else if (byte == 0x09 || byte == 0x0A || byte == 0x0D) {
+        } else if (CharClass_Has(&TEXT_SPACES, byte)) {
             // Caractères de contrôle acceptables (TAB, LF, CR)
             output[outputIndex++] = ' '; // Remplacer par espace
             validChars++;
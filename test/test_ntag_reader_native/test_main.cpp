@@ -0,0 +1,218 @@
+#include <unity.h>
+#include "../../include/ntag_reader.h"
+#include <stdio.h>
+#include <string.h>
+
+// Tag Type 2 simulé: mémoire par pages, READ / FAST_READ, NAK -> état IDLE
+typedef struct {
+    uint8_t mem[231 * 4];
+    int pages;
+    bool fastRead;
+    bool idle;
+    int transactions;
+    int rxBytes;         // octets de réponse (CRC exclus)
+    int txBytes;
+} FakeTag;
+
+static FakeTag tag;
+
+static int fakeTransceive(void* ctx, const uint8_t* cmd, size_t cmdLen, uint8_t* resp, size_t respMax) {
+    FakeTag* f = (FakeTag*)ctx;
+    f->transactions++;
+    f->txBytes += (int)cmdLen;
+    if (f->idle) return -1;
+    if (cmd[0] == NTAG_CMD_READ && cmdLen == 2) {
+        if (cmd[1] >= f->pages || respMax < 16) { f->idle = true; return -1; }
+        for (int i = 0; i < 16; i++) resp[i] = f->mem[((cmd[1] * 4) + i) % (f->pages * 4)];
+        f->rxBytes += 16;
+        return 16;
+    }
+    if (cmd[0] == NTAG_CMD_FAST_READ && cmdLen == 3 && f->fastRead) {
+        int n = (cmd[2] - cmd[1] + 1) * 4;
+        if (cmd[2] < cmd[1] || cmd[2] >= f->pages || (size_t)n > respMax || n > 60) { f->idle = true; return -1; }
+        memcpy(resp, f->mem + cmd[1] * 4, (size_t)n);
+        f->rxBytes += n;
+        return n;
+    }
+    f->idle = true;  // NAK
+    return -1;
+}
+
+static bool fakeReactivate(void* ctx) {
+    ((FakeTag*)ctx)->idle = false;
+    return true;
+}
+
+static NtagTransport transport = { fakeTransceive, fakeReactivate, &tag };
+static uint8_t out[NTAG_READER_MAX_BYTES];
+
+// Tag formaté NDEF: CC, puis TLV NDEF (record Text) de 'textLen' caractères
+static void formatTag(int pages, uint8_t ccSize, bool fastRead, size_t textLen) {
+    memset(&tag, 0, sizeof(tag));
+    tag.pages = pages;
+    tag.fastRead = fastRead;
+    uint8_t* cc = tag.mem + 12;
+    cc[0] = NTAG_CC_MAGIC; cc[1] = 0x10; cc[2] = ccSize; cc[3] = 0x00;
+
+    uint8_t* p = tag.mem + 16;
+    size_t recLen = 3 + 1 + 1 + 2 + textLen;   // en-tête SR, type 'T', statut + "fr", texte
+    if (recLen > 0xFF) recLen += 3;            // record long (payload sur 4 octets)
+    *p++ = 0x03;
+    if (recLen < 0xFF) {
+        *p++ = (uint8_t)recLen;
+    } else {
+        *p++ = 0xFF; *p++ = (uint8_t)(recLen >> 8); *p++ = (uint8_t)recLen;
+    }
+    size_t payload = 3 + textLen;
+    if (payload <= 0xFF) {
+        *p++ = 0xD1; *p++ = 1; *p++ = (uint8_t)payload;
+    } else {
+        *p++ = 0xC1; *p++ = 1;
+        *p++ = 0; *p++ = 0; *p++ = (uint8_t)(payload >> 8); *p++ = (uint8_t)payload;
+    }
+    *p++ = 'T'; *p++ = 0x02; *p++ = 'f'; *p++ = 'r';
+    for (size_t i = 0; i < textLen; i++) *p++ = (uint8_t)('a' + i % 26);
+    *p++ = 0xFE;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Tests lecture au plus juste
+void test_short_message_single_transaction() {
+    formatTag(45, 0x12, true, 4);  // NTAG213, "abcd"
+    NtagReadInfo info;
+    int n = NtagReader_ReadNdef(&transport, out, sizeof(out), &info);
+    TEST_ASSERT_EQUAL_INT(2 + 11, n);
+    TEST_ASSERT_EQUAL(NTAG_TYPE_NTAG213, info.type);
+    TEST_ASSERT_EQUAL_UINT16(144, info.dataBytes);
+    TEST_ASSERT_EQUAL_UINT16(2, info.ndefOffset);
+    TEST_ASSERT_EQUAL_UINT16(11, info.ndefLen);
+    TEST_ASSERT_EQUAL_UINT8(2, info.transactions);  // CC + 1 page
+    TEST_ASSERT_EQUAL_MEMORY("abcd", out + 2 + 7, 4);
+}
+
+void test_fast_read_exact_range() {
+    formatTag(45, 0x12, true, 100);
+    NtagReadInfo info;
+    int n = NtagReader_ReadNdef(&transport, out, sizeof(out), &info);
+    TEST_ASSERT_EQUAL_INT(2 + 107, n);
+    TEST_ASSERT_TRUE(info.fastRead);
+    // CC (pages 3-6) + FAST_READ 7..31 en deux transactions (15 + 10 pages)
+    TEST_ASSERT_EQUAL_UINT8(3, info.transactions);
+    TEST_ASSERT_EQUAL_MEMORY(tag.mem + 16, out, (size_t)n);
+}
+
+void test_ntag216_long_record() {
+    formatTag(231, 0x6D, true, 800);
+    NtagReadInfo info;
+    int n = NtagReader_ReadNdef(&transport, out, sizeof(out), &info);
+    TEST_ASSERT_EQUAL(NTAG_TYPE_NTAG216, info.type);
+    TEST_ASSERT_EQUAL_UINT16(4, info.ndefOffset);  // longueur TLV sur 3 octets
+    TEST_ASSERT_EQUAL_INT(4 + 10 + 800, n);
+    TEST_ASSERT_EQUAL_MEMORY(tag.mem + 16, out, (size_t)n);
+    TEST_ASSERT_TRUE(info.transactions <= 1 + 14);
+
+    // Buffer trop petit pour le message
+    TEST_ASSERT_EQUAL_INT(NTAG_READ_ERR_TOO_LARGE, NtagReader_ReadNdef(&transport, out, 512, &info));
+}
+
+void test_fallback_to_read_without_fast_read() {
+    formatTag(45, 0x12, false, 100);  // Ultralight C: même CC, pas de FAST_READ
+    NtagReadInfo info;
+    int n = NtagReader_ReadNdef(&transport, out, sizeof(out), &info);
+    TEST_ASSERT_EQUAL_INT(2 + 107, n);
+    TEST_ASSERT_FALSE(info.fastRead);
+    TEST_ASSERT_EQUAL_MEMORY(tag.mem + 16, out, (size_t)n);
+    // CC + FAST_READ refusé + 7 READ
+    TEST_ASSERT_EQUAL_UINT8(1 + 1 + 7, info.transactions);
+
+    NtagTransport noReactivate = { fakeTransceive, nullptr, &tag };
+    formatTag(45, 0x12, false, 100);
+    TEST_ASSERT_EQUAL_INT(NTAG_READ_ERR_IO, NtagReader_ReadNdef(&noReactivate, out, sizeof(out), &info));
+}
+
+void test_lock_tlv_and_errors() {
+    // Lock Control TLV avant le NDEF, en-tête NDEF à cheval sur la page 7
+    formatTag(16, 0x06, true, 0);
+    const uint8_t data[] = { 0x01, 0x03, 0xA0, 0x0C, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+                             0x03, 0xD0, 0x00, 0x00, 0xFE };
+    memcpy(tag.mem + 16, data, sizeof(data));
+    NtagReadInfo info;
+    TEST_ASSERT_EQUAL_INT(16, NtagReader_ReadNdef(&transport, out, sizeof(out), &info));
+    TEST_ASSERT_EQUAL(NTAG_TYPE_ULTRALIGHT, info.type);
+    TEST_ASSERT_EQUAL_UINT16(13, info.ndefOffset);
+    TEST_ASSERT_EQUAL_UINT16(3, info.ndefLen);
+
+    tag.mem[12] = 0x00;  // CC effacé
+    TEST_ASSERT_EQUAL_INT(NTAG_READ_ERR_CC, NtagReader_ReadNdef(&transport, out, sizeof(out), &info));
+
+    formatTag(16, 0x06, true, 0);
+    tag.mem[16] = 0xFE;  // Terminator seul
+    TEST_ASSERT_EQUAL_INT(NTAG_READ_ERR_NO_NDEF, NtagReader_ReadNdef(&transport, out, sizeof(out), &info));
+
+    formatTag(16, 0x06, true, 60);  // TLV plus long que la zone de 48 octets
+    TEST_ASSERT_EQUAL_INT(NTAG_READ_ERR_NO_NDEF, NtagReader_ReadNdef(&transport, out, sizeof(out), &info));
+
+    TEST_ASSERT_EQUAL_INT(NTAG_READ_ERR_IO, NtagReader_ReadNdef(nullptr, out, sizeof(out), &info));
+}
+
+// Benchmark: temps RF estimé tap -> texte par type de carte, lecture historique
+// (READ pages 4..39, 192 octets max) contre CC + FAST_READ au plus juste.
+// Modèle: 106 kbit/s (9 bits/octet, CRC compris), FDT et gestion FIFO RC522 ~0.5 ms/échange.
+static double airtimeMs(int transactions, int txBytes, int rxBytes) {
+    const double byteUs = 9.0 * 1000.0 / 106.0;
+    double bytes = txBytes + rxBytes + 4.0 * transactions;
+    return (bytes * byteUs) / 1000.0 + 0.5 * transactions;
+}
+
+void test_bench_tap_to_text() {
+    struct { const char* name; int pages; uint8_t cc; size_t text; } cards[] = {
+        { "ULTRALIGHT", 16, 0x06, 30 },
+        { "NTAG213", 45, 0x12, 30 },
+        { "NTAG213", 45, 0x12, 120 },
+        { "NTAG215", 135, 0x3E, 400 },
+        { "NTAG216", 231, 0x6D, 800 },
+    };
+    for (size_t c = 0; c < sizeof(cards) / sizeof(cards[0]); c++) {
+        formatTag(cards[c].pages, cards[c].cc, true, cards[c].text);
+        size_t msgBytes = 2 + 7 + cards[c].text + (cards[c].text + 10 > 0xFE ? 5 : 0);
+
+        // Historique: 9 READ quel que soit le message, tronqué à 192 octets
+        uint8_t page16[16];
+        int legacyTx = 0;
+        for (int page = 4; page < 40; page += 4) {
+            uint8_t cmd[2] = { NTAG_CMD_READ, (uint8_t)page };
+            if (fakeTransceive(&tag, cmd, 2, page16, sizeof(page16)) != 16) break;
+            legacyTx++;
+        }
+        double legacyMs = airtimeMs(tag.transactions, tag.txBytes, tag.rxBytes);
+        bool legacyComplete = msgBytes <= (size_t)legacyTx * 16;
+
+        formatTag(cards[c].pages, cards[c].cc, true, cards[c].text);
+        NtagReadInfo info;
+        int n = NtagReader_ReadNdef(&transport, out, sizeof(out), &info);
+        TEST_ASSERT_EQUAL_INT((int)msgBytes, n);
+        double newMs = airtimeMs(tag.transactions, tag.txBytes, tag.rxBytes);
+
+        printf("[BENCH] ntag_reader %-10s %4zu o: legacy %d échanges %.1f ms%s | fast_read %d échanges %.1f ms\n",
+               cards[c].name, msgBytes, legacyTx, legacyMs, legacyComplete ? "" : " (tronqué)",
+               info.transactions, newMs);
+        if (legacyComplete) TEST_ASSERT_TRUE(newMs < legacyMs);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests lecture au plus juste
+    RUN_TEST(test_short_message_single_transaction);
+    RUN_TEST(test_fast_read_exact_range);
+    RUN_TEST(test_ntag216_long_record);
+    RUN_TEST(test_fallback_to_read_without_fast_read);
+    RUN_TEST(test_lock_tlv_and_errors);
+
+    // Benchmark
+    RUN_TEST(test_bench_tap_to_text);
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+#include "../../include/order_progress.h"
+#include <string.h>
+
+void OrderProgress_Begin(OrderProgress* p, uint32_t spacingMs, uint32_t lastRequestMs) {
+  if (!p) return;
+  memset(p, 0, sizeof(*p));
+  p->inFlight = -1;
+  p->spacingMs = spacingMs;
+  p->lastRequestMs = lastRequestMs;
+}
+
+bool OrderProgress_AddItem(OrderProgress* p, int slot, int quantity) {
+  if (!p || p->count >= ORDER_PROGRESS_MAX_ITEMS || quantity <= 0) return false;
+  OrderProgressItem* it = &p->items[p->count++];
+  memset(it, 0, sizeof(*it));
+  it->slot = slot;
+  it->ordered = quantity;
+  return true;
+}
+
+// "<prefix>:<slot>[:...]" -> slot (1-99), *rest pointe après le slot
+static int parseSlot(const char* line, const char** rest) {
+  const char* p = line ? strchr(line, ':') : NULL;
+  if (!p) return -1;
+  p++;
+  int slot = 0;
+  int digits = 0;
+  while (*p >= '0' && *p <= '9' && digits < 3) {
+    slot = slot * 10 + (*p - '0');
+    p++;
+    digits++;
+  }
+  if (digits == 0 || (*p != '\0' && *p != ':')) return -1;
+  if (slot < 1 || slot > 99) return -1;
+  if (rest) *rest = p;
+  return slot;
+}
+
+static int findPending(const OrderProgress* p, int slot) {
+  for (int i = 0; i < p->count; i++) {
+    if (p->items[i].slot == slot && p->items[i].outcome == ORDER_ITEM_PENDING) return i;
+  }
+  return -1;
+}
+
+static void setReason(OrderProgressItem* it, const char* reason) {
+  size_t n = reason ? strlen(reason) : 0;
+  if (n >= sizeof(it->reason)) n = sizeof(it->reason) - 1;
+  if (n > 0) memcpy(it->reason, reason, n);
+  it->reason[n] = '\0';
+}
+
+static void markVended(OrderProgressItem* it) {
+  it->outcome = ORDER_ITEM_VENDED;
+  it->delivered = it->ordered;
+  it->sync = ORDER_SYNC_QUEUED;
+}
+
+int OrderProgress_OnVendCompleted(OrderProgress* p, const char* line) {
+  if (!p || p->deliveryEnded) return -1;
+  int idx = findPending(p, parseSlot(line, NULL));
+  if (idx < 0) return -1;
+  markVended(&p->items[idx]);
+  return idx;
+}
+
+int OrderProgress_OnVendFailed(OrderProgress* p, const char* line) {
+  if (!p || p->deliveryEnded) return -1;
+  const char* rest = NULL;
+  int idx = findPending(p, parseSlot(line, &rest));
+  if (idx < 0) return -1;
+  OrderProgressItem* it = &p->items[idx];
+  it->outcome = ORDER_ITEM_FAILED;
+  it->delivered = 0;
+  setReason(it, (rest && *rest == ':') ? rest + 1 : "UNKNOWN");
+  return idx;
+}
+
+void OrderProgress_OnDeliveryEnd(OrderProgress* p, bool success, const char* reason) {
+  if (!p || p->deliveryEnded) return;
+  p->deliveryEnded = true;
+  p->deliveryFailed = !success;
+  for (int i = 0; i < p->count; i++) {
+    OrderProgressItem* it = &p->items[i];
+    if (it->outcome != ORDER_ITEM_PENDING) continue;
+    if (success) {
+      markVended(it);
+    } else {
+      it->outcome = ORDER_ITEM_FAILED;
+      setReason(it, reason && *reason ? reason : "ABORTED");
+    }
+  }
+}
+
+bool OrderProgress_CanRequest(const OrderProgress* p, uint32_t nowMs) {
+  return p && (nowMs - p->lastRequestMs) >= p->spacingMs;
+}
+
+void OrderProgress_MarkRequest(OrderProgress* p, uint32_t nowMs) {
+  if (p) p->lastRequestMs = nowMs;
+}
+
+int OrderProgress_NextUpdate(OrderProgress* p, uint32_t nowMs) {
+  if (!p || p->inFlight >= 0 || !OrderProgress_CanRequest(p, nowMs)) return -1;
+  for (int i = 0; i < p->count; i++) {
+    if (p->items[i].sync != ORDER_SYNC_QUEUED) continue;
+    p->items[i].sync = ORDER_SYNC_IN_FLIGHT;
+    p->inFlight = (int8_t)i;
+    p->inFlightSinceMs = nowMs;
+    p->lastRequestMs = nowMs;
+    return i;
+  }
+  return -1;
+}
+
+int OrderProgress_OnUpdateResponse(OrderProgress* p, int statusCode) {
+  if (!p || p->inFlight < 0) return -1;
+  int idx = p->inFlight;
+  p->inFlight = -1;
+  if (statusCode == 200) {
+    p->items[idx].sync = ORDER_SYNC_DONE;
+    p->updatesOk++;
+  } else {
+    p->items[idx].sync = ORDER_SYNC_ERROR;
+    p->updatesFailed++;
+  }
+  return idx;
+}
+
+bool OrderProgress_CheckTimeout(OrderProgress* p, uint32_t nowMs, uint32_t timeoutMs) {
+  if (!p || p->inFlight < 0) return false;
+  if ((nowMs - p->inFlightSinceMs) < timeoutMs) return false;
+  OrderProgress_OnUpdateResponse(p, 0);
+  return true;
+}
+
+bool OrderProgress_IsSettled(const OrderProgress* p) {
+  if (!p || !p->deliveryEnded || p->inFlight >= 0) return false;
+  for (int i = 0; i < p->count; i++) {
+    if (p->items[i].sync == ORDER_SYNC_QUEUED) return false;
+  }
+  return true;
+}
+
+int OrderProgress_DeliveredTotal(const OrderProgress* p) {
+  if (!p) return 0;
+  int total = 0;
+  for (int i = 0; i < p->count; i++) total += p->items[i].delivered;
+  return total;
+}
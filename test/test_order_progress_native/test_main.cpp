@@ -0,0 +1,126 @@
+#include <unity.h>
+#include "../../include/order_progress.h"
+
+#define SPACING_MS 3000
+
+static OrderProgress progress;
+
+void setUp(void) {
+    // Commande type: slot 1 x2, slot 3 x1, slot 1 x1 (slot répété)
+    OrderProgress_Begin(&progress, SPACING_MS, 0);
+    OrderProgress_AddItem(&progress, 1, 2);
+    OrderProgress_AddItem(&progress, 3, 1);
+    OrderProgress_AddItem(&progress, 1, 1);
+}
+void tearDown(void) {}
+
+// Tests statuts NUCLEO
+void test_vend_completed_matches_pending_items() {
+    TEST_ASSERT_EQUAL(0, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1"));
+    TEST_ASSERT_EQUAL(2, progress.items[0].delivered);
+    TEST_ASSERT_EQUAL(ORDER_SYNC_QUEUED, progress.items[0].sync);
+    // Même slot: l'item suivant encore en attente
+    TEST_ASSERT_EQUAL(2, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1"));
+    TEST_ASSERT_EQUAL(-1, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1"));
+    TEST_ASSERT_EQUAL(-1, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:7"));
+    TEST_ASSERT_EQUAL(-1, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:3x"));
+    TEST_ASSERT_EQUAL(-1, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED"));
+    TEST_ASSERT_EQUAL(3, OrderProgress_DeliveredTotal(&progress));
+}
+
+void test_vend_failed_keeps_reason() {
+    TEST_ASSERT_EQUAL(1, OrderProgress_OnVendFailed(&progress, "VEND_FAILED:3:MOTOR_ERROR"));
+    TEST_ASSERT_EQUAL(ORDER_ITEM_FAILED, progress.items[1].outcome);
+    TEST_ASSERT_EQUAL(0, progress.items[1].delivered);
+    TEST_ASSERT_EQUAL(ORDER_SYNC_NONE, progress.items[1].sync);
+    TEST_ASSERT_EQUAL_STRING("MOTOR_ERROR", progress.items[1].reason);
+    TEST_ASSERT_EQUAL(0, OrderProgress_OnVendFailed(&progress, "VEND_FAILED:1"));
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", progress.items[0].reason);
+}
+
+void test_delivery_end() {
+    // Succès: VEND_COMPLETED perdu pour le slot 3 -> livré quand même
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1");
+    OrderProgress_OnDeliveryEnd(&progress, true, NULL);
+    TEST_ASSERT_EQUAL(ORDER_ITEM_VENDED, progress.items[1].outcome);
+    TEST_ASSERT_EQUAL(4, OrderProgress_DeliveredTotal(&progress));
+    TEST_ASSERT_EQUAL(-1, OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1"));
+
+    // Échec après le premier item: livraison partielle
+    setUp();
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1");
+    OrderProgress_OnVendFailed(&progress, "VEND_FAILED:3:SLOT_EMPTY");
+    OrderProgress_OnDeliveryEnd(&progress, false, "SLOT_EMPTY");
+    TEST_ASSERT_TRUE(progress.deliveryFailed);
+    TEST_ASSERT_EQUAL(ORDER_ITEM_FAILED, progress.items[2].outcome);
+    TEST_ASSERT_EQUAL_STRING("SLOT_EMPTY", progress.items[2].reason);
+    TEST_ASSERT_EQUAL(2, OrderProgress_DeliveredTotal(&progress));
+}
+
+// Tests envoi des mises à jour
+void test_updates_overlap_delivery() {
+    uint32_t now = 4000;
+    TEST_ASSERT_EQUAL(-1, OrderProgress_NextUpdate(&progress, now));
+
+    // Item 0 livré: sa mise à jour part pendant que la NUCLEO livre la suite
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1");
+    TEST_ASSERT_EQUAL(0, OrderProgress_NextUpdate(&progress, now));
+    TEST_ASSERT_EQUAL(ORDER_SYNC_IN_FLIGHT, progress.items[0].sync);
+
+    // Item 1 livré: une seule requête à la fois
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:3");
+    TEST_ASSERT_EQUAL(-1, OrderProgress_NextUpdate(&progress, now + 500));
+    TEST_ASSERT_EQUAL(0, OrderProgress_OnUpdateResponse(&progress, 200));
+    // Écart minimal entre requêtes
+    TEST_ASSERT_EQUAL(-1, OrderProgress_NextUpdate(&progress, now + 1000));
+    TEST_ASSERT_EQUAL(1, OrderProgress_NextUpdate(&progress, now + SPACING_MS));
+    TEST_ASSERT_EQUAL(1, OrderProgress_OnUpdateResponse(&progress, 500));
+
+    // Dernier item: seule sa mise à jour reste après DELIVERY_COMPLETED
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1");
+    OrderProgress_OnDeliveryEnd(&progress, true, NULL);
+    TEST_ASSERT_FALSE(OrderProgress_IsSettled(&progress));
+    TEST_ASSERT_EQUAL(2, OrderProgress_NextUpdate(&progress, now + 2 * SPACING_MS));
+    TEST_ASSERT_FALSE(OrderProgress_IsSettled(&progress));
+    OrderProgress_OnUpdateResponse(&progress, 200);
+    TEST_ASSERT_TRUE(OrderProgress_IsSettled(&progress));
+    TEST_ASSERT_EQUAL(2, progress.updatesOk);
+    TEST_ASSERT_EQUAL(1, progress.updatesFailed);
+    TEST_ASSERT_EQUAL(-1, OrderProgress_OnUpdateResponse(&progress, 200));
+
+    TEST_ASSERT_FALSE(OrderProgress_CanRequest(&progress, now + 2 * SPACING_MS + 100));
+    TEST_ASSERT_TRUE(OrderProgress_CanRequest(&progress, now + 3 * SPACING_MS));
+}
+
+void test_lost_response_times_out() {
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:1");
+    OrderProgress_OnVendCompleted(&progress, "VEND_COMPLETED:3");
+    TEST_ASSERT_EQUAL(0, OrderProgress_NextUpdate(&progress, 5000));
+    TEST_ASSERT_FALSE(OrderProgress_CheckTimeout(&progress, 19999, 15000));
+    TEST_ASSERT_TRUE(OrderProgress_CheckTimeout(&progress, 20000, 15000));
+    TEST_ASSERT_EQUAL(ORDER_SYNC_ERROR, progress.items[0].sync);
+    TEST_ASSERT_EQUAL(1, OrderProgress_NextUpdate(&progress, 20000));
+}
+
+void test_nothing_delivered_settles_immediately() {
+    OrderProgress_OnDeliveryEnd(&progress, false, "ORDER_NAK:BUSY");
+    TEST_ASSERT_TRUE(OrderProgress_IsSettled(&progress));
+    TEST_ASSERT_EQUAL(0, OrderProgress_DeliveredTotal(&progress));
+    TEST_ASSERT_EQUAL(-1, OrderProgress_NextUpdate(&progress, 100000));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests statuts NUCLEO
+    RUN_TEST(test_vend_completed_matches_pending_items);
+    RUN_TEST(test_vend_failed_keeps_reason);
+    RUN_TEST(test_delivery_end);
+
+    // Tests envoi des mises à jour
+    RUN_TEST(test_updates_overlap_delivery);
+    RUN_TEST(test_lost_response_times_out);
+    RUN_TEST(test_nothing_delivered_settles_immediately);
+
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+#include <unity.h>
+#include "../../include/qr_offline_token.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+// Token signé par scripts/qr_offline_token.py (clé de test, vecteur QRBENCH de token_verifier.cpp):
+// ord_8f3a2c1d9e, machine BENCH-01, expiration 4102444800, items 3x1, 12x2, 27x1
+static const char* signedToken =
+    "qrs_AfSGVwAOb3JkXzhmM2EyYzFkOWUIQkVOQ0gtMDEDAwEMAhsBGXArAmes1rz4uEHsdN5sf7A1BmfeDHVN4uRbs-rwQV1UgkIBYGFPg0YtCU4fFI_IPfyyYAHW4jf1GPZ6UNuzsA";
+static const uint32_t now = 1750000000u;
+
+// Vérificateur de test: la signature ECDSA est vérifiée sur cible (mbedtls); ici on contrôle
+// ce qui est passé au vérificateur et on impose sa réponse
+struct FakeVerifier {
+    bool accept;
+    int calls;
+    size_t msgLen;
+    size_t sigLen;
+};
+
+static FakeVerifier fake;
+
+static bool fakeVerify(void* ctx, const uint8_t*, size_t msgLen, const uint8_t*, size_t sigLen) {
+    FakeVerifier* f = (FakeVerifier*)ctx;
+    f->calls++;
+    f->msgLen = msgLen;
+    f->sigLen = sigLen;
+    return f->accept;
+}
+
+static QrOfflineResult verify(const char* token, uint32_t t, const char* machine, QrOfflineOrder* out) {
+    return QrOffline_Verify(token, strlen(token), t, machine, fakeVerify, &fake, out);
+}
+
+void setUp(void) {
+    memset(&fake, 0, sizeof(fake));
+    fake.accept = true;
+}
+void tearDown(void) {}
+
+// Tests décodage
+void test_base64url_decode() {
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL(3, QrOffline_Base64UrlDecode("-_-_", 4, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8(0xFB, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, out[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xBF, out[2]);
+    TEST_ASSERT_EQUAL(2, QrOffline_Base64UrlDecode("QUI", 3, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY("AB", out, 2);
+    TEST_ASSERT_EQUAL(-1, QrOffline_Base64UrlDecode("QU+", 3, out, sizeof(out)));   // alphabet standard refusé
+    TEST_ASSERT_EQUAL(-1, QrOffline_Base64UrlDecode("QUJDR", 5, out, sizeof(out)));  // longueur impossible
+    TEST_ASSERT_EQUAL(-1, QrOffline_Base64UrlDecode("QUJDREVGR0g", 11, out, 4));     // sortie trop petite
+}
+
+// Tests vérification
+void test_signed_token_accepted() {
+    QrOfflineOrder order;
+    TEST_ASSERT_EQUAL(QR_OFFLINE_OK, verify(signedToken, now, "BENCH-01", &order));
+    TEST_ASSERT_EQUAL(1, fake.calls);
+    TEST_ASSERT_EQUAL(QR_OFFLINE_SIGNATURE_SIZE, fake.sigLen);
+    TEST_ASSERT_EQUAL(1 + 4 + 1 + 14 + 1 + 8 + 1 + 6, fake.msgLen);
+    TEST_ASSERT_EQUAL_STRING("ord_8f3a2c1d9e", order.orderId);
+    TEST_ASSERT_EQUAL_STRING("BENCH-01", order.machineId);
+    TEST_ASSERT_EQUAL_UINT32(4102444800u, order.expiresAt);
+    TEST_ASSERT_EQUAL(3, order.itemCount);
+    TEST_ASSERT_EQUAL(12, order.items[1].slot);
+    TEST_ASSERT_EQUAL(2, order.items[1].quantity);
+    TEST_ASSERT_EQUAL(27, order.items[2].slot);
+    // Sans MACHINE_ID configuré: refusé (registre anti-rejeu propre à chaque machine)
+    TEST_ASSERT_EQUAL(QR_OFFLINE_WRONG_MACHINE, verify(signedToken, now, "", &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_WRONG_MACHINE, verify(signedToken, now, NULL, &order));
+}
+
+void test_rejections() {
+    QrOfflineOrder order;
+    memset(&order, 0xAA, sizeof(order));
+    fake.accept = false;
+    TEST_ASSERT_EQUAL(QR_OFFLINE_BAD_SIGNATURE, verify(signedToken, now, NULL, &order));
+    TEST_ASSERT_EQUAL_HEX8(0xAA, ((uint8_t*)&order)[0]);  // sortie intacte en cas d'échec
+    fake.accept = true;
+    TEST_ASSERT_EQUAL(QR_OFFLINE_EXPIRED, verify(signedToken, 4102444800u, NULL, &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_WRONG_MACHINE, verify(signedToken, now, "VM-02", &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_NO_CLOCK, verify(signedToken, 3600, NULL, &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_NOT_SIGNED, verify("qr_6565917e-a288_17552", now, NULL, &order));
+    TEST_ASSERT_EQUAL_STRING("EXPIRED", QrOffline_ResultName(QR_OFFLINE_EXPIRED));
+}
+
+void test_malformed_tokens() {
+    QrOfflineOrder order;
+    std::string truncated(signedToken, strlen(signedToken) - 8);
+    TEST_ASSERT_EQUAL(QR_OFFLINE_MALFORMED, verify(truncated.c_str(), now, NULL, &order));
+    TEST_ASSERT_EQUAL(0, fake.calls);  // pas de vérification de signature sur un payload incohérent
+    TEST_ASSERT_EQUAL(QR_OFFLINE_MALFORMED, verify("qrs_AfSG*wAO", now, NULL, &order));
+
+    // Payload: slot 0 refusé, nombre d'items incohérent refusé, identifiants JSON-sûrs
+    const uint8_t slot0[] = {1, 0, 0, 0, 1, 1, 'A', 1, 'M', 1, 0, 1};
+    const uint8_t count[] = {1, 0, 0, 0, 1, 1, 'A', 1, 'M', 2, 3, 1};
+    const uint8_t quote[] = {1, 0, 0, 0, 1, 1, '"', 1, 'M', 1, 3, 1};
+    const uint8_t ok[]    = {1, 0, 0, 0, 1, 1, 'A', 1, 'M', 1, 3, 1};
+    TEST_ASSERT_EQUAL(QR_OFFLINE_MALFORMED, QrOffline_ParsePayload(slot0, sizeof(slot0), &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_MALFORMED, QrOffline_ParsePayload(count, sizeof(count), &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_MALFORMED, QrOffline_ParsePayload(quote, sizeof(quote), &order));
+    TEST_ASSERT_EQUAL(QR_OFFLINE_OK, QrOffline_ParsePayload(ok, sizeof(ok), &order));
+    // Le token le plus long tient dans OrchestratorEvent::payload (224)
+    TEST_ASSERT_TRUE(QR_OFFLINE_TOKEN_MAX < 224);
+}
+
+// Benchmark: décodage et contrôles hors signature (le coût ECDSA se mesure sur cible: QRBENCH)
+void test_bench_parse() {
+    const int iterations = 200000;
+    QrOfflineOrder order;
+    size_t len = strlen(signedToken);
+    int ok = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        if (QrOffline_Verify(signedToken, len, now, "BENCH-01", fakeVerify, &fake, &order) == QR_OFFLINE_OK) ok++;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    printf("[BENCH] qr_offline_token: %.1f ns/token hors ECDSA (%zu caractères)\n", ns, len);
+    TEST_ASSERT_EQUAL(iterations, ok);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests décodage
+    RUN_TEST(test_base64url_decode);
+
+    // Tests vérification
+    RUN_TEST(test_signed_token_accepted);
+    RUN_TEST(test_rejections);
+    RUN_TEST(test_malformed_tokens);
+
+    // Benchmark
+    RUN_TEST(test_bench_parse);
+    return UNITY_END();
+}
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include "../../include/qr_scan.h"
+#include <string.h>
+#include <string>
+
+static QrScanAssembler scan;
+
+void setUp(void) {
+    QrScan_Init(&scan);
+}
+void tearDown(void) {}
+
+// Pousse un bloc complet (comme un événement du driver) et concatène les lignes avec '|'
+static int feedChunk(const char* chunk, bool idle, std::string& out) {
+    const uint8_t* p = (const uint8_t*)chunk;
+    size_t n = strlen(chunk);
+    size_t off = 0;
+    int lines = 0;
+    do {
+        const char* line;
+        size_t len;
+        off += QrScan_Push(&scan, p + off, n - off, idle, &line, &len);
+        if (line) {
+            out.append(line, len);
+            out += '|';
+            lines++;
+        }
+    } while (off < n);
+    return lines;
+}
+
+// Tests découpage
+void test_line_in_chunk_is_zero_copy() {
+    const char* chunk = "qr_abc_123\r\n";
+    const char* line;
+    size_t len;
+    TEST_ASSERT_EQUAL(11, QrScan_Push(&scan, (const uint8_t*)chunk, strlen(chunk), false, &line, &len));
+    TEST_ASSERT_EQUAL_PTR(chunk, line);
+    TEST_ASSERT_EQUAL(10, len);
+    // '\n' restant: ligne vide, rien à livrer
+    TEST_ASSERT_EQUAL(1, QrScan_Push(&scan, (const uint8_t*)chunk + 11, 1, false, &line, &len));
+    TEST_ASSERT_NULL(line);
+}
+
+void test_line_split_across_events() {
+    std::string out;
+    TEST_ASSERT_EQUAL(0, feedChunk("qr_6565917e-a288_17552", false, out));
+    TEST_ASSERT_EQUAL(1, feedChunk("60515417\rqr_b", false, out));
+    TEST_ASSERT_EQUAL_STRING("qr_6565917e-a288_1755260515417|", out.c_str());
+    TEST_ASSERT_EQUAL(1, feedChunk("_c\n", false, out));
+    TEST_ASSERT_EQUAL_STRING("qr_6565917e-a288_1755260515417|qr_b_c|", out.c_str());
+}
+
+void test_idle_terminates_line_without_suffix() {
+    std::string out;
+    TEST_ASSERT_EQUAL(1, feedChunk("qr_a_b", true, out));
+    TEST_ASSERT_EQUAL_STRING("qr_a_b|", out.c_str());
+    // Début déjà reçu puis silence sans nouvel octet
+    TEST_ASSERT_EQUAL(0, feedChunk("qr_c", false, out));
+    const char* line;
+    size_t len;
+    TEST_ASSERT_EQUAL(0, QrScan_Push(&scan, NULL, 0, true, &line, &len));
+    TEST_ASSERT_NOT_NULL(line);
+    TEST_ASSERT_EQUAL(4, len);
+    TEST_ASSERT_EQUAL_MEMORY("qr_c", line, 4);
+}
+
+void test_overlong_line_dropped() {
+    std::string out;
+    std::string big(QR_SCAN_LINE_MAX - 10, 'x');
+    TEST_ASSERT_EQUAL(0, feedChunk(big.c_str(), false, out));
+    TEST_ASSERT_EQUAL(1, feedChunk("0123456789ABCDEF\r\nqr_a_b\r\n", false, out));
+    TEST_ASSERT_EQUAL_STRING("qr_a_b|", out.c_str());
+    TEST_ASSERT_EQUAL(1, scan.truncated);
+}
+
+// Tests détection de token
+void test_token_detection() {
+    TEST_ASSERT_TRUE(QrScan_IsToken("qr_a_b", 6));
+    TEST_ASSERT_TRUE(QrScan_IsToken("qr_6565917e-a288_17552", 22));
+    TEST_ASSERT_FALSE(QrScan_IsToken("qr_abc", 6));
+    TEST_ASSERT_FALSE(QrScan_IsToken("qr__", 3));
+    TEST_ASSERT_FALSE(QrScan_IsToken("QR_a_b", 6));
+    TEST_ASSERT_FALSE(QrScan_IsToken("https://x_y", 11));
+    TEST_ASSERT_TRUE(QrScan_IsToken("qrs_AfSGVwAO", 12));
+    TEST_ASSERT_FALSE(QrScan_IsToken("qrs_", 4));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_line_in_chunk_is_zero_copy);
+    RUN_TEST(test_line_split_across_events);
+    RUN_TEST(test_idle_terminates_line_without_suffix);
+    RUN_TEST(test_overlong_line_dropped);
+    RUN_TEST(test_token_detection);
+    return UNITY_END();
+}
@@ -0,0 +1,77 @@
+#include <unity.h>
+#include "../../include/qr_spent.h"
+#include <string.h>
+
+static QrSpentSet spent;
+
+void setUp(void) {
+    QrSpent_Init(&spent);
+}
+void tearDown(void) {}
+
+static const uint32_t NOW = 1750000000u;
+
+// Tests registre
+void test_add_contains_remove() {
+    TEST_ASSERT_FALSE(QrSpent_Contains(&spent, 0x1111));
+    TEST_ASSERT_TRUE(QrSpent_Add(&spent, 0x1111, NOW + 3600, NOW));
+    TEST_ASSERT_TRUE(QrSpent_Contains(&spent, 0x1111));
+    TEST_ASSERT_FALSE(QrSpent_Contains(&spent, 0x2222));
+
+    // Même commande: pas de doublon, expiration la plus lointaine conservée
+    TEST_ASSERT_TRUE(QrSpent_Add(&spent, 0x1111, NOW + 60, NOW));
+    TEST_ASSERT_EQUAL_UINT32(1, spent.count);
+    TEST_ASSERT_EQUAL_UINT32(NOW + 3600, spent.entries[0].expiresAt);
+
+    TEST_ASSERT_TRUE(QrSpent_Remove(&spent, 0x1111));
+    TEST_ASSERT_FALSE(QrSpent_Remove(&spent, 0x1111));
+    TEST_ASSERT_FALSE(QrSpent_Contains(&spent, 0x1111));
+}
+
+void test_expired_entries_purged() {
+    QrSpent_Add(&spent, 1, NOW + 10, NOW);
+    QrSpent_Add(&spent, 2, NOW + 100, NOW);
+    QrSpent_Add(&spent, 3, NOW + 10, NOW);
+    TEST_ASSERT_EQUAL_INT(0, QrSpent_Purge(&spent, NOW + 10));   // encore valide à l'échéance
+    TEST_ASSERT_EQUAL_INT(2, QrSpent_Purge(&spent, NOW + 11));
+    TEST_ASSERT_EQUAL_UINT32(1, spent.count);
+    TEST_ASSERT_TRUE(QrSpent_Contains(&spent, 2));
+}
+
+void test_full_registry_never_evicts_live_entries() {
+    for (uint64_t i = 0; i < QR_SPENT_CAPACITY; i++) {
+        TEST_ASSERT_TRUE(QrSpent_Add(&spent, 100 + i, NOW + 1000 + (uint32_t)i, NOW));
+    }
+    TEST_ASSERT_FALSE(QrSpent_Add(&spent, 999, NOW + 5000, NOW + 500));
+    for (uint64_t i = 0; i < QR_SPENT_CAPACITY; i++) TEST_ASSERT_TRUE(QrSpent_Contains(&spent, 100 + i));
+
+    // Place libérée par l'expiration de la plus ancienne
+    TEST_ASSERT_TRUE(QrSpent_Add(&spent, 999, NOW + 5000, NOW + 1001));
+    TEST_ASSERT_FALSE(QrSpent_Contains(&spent, 100));
+    TEST_ASSERT_TRUE(QrSpent_Contains(&spent, 999));
+    TEST_ASSERT_EQUAL_UINT32(QR_SPENT_CAPACITY, spent.count);
+}
+
+// Tests relecture NVS
+void test_reloaded_block_validation() {
+    QrSpent_Add(&spent, 7, NOW + 10, NOW);
+    QrSpentSet copy;
+    memcpy(&copy, &spent, sizeof(copy));
+    TEST_ASSERT_TRUE(QrSpent_IsValid(&copy, sizeof(copy)));
+    TEST_ASSERT_TRUE(QrSpent_Contains(&copy, 7));
+    TEST_ASSERT_FALSE(QrSpent_IsValid(&copy, sizeof(copy) - 4));  // format d'une autre version
+    copy.count = QR_SPENT_CAPACITY + 1;
+    TEST_ASSERT_FALSE(QrSpent_IsValid(&copy, sizeof(copy)));
+    TEST_ASSERT_FALSE(QrSpent_IsValid(nullptr, sizeof(copy)));
+}
+
+int main() {
+    UNITY_BEGIN();
+    // Registre
+    RUN_TEST(test_add_contains_remove);
+    RUN_TEST(test_expired_entries_purged);
+    RUN_TEST(test_full_registry_never_evicts_live_entries);
+    // Relecture NVS
+    RUN_TEST(test_reloaded_block_validation);
+    return UNITY_END();
+}
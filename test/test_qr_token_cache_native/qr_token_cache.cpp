@@ -0,0 +1,101 @@
+#include "../../include/qr_token_cache.h"
+#include <string.h>
+
+void QrTokenCache_Init(QrTokenCache* c) {
+  if (!c) return;
+  memset(c, 0, sizeof(*c));
+}
+
+uint64_t QrTokenCache_Hash(const char* token, size_t len) {
+  uint64_t h = 1469598103934665603ULL;
+  for (size_t i = 0; token && i < len; i++) {
+    h ^= (uint8_t)token[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static bool isExpired(const QrTokenCacheEntry* e, uint32_t nowMs) {
+  return (nowMs - e->storedMs) >= e->ttlMs;
+}
+
+static QrTokenCacheEntry* find(QrTokenCache* c, uint64_t hash) {
+  for (int i = 0; i < QR_TOKEN_CACHE_CAPACITY; i++) {
+    QrTokenCacheEntry* e = &c->entries[i];
+    if (e->outcome != QR_TOKEN_CACHE_MISS && e->hash == hash) return e;
+  }
+  return NULL;
+}
+
+QrTokenOutcome QrTokenCache_Lookup(QrTokenCache* c, uint64_t hash, uint32_t nowMs) {
+  if (!c) return QR_TOKEN_CACHE_MISS;
+  QrTokenCacheEntry* e = find(c, hash);
+  if (e && isExpired(e, nowMs)) {
+    e->outcome = QR_TOKEN_CACHE_MISS;
+    c->expired++;
+    e = NULL;
+  }
+  if (!e) {
+    c->misses++;
+    return QR_TOKEN_CACHE_MISS;
+  }
+  e->lastUse = ++c->clock;
+  c->hits++;
+  return (QrTokenOutcome)e->outcome;
+}
+
+void QrTokenCache_Store(QrTokenCache* c, uint64_t hash, QrTokenOutcome outcome, uint32_t nowMs, uint32_t ttlMs) {
+  if (!c) return;
+  if (outcome == QR_TOKEN_CACHE_MISS) {
+    QrTokenCache_Remove(c, hash);
+    return;
+  }
+  QrTokenCacheEntry* e = find(c, hash);
+  if (!e) {
+    // Entrée libre ou expirée, sinon la moins récemment utilisée
+    QrTokenCacheEntry* victim = NULL;
+    for (int i = 0; i < QR_TOKEN_CACHE_CAPACITY; i++) {
+      QrTokenCacheEntry* cand = &c->entries[i];
+      if (cand->outcome == QR_TOKEN_CACHE_MISS || isExpired(cand, nowMs)) {
+        victim = cand;
+        break;
+      }
+      if (!victim || cand->lastUse < victim->lastUse) victim = cand;
+    }
+    if (victim->outcome != QR_TOKEN_CACHE_MISS) {
+      if (isExpired(victim, nowMs)) c->expired++;
+      else c->evicted++;
+    }
+    e = victim;
+  }
+  e->hash = hash;
+  e->outcome = (uint8_t)outcome;
+  e->storedMs = nowMs;
+  e->ttlMs = ttlMs;
+  e->lastUse = ++c->clock;
+}
+
+void QrTokenCache_Remove(QrTokenCache* c, uint64_t hash) {
+  if (!c) return;
+  QrTokenCacheEntry* e = find(c, hash);
+  if (e) e->outcome = QR_TOKEN_CACHE_MISS;
+}
+
+size_t QrTokenCache_Count(const QrTokenCache* c, uint32_t nowMs) {
+  if (!c) return 0;
+  size_t n = 0;
+  for (int i = 0; i < QR_TOKEN_CACHE_CAPACITY; i++) {
+    const QrTokenCacheEntry* e = &c->entries[i];
+    if (e->outcome != QR_TOKEN_CACHE_MISS && !isExpired(e, nowMs)) n++;
+  }
+  return n;
+}
+
+const char* QrTokenCache_Reply(QrTokenOutcome outcome) {
+  switch (outcome) {
+    case QR_TOKEN_CACHE_REJECTED:
+    case QR_TOKEN_CACHE_CONSUMED: return "QR_TOKEN_INVALID";   // le backend refuserait aussi un token déjà utilisé
+    case QR_TOKEN_CACHE_IN_PROGRESS: return "QR_TOKEN_BUSY";
+    default: return NULL;
+  }
+}
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include "../../include/qr_token_cache.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static QrTokenCache cache;
+
+void setUp(void) {
+    QrTokenCache_Init(&cache);
+}
+void tearDown(void) {}
+
+static uint64_t h(const char* token) {
+    return QrTokenCache_Hash(token, strlen(token));
+}
+
+// Tests résultat mémorisé
+void test_miss_then_hit() {
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_MISS, QrTokenCache_Lookup(&cache, h("qr_a_1"), 0));
+    QrTokenCache_Store(&cache, h("qr_a_1"), QR_TOKEN_CACHE_REJECTED, 0, 30000);
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_REJECTED, QrTokenCache_Lookup(&cache, h("qr_a_1"), 100));
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_MISS, QrTokenCache_Lookup(&cache, h("qr_a_2"), 100));
+    TEST_ASSERT_EQUAL(1, cache.hits);
+    TEST_ASSERT_EQUAL(2, cache.misses);
+}
+
+void test_outcome_update_and_remove() {
+    QrTokenCache_Store(&cache, h("qr_a_1"), QR_TOKEN_CACHE_IN_PROGRESS, 0, 120000);
+    TEST_ASSERT_EQUAL_STRING("QR_TOKEN_BUSY", QrTokenCache_Reply(QrTokenCache_Lookup(&cache, h("qr_a_1"), 10)));
+    QrTokenCache_Store(&cache, h("qr_a_1"), QR_TOKEN_CACHE_CONSUMED, 20, 600000);
+    TEST_ASSERT_EQUAL_STRING("QR_TOKEN_INVALID", QrTokenCache_Reply(QrTokenCache_Lookup(&cache, h("qr_a_1"), 30)));
+    TEST_ASSERT_EQUAL(1, QrTokenCache_Count(&cache, 30));
+    QrTokenCache_Remove(&cache, h("qr_a_1"));
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_MISS, QrTokenCache_Lookup(&cache, h("qr_a_1"), 40));
+    TEST_ASSERT_NULL(QrTokenCache_Reply(QR_TOKEN_CACHE_MISS));
+}
+
+void test_ttl_expiry_with_wraparound() {
+    uint32_t t0 = 0xFFFFF000u;
+    QrTokenCache_Store(&cache, h("qr_a_1"), QR_TOKEN_CACHE_REJECTED, t0, 30000);
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_REJECTED, QrTokenCache_Lookup(&cache, h("qr_a_1"), t0 + 29999));
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_MISS, QrTokenCache_Lookup(&cache, h("qr_a_1"), t0 + 30000));
+    TEST_ASSERT_EQUAL(1, cache.expired);
+    TEST_ASSERT_EQUAL(0, QrTokenCache_Count(&cache, t0 + 30000));
+}
+
+void test_lru_eviction() {
+    char tok[16];
+    for (int i = 0; i < QR_TOKEN_CACHE_CAPACITY; i++) {
+        snprintf(tok, sizeof(tok), "qr_t_%d", i);
+        QrTokenCache_Store(&cache, h(tok), QR_TOKEN_CACHE_REJECTED, 0, 60000);
+    }
+    // qr_t_0 utilisé récemment: c'est qr_t_1 qui part
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_REJECTED, QrTokenCache_Lookup(&cache, h("qr_t_0"), 10));
+    QrTokenCache_Store(&cache, h("qr_new_1"), QR_TOKEN_CACHE_CONSUMED, 20, 60000);
+    TEST_ASSERT_EQUAL(1, cache.evicted);
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_REJECTED, QrTokenCache_Lookup(&cache, h("qr_t_0"), 30));
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_MISS, QrTokenCache_Lookup(&cache, h("qr_t_1"), 30));
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_CONSUMED, QrTokenCache_Lookup(&cache, h("qr_new_1"), 30));
+    TEST_ASSERT_EQUAL(QR_TOKEN_CACHE_CAPACITY, QrTokenCache_Count(&cache, 30));
+}
+
+// Benchmark: réponse locale à un scan répété (hash + recherche)
+void test_bench_repeat_scan() {
+    char tok[48];
+    for (int i = 0; i < QR_TOKEN_CACHE_CAPACITY; i++) {
+        snprintf(tok, sizeof(tok), "qr_6565917e-a288-4f0b_%08d", i);
+        QrTokenCache_Store(&cache, h(tok), QR_TOKEN_CACHE_REJECTED, 0, 600000);
+    }
+    const char* scan = "qr_6565917e-a288-4f0b_00000015";
+    const int iterations = 200000;
+    volatile int replies = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        const char* r = QrTokenCache_Reply(QrTokenCache_Lookup(&cache, QrTokenCache_Hash(scan, strlen(scan)), 1000));
+        if (r) replies = replies + 1;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    printf("[BENCH] qr_token_cache: %.1f ns/scan répété (%d entrées)\n", ns, QR_TOKEN_CACHE_CAPACITY);
+    TEST_ASSERT_EQUAL(iterations, replies);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests résultat mémorisé
+    RUN_TEST(test_miss_then_hit);
+    RUN_TEST(test_outcome_update_and_remove);
+    RUN_TEST(test_ttl_expiry_with_wraparound);
+    RUN_TEST(test_lru_eviction);
+
+    // Benchmark
+    RUN_TEST(test_bench_repeat_scan);
+    return UNITY_END();
+}
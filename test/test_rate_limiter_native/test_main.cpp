@@ -0,0 +1,160 @@
+#include <unity.h>
+#include "../../include/rate_limiter.h"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+static RateLimiter rl;
+
+void setUp(void) {
+    memset(&rl, 0, sizeof(rl));
+    rl.rules[RATE_LIMIT_NFC] = { 3000, 1 };
+    rl.rules[RATE_LIMIT_UART] = { 200, 5 };
+    rl.rules[RATE_LIMIT_HTTP] = { 100, 3 };
+    rl.rules[RATE_LIMIT_WIFI] = { 5000, 1 };
+}
+void tearDown(void) {}
+
+// Tests seau
+void test_burst_then_steady_rate() {
+    uint32_t t = 1000;
+    for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t));
+    // Un jeton toutes les 100 ms
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t + 99));
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t + 100));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t + 150));
+    // Après 1 s d'inactivité le seau est de nouveau plein, pas plus
+    t += 1200;
+    for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_HTTP, t + 10));
+    TEST_ASSERT_EQUAL_UINT32(7, RateLimit_Accepted(&rl, RATE_LIMIT_HTTP));
+    TEST_ASSERT_EQUAL_UINT32(4, RateLimit_Rejected(&rl, RATE_LIMIT_HTTP));
+    // Seaux indépendants
+    TEST_ASSERT_EQUAL_UINT32(0, RateLimit_Accepted(&rl, RATE_LIMIT_UART));
+}
+
+void test_single_token_is_a_cooldown_and_boot_is_allowed() {
+    // Premier scan accepté dès le démarrage
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_NFC, 0));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_NFC, 2999));
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_NFC, 3000));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_NFC, 3001));
+}
+
+void test_millis_wrap_and_long_idle() {
+    // Rebouclage de millis() au milieu d'une rafale
+    uint32_t t = 0xFFFFFFFFu - 50;
+    for (int i = 0; i < 5; i++) TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_UART, t));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_UART, t + 100));
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_UART, t + 200));
+
+    // Plus de 24 jours sans demande: tat paraît dans le futur, seau considéré plein
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_WIFI, 10000));
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_WIFI, 10000 + 0x90000000u));
+}
+
+void test_reset_and_invalid_id() {
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_WIFI, 500));
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_WIFI, 600));
+    RateLimit_Reset(&rl, RATE_LIMIT_WIFI);
+    TEST_ASSERT_TRUE(RateLimit_TryAcquire(&rl, RATE_LIMIT_WIFI, 700));
+    TEST_ASSERT_EQUAL_UINT32(2, RateLimit_Accepted(&rl, RATE_LIMIT_WIFI));
+    TEST_ASSERT_EQUAL_UINT32(1, RateLimit_Rejected(&rl, RATE_LIMIT_WIFI));
+
+    TEST_ASSERT_FALSE(RateLimit_TryAcquire(&rl, RATE_LIMIT_COUNT, 0));
+    TEST_ASSERT_EQUAL_STRING("UART", RateLimit_Name(RATE_LIMIT_UART));
+    TEST_ASSERT_EQUAL_STRING("?", RateLimit_Name(RATE_LIMIT_COUNT));
+}
+
+// Tests concurrence
+void test_concurrent_tasks_never_exceed_burst() {
+    // 4 tâches sur le même seau au même instant: exactement `burst` demandes acceptées
+    const int threads = 4, perThread = 20000;
+    std::atomic<int> accepted(0);
+    std::thread pool[threads];
+    for (int n = 0; n < 20; n++) {
+        uint32_t t = 100000u + (uint32_t)n * 10000u;     // seau plein à chaque tour
+        accepted = 0;
+        for (int i = 0; i < threads; i++) {
+            pool[i] = std::thread([&accepted, t]() {
+                for (int k = 0; k < perThread; k++) {
+                    if (RateLimit_TryAcquire(&rl, RATE_LIMIT_UART, t)) accepted++;
+                }
+            });
+        }
+        for (int i = 0; i < threads; i++) pool[i].join();
+        TEST_ASSERT_EQUAL_INT(5, accepted.load());
+    }
+    TEST_ASSERT_EQUAL_UINT32(20 * 5, RateLimit_Accepted(&rl, RATE_LIMIT_UART));
+    TEST_ASSERT_EQUAL_UINT32(20 * (threads * perThread - 5), RateLimit_Rejected(&rl, RATE_LIMIT_UART));
+}
+
+// Ancienne implémentation (security_utils.cpp): recherche strcmp sur 10 emplacements, un délai
+static unsigned long legacyLast[10];
+static char legacyServices[10][10] = {"NFC", "UART", "HTTP", "WIFI", "QR", "", "", "", "", ""};
+
+static int legacyFind(const char* serviceName) {
+    for (int i = 0; i < 10; i++) {
+        if (strcmp(legacyServices[i], serviceName) == 0) return i;
+        if (strlen(legacyServices[i]) == 0) {
+            strncpy(legacyServices[i], serviceName, 9);
+            legacyServices[i][9] = '\0';
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool legacyCheck(const char* service, unsigned long cooldownMs, unsigned long now) {
+    int index = legacyFind(service);
+    if (index < 0) return false;
+    if (now - legacyLast[index] < cooldownMs) return false;
+    legacyLast[index] = now;
+    return true;
+}
+
+// Benchmark
+void test_bench_against_legacy() {
+    static const char* const names[4] = { "NFC", "UART", "HTTP", "WIFI" };
+    static const unsigned long cooldowns[4] = { 3000, 200, 100, 5000 };
+    const int iterations = 2000000;
+    unsigned legacyOk = 0, bucketOk = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        int s = i & 3;
+        legacyOk += legacyCheck(names[s], cooldowns[s], (unsigned long)(i >> 4));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        bucketOk += RateLimit_TryAcquire(&rl, (RateLimitId)(i & 3), (uint32_t)(i >> 4));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    TEST_ASSERT_TRUE(legacyOk > 0 && bucketOk >= legacyOk);
+    double legacyNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    double bucketNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations;
+    printf("[BENCH] rate_limiter: strcmp + délai=%.1f ns, seau à jetons CAS=%.1f ns par appel (x%.1f), "
+           "acceptés %u / %u\n",
+           legacyNs, bucketNs, bucketNs > 0 ? legacyNs / bucketNs : 0.0, legacyOk, bucketOk);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests seau
+    RUN_TEST(test_burst_then_steady_rate);
+    RUN_TEST(test_single_token_is_a_cooldown_and_boot_is_allowed);
+    RUN_TEST(test_millis_wrap_and_long_idle);
+    RUN_TEST(test_reset_and_invalid_id);
+
+    // Tests concurrence
+    RUN_TEST(test_concurrent_tasks_never_exceed_burst);
+
+    // Benchmark
+    RUN_TEST(test_bench_against_legacy);
+    return UNITY_END();
+}
@@ -0,0 +1,610 @@
+#include <unity.h>
+#include "../../include/rc522_drv.h"
+#include <stdio.h>
+#include <string.h>
+
+// ---- RC522 simulé au niveau des trames SPI, avec cartes ISO 14443-A ----
+#define SIM_REG_CRC_H   0x21
+#define SIM_REG_CRC_L   0x22
+#define SIM_NO_RESPONSE -1
+
+typedef enum { PICC_IDLE, PICC_READY, PICC_ACTIVE, PICC_HALT } PiccState;
+
+typedef struct {
+    uint8_t uid[10];
+    uint8_t uidLen;
+    uint8_t sak;
+    uint8_t mem[64 * 4];
+    int pages;
+    PiccState state;
+    int level;
+} SimCard;
+
+typedef struct {
+    uint8_t regs[64];
+    uint8_t fifo[RC522_FIFO_SIZE];
+    int fifoLen;
+    int fifoPos;
+    SimCard cards[2];
+    int cardCount;
+    bool corruptBursts;     // horloge trop élevée: octets FIFO altérés au-delà de 16
+    bool corruptCrc;        // réponse suivante avec CRC faux
+    // Comptage
+    uint32_t frames;        // transactions (CS bas -> haut)
+    uint32_t calls;         // appels au pilote SPI (1 par octet pour la bibliothèque MFRC522)
+    uint32_t bytes;
+    uint32_t rfExchanges;
+    uint32_t rfBits;        // bits émis et reçus sur l'air
+    uint32_t timeouts;      // échanges sans réponse (TimerIRq après 25 ms)
+} SimRc522;
+
+static SimRc522 sim;
+
+static void simCl(const SimCard* c, int level, uint8_t cl[5]) {
+    int levels = c->uidLen == 4 ? 1 : (c->uidLen == 7 ? 2 : 3);
+    if (level < levels - 1) {
+        cl[0] = RC522_PICC_CASCADE_TAG;
+        memcpy(cl + 1, c->uid + level * 3, 3);
+    } else {
+        memcpy(cl, c->uid + level * 3, 4);
+    }
+    cl[4] = (uint8_t)(cl[0] ^ cl[1] ^ cl[2] ^ cl[3]);
+}
+
+static bool simBit(const uint8_t* b, int i) { return (b[i / 8] >> (i % 8)) & 1; }
+
+static void simPush(const uint8_t* data, int n) {
+    for (int i = 0; i < n && sim.fifoLen < RC522_FIFO_SIZE; i++) sim.fifo[sim.fifoLen++] = data[i];
+}
+
+static bool simCrcOk(const uint8_t* f, int len) {
+    if (len < 3) return false;
+    uint16_t crc = Rc522Drv_CrcA(f, (size_t)len - 2);
+    return f[len - 2] == (uint8_t)crc && f[len - 1] == (uint8_t)(crc >> 8);
+}
+
+// Réponse d'une carte: octets + CRC
+static int simReplyCrc(uint8_t* resp, const uint8_t* data, int n) {
+    memcpy(resp, data, (size_t)n);
+    uint16_t crc = Rc522Drv_CrcA(data, (size_t)n);
+    resp[n] = (uint8_t)crc;
+    resp[n + 1] = (uint8_t)(crc >> 8);
+    if (sim.corruptCrc) { resp[n] ^= 0xFF; sim.corruptCrc = false; }
+    return n + 2;
+}
+
+// Trame reçue par les cartes -> réponse (octets, bits du dernier octet, collision)
+static int simPicc(const uint8_t* f, int len, uint8_t lastBits, uint8_t* resp, uint8_t* respLastBits, int* collBit, int* knownBits) {
+    *respLastBits = 0;
+    *collBit = -1;
+    *knownBits = 0;
+    if (len == 1 && lastBits == 7 && (f[0] == RC522_PICC_REQA || f[0] == RC522_PICC_WUPA)) {
+        int n = 0;
+        uint8_t atqa[2] = { 0, 0 };
+        for (int i = 0; i < sim.cardCount; i++) {
+            SimCard* c = &sim.cards[i];
+            bool wakes = c->state == PICC_IDLE || (f[0] == RC522_PICC_WUPA && c->state == PICC_HALT);
+            if (!wakes) continue;
+            c->state = PICC_READY;
+            c->level = 0;
+            atqa[0] |= c->uidLen == 4 ? 0x04 : (c->uidLen == 7 ? 0x44 : 0x84);
+            n++;
+        }
+        if (n == 0) return SIM_NO_RESPONSE;
+        memcpy(resp, atqa, 2);
+        return 2;
+    }
+    if (len >= 2 && (f[0] == RC522_PICC_SEL_CL1 || f[0] == RC522_PICC_SEL_CL2 || f[0] == RC522_PICC_SEL_CL3)) {
+        int level = (f[0] - RC522_PICC_SEL_CL1) / 2;
+        if (f[1] == 0x70) {
+            if (len != 9 || !simCrcOk(f, len)) return SIM_NO_RESPONSE;
+            int r = SIM_NO_RESPONSE;
+            for (int i = 0; i < sim.cardCount; i++) {
+                SimCard* c = &sim.cards[i];
+                if (c->state != PICC_READY || c->level != level) continue;
+                uint8_t cl[5];
+                simCl(c, level, cl);
+                if (memcmp(cl, f + 2, 5) != 0) { c->state = PICC_IDLE; continue; }
+                int levels = c->uidLen == 4 ? 1 : (c->uidLen == 7 ? 2 : 3);
+                uint8_t sak = c->sak;
+                if (level < levels - 1) { sak = 0x04; c->level++; } else { c->state = PICC_ACTIVE; }
+                r = simReplyCrc(resp, &sak, 1);
+            }
+            return r;
+        }
+        // Anticollision: bits connus = NVB, réponse alignée sur l'octet en cours
+        int known = ((f[1] >> 4) - 2) * 8 + (f[1] & 0x07);
+        int first = known / 8;
+        uint8_t acc[5] = { 0 };
+        uint8_t seen[5] = { 0 };
+        int matches = 0;
+        int coll = 40;
+        for (int i = 0; i < sim.cardCount; i++) {
+            SimCard* c = &sim.cards[i];
+            if (c->state != PICC_READY || c->level != level) continue;
+            uint8_t cl[5];
+            simCl(c, level, cl);
+            bool match = true;
+            for (int b = 0; b < known; b++) if (simBit(cl, b) != simBit(f + 2, b)) { match = false; break; }
+            if (!match) continue;
+            if (matches++ == 0) { memcpy(acc, cl, 5); memcpy(seen, cl, 5); continue; }
+            for (int b = known; b < coll; b++) if (simBit(cl, b) != simBit(seen, b)) { coll = b; break; }
+        }
+        if (matches == 0) return SIM_NO_RESPONSE;
+        int end = 40;
+        if (coll < 40) {
+            // ValuesAfterColl = 0: bits après la collision à zéro
+            for (int b = coll; b < 40; b++) acc[b / 8] &= (uint8_t)~(1 << (b % 8));
+            acc[coll / 8] |= (uint8_t)(1 << (coll % 8));
+            *collBit = coll;
+            end = coll + 1;
+            *respLastBits = (uint8_t)(end % 8);
+        }
+        *knownBits = known;
+        acc[first] &= (uint8_t)~((1 << (known % 8)) - 1);
+        int n = (end + 7) / 8 - first;
+        memcpy(resp, acc + first, (size_t)n);
+        return n;
+    }
+
+    SimCard* active = nullptr;
+    for (int i = 0; i < sim.cardCount; i++) if (sim.cards[i].state == PICC_ACTIVE) active = &sim.cards[i];
+    if (!active || !simCrcOk(f, len)) return SIM_NO_RESPONSE;
+    if (f[0] == RC522_PICC_HLTA && len == 4) {
+        active->state = PICC_HALT;
+        return SIM_NO_RESPONSE;
+    }
+    if (f[0] == RC522_PICC_READ && len == 4) {
+        if (f[1] >= active->pages) { active->state = PICC_IDLE; resp[0] = 0x00; *respLastBits = 4; return 1; }
+        uint8_t data[16];
+        for (int i = 0; i < 16; i++) data[i] = active->mem[(f[1] * 4 + i) % (active->pages * 4)];
+        return simReplyCrc(resp, data, 16);
+    }
+    if (f[0] == 0x3A && len == 5) {
+        int n = (f[2] - f[1] + 1) * 4;
+        if (f[2] < f[1] || f[2] >= active->pages || n > 60) { active->state = PICC_IDLE; resp[0] = 0x00; *respLastBits = 4; return 1; }
+        return simReplyCrc(resp, active->mem + f[1] * 4, n);
+    }
+    active->state = PICC_IDLE;
+    return SIM_NO_RESPONSE;
+}
+
+static void simRf(bool transceive) {
+    uint8_t frame[RC522_FIFO_SIZE];
+    int len = sim.fifoLen - sim.fifoPos;
+    memcpy(frame, sim.fifo + sim.fifoPos, (size_t)len);
+    sim.fifoLen = sim.fifoPos = 0;
+    uint8_t lastBits = sim.regs[RC522_REG_BIT_FRAMING] & 0x07;
+    sim.rfExchanges++;
+    sim.rfBits += (uint32_t)(len * 8 - (lastBits ? 8 - lastBits : 0));
+
+    uint8_t resp[RC522_FIFO_SIZE];
+    uint8_t respLastBits = 0;
+    int collBit = -1;
+    int known = 0;
+    int n = simPicc(frame, len, lastBits, resp, &respLastBits, &collBit, &known);
+    if (!transceive) {
+        sim.regs[RC522_REG_COM_IRQ] |= RC522_COM_TX_IRQ | RC522_COM_IDLE_IRQ;
+        sim.regs[RC522_REG_COMMAND] = RC522_CMD_IDLE;
+        return;
+    }
+    sim.regs[RC522_REG_COM_IRQ] |= RC522_COM_TX_IRQ;
+    if (n == SIM_NO_RESPONSE) {
+        sim.timeouts++;
+        sim.regs[RC522_REG_COM_IRQ] |= RC522_COM_TIMER_IRQ;
+        return;
+    }
+    sim.rfBits += (uint32_t)(n * 8);
+    sim.regs[RC522_REG_COM_IRQ] |= RC522_COM_RX_IRQ;
+    sim.regs[RC522_REG_ERROR] = 0;
+    sim.regs[RC522_REG_CONTROL] = respLastBits;
+    if (collBit >= 0) {
+        sim.regs[RC522_REG_COM_IRQ] |= RC522_COM_ERR_IRQ;
+        sim.regs[RC522_REG_ERROR] = RC522_ERRREG_COLL;
+        sim.regs[RC522_REG_COLL] = (uint8_t)((collBit - (known / 8) * 8 + 1) & 0x1F);
+    }
+    simPush(resp, n);
+}
+
+static uint8_t simRead(uint8_t reg) {
+    if (reg == RC522_REG_FIFO_DATA) {
+        if (sim.fifoPos >= sim.fifoLen) return 0;
+        uint8_t v = sim.fifo[sim.fifoPos++];
+        if (sim.corruptBursts && sim.fifoPos > 16) v ^= 0x01;
+        return v;
+    }
+    if (reg == RC522_REG_FIFO_LEVEL) return (uint8_t)(sim.fifoLen - sim.fifoPos);
+    return sim.regs[reg];
+}
+
+static void simWrite(uint8_t reg, uint8_t v) {
+    switch (reg) {
+        case RC522_REG_FIFO_DATA: simPush(&v, 1); break;
+        case RC522_REG_FIFO_LEVEL: if (v & 0x80) sim.fifoLen = sim.fifoPos = 0; break;
+        case RC522_REG_COM_IRQ:
+        case RC522_REG_DIV_IRQ:
+            if (v & 0x80) sim.regs[reg] |= (uint8_t)(v & 0x7F); else sim.regs[reg] &= (uint8_t)~v;
+            break;
+        case RC522_REG_COMMAND:
+            sim.regs[reg] = v;
+            if (v == RC522_CMD_TRANSMIT) simRf(false);
+            if (v == RC522_CMD_CALC_CRC) {
+                uint16_t crc = Rc522Drv_CrcA(sim.fifo + sim.fifoPos, (size_t)(sim.fifoLen - sim.fifoPos));
+                sim.fifoLen = sim.fifoPos = 0;
+                sim.regs[SIM_REG_CRC_L] = (uint8_t)crc;
+                sim.regs[SIM_REG_CRC_H] = (uint8_t)(crc >> 8);
+                sim.regs[RC522_REG_DIV_IRQ] |= RC522_DIV_CRC_IRQ;
+            }
+            break;
+        case RC522_REG_BIT_FRAMING:
+            sim.regs[reg] = (uint8_t)(v & 0x7F);
+            if ((v & 0x80) && sim.regs[RC522_REG_COMMAND] == RC522_CMD_TRANSCEIVE) simRf(true);
+            break;
+        default: sim.regs[reg] = v; break;
+    }
+}
+
+// Une trame SPI: adresse(s) puis données, comme sur le bus réel
+static void simFrame(const uint8_t* tx, uint8_t* rx, size_t len) {
+    sim.frames++;
+    sim.bytes += (uint32_t)len;
+    if (rx) memset(rx, 0, len);
+    if (tx[0] & 0x80) {
+        for (size_t i = 0; i + 1 < len; i++) {
+            uint8_t v = simRead((tx[i] >> 1) & 0x3F);
+            if (rx) rx[i + 1] = v;
+        }
+    } else {
+        for (size_t i = 1; i < len; i++) simWrite((tx[0] >> 1) & 0x3F, tx[i]);
+    }
+}
+
+static bool simTransfer(void* ctx, const uint8_t* tx, uint8_t* rx, size_t len) {
+    (void)ctx;
+    sim.calls++;
+    simFrame(tx, rx, len);
+    return true;
+}
+
+static const Rc522Transport simTransport = { simTransfer, nullptr, &sim };
+static Rc522Drv drv;
+
+static void simAddCard(const uint8_t* uid, uint8_t uidLen, uint8_t sak) {
+    SimCard* c = &sim.cards[sim.cardCount++];
+    memset(c, 0, sizeof(*c));
+    memcpy(c->uid, uid, uidLen);
+    c->uidLen = uidLen;
+    c->sak = sak;
+    c->pages = 45;
+    for (int i = 0; i < (int)sizeof(c->mem); i++) c->mem[i] = (uint8_t)(i * 7 + uidLen);
+}
+
+void setUp(void) {
+    memset(&sim, 0, sizeof(sim));
+    Rc522Drv_Init(&drv, &simTransport);
+}
+void tearDown(void) {}
+
+// Tests accès registres
+void test_crc_a_vectors() {
+    const uint8_t hlta[] = { 0x50, 0x00 };
+    const uint8_t read0[] = { 0x30, 0x00 };
+    const uint8_t read4[] = { 0x30, 0x04 };
+    TEST_ASSERT_EQUAL_HEX16(0xCD57, Rc522Drv_CrcA(hlta, 2));
+    TEST_ASSERT_EQUAL_HEX16(0xA802, Rc522Drv_CrcA(read0, 2));
+    TEST_ASSERT_EQUAL_HEX16(0xEE26, Rc522Drv_CrcA(read4, 2));
+}
+
+void test_bursts_are_single_transactions() {
+    const uint8_t regs[3] = { RC522_REG_COM_IRQ, RC522_REG_ERROR, RC522_REG_FIFO_LEVEL };
+    uint8_t out[3];
+    sim.regs[RC522_REG_COM_IRQ] = 0x14;
+    sim.regs[RC522_REG_ERROR] = 0x08;
+    TEST_ASSERT_TRUE(Rc522Drv_ReadRegs(&drv, regs, out, 3));
+    TEST_ASSERT_EQUAL_HEX8(0x14, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x08, out[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.frames);
+    TEST_ASSERT_EQUAL_UINT32(4, sim.bytes);
+
+    TEST_ASSERT_TRUE(Rc522Drv_CheckFifo(&drv));
+    // Idle, flush, FIFO 64 octets, FIFOLevel, FIFO 64 octets, flush
+    TEST_ASSERT_EQUAL_UINT32(1 + 6, sim.frames);
+    TEST_ASSERT_EQUAL_UINT32(drv.transactions, sim.frames);
+
+    sim.corruptBursts = true;  // horloge SPI trop élevée pour le module
+    TEST_ASSERT_FALSE(Rc522Drv_CheckFifo(&drv));
+}
+
+// Tests échanges ISO 14443-A
+void test_reqa_select_read_halt() {
+    const uint8_t uid[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    simAddCard(uid, 4, 0x08);
+    uint8_t atqa[2];
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_HEX8(0x04, atqa[0]);
+
+    Rc522Uid out;
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    TEST_ASSERT_EQUAL_UINT8(4, out.size);
+    TEST_ASSERT_EQUAL_MEMORY(uid, out.bytes, 4);
+    TEST_ASSERT_EQUAL_HEX8(0x08, out.sak);
+
+    uint8_t block[16];
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Read(&drv, 4, block));
+    TEST_ASSERT_EQUAL_MEMORY(sim.cards[0].mem + 16, block, 16);
+
+    // FAST_READ pages 4..18 (60 octets, FIFO pleine avec le CRC)
+    uint8_t cmd[3] = { 0x3A, 4, 18 };
+    uint8_t data[60];
+    TEST_ASSERT_EQUAL_INT(60, Rc522Drv_TransceiveCrc(&drv, cmd, 3, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_MEMORY(sim.cards[0].mem + 16, data, 60);
+
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_HaltA(&drv));
+    TEST_ASSERT_EQUAL(PICC_HALT, sim.cards[0].state);
+    TEST_ASSERT_EQUAL_INT(RC522_ERR_TIMEOUT, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_WakeupA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+
+    TEST_ASSERT_EQUAL_UINT32(2, drv.ops[RC522_OP_SELECT].calls);
+    TEST_ASSERT_EQUAL_UINT32(1, drv.ops[RC522_OP_REQA].errors);
+}
+
+void test_cascade_levels() {
+    const uint8_t uid7[7] = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+    simAddCard(uid7, 7, 0x00);
+    uint8_t atqa[2];
+    Rc522Uid out;
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_HEX8(0x44, atqa[0]);
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    TEST_ASSERT_EQUAL_UINT8(7, out.size);
+    TEST_ASSERT_EQUAL_MEMORY(uid7, out.bytes, 7);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out.sak);
+
+    setUp();
+    const uint8_t uid10[10] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A };
+    simAddCard(uid10, 10, 0x20);
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    TEST_ASSERT_EQUAL_UINT8(10, out.size);
+    TEST_ASSERT_EQUAL_MEMORY(uid10, out.bytes, 10);
+    TEST_ASSERT_EQUAL_HEX8(0x20, out.sak);
+}
+
+void test_anticollision_two_cards() {
+    // Premier écart au bit 1 du troisième octet (0x30 / 0x32)
+    const uint8_t uidA[4] = { 0x10, 0x20, 0x30, 0x40 };
+    const uint8_t uidB[4] = { 0x10, 0x20, 0x32, 0x41 };
+    simAddCard(uidA, 4, 0x08);
+    simAddCard(uidB, 4, 0x08);
+    uint8_t atqa[2];
+    Rc522Uid out;
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    TEST_ASSERT_EQUAL_MEMORY(uidB, out.bytes, 4);    // bit de collision choisi à 1
+    TEST_ASSERT_EQUAL(PICC_IDLE, sim.cards[0].state);
+
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_HaltA(&drv));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    TEST_ASSERT_EQUAL_MEMORY(uidA, out.bytes, 4);
+
+    // Collision sur un bit non aligné (octet 0, bit 3)
+    setUp();
+    const uint8_t uidC[4] = { 0x01, 0xAA, 0xBB, 0xCC };
+    const uint8_t uidD[4] = { 0x09, 0xAA, 0xBB, 0xCC };
+    simAddCard(uidC, 4, 0x08);
+    simAddCard(uidD, 4, 0x08);
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    TEST_ASSERT_EQUAL_MEMORY(uidD, out.bytes, 4);
+}
+
+void test_errors() {
+    uint8_t atqa[2];
+    uint8_t block[16];
+    Rc522Uid out;
+    TEST_ASSERT_EQUAL_INT(RC522_ERR_TIMEOUT, Rc522Drv_RequestA(&drv, atqa));  // pas de carte
+
+    const uint8_t uid[4] = { 0xCA, 0xFE, 0x00, 0x01 };
+    simAddCard(uid, 4, 0x00);
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_RequestA(&drv, atqa));
+    TEST_ASSERT_EQUAL_INT(RC522_OK, Rc522Drv_Select(&drv, &out));
+    sim.corruptCrc = true;
+    TEST_ASSERT_EQUAL_INT(RC522_ERR_CRC, Rc522Drv_Read(&drv, 4, block));
+    TEST_ASSERT_EQUAL_INT(RC522_ERR_NAK, Rc522Drv_Read(&drv, 200, block));  // hors mémoire
+    TEST_ASSERT_EQUAL(PICC_IDLE, sim.cards[0].state);
+    TEST_ASSERT_EQUAL_UINT32(2, drv.ops[RC522_OP_READ].errors);
+
+    Rc522Drv nullDrv;
+    Rc522Drv_Init(&nullDrv, nullptr);
+    TEST_ASSERT_EQUAL_INT(RC522_ERR_IO, Rc522Drv_RequestA(&nullDrv, atqa));
+}
+
+// ---- Benchmark: accès de la bibliothèque MFRC522 (un SPI.transfer par octet, 4 MHz,
+// CRC par le coprocesseur, HLTA attendu jusqu'au timeout) contre le pilote par rafales.
+static void legacyFrame(const uint8_t* tx, uint8_t* rx, size_t len) {
+    sim.calls += (uint32_t)len;
+    simFrame(tx, rx, len);
+}
+static void lWrite(uint8_t reg, uint8_t v) { uint8_t tx[2] = { (uint8_t)(reg << 1), v }; legacyFrame(tx, nullptr, 2); }
+static uint8_t lRead(uint8_t reg) {
+    uint8_t tx[2] = { (uint8_t)(0x80 | (reg << 1)), 0 };
+    uint8_t rx[2];
+    legacyFrame(tx, rx, 2);
+    return rx[1];
+}
+static void lWriteN(uint8_t reg, const uint8_t* data, size_t n) {
+    uint8_t tx[RC522_FIFO_SIZE + 1] = { (uint8_t)(reg << 1) };
+    memcpy(tx + 1, data, n);
+    legacyFrame(tx, nullptr, n + 1);
+}
+static void lReadN(uint8_t reg, uint8_t* out, size_t n) {
+    uint8_t tx[RC522_FIFO_SIZE + 1];
+    uint8_t rx[RC522_FIFO_SIZE + 1];
+    memset(tx, 0x80 | (reg << 1), n);
+    tx[n] = 0;
+    legacyFrame(tx, rx, n + 1);
+    memcpy(out, rx + 1, n);
+}
+static void lClearMask(uint8_t reg, uint8_t mask) { lWrite(reg, (uint8_t)(lRead(reg) & ~mask)); }
+
+static void lCalcCrc(const uint8_t* data, size_t n, uint8_t* out) {
+    lWrite(RC522_REG_COMMAND, RC522_CMD_IDLE);
+    lWrite(RC522_REG_DIV_IRQ, 0x04);
+    lWrite(RC522_REG_FIFO_LEVEL, 0x80);
+    lWriteN(RC522_REG_FIFO_DATA, data, n);
+    lWrite(RC522_REG_COMMAND, RC522_CMD_CALC_CRC);
+    while (!(lRead(RC522_REG_DIV_IRQ) & 0x04)) {}
+    lWrite(RC522_REG_COMMAND, RC522_CMD_IDLE);
+    out[0] = lRead(SIM_REG_CRC_L);
+    out[1] = lRead(SIM_REG_CRC_H);
+}
+
+// PCD_CommunicateWithPICC (Transceive)
+static int lTransceive(const uint8_t* tx, size_t n, uint8_t lastBits, uint8_t* back, size_t backMax, bool checkCrc) {
+    lWrite(RC522_REG_COMMAND, RC522_CMD_IDLE);
+    lWrite(RC522_REG_COM_IRQ, 0x7F);
+    lWrite(RC522_REG_FIFO_LEVEL, 0x80);
+    lWriteN(RC522_REG_FIFO_DATA, tx, n);
+    lWrite(RC522_REG_BIT_FRAMING, lastBits);
+    lWrite(RC522_REG_COMMAND, RC522_CMD_TRANSCEIVE);
+    lWrite(RC522_REG_BIT_FRAMING, (uint8_t)(lRead(RC522_REG_BIT_FRAMING) | 0x80));
+    for (;;) {
+        uint8_t irq = lRead(RC522_REG_COM_IRQ);
+        if (irq & 0x30) break;
+        if (irq & 0x01) return -1;
+    }
+    if (lRead(RC522_REG_ERROR) & 0x13) return -1;
+    int got = 0;
+    if (back) {
+        got = lRead(RC522_REG_FIFO_LEVEL);
+        if ((size_t)got > backMax) return -1;
+        lReadN(RC522_REG_FIFO_DATA, back, (size_t)got);
+        lRead(RC522_REG_CONTROL);
+    }
+    if (checkCrc && got >= 3) {
+        uint8_t crc[2];
+        lCalcCrc(back, (size_t)got - 2, crc);
+    }
+    return got;
+}
+
+static void legacyTap(uint8_t block[16]) {
+    // PICC_IsNewCardPresent
+    lWrite(0x12, 0x00);
+    lWrite(0x13, 0x00);
+    lWrite(0x24, 0x26);
+    lClearMask(RC522_REG_COLL, 0x80);
+    uint8_t req = RC522_PICC_REQA;
+    uint8_t atqa[2];
+    lTransceive(&req, 1, 7, atqa, 2, false);
+    // PICC_ReadCardSerial (UID 4 octets, sans collision)
+    lClearMask(RC522_REG_COLL, 0x80);
+    uint8_t buf[9] = { RC522_PICC_SEL_CL1, 0x20 };
+    uint8_t rx[5];
+    lWrite(RC522_REG_BIT_FRAMING, 0x00);
+    lTransceive(buf, 2, 0, rx, 5, false);
+    memcpy(buf + 2, rx, 5);
+    buf[1] = 0x70;
+    lCalcCrc(buf, 7, buf + 7);
+    lWrite(RC522_REG_BIT_FRAMING, 0x00);
+    uint8_t sak[3];
+    lTransceive(buf, 9, 0, sak, 3, false);
+    uint8_t crc[2];
+    lCalcCrc(sak, 1, crc);
+    // MIFARE_Read
+    uint8_t cmd[4] = { RC522_PICC_READ, 4 };
+    uint8_t back[18];
+    lCalcCrc(cmd, 2, cmd + 2);
+    lTransceive(cmd, 4, 0, back, sizeof(back), true);
+    memcpy(block, back, 16);
+    // PICC_HaltA: attendu jusqu'au timeout
+    uint8_t hlta[4] = { RC522_PICC_HLTA, 0x00 };
+    lCalcCrc(hlta, 2, hlta + 2);
+    lTransceive(hlta, 4, 0, nullptr, 0, false);
+}
+
+static void burstTap(uint8_t block[16]) {
+    uint8_t atqa[2];
+    Rc522Uid uid;
+    Rc522Drv_RequestA(&drv, atqa);
+    Rc522Drv_Select(&drv, &uid);
+    Rc522Drv_Read(&drv, 4, block);
+    Rc522Drv_HaltA(&drv);
+}
+
+// Modèle de temps SPI (ESP32, Arduino): par transaction (CS, beginTransaction) + par appel
+// au pilote + bits à l'horloge. RF: 106 kbit/s (9,44 us/bit avec parité) + FDT ~90 us.
+static double spiUs(uint32_t frames, uint32_t calls, uint32_t bytes, double mhz) {
+    return frames * 2.0 + calls * 1.0 + bytes * 8.0 / mhz;
+}
+static double rfUs() {
+    return sim.rfBits * 9.44 + sim.rfExchanges * 90.0 + sim.timeouts * 25000.0;
+}
+
+void test_bench_per_operation() {
+    const uint8_t uid[4] = { 0x12, 0x34, 0x56, 0x78 };
+    uint8_t a[16], b[16];
+
+    setUp();
+    simAddCard(uid, 4, 0x08);
+    legacyTap(a);
+    uint32_t lFrames = sim.frames, lCalls = sim.calls, lBytes = sim.bytes;
+    double lSpi = spiUs(lFrames, lCalls, lBytes, 4.0);
+    double lRf = rfUs();
+
+    setUp();
+    simAddCard(uid, 4, 0x08);
+    burstTap(b);
+    TEST_ASSERT_EQUAL_MEMORY(a, b, 16);
+    double bSpi = spiUs(sim.frames, sim.calls, sim.bytes, 10.0);
+    double bRf = rfUs();
+
+    printf("[BENCH] rc522_drv tap REQA+SELECT+READ+HALT: MFRC522 %lu trames, %lu appels, %lu o, SPI %.0f us, total %.1f ms"
+           " | rafales %lu trames, %lu o, SPI %.0f us, total %.1f ms\n",
+           (unsigned long)lFrames, (unsigned long)lCalls, (unsigned long)lBytes, lSpi, (lSpi + lRf) / 1000.0,
+           (unsigned long)sim.frames, (unsigned long)sim.bytes, bSpi, (bSpi + bRf) / 1000.0);
+    for (int op = 0; op < RC522_OP_COUNT; op++) {
+        const Rc522OpStats* s = &drv.ops[op];
+        if (s->calls == 0) continue;
+        printf("[BENCH] rc522_drv   %-10s %2lu trames %3lu o, SPI %.0f us\n",
+               Rc522Drv_OpName((Rc522Op)op), (unsigned long)s->transactions, (unsigned long)s->bytes,
+               spiUs(s->transactions, s->transactions, s->bytes, 10.0));
+    }
+    TEST_ASSERT_TRUE(sim.frames < lFrames);
+    TEST_ASSERT_TRUE(bSpi * 2 < lSpi);
+    TEST_ASSERT_TRUE(bSpi + bRf < lSpi + lRf);
+
+    // FAST_READ 60 octets: FIFO lue en une trame
+    setUp();
+    simAddCard(uid, 4, 0x00);
+    burstTap(b);
+    Rc522Drv_WakeupA(&drv, (uint8_t*)a);
+    Rc522Uid out;
+    Rc522Drv_Select(&drv, &out);
+    uint32_t before = drv.transactions;
+    uint8_t cmd[3] = { 0x3A, 4, 18 };
+    uint8_t data[60];
+    TEST_ASSERT_EQUAL_INT(60, Rc522Drv_TransceiveCrc(&drv, cmd, 3, data, sizeof(data)));
+    printf("[BENCH] rc522_drv   FAST_READ 60 o: %lu trames (MFRC522: 61 appels pour la seule FIFO)\n",
+           (unsigned long)(drv.transactions - before));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests accès registres
+    RUN_TEST(test_crc_a_vectors);
+    RUN_TEST(test_bursts_are_single_transactions);
+
+    // Tests échanges ISO 14443-A
+    RUN_TEST(test_reqa_select_read_halt);
+    RUN_TEST(test_cascade_levels);
+    RUN_TEST(test_anticollision_two_cards);
+    RUN_TEST(test_errors);
+
+    // Benchmark
+    RUN_TEST(test_bench_per_operation);
+    return UNITY_END();
+}
@@ -0,0 +1,63 @@
+#include "../../include/rc522_irq.h"
+
+uint8_t Rc522Irq_Read(Rc522Bus* bus, uint8_t reg) {
+  if (!bus || !bus->read) return 0;
+  bus->transfers++;
+  return bus->read(bus->ctx, reg);
+}
+
+void Rc522Irq_Write(Rc522Bus* bus, uint8_t reg, uint8_t value) {
+  if (!bus || !bus->write) return;
+  bus->transfers++;
+  bus->write(bus->ctx, reg, value);
+}
+
+void Rc522Irq_Enable(Rc522Bus* bus) {
+  Rc522Irq_Write(bus, RC522_REG_COM_IEN, RC522_COM_IRQ_INV | RC522_COM_RX_IRQ);
+  Rc522Irq_Write(bus, RC522_REG_DIV_IEN, RC522_DIV_IRQ_PUSHPULL);
+}
+
+void Rc522Irq_Disable(Rc522Bus* bus) {
+  Rc522Irq_Write(bus, RC522_REG_COM_IEN, RC522_COM_IRQ_INV);
+  Rc522Irq_Write(bus, RC522_REG_DIV_IEN, 0x00);
+}
+
+void Rc522Irq_Clear(Rc522Bus* bus) {
+  // Set1/Set2 = 0: les bits à 1 sont remis à zéro
+  Rc522Irq_Write(bus, RC522_REG_COM_IRQ, 0x7F);
+  Rc522Irq_Write(bus, RC522_REG_DIV_IRQ, 0x7F);
+}
+
+void Rc522Irq_ArmReqa(Rc522Bus* bus) {
+  Rc522Irq_Write(bus, RC522_REG_COMMAND, RC522_CMD_IDLE);
+  Rc522Irq_Write(bus, RC522_REG_COM_IRQ, 0x7F);
+  Rc522Irq_Write(bus, RC522_REG_FIFO_LEVEL, 0x80);   // FlushBuffer
+  Rc522Irq_Write(bus, RC522_REG_FIFO_DATA, RC522_PICC_REQA);
+  Rc522Irq_Write(bus, RC522_REG_COMMAND, RC522_CMD_TRANSCEIVE);
+  Rc522Irq_Write(bus, RC522_REG_BIT_FRAMING, 0x87);  // StartSend, 7 bits (trame courte)
+}
+
+bool Rc522Irq_CardResponded(Rc522Bus* bus) {
+  uint8_t irq = Rc522Irq_Read(bus, RC522_REG_COM_IRQ);
+  if (!(irq & RC522_COM_RX_IRQ)) return false;
+  if (!(irq & RC522_COM_ERR_IRQ)) return true;
+  // Collision (plusieurs cartes) acceptée: l'anticollision la résout ensuite
+  uint8_t err = Rc522Irq_Read(bus, RC522_REG_ERROR);
+  return (err & 0x13) == 0;  // BufferOvfl, ParityErr, ProtocolErr
+}
+
+void Rc522Irq_ProbeBegin(Rc522Bus* bus) {
+  Rc522Irq_Write(bus, RC522_REG_COMMAND, RC522_CMD_IDLE);
+  Rc522Irq_Clear(bus);
+  Rc522Irq_Write(bus, RC522_REG_COM_IEN, RC522_COM_IRQ_INV);
+  Rc522Irq_Write(bus, RC522_REG_DIV_IEN, RC522_DIV_IRQ_PUSHPULL | RC522_DIV_CRC_IRQ);
+  Rc522Irq_Write(bus, RC522_REG_FIFO_LEVEL, 0x80);
+  Rc522Irq_Write(bus, RC522_REG_FIFO_DATA, 0x00);
+  Rc522Irq_Write(bus, RC522_REG_COMMAND, RC522_CMD_CALC_CRC);
+}
+
+void Rc522Irq_ProbeEnd(Rc522Bus* bus) {
+  Rc522Irq_Write(bus, RC522_REG_COMMAND, RC522_CMD_IDLE);
+  Rc522Irq_Write(bus, RC522_REG_DIV_IEN, RC522_DIV_IRQ_PUSHPULL);
+  Rc522Irq_Clear(bus);
+}
@@ -0,0 +1,117 @@
+#include <unity.h>
+#include "../../include/rc522_irq.h"
+#include <string.h>
+
+// Registres simulés et journal des écritures
+typedef struct {
+  uint8_t regs[64];
+  uint8_t log[32][2];
+  int logCount;
+  uint8_t fifo[8];
+  int fifoCount;
+} FakeRc522;
+
+static FakeRc522 fake;
+static Rc522Bus bus;
+
+static uint8_t fakeRead(void* ctx, uint8_t reg) {
+  return ((FakeRc522*)ctx)->regs[reg & 0x3F];
+}
+
+static void fakeWrite(void* ctx, uint8_t reg, uint8_t value) {
+  FakeRc522* f = (FakeRc522*)ctx;
+  if (f->logCount < 32) {
+    f->log[f->logCount][0] = reg;
+    f->log[f->logCount][1] = value;
+    f->logCount++;
+  }
+  if (reg == RC522_REG_FIFO_DATA && f->fifoCount < 8) f->fifo[f->fifoCount++] = value;
+  if (reg == RC522_REG_FIFO_LEVEL && (value & 0x80)) f->fifoCount = 0;
+  f->regs[reg & 0x3F] = value;
+}
+
+void setUp(void) {
+  memset(&fake, 0, sizeof(fake));
+  memset(&bus, 0, sizeof(bus));
+  bus.read = fakeRead;
+  bus.write = fakeWrite;
+  bus.ctx = &fake;
+}
+
+void tearDown(void) {}
+
+// Tests configuration IRQ
+void test_enable_rx_irq_push_pull() {
+  Rc522Irq_Enable(&bus);
+  TEST_ASSERT_EQUAL_HEX8(0xA0, fake.regs[RC522_REG_COM_IEN]);
+  TEST_ASSERT_EQUAL_HEX8(0x80, fake.regs[RC522_REG_DIV_IEN]);
+
+  Rc522Irq_Disable(&bus);
+  TEST_ASSERT_EQUAL_HEX8(0x80, fake.regs[RC522_REG_COM_IEN]);
+  TEST_ASSERT_EQUAL_HEX8(0x00, fake.regs[RC522_REG_DIV_IEN]);
+  TEST_ASSERT_EQUAL_UINT32(4, bus.transfers);
+}
+
+// Tests armement REQA
+void test_arm_reqa_sequence() {
+  fake.fifoCount = 3;  // restes d'une commande précédente
+  Rc522Irq_ArmReqa(&bus);
+
+  TEST_ASSERT_EQUAL_INT(1, fake.fifoCount);
+  TEST_ASSERT_EQUAL_HEX8(RC522_PICC_REQA, fake.fifo[0]);
+  // Transceive lancé avant StartSend, qui doit être la dernière écriture
+  TEST_ASSERT_EQUAL_HEX8(RC522_REG_COMMAND, fake.log[fake.logCount - 2][0]);
+  TEST_ASSERT_EQUAL_HEX8(RC522_CMD_TRANSCEIVE, fake.log[fake.logCount - 2][1]);
+  TEST_ASSERT_EQUAL_HEX8(RC522_REG_BIT_FRAMING, fake.log[fake.logCount - 1][0]);
+  TEST_ASSERT_EQUAL_HEX8(0x87, fake.log[fake.logCount - 1][1]);
+  // Aucune lecture: pas d'attente active de la réponse
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)fake.logCount, bus.transfers);
+  TEST_ASSERT_TRUE(bus.transfers <= 6);
+}
+
+void test_card_responded() {
+  fake.regs[RC522_REG_COM_IRQ] = RC522_COM_TIMER_IRQ;
+  TEST_ASSERT_FALSE(Rc522Irq_CardResponded(&bus));
+
+  fake.regs[RC522_REG_COM_IRQ] = RC522_COM_RX_IRQ;
+  TEST_ASSERT_TRUE(Rc522Irq_CardResponded(&bus));
+
+  // Collision: acceptée, l'anticollision la résout
+  fake.regs[RC522_REG_COM_IRQ] = RC522_COM_RX_IRQ | RC522_COM_ERR_IRQ;
+  fake.regs[RC522_REG_ERROR] = 0x08;
+  TEST_ASSERT_TRUE(Rc522Irq_CardResponded(&bus));
+
+  fake.regs[RC522_REG_ERROR] = 0x02;  // ParityErr
+  TEST_ASSERT_FALSE(Rc522Irq_CardResponded(&bus));
+}
+
+// Tests auto-test de câblage
+void test_probe_enables_crc_irq_then_restores() {
+  Rc522Irq_ProbeBegin(&bus);
+  TEST_ASSERT_EQUAL_HEX8(0x84, fake.regs[RC522_REG_DIV_IEN]);
+  TEST_ASSERT_EQUAL_HEX8(RC522_CMD_CALC_CRC, fake.regs[RC522_REG_COMMAND]);
+
+  Rc522Irq_ProbeEnd(&bus);
+  TEST_ASSERT_EQUAL_HEX8(0x80, fake.regs[RC522_REG_DIV_IEN]);
+  TEST_ASSERT_EQUAL_HEX8(RC522_CMD_IDLE, fake.regs[RC522_REG_COMMAND]);
+  TEST_ASSERT_EQUAL_HEX8(0x7F, fake.regs[RC522_REG_DIV_IRQ]);
+}
+
+void test_null_bus_is_safe() {
+  Rc522Irq_ArmReqa(NULL);
+  TEST_ASSERT_FALSE(Rc522Irq_CardResponded(NULL));
+  Rc522Bus empty;
+  memset(&empty, 0, sizeof(empty));
+  TEST_ASSERT_EQUAL_HEX8(0, Rc522Irq_Read(&empty, RC522_REG_COM_IRQ));
+  TEST_ASSERT_EQUAL_UINT32(0, empty.transfers);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_enable_rx_irq_push_pull);
+  RUN_TEST(test_arm_reqa_sequence);
+  RUN_TEST(test_card_responded);
+  RUN_TEST(test_probe_enables_crc_irq_then_restores);
+  RUN_TEST(test_null_bus_is_safe);
+  return UNITY_END();
+}
@@ -0,0 +1,109 @@
+#include <unity.h>
+#include "../../include/uart_baud.h"
+#include <string.h>
+
+static UartBaudState st;
+
+void setUp(void) {
+    UartBaud_Init(&st, 115200, 2000000);
+}
+void tearDown(void) {}
+
+// Tests sélection des candidats
+void test_candidates_descend_after_failures() {
+    TEST_ASSERT_EQUAL_UINT32(2000000, UartBaud_NextCandidate(&st));
+    UartBaud_OnUpgradeFailed(&st, 2000000);
+    TEST_ASSERT_EQUAL_UINT32(921600, UartBaud_NextCandidate(&st));
+    UartBaud_OnUpgradeFailed(&st, 921600);
+    UartBaud_OnUpgradeFailed(&st, 460800);
+    TEST_ASSERT_EQUAL_UINT32(230400, UartBaud_NextCandidate(&st));
+    UartBaud_OnUpgradeFailed(&st, 230400);
+    TEST_ASSERT_EQUAL_UINT32(0, UartBaud_NextCandidate(&st));
+}
+
+void test_candidates_respect_ceiling() {
+    UartBaud_Init(&st, 115200, 921600);
+    TEST_ASSERT_EQUAL_UINT32(921600, UartBaud_NextCandidate(&st));
+    UartBaud_OnUpgradeSucceeded(&st, 921600);
+    TEST_ASSERT_EQUAL_UINT32(0, UartBaud_NextCandidate(&st));
+    TEST_ASSERT_EQUAL_UINT32(1, st.upgrades);
+}
+
+// Tests lignes de négociation
+void test_proposal_and_accept() {
+    char line[32];
+    TEST_ASSERT_GREATER_THAN(0, UartBaud_FormatProposal(line, sizeof(line), 921600));
+    TEST_ASSERT_EQUAL_STRING("BAUD?:921600", line);
+    TEST_ASSERT_TRUE(UartBaud_IsAccept("BAUD_OK:921600", 921600));
+    TEST_ASSERT_FALSE(UartBaud_IsAccept("BAUD_OK:460800", 921600));
+    TEST_ASSERT_FALSE(UartBaud_IsAccept("ERR:UNKNOWN_CMD", 921600));
+    TEST_ASSERT_EQUAL(0, UartBaud_FormatProposal(line, 8, 921600));
+}
+
+void test_training_line_check() {
+    char line[40];
+    TEST_ASSERT_GREATER_THAN(0, UartBaud_FormatTrainingLine(line, sizeof(line), 3));
+    TEST_ASSERT_TRUE(UartBaud_CheckTrainingLine(line, 3));
+    TEST_ASSERT_FALSE(UartBaud_CheckTrainingLine(line, 4));
+    line[strlen(line) - 2] ^= 0x01; // bit retourné
+    TEST_ASSERT_FALSE(UartBaud_CheckTrainingLine(line, 3));
+}
+
+void test_training_threshold() {
+    TEST_ASSERT_TRUE(UartBaud_TrainingPassed(UART_BAUD_TRAIN_LINES, UART_BAUD_TRAIN_LINES));
+    TEST_ASSERT_EQUAL(UART_BAUD_TRAIN_MAX_ERRORS == 0 ? 0 : 1,
+                      UartBaud_TrainingPassed(UART_BAUD_TRAIN_LINES - 1, UART_BAUD_TRAIN_LINES));
+    TEST_ASSERT_FALSE(UartBaud_TrainingPassed(0, 0));
+}
+
+// Tests repli en service
+void test_error_burst_triggers_downgrade() {
+    UartBaud_OnUpgradeSucceeded(&st, 921600);
+    uint32_t now = 1000;
+    for (int i = 0; i < UART_BAUD_ERROR_THRESHOLD - 1; i++) {
+        TEST_ASSERT_FALSE(UartBaud_RecordError(&st, UART_BAUD_ERR_CRC, now++));
+    }
+    TEST_ASSERT_TRUE(UartBaud_RecordError(&st, UART_BAUD_ERR_FRAMING, now));
+    UartBaud_OnDowngrade(&st);
+    TEST_ASSERT_EQUAL_UINT32(115200, st.currentBaud);
+    TEST_ASSERT_EQUAL_UINT32(1, st.downgrades);
+    // Le débit défaillant n'est plus reproposé
+    TEST_ASSERT_EQUAL_UINT32(460800, UartBaud_NextCandidate(&st));
+}
+
+void test_sparse_errors_do_not_downgrade() {
+    UartBaud_OnUpgradeSucceeded(&st, 921600);
+    uint32_t now = 0;
+    for (int i = 0; i < 3 * UART_BAUD_ERROR_THRESHOLD; i++) {
+        TEST_ASSERT_FALSE(UartBaud_RecordError(&st, UART_BAUD_ERR_CRC, now));
+        now += UART_BAUD_ERROR_WINDOW_MS / 2 + 1;
+    }
+    TEST_ASSERT_EQUAL_UINT32(3 * UART_BAUD_ERROR_THRESHOLD, st.crcErrors);
+}
+
+void test_no_downgrade_at_base_rate() {
+    for (int i = 0; i < 2 * UART_BAUD_ERROR_THRESHOLD; i++) {
+        TEST_ASSERT_FALSE(UartBaud_RecordError(&st, UART_BAUD_ERR_FRAMING, 10));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2 * UART_BAUD_ERROR_THRESHOLD, st.framingErrors);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests sélection des candidats
+    RUN_TEST(test_candidates_descend_after_failures);
+    RUN_TEST(test_candidates_respect_ceiling);
+
+    // Tests lignes de négociation
+    RUN_TEST(test_proposal_and_accept);
+    RUN_TEST(test_training_line_check);
+    RUN_TEST(test_training_threshold);
+
+    // Tests repli en service
+    RUN_TEST(test_error_burst_triggers_downgrade);
+    RUN_TEST(test_sparse_errors_do_not_downgrade);
+    RUN_TEST(test_no_downgrade_at_base_rate);
+
+    return UNITY_END();
+}
@@ -0,0 +1,231 @@
+#include <unity.h>
+#include "../../include/uart_frame.h"
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static UartFrame makeData(uint8_t seq, const char* text) {
+    UartFrame f = {};
+    f.type = UART_FRAME_TYPE_DATA;
+    f.seq = seq;
+    f.len = (uint8_t)strlen(text);
+    memcpy(f.payload, text, f.len);
+    return f;
+}
+
+// Tests CRC
+void test_crc16_check_value() {
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, UartFrame_Crc16(data, sizeof(data)));
+}
+
+// Tests COBS
+void test_cobs_roundtrip_with_zeros() {
+    const uint8_t in[] = {0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+    uint8_t enc[16];
+    uint8_t dec[16];
+    size_t n = UartFrame_CobsEncode(in, sizeof(in), enc, sizeof(enc));
+    TEST_ASSERT_EQUAL(sizeof(in) + 1, n);
+    for (size_t i = 0; i < n; i++) TEST_ASSERT_NOT_EQUAL(0x00, enc[i]);
+    TEST_ASSERT_EQUAL(sizeof(in), UartFrame_CobsDecode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_MEMORY(in, dec, sizeof(in));
+}
+
+void test_cobs_long_run() {
+    uint8_t in[300];
+    for (size_t i = 0; i < sizeof(in); i++) in[i] = (uint8_t)(i % 255 + 1);
+    uint8_t enc[310];
+    uint8_t dec[300];
+    size_t n = UartFrame_CobsEncode(in, sizeof(in), enc, sizeof(enc));
+    TEST_ASSERT_GREATER_THAN(sizeof(in), n);
+    TEST_ASSERT_EQUAL(sizeof(in), UartFrame_CobsDecode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_MEMORY(in, dec, sizeof(in));
+
+    // Buffer de sortie trop petit
+    TEST_ASSERT_EQUAL(0, UartFrame_CobsEncode(in, sizeof(in), enc, 100));
+}
+
+// Tests trames
+void test_frame_roundtrip_through_stream_decoder() {
+    UartFrame f = makeData(7, "VEND 3 1 prod_42");
+    f.ack = 5;
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    size_t n = UartFrame_Encode(&f, wire, sizeof(wire));
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_EQUAL_HEX8(0x00, wire[n - 1]);
+
+    UartFrameDecoder dec;
+    UartFrameDecoder_Init(&dec);
+    UartFrame out = {};
+    UartFrameStatus st = UART_FRAME_NONE;
+    for (size_t i = 0; i < n; i++) st = UartFrameDecoder_Push(&dec, wire[i], &out);
+    TEST_ASSERT_EQUAL(UART_FRAME_OK, st);
+    TEST_ASSERT_EQUAL(7, out.seq);
+    TEST_ASSERT_EQUAL(5, out.ack);
+    TEST_ASSERT_EQUAL(f.len, out.len);
+    TEST_ASSERT_EQUAL_MEMORY(f.payload, out.payload, f.len);
+}
+
+void test_frame_corruption_detected() {
+    UartFrame f = makeData(1, "VEND 1 2 prod_1");
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    size_t n = UartFrame_Encode(&f, wire, sizeof(wire));
+    // Un chiffre de slot corrompu ('1' -> '7') ne doit pas passer
+    for (size_t i = 0; i < n; i++) {
+        if (wire[i] == '1') { wire[i] = '7'; break; }
+    }
+    UartFrame out = {};
+    TEST_ASSERT_EQUAL(UART_FRAME_ERR_CRC, UartFrame_Decode(wire, n - 1, &out));
+}
+
+void test_decoder_overflow_resync() {
+    UartFrameDecoder dec;
+    UartFrameDecoder_Init(&dec);
+    UartFrame out = {};
+    for (size_t i = 0; i < UART_FRAME_ENCODED_MAX + 10; i++) {
+        TEST_ASSERT_EQUAL(UART_FRAME_NONE, UartFrameDecoder_Push(&dec, 0x41, &out));
+    }
+    TEST_ASSERT_EQUAL(UART_FRAME_ERR_OVERFLOW, UartFrameDecoder_Push(&dec, 0x00, &out));
+
+    // Le décodeur repart proprement sur la trame suivante
+    UartFrame f = makeData(0, "ORDER_ACK");
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    size_t n = UartFrame_Encode(&f, wire, sizeof(wire));
+    UartFrameStatus st = UART_FRAME_NONE;
+    for (size_t i = 0; i < n; i++) st = UartFrameDecoder_Push(&dec, wire[i], &out);
+    TEST_ASSERT_EQUAL(UART_FRAME_OK, st);
+}
+
+// Tests fenêtre glissante
+void test_link_window_full() {
+    UartFrameLink link;
+    UartFrameLink_Init(&link);
+    const uint8_t p[] = "X";
+    for (int i = 0; i < UART_FRAME_WINDOW_SIZE; i++) {
+        TEST_ASSERT_TRUE(UartFrameLink_Send(&link, p, 1));
+    }
+    TEST_ASSERT_FALSE(UartFrameLink_Send(&link, p, 1));
+    TEST_ASSERT_EQUAL(UART_FRAME_WINDOW_SIZE, UartFrameLink_InFlight(&link));
+}
+
+void test_link_exchange_and_cumulative_ack() {
+    UartFrameLink esp, nucleo;
+    UartFrameLink_Init(&esp);
+    UartFrameLink_Init(&nucleo);
+    const char* lines[] = {"ORDER_START:o1", "VEND 1 2 p1", "ORDER_END"};
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(UartFrameLink_Send(&esp, (const uint8_t*)lines[i], strlen(lines[i])));
+    }
+
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    UartFrame f = {};
+    int delivered = 0;
+    size_t n;
+    while ((n = UartFrameLink_Poll(&esp, 10, wire, sizeof(wire))) > 0) {
+        TEST_ASSERT_EQUAL(UART_FRAME_OK, UartFrame_Decode(wire, n - 1, &f));
+        if (UartFrameLink_OnFrame(&nucleo, &f)) {
+            TEST_ASSERT_EQUAL_MEMORY(lines[delivered], f.payload, strlen(lines[delivered]));
+            delivered++;
+        }
+    }
+    TEST_ASSERT_EQUAL(3, delivered);
+
+    // Un seul ACK cumulatif vide la fenêtre de l'ESP32
+    n = UartFrameLink_Poll(&nucleo, 11, wire, sizeof(wire));
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_EQUAL(UART_FRAME_OK, UartFrame_Decode(wire, n - 1, &f));
+    TEST_ASSERT_EQUAL(UART_FRAME_TYPE_ACK, f.type);
+    TEST_ASSERT_FALSE(UartFrameLink_OnFrame(&esp, &f));
+    TEST_ASSERT_EQUAL(0, UartFrameLink_InFlight(&esp));
+}
+
+void test_link_retransmit_and_duplicate() {
+    UartFrameLink esp, nucleo;
+    UartFrameLink_Init(&esp);
+    UartFrameLink_Init(&nucleo);
+    TEST_ASSERT_TRUE(UartFrameLink_Send(&esp, (const uint8_t*)"ORDER_END", 9));
+
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    UartFrame f = {};
+    size_t n = UartFrameLink_Poll(&esp, 100, wire, sizeof(wire));
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_EQUAL(0, UartFrameLink_Poll(&esp, 100 + UART_FRAME_RETX_TIMEOUT_MS - 1, wire, sizeof(wire)));
+
+    // ACK perdu: la trame est réémise après le timeout
+    TEST_ASSERT_EQUAL(UART_FRAME_OK, UartFrame_Decode(wire, n - 1, &f));
+    TEST_ASSERT_TRUE(UartFrameLink_OnFrame(&nucleo, &f));
+    n = UartFrameLink_Poll(&esp, 100 + UART_FRAME_RETX_TIMEOUT_MS, wire, sizeof(wire));
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_EQUAL(1, esp.retransmits);
+
+    // Le doublon n'est pas relivré mais reste acquitté
+    TEST_ASSERT_EQUAL(UART_FRAME_OK, UartFrame_Decode(wire, n - 1, &f));
+    TEST_ASSERT_FALSE(UartFrameLink_OnFrame(&nucleo, &f));
+    TEST_ASSERT_EQUAL(1, nucleo.duplicates);
+    TEST_ASSERT_TRUE(nucleo.ackPending);
+}
+
+void test_link_fails_after_max_retries() {
+    UartFrameLink esp;
+    UartFrameLink_Init(&esp);
+    TEST_ASSERT_TRUE(UartFrameLink_Send(&esp, (const uint8_t*)"PING", 4));
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    uint32_t now = 1;
+    for (int i = 0; i <= UART_FRAME_MAX_RETRIES; i++) {
+        TEST_ASSERT_GREATER_THAN(0, UartFrameLink_Poll(&esp, now, wire, sizeof(wire)));
+        now += UART_FRAME_RETX_TIMEOUT_MS;
+    }
+    TEST_ASSERT_EQUAL(0, UartFrameLink_Poll(&esp, now, wire, sizeof(wire)));
+    TEST_ASSERT_TRUE(esp.failed);
+}
+
+void test_link_take_unacked_in_order() {
+    // Repli texte: les lignes jamais acquittées sont récupérées dans l'ordre d'envoi
+    UartFrameLink esp;
+    UartFrameLink_Init(&esp);
+    const char* lines[] = {"ORDER_START:o1", "VEND 1 2 p1", "VEND 2 1 p2", "ORDER_END"};
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(UartFrameLink_Send(&esp, (const uint8_t*)lines[i], strlen(lines[i])));
+    }
+    // ORDER_START déjà acquitté par la NUCLEO
+    UartFrame ack = {};
+    ack.type = UART_FRAME_TYPE_ACK;
+    ack.ack = 1;
+    UartFrameLink_OnFrame(&esp, &ack);
+
+    uint8_t out[UART_FRAME_MAX_PAYLOAD];
+    size_t len = 0;
+    uint8_t small[4];
+    TEST_ASSERT_FALSE(UartFrameLink_TakeUnacked(&esp, small, sizeof(small), &len));
+    for (int i = 1; i < 4; i++) {
+        TEST_ASSERT_TRUE(UartFrameLink_TakeUnacked(&esp, out, sizeof(out), &len));
+        TEST_ASSERT_EQUAL(strlen(lines[i]), len);
+        TEST_ASSERT_EQUAL_MEMORY(lines[i], out, len);
+    }
+    TEST_ASSERT_FALSE(UartFrameLink_TakeUnacked(&esp, out, sizeof(out), &len));
+    TEST_ASSERT_EQUAL(0, UartFrameLink_InFlight(&esp));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests CRC / COBS
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_cobs_roundtrip_with_zeros);
+    RUN_TEST(test_cobs_long_run);
+
+    // Tests trames
+    RUN_TEST(test_frame_roundtrip_through_stream_decoder);
+    RUN_TEST(test_frame_corruption_detected);
+    RUN_TEST(test_decoder_overflow_resync);
+
+    // Tests fenêtre glissante
+    RUN_TEST(test_link_window_full);
+    RUN_TEST(test_link_exchange_and_cumulative_ack);
+    RUN_TEST(test_link_retransmit_and_duplicate);
+    RUN_TEST(test_link_fails_after_max_retries);
+    RUN_TEST(test_link_take_unacked_in_order);
+
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+#include <unity.h>
+#include "../../include/uart_line.h"
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// Compteur d'allocations heap (benchmark)
+static size_t heapAllocs = 0;
+void* operator new(size_t n) {
+    heapAllocs++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static UartLineAssembler lineAsm;
+
+void setUp(void) {
+    UartLine_Init(&lineAsm);
+}
+void tearDown(void) {}
+
+// Pousse tout le flux et copie les lignes livrées dans 'out' séparées par '|'
+static int feedAll(const char* stream, std::string& out) {
+    const uint8_t* p = (const uint8_t*)stream;
+    size_t rem = strlen(stream);
+    int lines = 0;
+    while (rem > 0) {
+        const char* line;
+        size_t len;
+        size_t used = UartLine_Push(&lineAsm, p, rem, &line, &len);
+        p += used;
+        rem -= used;
+        if (line) {
+            out.append(line, len);
+            out += '|';
+            lines++;
+        }
+    }
+    return lines;
+}
+
+// Tests assemblage
+void test_crlf_and_empty_lines() {
+    std::string out;
+    TEST_ASSERT_EQUAL(2, feedAll("ORDER_ACK\r\n\r\nVEND_COMPLETED:1\n", out));
+    TEST_ASSERT_EQUAL_STRING("ORDER_ACK|VEND_COMPLETED:1|", out.c_str());
+}
+
+void test_line_split_across_chunks() {
+    const char* line;
+    size_t len;
+    TEST_ASSERT_EQUAL(6, UartLine_Push(&lineAsm, (const uint8_t*)"STATE:", 6, &line, &len));
+    TEST_ASSERT_NULL(line);
+    TEST_ASSERT_EQUAL(7, UartLine_Push(&lineAsm, (const uint8_t*)"PAYING\nX", 8, &line, &len));
+    TEST_ASSERT_NOT_NULL(line);
+    TEST_ASSERT_EQUAL(12, len);
+    TEST_ASSERT_EQUAL_STRING("STATE:PAYING", line);
+}
+
+void test_overlong_line_dropped() {
+    std::string stream(UART_LINE_MAX + 10, 'A');
+    stream += "\nORDER_ACK\n";
+    std::string out;
+    TEST_ASSERT_EQUAL(1, feedAll(stream.c_str(), out));
+    TEST_ASSERT_EQUAL_STRING("ORDER_ACK|", out.c_str());
+    TEST_ASSERT_EQUAL(1, lineAsm.overflows);
+}
+
+// Tests classification
+void test_classify_prefixes() {
+    size_t off;
+    TEST_ASSERT_EQUAL(UART_MSG_SUPERVISION_ERROR, UartLine_Classify("SUPERVISION_ERROR:{}", 20, &off));
+    TEST_ASSERT_EQUAL(18, off);
+    TEST_ASSERT_EQUAL(UART_MSG_VEND_FAILED, UartLine_Classify("VEND_FAILED:2:JAM", 17, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_DELIVERY_COMPLETED, UartLine_Classify("DELIVERY_COMPLETED", 18, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_ORDER_NAK, UartLine_Classify("ORDER_NAK:BUSY", 14, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_BAUD_OK, UartLine_Classify("BAUD_OK:921600", 14, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_UNKNOWN, UartLine_Classify("STATE:PAYING", 12, &off));
+    TEST_ASSERT_EQUAL(0, off);
+    TEST_ASSERT_EQUAL(UART_MSG_UNKNOWN, UartLine_Classify("VEND", 4, &off));
+}
+
+void test_classify_exact_matches() {
+    size_t off;
+    TEST_ASSERT_EQUAL(UART_MSG_PROTO_TEXT, UartLine_Classify("PROTO:TEXT", 10, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_UNKNOWN, UartLine_Classify("PROTO:TEXTX", 11, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_BAUD_RESET, UartLine_Classify("BAUD_RESET", 10, &off));
+    TEST_ASSERT_EQUAL(UART_MSG_PROTO_OFFER_BIN, UartLine_Classify("PROTO?:BIN1", 11, &off));
+}
+
+// ---- Benchmark: trafic NUCLEO enregistré ----
+
+static const char* const recordedTraffic[] = {
+    "STATE:PAYING\r\n",
+    "ORDER_ACK\r\n",
+    "VEND_COMPLETED:1\r\n",
+    "VEND_COMPLETED:1\r\n",
+    "VEND_FAILED:2:MOTOR_JAM\r\n",
+    "VEND_COMPLETED:3\r\n",
+    "DELIVERY_COMPLETED\r\n",
+    "SUPERVISION_ERROR:{\"code\":\"MOTOR_JAM\",\"slot\":2,\"detail\":\"timeout 3000ms\"}\r\n",
+    "STATE:IDLE\r\n",
+};
+
+static std::string buildTraffic(int repeat) {
+    std::string s;
+    for (int r = 0; r < repeat; r++) {
+        for (const char* l : recordedTraffic) s += l;
+    }
+    return s;
+}
+
+// Ancien chemin: String qui grossit octet par octet, copies de masquage, chaîne de startsWith
+static size_t legacyMask(const std::string& data, size_t visible, std::string& out) {
+    if (data.size() <= visible) { out = data; return out.size(); }
+    out = data.substr(0, visible);
+    for (size_t i = visible; i < data.size(); i++) out += "*";
+    return out.size();
+}
+
+static int legacyDispatch(const std::string& line) {
+    std::string maskedLine = line;
+    if (line.rfind("STATE:PAYING", 0) == 0) legacyMask(line, 12, maskedLine);
+    static const char* chain[] = {"DELIVERY_COMPLETED", "DELIVERY_FAILED", "ORDER_ACK", "ORDER_NAK",
+                                  "VEND_COMPLETED", "VEND_FAILED", "SUPERVISION_ERROR:"};
+    for (int i = 0; i < 7; i++) {
+        if (line.rfind(chain[i], 0) == 0) {
+            if (i == 6) {
+                std::string payload = line.substr(18);
+                return (int)payload.size() + i;
+            }
+            return i + (int)maskedLine.size();
+        }
+    }
+    return (int)maskedLine.size();
+}
+
+static long legacyRun(const std::string& traffic) {
+    long sink = 0;
+    std::string buffer;
+    buffer.reserve(128);
+    for (char c : traffic) {
+        if (c == '\n' || c == '\r') {
+            if (!buffer.empty()) {
+                std::string masked;
+                sink += (long)legacyMask(buffer, 10, masked);
+                sink += legacyDispatch(buffer);
+                buffer = "";
+            }
+        } else {
+            buffer += c;
+        }
+    }
+    return sink;
+}
+
+static long newRun(const std::string& traffic) {
+    long sink = 0;
+    const uint8_t* p = (const uint8_t*)traffic.data();
+    size_t rem = traffic.size();
+    char masked[UART_LINE_MAX + 1];
+    while (rem > 0) {
+        const char* line;
+        size_t len;
+        size_t used = UartLine_Push(&lineAsm, p, rem, &line, &len);
+        p += used;
+        rem -= used;
+        if (!line) continue;
+        // Masquage dans un buffer de pile
+        size_t visible = len < 10 ? len : 10;
+        memcpy(masked, line, visible);
+        memset(masked + visible, '*', len - visible);
+        masked[len] = '\0';
+        size_t off;
+        sink += (long)UartLine_Classify(line, len, &off) + (long)(len - off) + masked[0];
+    }
+    return sink;
+}
+
+void test_bench_recorded_traffic() {
+    const int repeat = 2000;
+    std::string traffic = buildTraffic(repeat);
+    const double lines = (double)repeat * (sizeof(recordedTraffic) / sizeof(recordedTraffic[0]));
+
+    heapAllocs = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    volatile long a = legacyRun(traffic);
+    auto t1 = std::chrono::steady_clock::now();
+    size_t legacyAllocs = heapAllocs;
+
+    heapAllocs = 0;
+    volatile long b = newRun(traffic);
+    auto t2 = std::chrono::steady_clock::now();
+    size_t newAllocs = heapAllocs;
+    (void)a;
+    (void)b;
+
+    double legacyNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / lines;
+    double newNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / lines;
+    printf("[BENCH] uart_line: legacy %.1f ns/line, %.2f allocs/line | new %.1f ns/line, %.2f allocs/line\n",
+           legacyNs, legacyAllocs / lines, newNs, newAllocs / lines);
+
+    TEST_ASSERT_GREATER_THAN(0, legacyAllocs);
+    TEST_ASSERT_EQUAL(0, newAllocs);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests assemblage
+    RUN_TEST(test_crlf_and_empty_lines);
+    RUN_TEST(test_line_split_across_chunks);
+    RUN_TEST(test_overlong_line_dropped);
+
+    // Tests classification
+    RUN_TEST(test_classify_prefixes);
+    RUN_TEST(test_classify_exact_matches);
+
+    // Benchmark
+    RUN_TEST(test_bench_recorded_traffic);
+
+    return UNITY_END();
+}
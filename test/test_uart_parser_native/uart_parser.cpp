@@ -1,16 +1,13 @@
 #include "../../include/uart_parser.h"
+#include "../../include/char_class.h"
 #include <string.h>
 
-static bool isPrintableOrAllowed(char ch) {
-  return (ch == ':' || ch == '_' || ch == '-' || ch == ' ' || (ch >= 0x20 && ch <= 0x7E));
-}
-
 UartResult UartParser_HandleLine(const char* line, bool wifiReady) {
   if (!line) return UART_UNKNOWN;
-  size_t len = strlen(line);
-  if (len > 64) return UART_ERR_TOO_LONG;
-  for (size_t i = 0; i < len; ++i) {
-    if (!isPrintableOrAllowed(line[i])) return UART_ERR_BAD_CHAR;
+  // ASCII imprimable seulement; une ligne trop longue l'emporte sur un caractère interdit
+  size_t n = CharClass_Span(&CHAR_CLASS_PRINTABLE, line, 64);
+  if (line[n] != '\0') {
+    return (n > 64 || n + strlen(line + n) > 64) ? UART_ERR_TOO_LONG : UART_ERR_BAD_CHAR;
   }
   if (strncmp(line, "STATE:", 6) == 0) {
     const char* state = line + 6;
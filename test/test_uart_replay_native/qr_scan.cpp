@@ -0,0 +1,62 @@
+#include "../../include/qr_scan.h"
+#include <string.h>
+
+void QrScan_Init(QrScanAssembler* a) {
+  if (!a) return;
+  a->len = 0;
+  a->discarding = false;
+  a->truncated = 0;
+  a->buf[0] = '\0';
+}
+
+size_t QrScan_Push(QrScanAssembler* a, const uint8_t* data, size_t len, bool idle,
+                   const char** line, size_t* lineLen) {
+  if (line) *line = NULL;
+  if (lineLen) *lineLen = 0;
+  if (!a || (!data && len > 0)) return 0;
+
+  // Fin de ligne la plus proche: '\n' puis '\r' dans la partie qui précède
+  const uint8_t* end = len ? (const uint8_t*)memchr(data, '\n', len) : NULL;
+  size_t span = end ? (size_t)(end - data) : len;
+  const uint8_t* cr = span ? (const uint8_t*)memchr(data, '\r', span) : NULL;
+  if (cr) {
+    end = cr;
+    span = (size_t)(cr - data);
+  }
+
+  if (!a->discarding && a->len + span > QR_SCAN_LINE_MAX) {
+    a->discarding = true;
+    a->truncated++;
+  }
+  if (!end && !idle) {
+    if (!a->discarding && span > 0) {
+      memcpy(a->buf + a->len, data, span);
+      a->len += span;
+    }
+    return len;
+  }
+
+  // Ligne complète (fin de ligne ou silence)
+  if (!a->discarding) {
+    if (a->len == 0) {
+      if (span > 0 && line) *line = (const char*)data;
+      if (span > 0 && lineLen) *lineLen = span;
+    } else {
+      if (span > 0) memcpy(a->buf + a->len, data, span);
+      a->len += span;
+      a->buf[a->len] = '\0';
+      if (line) *line = a->buf;
+      if (lineLen) *lineLen = a->len;
+    }
+  }
+  a->len = 0;
+  a->discarding = false;
+  return end ? span + 1 : len;
+}
+
+bool QrScan_IsToken(const char* line, size_t len) {
+  if (!line || len < 4) return false;
+  if (memcmp(line, "qrs_", 4) == 0) return len > 4;
+  if (memcmp(line, "qr_", 3) != 0) return false;
+  return memchr(line + 3, '_', len - 3) != NULL;
+}
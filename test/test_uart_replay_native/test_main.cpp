@@ -0,0 +1,392 @@
+#include <unity.h>
+#include "../../include/uart_capture.h"
+#include "../../include/uart_line.h"
+#include "../../include/uart_frame.h"
+#include "../../include/uart_parser.h"
+#include "../../include/order_progress.h"
+#include "../../include/qr_scan.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Relecture déterministe d'une capture UART: NUCLEO (lignes texte ou trames binaires)
+// -> assemblage -> classification -> suivi de commande, scanner QR -> détection de token.
+// UART_REPLAY_FILE=<capture.ucap> rejoue en plus une capture terrain (scripts/uart_capture.py).
+
+static uint8_t ring[64 * 1024];
+static UartCapture cap;
+
+void setUp(void) {
+    UartCapture_Init(&cap, ring, sizeof(ring));
+}
+void tearDown(void) {}
+
+static void appendDump(void* ctx, const uint8_t* data, size_t len) {
+    ((std::vector<uint8_t>*)ctx)->insert(((std::vector<uint8_t>*)ctx)->end(), data, data + len);
+}
+
+static std::vector<uint8_t> dumpOf(const UartCapture* c) {
+    std::vector<uint8_t> out;
+    UartCapture_Dump(c, appendDump, &out);
+    return out;
+}
+
+static void rec(uint8_t ch, uint8_t dir, uint32_t t, const char* s) {
+    UartCapture_Record(&cap, ch, dir, t, (const uint8_t*)s, strlen(s));
+}
+
+// ---- Banc de relecture ----
+
+struct Harness {
+    UartLineAssembler lines;
+    UartFrameDecoder frames;
+    bool binary;
+    bool skipLf;             // '\n' de la ligne de bascule (comme uart_service.cpp)
+    OrderProgress progress;
+    bool orderOpen;
+    uint32_t msgCount[UART_MSG_COUNT];
+    uint32_t parserAcks;
+    uint32_t nucleoLines;
+    QrScanAssembler qr;
+    uint32_t qrTokens;
+};
+
+static void harnessInit(Harness* h) {
+    memset(h, 0, sizeof(*h));
+    UartLine_Init(&h->lines);
+    UartFrameDecoder_Init(&h->frames);
+    QrScan_Init(&h->qr);
+}
+
+// Même aiguillage que handleIncomingLine (uart_service.cpp), sur le modèle de commande
+static void onNucleoLine(Harness* h, const char* line, size_t len) {
+    h->nucleoLines++;
+    size_t off;
+    UartMsgType type = UartLine_Classify(line, len, &off);
+    h->msgCount[type]++;
+    std::string s(line, len);
+    switch (type) {
+        case UART_MSG_PROTO_ACCEPT_BIN:
+        case UART_MSG_PROTO_OFFER_BIN:
+            h->binary = true;
+            h->skipLf = true;
+            UartFrameDecoder_Init(&h->frames);
+            break;
+        case UART_MSG_PROTO_TEXT:
+            h->binary = false;
+            break;
+        case UART_MSG_VEND_COMPLETED:
+            if (h->orderOpen) OrderProgress_OnVendCompleted(&h->progress, s.c_str());
+            break;
+        case UART_MSG_VEND_FAILED:
+            if (h->orderOpen) OrderProgress_OnVendFailed(&h->progress, s.c_str());
+            break;
+        case UART_MSG_DELIVERY_COMPLETED:
+            if (h->orderOpen) OrderProgress_OnDeliveryEnd(&h->progress, true, nullptr);
+            break;
+        case UART_MSG_DELIVERY_FAILED:
+        case UART_MSG_ORDER_NAK:
+            if (h->orderOpen) OrderProgress_OnDeliveryEnd(&h->progress, false, s.c_str() + off);
+            break;
+        case UART_MSG_UNKNOWN:
+            if (UartParser_HandleLine(s.c_str(), true) == UART_ACK) h->parserAcks++;
+            break;
+        default:
+            break;
+    }
+}
+
+// Lignes émises par l'ESP32: ouvre le modèle de commande (ORDER_START + VEND)
+static void onEspLine(Harness* h, const char* line, size_t len) {
+    std::string s(line, len);
+    if (s.rfind("ORDER_START", 0) == 0) {
+        OrderProgress_Begin(&h->progress, 0, 0);
+        h->orderOpen = true;
+    } else if (s.rfind("VEND ", 0) == 0 && h->orderOpen) {
+        int slot = 0, qty = 0;
+        if (sscanf(s.c_str() + 5, "%d %d", &slot, &qty) == 2) OrderProgress_AddItem(&h->progress, slot, qty);
+    }
+}
+
+static void feedNucleoRx(Harness* h, const uint8_t* p, size_t n) {
+    size_t off = 0;
+    while (off < n) {
+        if (h->binary) {
+            if (h->skipLf) {
+                h->skipLf = false;
+                if (p[off] == '\n') {
+                    off++;
+                    continue;
+                }
+            }
+            UartFrame f;
+            if (UartFrameDecoder_Push(&h->frames, p[off++], &f) == UART_FRAME_OK &&
+                f.type == UART_FRAME_TYPE_DATA) {
+                onNucleoLine(h, (const char*)f.payload, f.len);
+            }
+            continue;
+        }
+        const char* line;
+        size_t len;
+        off += UartLine_Push(&h->lines, p + off, n - off, &line, &len);
+        if (line) onNucleoLine(h, line, len);
+    }
+}
+
+static void feedEspTx(Harness* h, const uint8_t* p, size_t n) {
+    if (h->binary) return; // trames déjà couvertes côté RX pour ce banc
+    const uint8_t* end = p + n;
+    while (p < end) {
+        const uint8_t* nl = (const uint8_t*)memchr(p, '\n', (size_t)(end - p));
+        size_t len = nl ? (size_t)(nl - p) : (size_t)(end - p);
+        size_t l = len;
+        if (l > 0 && p[l - 1] == '\r') l--;
+        if (l > 0) onEspLine(h, (const char*)p, l);
+        p += len + (nl ? 1 : 0);
+    }
+}
+
+// Même découpage et détection que qr_service.cpp (bloc = lecture driver)
+static void feedQrRx(Harness* h, const uint8_t* p, size_t n) {
+    size_t off = 0;
+    while (off < n) {
+        const char* line;
+        size_t len;
+        off += QrScan_Push(&h->qr, p + off, n - off, false, &line, &len);
+        if (line && QrScan_IsToken(line, len)) h->qrTokens++;
+    }
+}
+
+static void harnessSink(void* ctx, const UartCaptureRecord* r) {
+    Harness* h = (Harness*)ctx;
+    if (r->channel == UART_CAPTURE_CH_QR) {
+        if (r->dir == UART_CAPTURE_RX) feedQrRx(h, r->data, r->len);
+    } else if (r->dir == UART_CAPTURE_RX) {
+        feedNucleoRx(h, r->data, r->len);
+    } else {
+        feedEspTx(h, r->data, r->len);
+    }
+}
+
+// Session type: token QR, commande de 2 items, un item en échec, lignes coupées entre lectures
+static void recordSession(uint32_t t0) {
+    rec(UART_CAPTURE_CH_QR, UART_CAPTURE_RX, t0, "qr_6565917e-a288_17552");
+    rec(UART_CAPTURE_CH_QR, UART_CAPTURE_RX, t0 + 3, "60515417\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, t0 + 10, "STATE:PAY");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, t0 + 11, "ING\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, t0 + 12, "ACK:STATE:PAYING\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, t0 + 400,
+        "ORDER_START:order_1\r\nVEND 1 2 prod_a\r\nVEND 3 1 prod_b\r\nORDER_END\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, t0 + 420, "ORDER_ACK\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, t0 + 2400, "VEND_COMPLETED:1\r\nVEND_FA");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, t0 + 4100, "ILED:3:MOTOR_ERROR\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, t0 + 4300, "DELIVERY_FAILED:MOTOR_ERROR\r\n");
+}
+
+// Tests capture
+void test_capture_roundtrip() {
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, 1000, "ORDER_ACK\r\n");
+    rec(UART_CAPTURE_CH_QR, UART_CAPTURE_RX, 1250, "qr_a_b\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, 100000, "QR_TOKEN_BUSY\r\n");
+    std::vector<uint8_t> dump = dumpOf(&cap);
+    TEST_ASSERT_EQUAL(UartCapture_DumpSize(&cap), dump.size());
+    // Deltas 0, 250 et 98750 ms: varints de 1, 2 et 3 octets
+    TEST_ASSERT_EQUAL(UART_CAPTURE_HEADER_SIZE + 11 + 8 + 15 + 3 + 4 + 5, dump.size());
+
+    UartCaptureReader r;
+    UartCaptureRecord rc;
+    TEST_ASSERT_TRUE(UartCapture_OpenDump(&r, dump.data(), dump.size()));
+    TEST_ASSERT_TRUE(UartCapture_Next(&r, &rc));
+    TEST_ASSERT_EQUAL(UART_CAPTURE_CH_NUCLEO, rc.channel);
+    TEST_ASSERT_EQUAL(UART_CAPTURE_RX, rc.dir);
+    TEST_ASSERT_EQUAL_UINT32(1000, rc.timeMs);
+    TEST_ASSERT_TRUE(UartCapture_Next(&r, &rc));
+    TEST_ASSERT_EQUAL(UART_CAPTURE_CH_QR, rc.channel);
+    TEST_ASSERT_EQUAL_UINT32(1250, rc.timeMs);
+    TEST_ASSERT_EQUAL_MEMORY("qr_a_b\r\n", rc.data, rc.len);
+    TEST_ASSERT_TRUE(UartCapture_Next(&r, &rc));
+    TEST_ASSERT_EQUAL(UART_CAPTURE_TX, rc.dir);
+    TEST_ASSERT_EQUAL_UINT32(100000, rc.timeMs);
+    TEST_ASSERT_FALSE(UartCapture_Next(&r, &rc));
+}
+
+void test_ring_overwrites_oldest() {
+    static uint8_t small[64];
+    UartCapture_Init(&cap, small, sizeof(small));
+    // 10 enregistrements de 3 + 10 octets: seuls les 4 derniers tiennent
+    for (uint32_t i = 0; i < 10; i++) {
+        char line[11];
+        snprintf(line, sizeof(line), "LINE_%03u\r\n", (unsigned)i);
+        UartCapture_Record(&cap, UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, 100 * i, (const uint8_t*)line, 10);
+    }
+    TEST_ASSERT_EQUAL(4, cap.records);
+    TEST_ASSERT_EQUAL(6, cap.dropped);
+    TEST_ASSERT_EQUAL_UINT32(600, cap.tailMs);
+
+    std::vector<uint8_t> dump = dumpOf(&cap);
+    UartCaptureReader r;
+    UartCaptureRecord rc;
+    TEST_ASSERT_TRUE(UartCapture_OpenDump(&r, dump.data(), dump.size()));
+    TEST_ASSERT_EQUAL(6, r.dropped);
+    uint32_t expect = 6;
+    while (UartCapture_Next(&r, &rc)) {
+        char line[11];
+        snprintf(line, sizeof(line), "LINE_%03u\r\n", (unsigned)expect);
+        TEST_ASSERT_EQUAL_MEMORY(line, rc.data, 10);
+        TEST_ASSERT_EQUAL_UINT32(100 * expect, rc.timeMs);
+        expect++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, expect);
+
+    // Plus grand que le buffer: refusé
+    uint8_t big[100] = {0};
+    TEST_ASSERT_FALSE(UartCapture_Record(&cap, 0, 0, 2000, big, sizeof(big)));
+}
+
+void test_long_block_split_and_bad_dump() {
+    std::string block(UART_CAPTURE_RECORD_MAX + 100, 'X');
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, 5, block.c_str());
+    TEST_ASSERT_EQUAL(2, cap.records);
+    TEST_ASSERT_EQUAL_UINT32(block.size(), cap.bytesCaptured);
+
+    std::vector<uint8_t> dump = dumpOf(&cap);
+    UartCaptureReader r;
+    TEST_ASSERT_FALSE(UartCapture_OpenDump(&r, dump.data(), dump.size() - 1));
+    dump[0] = 'X';
+    TEST_ASSERT_FALSE(UartCapture_OpenDump(&r, dump.data(), dump.size()));
+}
+
+// Tests relecture
+void test_replay_session_through_pipeline() {
+    recordSession(10000);
+    std::vector<uint8_t> dump = dumpOf(&cap);
+
+    Harness h;
+    harnessInit(&h);
+    UartReplayStats st;
+    TEST_ASSERT_TRUE(UartCapture_Replay(dump.data(), dump.size(), false, harnessSink, nullptr, &h, &st));
+    TEST_ASSERT_EQUAL(10, st.records);
+    TEST_ASSERT_EQUAL_UINT32(4300, st.spanMs);
+
+    TEST_ASSERT_EQUAL(1, h.qrTokens);
+    TEST_ASSERT_EQUAL(1, h.parserAcks);
+    TEST_ASSERT_EQUAL(1, h.msgCount[UART_MSG_ORDER_ACK]);
+    TEST_ASSERT_EQUAL(1, h.msgCount[UART_MSG_VEND_COMPLETED]);
+    TEST_ASSERT_EQUAL(1, h.msgCount[UART_MSG_VEND_FAILED]);
+    TEST_ASSERT_TRUE(h.orderOpen);
+    TEST_ASSERT_EQUAL(2, h.progress.count);
+    TEST_ASSERT_TRUE(h.progress.deliveryFailed);
+    TEST_ASSERT_EQUAL(2, OrderProgress_DeliveredTotal(&h.progress));
+    TEST_ASSERT_EQUAL_STRING("MOTOR_ERROR", h.progress.items[1].reason);
+}
+
+// Contexte commun au sink et à l'attente
+struct Timed {
+    Harness h;
+    uint32_t waited;
+};
+
+static void timedSink(void* ctx, const UartCaptureRecord* r) {
+    harnessSink(&((Timed*)ctx)->h, r);
+}
+
+static void timedWait(void* ctx, uint32_t ms) {
+    ((Timed*)ctx)->waited += ms;
+}
+
+void test_replay_original_timing() {
+    recordSession(0);
+    std::vector<uint8_t> dump = dumpOf(&cap);
+    Timed t;
+    UartReplayStats st;
+
+    harnessInit(&t.h);
+    t.waited = 0;
+    UartCapture_Replay(dump.data(), dump.size(), false, timedSink, timedWait, &t, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, t.waited);
+
+    harnessInit(&t.h);
+    UartCapture_Replay(dump.data(), dump.size(), true, timedSink, timedWait, &t, &st);
+    TEST_ASSERT_EQUAL_UINT32(st.spanMs, t.waited);
+    TEST_ASSERT_EQUAL(2, OrderProgress_DeliveredTotal(&t.h.progress));
+}
+
+void test_replay_binary_frames() {
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, 0, "ORDER_START:o\r\nVEND 4 1 p\r\nORDER_END\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_TX, 1, UART_PROTO_OFFER_BIN "\r\n");
+    rec(UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, 2, UART_PROTO_ACCEPT_BIN "\r\n");
+    UartFrame f{};
+    f.type = UART_FRAME_TYPE_DATA;
+    f.len = (uint8_t)strlen("VEND_COMPLETED:4");
+    memcpy(f.payload, "VEND_COMPLETED:4", f.len);
+    uint8_t wire[UART_FRAME_ENCODED_MAX];
+    size_t n = UartFrame_Encode(&f, wire, sizeof(wire));
+    UartCapture_Record(&cap, UART_CAPTURE_CH_NUCLEO, UART_CAPTURE_RX, 50, wire, n);
+
+    std::vector<uint8_t> dump = dumpOf(&cap);
+    Harness h;
+    harnessInit(&h);
+    TEST_ASSERT_TRUE(UartCapture_Replay(dump.data(), dump.size(), false, harnessSink, nullptr, &h, nullptr));
+    TEST_ASSERT_TRUE(h.binary);
+    TEST_ASSERT_EQUAL(1, h.msgCount[UART_MSG_VEND_COMPLETED]);
+    TEST_ASSERT_EQUAL(1, OrderProgress_DeliveredTotal(&h.progress));
+}
+
+// ---- Benchmark: relecture pleine vitesse ----
+
+static void benchReplay(const char* label, const std::vector<uint8_t>& dump) {
+    Harness h;
+    harnessInit(&h);
+    UartReplayStats st;
+    auto t0 = std::chrono::steady_clock::now();
+    UartCapture_Replay(dump.data(), dump.size(), false, harnessSink, nullptr, &h, &st);
+    auto t1 = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(t1 - t0).count();
+    printf("[BENCH] uart_replay %s: %lu records, %lu bytes, %lu NUCLEO lines in %.2f ms "
+           "(%.1f MB/s, %.0f lines/s, capture span %lu ms)\n",
+           label, (unsigned long)st.records, (unsigned long)st.bytes, (unsigned long)h.nucleoLines,
+           s * 1e3, st.bytes / s / 1e6, h.nucleoLines / s, (unsigned long)st.spanMs);
+}
+
+void test_bench_replay() {
+    // Capture synthétique: la session type répétée jusqu'à remplir le buffer
+    for (uint32_t i = 0; cap.dropped == 0; i++) recordSession(i * 5000);
+    std::vector<uint8_t> dump = dumpOf(&cap);
+    benchReplay("synthetic", dump);
+
+    // Capture terrain éventuelle
+    const char* path = getenv("UART_REPLAY_FILE");
+    if (!path) return;
+    FILE* fp = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(fp, path);
+    std::vector<uint8_t> field;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) field.insert(field.end(), buf, buf + n);
+    fclose(fp);
+    UartCaptureReader r;
+    TEST_ASSERT_TRUE_MESSAGE(UartCapture_OpenDump(&r, field.data(), field.size()), "not a UCAP dump");
+    benchReplay(path, field);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests capture
+    RUN_TEST(test_capture_roundtrip);
+    RUN_TEST(test_ring_overwrites_oldest);
+    RUN_TEST(test_long_block_split_and_bad_dump);
+
+    // Tests relecture
+    RUN_TEST(test_replay_session_through_pipeline);
+    RUN_TEST(test_replay_original_timing);
+    RUN_TEST(test_replay_binary_frames);
+
+    // Benchmark
+    RUN_TEST(test_bench_replay);
+
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+#include "../../include/uart_line.h"
+#include "../../include/uart_frame.h"
+#include "../../include/uart_baud.h"
+#include <string.h>
+
+void UartLine_Init(UartLineAssembler* a) {
+  if (!a) return;
+  a->len = 0;
+  a->discarding = false;
+  a->overflows = 0;
+  a->buf[0] = '\0';
+}
+
+size_t UartLine_Push(UartLineAssembler* a, const uint8_t* data, size_t len,
+                     const char** line, size_t* lineLen) {
+  if (line) *line = NULL;
+  if (lineLen) *lineLen = 0;
+  if (!a || !data || len == 0) return 0;
+
+  // Fin de ligne la plus proche: '\n' puis '\r' dans la partie qui précède
+  const uint8_t* end = (const uint8_t*)memchr(data, '\n', len);
+  size_t span = end ? (size_t)(end - data) : len;
+  const uint8_t* cr = (const uint8_t*)memchr(data, '\r', span);
+  if (cr) {
+    end = cr;
+    span = (size_t)(cr - data);
+  }
+
+  if (!a->discarding) {
+    if (a->len + span > UART_LINE_MAX) {
+      a->discarding = true;
+      a->overflows++;
+    } else {
+      memcpy(a->buf + a->len, data, span);
+      a->len += span;
+    }
+  }
+  if (!end) return len;
+
+  // Fin de ligne atteinte
+  if (!a->discarding && a->len > 0) {
+    a->buf[a->len] = '\0';
+    if (line) *line = a->buf;
+    if (lineLen) *lineLen = a->len;
+  }
+  a->len = 0;
+  a->discarding = false;
+  return span + 1;
+}
+
+// Table de préfixes résolue à la compilation: premier caractère (switch) puis memcmp
+typedef struct {
+  const char* text;
+  uint8_t len;
+  bool exact;
+  UartMsgType type;
+} UartPrefix;
+
+#define UART_PREFIX(s, exact, type) { s, (uint8_t)(sizeof(s) - 1), exact, type }
+
+static const UartPrefix prefixesB[] = {
+  UART_PREFIX(UART_BAUD_RESET, true, UART_MSG_BAUD_RESET),
+  UART_PREFIX(UART_BAUD_ACCEPT_PREFIX, false, UART_MSG_BAUD_OK),
+};
+static const UartPrefix prefixesD[] = {
+  UART_PREFIX("DELIVERY_COMPLETED", false, UART_MSG_DELIVERY_COMPLETED),
+  UART_PREFIX("DELIVERY_FAILED", false, UART_MSG_DELIVERY_FAILED),
+};
+static const UartPrefix prefixesO[] = {
+  UART_PREFIX("ORDER_ACK", false, UART_MSG_ORDER_ACK),
+  UART_PREFIX("ORDER_NAK", false, UART_MSG_ORDER_NAK),
+};
+static const UartPrefix prefixesP[] = {
+  UART_PREFIX(UART_PROTO_ACCEPT_BIN, true, UART_MSG_PROTO_ACCEPT_BIN),
+  UART_PREFIX(UART_PROTO_OFFER_BIN, true, UART_MSG_PROTO_OFFER_BIN),
+  UART_PREFIX(UART_PROTO_FALLBACK_TEXT, true, UART_MSG_PROTO_TEXT),
+};
+static const UartPrefix prefixesS[] = {
+  UART_PREFIX("SUPERVISION_ERROR:", false, UART_MSG_SUPERVISION_ERROR),
+};
+static const UartPrefix prefixesT[] = {
+  UART_PREFIX(UART_BAUD_TRAIN_PREFIX, false, UART_MSG_BAUD_TRAIN),
+};
+static const UartPrefix prefixesV[] = {
+  UART_PREFIX("VEND_COMPLETED", false, UART_MSG_VEND_COMPLETED),
+  UART_PREFIX("VEND_FAILED", false, UART_MSG_VEND_FAILED),
+};
+
+#define UART_BUCKET(arr) bucket = arr; count = sizeof(arr) / sizeof(arr[0]); break
+
+UartMsgType UartLine_Classify(const char* line, size_t len, size_t* argOffset) {
+  if (argOffset) *argOffset = 0;
+  if (!line || len == 0) return UART_MSG_UNKNOWN;
+
+  const UartPrefix* bucket = NULL;
+  size_t count = 0;
+  switch (line[0]) {
+    case 'B': UART_BUCKET(prefixesB);
+    case 'D': UART_BUCKET(prefixesD);
+    case 'O': UART_BUCKET(prefixesO);
+    case 'P': UART_BUCKET(prefixesP);
+    case 'S': UART_BUCKET(prefixesS);
+    case 'T': UART_BUCKET(prefixesT);
+    case 'V': UART_BUCKET(prefixesV);
+    default: return UART_MSG_UNKNOWN;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const UartPrefix* p = &bucket[i];
+    if (len < p->len || (p->exact && len != p->len)) continue;
+    if (memcmp(line, p->text, p->len) != 0) continue;
+    if (argOffset) *argOffset = p->len;
+    return p->type;
+  }
+  return UART_MSG_UNKNOWN;
+}
@@ -0,0 +1,20 @@
+#include "../../include/uart_parser.h"
+#include "../../include/char_class.h"
+#include <string.h>
+
+UartResult UartParser_HandleLine(const char* line, bool wifiReady) {
+  if (!line) return UART_UNKNOWN;
+  // ASCII imprimable seulement; une ligne trop longue l'emporte sur un caractère interdit
+  size_t n = CharClass_Span(&CHAR_CLASS_PRINTABLE, line, 64);
+  if (line[n] != '\0') {
+    return (n > 64 || n + strlen(line + n) > 64) ? UART_ERR_TOO_LONG : UART_ERR_BAD_CHAR;
+  }
+  if (strncmp(line, "STATE:", 6) == 0) {
+    const char* state = line + 6;
+    while (*state == ' ') state++;
+    if (strcmp(state, "PAYING") == 0) {
+      return wifiReady ? UART_ACK : UART_NAK;
+    }
+  }
+  return UART_UNKNOWN;
+}
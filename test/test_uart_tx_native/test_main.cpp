@@ -0,0 +1,120 @@
+#include <unity.h>
+#include "../../include/uart_tx.h"
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Découpe complète via l'itérateur
+static size_t splitAll(const char* text, uint8_t flags, uint32_t nowMs, UartTxLine* out, size_t maxLines) {
+    const char* cursor = text;
+    size_t n = 0;
+    while (n < maxLines && UartTx_NextLine(&cursor, flags, nowMs, &out[n])) n++;
+    return n;
+}
+
+// Tests découpage
+void test_split_order_block() {
+    UartTxLine lines[4];
+    const char* block = "ORDER_START:o1\nVEND 1 2 p1\r\nORDER_END\n";
+    TEST_ASSERT_EQUAL(3, UartTx_CountLines(block));
+    size_t n = splitAll(block, 0, 42, lines, 4);
+    TEST_ASSERT_EQUAL(3, n);
+    TEST_ASSERT_EQUAL(11, lines[1].len);
+    TEST_ASSERT_EQUAL_MEMORY("VEND 1 2 p1", lines[1].text, 11);
+    TEST_ASSERT_TRUE(lines[0].flags & UART_TX_FLAG_CONTINUED);
+    TEST_ASSERT_TRUE(lines[1].flags & UART_TX_FLAG_CONTINUED);
+    TEST_ASSERT_FALSE(lines[2].flags & UART_TX_FLAG_CONTINUED);
+    TEST_ASSERT_EQUAL_UINT32(42, lines[2].enqueuedMs);
+}
+
+void test_split_priority_and_limits() {
+    UartTxLine lines[2];
+    TEST_ASSERT_EQUAL(1, splitAll("ACK:STATE:PAYING", UART_TX_FLAG_PRIORITY, 0, lines, 2));
+    TEST_ASSERT_EQUAL(UART_TX_FLAG_PRIORITY, lines[0].flags);
+    TEST_ASSERT_EQUAL(0, UartTx_CountLines("\n\r\n"));
+    TEST_ASSERT_EQUAL(0, splitAll("\n\n", 0, 0, lines, 2));
+
+    // Ligne NFC_TEXT la plus longue acceptée, un caractère de plus refusé
+    char longLine[UART_TX_LINE_MAX + 2];
+    memcpy(longLine, "NFC_TEXT:", 9);
+    memset(longLine + 9, 'X', sizeof(longLine) - 10);
+    longLine[sizeof(longLine) - 1] = '\0';
+    TEST_ASSERT_EQUAL(0, UartTx_CountLines(longLine));
+    longLine[9 + 119] = '\0';
+    TEST_ASSERT_EQUAL(1, UartTx_CountLines(longLine));
+    TEST_ASSERT_EQUAL(1, splitAll(longLine, 0, 0, lines, 2));
+    TEST_ASSERT_EQUAL(128, lines[0].len);
+}
+
+// Tests regroupement
+void test_batch_coalesces_lines() {
+    UartTxLine lines[2];
+    splitAll("NFC_UID:04A1\nQR_TOKEN_BUSY", 0, 100, lines, 2);
+    lines[1].enqueuedMs = 90;
+    UartTxBatch b;
+    UartTxBatch_Reset(&b);
+    TEST_ASSERT_TRUE(UartTxBatch_AppendLine(&b, &lines[0]));
+    TEST_ASSERT_TRUE(UartTxBatch_AppendLine(&b, &lines[1]));
+    TEST_ASSERT_EQUAL(2, b.lines);
+    TEST_ASSERT_EQUAL_UINT32(90, b.oldestMs);
+    TEST_ASSERT_EQUAL(strlen("NFC_UID:04A1\r\nQR_TOKEN_BUSY\r\n"), b.len);
+    TEST_ASSERT_EQUAL_MEMORY("NFC_UID:04A1\r\nQR_TOKEN_BUSY\r\n", b.data, b.len);
+}
+
+void test_batch_full() {
+    UartTxLine line;
+    TEST_ASSERT_EQUAL(1, splitAll("VEND 10 1 product_with_a_long_identifier_0123456789", 0, 0, &line, 1));
+    UartTxBatch b;
+    UartTxBatch_Reset(&b);
+    size_t appended = 0;
+    while (UartTxBatch_AppendLine(&b, &line)) appended++;
+    TEST_ASSERT_EQUAL(UART_TX_BATCH_MAX / (line.len + 2), appended);
+    TEST_ASSERT_LESS_OR_EQUAL(UART_TX_BATCH_MAX, b.len);
+    const uint8_t frame[8] = {1, 2, 3, 4, 5, 6, 7, 0};
+    size_t before = b.len;
+    bool fits = UartTxBatch_AppendBytes(&b, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL(before + sizeof(frame) <= UART_TX_BATCH_MAX, fits);
+}
+
+// Tests statistiques
+void test_stats_latency_and_depth() {
+    UartTxStats s;
+    UartTxStats_Init(&s);
+    UartTxStats_OnDepth(&s, 5);
+    UartTxStats_OnDepth(&s, 1);
+    TEST_ASSERT_EQUAL(1, s.depth);
+    TEST_ASSERT_EQUAL(5, s.depthMax);
+
+    UartTxBatch b;
+    UartTxBatch_Reset(&b);
+    UartTxBatch_Track(&b, 1000);
+    UartTxBatch_AppendBytes(&b, (const uint8_t*)"x", 1);
+    UartTxStats_OnWrite(&s, &b, 1016, 250);
+    TEST_ASSERT_EQUAL_UINT32(16, s.latencyLastMs);
+    TEST_ASSERT_EQUAL_UINT32(16, s.latencyAvgMs);
+    TEST_ASSERT_EQUAL_UINT32(250, s.writeMaxUs);
+
+    UartTxStats_OnWrite(&s, &b, 1096, 100);
+    TEST_ASSERT_EQUAL_UINT32(96, s.latencyMaxMs);
+    TEST_ASSERT_EQUAL_UINT32(26, s.latencyAvgMs);
+    TEST_ASSERT_EQUAL_UINT32(2, s.batches);
+    TEST_ASSERT_EQUAL_UINT32(2, s.lines);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests découpage
+    RUN_TEST(test_split_order_block);
+    RUN_TEST(test_split_priority_and_limits);
+
+    // Tests regroupement
+    RUN_TEST(test_batch_coalesces_lines);
+    RUN_TEST(test_batch_full);
+
+    // Tests statistiques
+    RUN_TEST(test_stats_latency_and_depth);
+
+    return UNITY_END();
+}
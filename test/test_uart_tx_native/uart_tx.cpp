@@ -0,0 +1,120 @@
+#include "../../include/uart_tx.h"
+#include <string.h>
+
+// Ligne suivante à partir de p: début et longueur sans fin de ligne; retourne le début de la suivante (NULL si fin)
+static const char* scanLine(const char* p, size_t* len) {
+  const char* nl = strchr(p, '\n');
+  size_t n = nl ? (size_t)(nl - p) : strlen(p);
+  if (n > 0 && p[n - 1] == '\r') n--;
+  *len = n;
+  return nl ? nl + 1 : NULL;
+}
+
+size_t UartTx_CountLines(const char* text) {
+  if (!text) return 0;
+  size_t count = 0;
+  const char* p = text;
+  while (p) {
+    size_t len;
+    const char* next = scanLine(p, &len);
+    if (len > UART_TX_LINE_MAX) return 0;
+    if (len > 0) count++;
+    p = next;
+  }
+  return count;
+}
+
+bool UartTx_NextLine(const char** cursor, uint8_t flags, uint32_t nowMs, UartTxLine* out) {
+  if (!cursor || !out) return false;
+  const char* p = *cursor;
+  while (p) {
+    size_t len;
+    const char* next = scanLine(p, &len);
+    if (len == 0) {
+      p = next;
+      continue;
+    }
+    if (len > UART_TX_LINE_MAX) len = UART_TX_LINE_MAX;
+    memcpy(out->text, p, len);
+    out->len = (uint8_t)len;
+    out->flags = flags;
+    out->enqueuedMs = nowMs;
+
+    // Une autre ligne non vide suit-elle ?
+    const char* q = next;
+    while (q) {
+      size_t l;
+      const char* n2 = scanLine(q, &l);
+      if (l > 0) {
+        out->flags |= UART_TX_FLAG_CONTINUED;
+        break;
+      }
+      q = n2;
+    }
+    *cursor = next;
+    return true;
+  }
+  *cursor = NULL;
+  return false;
+}
+
+void UartTxBatch_Reset(UartTxBatch* b) {
+  if (!b) return;
+  b->len = 0;
+  b->lines = 0;
+  b->oldestMs = 0;
+}
+
+bool UartTxBatch_AppendBytes(UartTxBatch* b, const uint8_t* data, size_t len) {
+  if (!b || (!data && len > 0)) return false;
+  if (len > sizeof(b->data) - b->len) return false;
+  memcpy(b->data + b->len, data, len);
+  b->len += len;
+  return true;
+}
+
+void UartTxBatch_Track(UartTxBatch* b, uint32_t enqueuedMs) {
+  if (!b) return;
+  if (b->lines == 0 || (int32_t)(enqueuedMs - b->oldestMs) < 0) b->oldestMs = enqueuedMs;
+  b->lines++;
+}
+
+bool UartTxBatch_AppendLine(UartTxBatch* b, const UartTxLine* line) {
+  if (!b || !line) return false;
+  if ((size_t)line->len + 2 > sizeof(b->data) - b->len) return false;
+  memcpy(b->data + b->len, line->text, line->len);
+  b->len += line->len;
+  b->data[b->len++] = '\r';
+  b->data[b->len++] = '\n';
+  UartTxBatch_Track(b, line->enqueuedMs);
+  return true;
+}
+
+void UartTxStats_Init(UartTxStats* s) {
+  if (!s) return;
+  memset(s, 0, sizeof(*s));
+}
+
+void UartTxStats_OnDepth(UartTxStats* s, uint16_t depth) {
+  if (!s) return;
+  s->depth = depth;
+  if (depth > s->depthMax) s->depthMax = depth;
+}
+
+void UartTxStats_OnWrite(UartTxStats* s, const UartTxBatch* b, uint32_t nowMs, uint32_t writeUs) {
+  if (!s || !b || b->len == 0) return;
+  s->batches++;
+  s->lines += b->lines;
+  s->writeLastUs = writeUs;
+  if (writeUs > s->writeMaxUs) s->writeMaxUs = writeUs;
+  if (b->lines == 0) return; // ACK/retransmission seuls: pas de latence de file
+
+  uint32_t latency = nowMs - b->oldestMs;
+  s->latencyLastMs = latency;
+  if (latency > s->latencyMaxMs) s->latencyMaxMs = latency;
+  if (s->latencyAvgMs == 0) {
+    s->latencyAvgMs = latency;
+  } else {
+    s->latencyAvgMs = (uint32_t)((int32_t)s->latencyAvgMs + ((int32_t)latency - (int32_t)s->latencyAvgMs) / 8);
+  }
+}
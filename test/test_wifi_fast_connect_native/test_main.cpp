@@ -0,0 +1,104 @@
+#include <unity.h>
+#include "../../include/wifi_fast_connect.h"
+#include <string.h>
+
+static const uint8_t BSSID[6] = { 0x24, 0x0A, 0xC4, 0x12, 0x34, 0x56 };
+static const uint32_t IP = 0x1401A8C0;        // 192.168.1.20
+static const uint32_t GATEWAY = 0x0101A8C0;   // 192.168.1.1
+static const uint32_t MASK = 0x00FFFFFF;      // 255.255.255.0
+
+static WifiFastRecord record() {
+    WifiFastRecord r;
+    WifiFast_Fill(&r, "DPM-Shop", BSSID, 6, IP, GATEWAY, MASK, GATEWAY, 0x08080808);
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Tests enregistrement NVS
+void test_record_bound_to_ssid_and_checked() {
+    WifiFastRecord r = record();
+    TEST_ASSERT_TRUE(WifiFast_IsUsable(&r, "DPM-Shop"));
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&r, "DPM-Shop2"));   // réseau reconfiguré
+
+    WifiFastRecord bad = r;
+    bad.channel = 7;                                         // altéré sans resceller
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&bad, "DPM-Shop"));
+    WifiFast_Seal(&bad);
+    TEST_ASSERT_TRUE(WifiFast_IsUsable(&bad, "DPM-Shop"));
+    bad.channel = 15;
+    WifiFast_Seal(&bad);
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&bad, "DPM-Shop"));
+
+    // NVS vide ou d'une autre version
+    WifiFastRecord empty;
+    memset(&empty, 0, sizeof(empty));
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&empty, ""));
+    bad = r;
+    bad.version = WIFI_FAST_RECORD_VERSION + 1;
+    WifiFast_Seal(&bad);
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&bad, "DPM-Shop"));
+    uint8_t zero[6] = { 0 };
+    WifiFast_Fill(&bad, "DPM-Shop", zero, 6, IP, GATEWAY, MASK, 0, 0);
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&bad, "DPM-Shop"));
+}
+
+void test_failures_disable_fast_path_until_refresh() {
+    WifiFastRecord r = record();
+    WifiFast_OnFailure(&r);
+    TEST_ASSERT_TRUE(WifiFast_IsUsable(&r, "DPM-Shop"));
+    WifiFast_OnFailure(&r);
+    TEST_ASSERT_FALSE(WifiFast_IsUsable(&r, "DPM-Shop"));
+
+    // Connexion complète réussie: même lien mais compteur remis à zéro -> réécriture
+    WifiFastRecord fresh = record();
+    TEST_ASSERT_FALSE(WifiFast_SameLink(&r, &fresh));
+    TEST_ASSERT_TRUE(WifiFast_IsUsable(&fresh, "DPM-Shop"));
+
+    // Même AP, même bail: aucune écriture NVS
+    WifiFastRecord again = record();
+    TEST_ASSERT_TRUE(WifiFast_SameLink(&fresh, &again));
+    WifiFast_Fill(&again, "DPM-Shop", BSSID, 11, IP, GATEWAY, MASK, GATEWAY, 0x08080808);
+    TEST_ASSERT_FALSE(WifiFast_SameLink(&fresh, &again));
+}
+
+// Tests IP fixe
+void test_parse_static_ip() {
+    uint32_t ip = 0;
+    TEST_ASSERT_TRUE(WifiFast_ParseIpv4("192.168.1.20", 12, &ip));
+    TEST_ASSERT_EQUAL_HEX32(IP, ip);
+    TEST_ASSERT_FALSE(WifiFast_ParseIpv4("192.168.1", 9, &ip));
+    TEST_ASSERT_FALSE(WifiFast_ParseIpv4("192.168.1.256", 13, &ip));
+    TEST_ASSERT_FALSE(WifiFast_ParseIpv4("192.168.1.2x", 12, &ip));
+    TEST_ASSERT_FALSE(WifiFast_ParseIpv4("1921.168.1.2", 12, &ip));
+
+    WifiStaticIp cfg;
+    TEST_ASSERT_TRUE(WifiFast_ParseStaticIp("192.168.1.20,192.168.1.1,255.255.255.0", &cfg));
+    TEST_ASSERT_EQUAL_HEX32(IP, cfg.ip);
+    TEST_ASSERT_EQUAL_HEX32(GATEWAY, cfg.gateway);
+    TEST_ASSERT_EQUAL_HEX32(MASK, cfg.mask);
+    TEST_ASSERT_EQUAL_HEX32(0, cfg.dns1);
+
+    TEST_ASSERT_TRUE(WifiFast_ParseStaticIp("192.168.1.20, 192.168.1.1, 255.255.255.0, 1.1.1.1, 8.8.8.8", &cfg));
+    TEST_ASSERT_EQUAL_HEX32(0x01010101, cfg.dns1);
+    TEST_ASSERT_EQUAL_HEX32(0x08080808, cfg.dns2);
+
+    TEST_ASSERT_FALSE(WifiFast_ParseStaticIp("192.168.1.20,192.168.1.1", &cfg));
+    TEST_ASSERT_FALSE(WifiFast_ParseStaticIp("192.168.1.20,192.168.1.1,255.255.255.0,1.1.1.1,8.8.8.8,9.9.9.9", &cfg));
+    TEST_ASSERT_FALSE(WifiFast_ParseStaticIp("0.0.0.0,192.168.1.1,255.255.255.0", &cfg));
+    TEST_ASSERT_FALSE(WifiFast_ParseStaticIp("192.168.1.20,,255.255.255.0", &cfg));
+    TEST_ASSERT_FALSE(WifiFast_ParseStaticIp(nullptr, &cfg));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Enregistrement NVS
+    RUN_TEST(test_record_bound_to_ssid_and_checked);
+    RUN_TEST(test_failures_disable_fast_path_until_refresh);
+
+    // IP fixe
+    RUN_TEST(test_parse_static_ip);
+    return UNITY_END();
+}
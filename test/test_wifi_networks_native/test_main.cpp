@@ -0,0 +1,166 @@
+#include <unity.h>
+#include "../../include/wifi_networks.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static WifiNetworkList list;
+
+static WifiScanEntry ap(const char* ssid, int8_t rssi, uint8_t channel) {
+    WifiScanEntry e;
+    memset(&e, 0, sizeof(e));
+    strncpy(e.ssid, ssid, sizeof(e.ssid) - 1);
+    e.rssi = rssi;
+    e.channel = channel;
+    e.bssid[5] = (uint8_t)(channel + rssi);
+    return e;
+}
+
+void setUp(void) {
+    WifiNetworks_Init(&list);
+}
+void tearDown(void) {}
+
+// Tests liste
+void test_add_update_and_replace_when_full() {
+    TEST_ASSERT_EQUAL_INT(0, WifiNetworks_Add(&list, "Shop", 9));
+    TEST_ASSERT_EQUAL_INT(1, WifiNetworks_Add(&list, "Shop-4G", 3));
+    TEST_ASSERT_EQUAL_INT(-1, WifiNetworks_Add(&list, "", 3));
+    TEST_ASSERT_EQUAL_INT(-1, WifiNetworks_Add(&list, "123456789012345678901234567890123", 3));
+
+    // SSID déjà connu: priorité mise à jour, échecs oubliés
+    WifiNetworks_OnFailed(&list, 1);
+    TEST_ASSERT_EQUAL_INT(1, WifiNetworks_Add(&list, "Shop-4G", 12));
+    TEST_ASSERT_EQUAL_UINT8(WIFI_NET_PRIORITY_MAX, list.nets[1].priority);
+    TEST_ASSERT_EQUAL_UINT8(0, list.nets[1].failures);
+    TEST_ASSERT_EQUAL_UINT8(2, list.count);
+
+    WifiNetworks_Add(&list, "Mall", 2);
+    WifiNetworks_Add(&list, "Guest", 1);
+    WifiNetworks_Add(&list, "Office", 1);
+    WifiNetworks_OnFailed(&list, 4);
+    // Pleine: la priorité la plus basse sort, à égalité celle qui échoue
+    TEST_ASSERT_EQUAL_INT(4, WifiNetworks_Add(&list, "Depot", 5));
+    TEST_ASSERT_EQUAL_INT(-1, WifiNetworks_Find(&list, "Office"));
+    TEST_ASSERT_EQUAL_INT(3, WifiNetworks_Find(&list, "Guest"));
+    TEST_ASSERT_TRUE(WifiNetworks_IsValid(&list));
+
+    int moved;
+    TEST_ASSERT_TRUE(WifiNetworks_Remove(&list, 1, &moved));
+    TEST_ASSERT_EQUAL_INT(4, moved);
+    TEST_ASSERT_EQUAL_STRING("Depot", list.nets[1].ssid);
+    TEST_ASSERT_EQUAL_UINT8(4, list.count);
+    TEST_ASSERT_FALSE(WifiNetworks_Remove(&list, 4, &moved));
+}
+
+void test_blob_validation() {
+    WifiNetworks_Add(&list, "Shop", 5);
+    TEST_ASSERT_TRUE(WifiNetworks_IsValid(&list));
+    WifiNetworkList bad = list;
+    bad.nets[0].priority = 1;                  // altéré sans resceller
+    TEST_ASSERT_FALSE(WifiNetworks_IsValid(&bad));
+    bad = list;
+    memset(bad.nets[0].ssid, 'A', sizeof(bad.nets[0].ssid));
+    WifiNetworks_Seal(&bad);
+    TEST_ASSERT_FALSE(WifiNetworks_IsValid(&bad));
+    bad = list;
+    bad.count = WIFI_NETWORKS_MAX + 1;
+    WifiNetworks_Seal(&bad);
+    TEST_ASSERT_FALSE(WifiNetworks_IsValid(&bad));
+}
+
+// Tests sélection
+void test_rank_prefers_priority_then_fastest() {
+    WifiNetworks_Add(&list, "Shop", 5);
+    WifiNetworks_Add(&list, "Shop-4G", 5);
+    WifiNetworks_Add(&list, "Backup", 3);
+    WifiNetworks_Add(&list, "Away", 9);
+    WifiNetworks_RecordLatency(&list, 0, 400);
+    WifiNetworks_RecordLatency(&list, 1, 120);
+    WifiScanEntry scan[] = {
+        ap("Neighbour", -40, 1), ap("Shop", -55, 6), ap("Shop", -70, 11),
+        ap("Shop-4G", -58, 1), ap("Backup", -45, 11),
+    };
+    WifiCandidate c[WIFI_NETWORKS_MAX];
+    size_t n = WifiNetworks_Rank(&list, scan, 5, c, WIFI_NETWORKS_MAX);
+    TEST_ASSERT_EQUAL_UINT32(3, n);                     // "Away" absent du balayage
+    TEST_ASSERT_EQUAL_UINT8(1, c[0].index);             // même priorité, backend le plus rapide
+    TEST_ASSERT_EQUAL_UINT8(0, c[1].index);
+    TEST_ASSERT_EQUAL_UINT8(1, c[1].scanIndex);         // AP "Shop" au meilleur signal
+    TEST_ASSERT_EQUAL_UINT8(2, c[2].index);
+    TEST_ASSERT_EQUAL_INT(-55, list.nets[0].lastRssi);
+    TEST_ASSERT_EQUAL_UINT32(1, list.nets[0].lastSeenScan);
+    TEST_ASSERT_EQUAL_UINT32(0, list.nets[3].lastSeenScan);
+
+    // Signal faible et échecs répétés: le réseau le plus rapide recule
+    scan[3].rssi = -85;
+    WifiNetworks_OnFailed(&list, 1);
+    n = WifiNetworks_Rank(&list, scan, 5, c, WIFI_NETWORKS_MAX);
+    TEST_ASSERT_EQUAL_UINT8(0, c[0].index);
+    TEST_ASSERT_EQUAL_UINT8(1, c[1].index);
+    WifiNetworks_OnFailed(&list, 1);
+    n = WifiNetworks_Rank(&list, scan, 5, c, WIFI_NETWORKS_MAX);
+    TEST_ASSERT_EQUAL_UINT8(2, c[1].index);             // priorité 3 devant deux échecs
+    WifiNetworks_OnConnected(&list, 1);
+    TEST_ASSERT_EQUAL_UINT8(0, list.nets[1].failures);
+    TEST_ASSERT_EQUAL_UINT16(1, list.nets[1].connects);
+
+    // AP à la limite de la portée ignoré
+    scan[3].rssi = -90;
+    n = WifiNetworks_Rank(&list, scan, 5, c, WIFI_NETWORKS_MAX);
+    TEST_ASSERT_EQUAL_UINT32(2, n);
+    TEST_ASSERT_TRUE(WifiNetworks_IsValid(&list));
+}
+
+void test_latency_moving_average() {
+    WifiNetworks_Add(&list, "Shop", 5);
+    WifiNetworks_RecordLatency(&list, 0, 200);
+    TEST_ASSERT_EQUAL_UINT16(200, list.nets[0].latencyMs);
+    WifiNetworks_RecordLatency(&list, 0, 600);
+    TEST_ASSERT_EQUAL_UINT16(300, list.nets[0].latencyMs);
+    WifiNetworks_RecordLatency(&list, 0, 100000);
+    TEST_ASSERT_EQUAL_UINT16((3 * 300 + 65535 + 2) / 4, list.nets[0].latencyMs);
+    WifiNetworks_RecordLatency(&list, 3, 100);          // emplacement vide: ignoré
+    TEST_ASSERT_TRUE(WifiNetworks_IsValid(&list));
+}
+
+// Benchmark: classement après un balayage chargé (centre commercial, 40 AP)
+void test_bench_rank() {
+    char name[16];
+    for (int i = 0; i < WIFI_NETWORKS_MAX; i++) {
+        snprintf(name, sizeof(name), "Known-%d", i);
+        WifiNetworks_Add(&list, name, (uint8_t)(i % 3));
+        WifiNetworks_RecordLatency(&list, i, 100 + 50 * i);
+    }
+    WifiScanEntry scan[40];
+    for (int i = 0; i < 40; i++) {
+        snprintf(name, sizeof(name), i % 8 == 0 ? "Known-%d" : "Other-%d", i % 8 == 0 ? i / 8 : i);
+        scan[i] = ap(name, (int8_t)(-40 - i), (uint8_t)(1 + i % 13));
+    }
+    WifiCandidate c[WIFI_NETWORKS_MAX];
+    const int iterations = 100000;
+    volatile size_t total = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) total = total + WifiNetworks_Rank(&list, scan, 40, c, WIFI_NETWORKS_MAX);
+    auto t1 = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+    TEST_ASSERT_EQUAL(iterations * 5, (int)total);
+    printf("[BENCH] wifi_networks: classement %d réseaux connus / 40 AP en %.2f us (balayage actif ~2000 ms)\n",
+           WIFI_NETWORKS_MAX, us);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests liste
+    RUN_TEST(test_add_update_and_replace_when_full);
+    RUN_TEST(test_blob_validation);
+
+    // Tests sélection
+    RUN_TEST(test_rank_prefers_priority_then_fastest);
+    RUN_TEST(test_latency_moving_average);
+
+    // Benchmark
+    RUN_TEST(test_bench_rank);
+    return UNITY_END();
+}
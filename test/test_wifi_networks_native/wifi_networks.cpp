@@ -0,0 +1,146 @@
+#include "../../include/wifi_networks.h"
+#include <string.h>
+
+static uint32_t crc32(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+void WifiNetworks_Init(WifiNetworkList* l) {
+  memset(l, 0, sizeof(*l));
+  l->version = WIFI_NETWORKS_VERSION;
+  WifiNetworks_Seal(l);
+}
+
+void WifiNetworks_Seal(WifiNetworkList* l) {
+  l->crc = crc32((const uint8_t*)l, offsetof(WifiNetworkList, crc));
+}
+
+bool WifiNetworks_IsValid(const WifiNetworkList* l) {
+  if (l->version != WIFI_NETWORKS_VERSION || l->count > WIFI_NETWORKS_MAX) return false;
+  if (l->crc != crc32((const uint8_t*)l, offsetof(WifiNetworkList, crc))) return false;
+  for (uint8_t i = 0; i < l->count; i++) {
+    if (memchr(l->nets[i].ssid, '\0', sizeof(l->nets[i].ssid)) == nullptr || l->nets[i].ssid[0] == '\0') return false;
+  }
+  return true;
+}
+
+int WifiNetworks_Find(const WifiNetworkList* l, const char* ssid) {
+  if (!ssid) return -1;
+  for (uint8_t i = 0; i < l->count; i++) {
+    if (strcmp(l->nets[i].ssid, ssid) == 0) return i;
+  }
+  return -1;
+}
+
+// Emplacement sacrifié quand la liste est pleine
+static bool worse(const WifiNetwork* a, const WifiNetwork* b) {
+  if (a->priority != b->priority) return a->priority < b->priority;
+  if (a->failures != b->failures) return a->failures > b->failures;
+  return a->lastSeenScan < b->lastSeenScan;
+}
+
+int WifiNetworks_Add(WifiNetworkList* l, const char* ssid, uint8_t priority) {
+  size_t len = ssid ? strlen(ssid) : 0;
+  if (len == 0 || len > WIFI_NET_SSID_MAX) return -1;
+  if (priority > WIFI_NET_PRIORITY_MAX) priority = WIFI_NET_PRIORITY_MAX;
+  int index = WifiNetworks_Find(l, ssid);
+  if (index >= 0) {
+    // Nouveau mot de passe ou priorité: les échecs passés ne comptent plus
+    l->nets[index].priority = priority;
+    l->nets[index].failures = 0;
+    WifiNetworks_Seal(l);
+    return index;
+  }
+  if (l->count < WIFI_NETWORKS_MAX) {
+    index = l->count++;
+  } else {
+    index = 0;
+    for (int i = 1; i < WIFI_NETWORKS_MAX; i++) {
+      if (worse(&l->nets[i], &l->nets[index])) index = i;
+    }
+  }
+  WifiNetwork* n = &l->nets[index];
+  memset(n, 0, sizeof(*n));
+  memcpy(n->ssid, ssid, len);
+  n->priority = priority;
+  WifiNetworks_Seal(l);
+  return index;
+}
+
+bool WifiNetworks_Remove(WifiNetworkList* l, int index, int* movedFrom) {
+  if (movedFrom) *movedFrom = -1;
+  if (index < 0 || index >= l->count) return false;
+  int last = l->count - 1;
+  if (index != last) {
+    l->nets[index] = l->nets[last];
+    if (movedFrom) *movedFrom = last;
+  }
+  memset(&l->nets[last], 0, sizeof(l->nets[last]));
+  l->count--;
+  WifiNetworks_Seal(l);
+  return true;
+}
+
+int32_t WifiNetworks_Cost(const WifiNetwork* n, int8_t rssi) {
+  int32_t cost = n->latencyMs ? n->latencyMs : WIFI_NET_UNKNOWN_LATENCY_MS;
+  cost -= (int32_t)n->priority * WIFI_NET_PRIORITY_WEIGHT_MS;
+  if (rssi < WIFI_NET_WEAK_RSSI) cost += (WIFI_NET_WEAK_RSSI - rssi) * WIFI_NET_RSSI_PENALTY_MS;
+  cost += (int32_t)n->failures * WIFI_NET_FAILURE_PENALTY_MS;
+  return cost;
+}
+
+size_t WifiNetworks_Rank(WifiNetworkList* l, const WifiScanEntry* scan, size_t scanCount,
+                         WifiCandidate* out, size_t outMax) {
+  l->scanSeq++;
+  size_t n = 0;
+  for (uint8_t i = 0; i < l->count; i++) {
+    int best = -1;
+    for (size_t s = 0; s < scanCount; s++) {
+      if (strcmp(scan[s].ssid, l->nets[i].ssid) != 0 || scan[s].rssi < WIFI_NET_MIN_RSSI) continue;
+      if (best < 0 || scan[s].rssi > scan[best].rssi) best = (int)s;
+    }
+    if (best < 0) continue;
+    l->nets[i].lastRssi = scan[best].rssi;
+    l->nets[i].lastSeenScan = l->scanSeq;
+    if (n == outMax) continue;
+    WifiCandidate c = { i, (uint8_t)best, WifiNetworks_Cost(&l->nets[i], scan[best].rssi) };
+    // Insertion triée (au plus WIFI_NETWORKS_MAX candidats); à coût égal, signal le plus fort
+    size_t pos = n;
+    while (pos > 0 && (out[pos - 1].cost > c.cost ||
+                       (out[pos - 1].cost == c.cost && scan[out[pos - 1].scanIndex].rssi < scan[best].rssi))) {
+      out[pos] = out[pos - 1];
+      pos--;
+    }
+    out[pos] = c;
+    n++;
+  }
+  WifiNetworks_Seal(l);
+  return n;
+}
+
+void WifiNetworks_OnConnected(WifiNetworkList* l, int index) {
+  if (index < 0 || index >= l->count) return;
+  l->nets[index].failures = 0;
+  if (l->nets[index].connects < 0xFFFF) l->nets[index].connects++;
+  WifiNetworks_Seal(l);
+}
+
+void WifiNetworks_OnFailed(WifiNetworkList* l, int index) {
+  if (index < 0 || index >= l->count) return;
+  if (l->nets[index].failures < 0xFF) l->nets[index].failures++;
+  WifiNetworks_Seal(l);
+}
+
+void WifiNetworks_RecordLatency(WifiNetworkList* l, int index, uint32_t latencyMs) {
+  if (index < 0 || index >= l->count) return;
+  if (latencyMs == 0) latencyMs = 1;
+  if (latencyMs > 0xFFFF) latencyMs = 0xFFFF;
+  WifiNetwork* n = &l->nets[index];
+  n->latencyMs = n->latencyMs ? (uint16_t)((3u * n->latencyMs + latencyMs + 2) / 4) : (uint16_t)latencyMs;
+  WifiNetworks_Seal(l);
+}
@@ -0,0 +1,102 @@
+#include <unity.h>
+#include "../../include/wifi_power.h"
+#include <stdio.h>
+
+static WifiPower power;
+
+void setUp(void) {
+    // Valeurs de banc: ~30 mA en modem sleep (DTIM 1), ~110 mA radio éveillée
+    WifiPower_Init(&power, WIFI_POWER_MODEM_SLEEP, 30, 110, 1000);
+}
+void tearDown(void) {}
+
+// Tests politique
+void test_transaction_switches_mode_once() {
+    TEST_ASSERT_EQUAL(WIFI_POWER_AWAKE, WifiPower_ModeFor(true));
+    TEST_ASSERT_EQUAL(WIFI_POWER_MODEM_SLEEP, WifiPower_ModeFor(false));
+
+    // Appelé à chaque tour de boucle de l'orchestrateur: seuls les changements comptent
+    TEST_ASSERT_FALSE(WifiPower_SetMode(&power, WIFI_POWER_MODEM_SLEEP, 1500));
+    TEST_ASSERT_TRUE(WifiPower_SetMode(&power, WIFI_POWER_AWAKE, 2000));
+    TEST_ASSERT_FALSE(WifiPower_SetMode(&power, WIFI_POWER_AWAKE, 2100));
+    TEST_ASSERT_TRUE(WifiPower_SetMode(&power, WIFI_POWER_MODEM_SLEEP, 6000));
+    TEST_ASSERT_FALSE(WifiPower_SetMode(&power, WIFI_POWER_MODES, 7000));
+
+    TEST_ASSERT_EQUAL_UINT32(2, power.modes[WIFI_POWER_MODEM_SLEEP].entries);
+    TEST_ASSERT_EQUAL_UINT32(1, power.modes[WIFI_POWER_AWAKE].entries);
+    TEST_ASSERT_EQUAL_UINT32(1000 + 4000, (uint32_t)WifiPower_TimeMs(&power, WIFI_POWER_MODEM_SLEEP, 10000));
+    TEST_ASSERT_EQUAL_UINT32(4000, (uint32_t)WifiPower_TimeMs(&power, WIFI_POWER_AWAKE, 10000));
+}
+
+// Tests mesures
+void test_latency_attributed_to_current_mode() {
+    WifiPower_Record(&power, WIFI_POWER_SAMPLE_TCP, 180);
+    WifiPower_Record(&power, WIFI_POWER_SAMPLE_HTTP, 620);
+    WifiPower_Record(&power, WIFI_POWER_SAMPLE_HTTP, 380);
+    WifiPower_SetMode(&power, WIFI_POWER_AWAKE, 2000);
+    WifiPower_Record(&power, WIFI_POWER_SAMPLE_HTTP, 240);
+    WifiPower_Record(&power, WIFI_POWER_SAMPLE_HTTP, 260);
+
+    TEST_ASSERT_EQUAL_UINT32(500, WifiPower_AvgLatencyMs(&power, WIFI_POWER_MODEM_SLEEP, WIFI_POWER_SAMPLE_HTTP));
+    TEST_ASSERT_EQUAL_UINT32(620, power.modes[WIFI_POWER_MODEM_SLEEP].latency[WIFI_POWER_SAMPLE_HTTP].maxMs);
+    TEST_ASSERT_EQUAL_UINT32(180, WifiPower_AvgLatencyMs(&power, WIFI_POWER_MODEM_SLEEP, WIFI_POWER_SAMPLE_TCP));
+    TEST_ASSERT_EQUAL_UINT32(250, WifiPower_AvgLatencyMs(&power, WIFI_POWER_AWAKE, WIFI_POWER_SAMPLE_HTTP));
+    TEST_ASSERT_EQUAL_UINT32(0, WifiPower_AvgLatencyMs(&power, WIFI_POWER_AWAKE, WIFI_POWER_SAMPLE_TCP));
+}
+
+void test_average_current_weighted_by_time() {
+    TEST_ASSERT_EQUAL_UINT32(300, WifiPower_AvgCurrentDeciMa(&power, 1000));   // aucun temps écoulé
+    // 90 s au repos, 10 s de transaction: 0.9 * 30 + 0.1 * 110 = 38 mA
+    WifiPower_SetMode(&power, WIFI_POWER_AWAKE, 91000);
+    WifiPower_SetMode(&power, WIFI_POWER_MODEM_SLEEP, 101000);
+    TEST_ASSERT_EQUAL_UINT32(380, WifiPower_AvgCurrentDeciMa(&power, 101000));
+    // Radio toujours éveillée (ancien comportement sans modem sleep): 110 mA
+    WifiPower_Init(&power, WIFI_POWER_AWAKE, 30, 110, 0);
+    TEST_ASSERT_EQUAL_UINT32(1100, WifiPower_AvgCurrentDeciMa(&power, 100000));
+
+    // À travers le débordement de millis()
+    WifiPower_Init(&power, WIFI_POWER_MODEM_SLEEP, 30, 110, 0xFFFFF000u);
+    TEST_ASSERT_EQUAL_UINT32(0x2000, (uint32_t)WifiPower_TimeMs(&power, WIFI_POWER_MODEM_SLEEP, 0x00001000u));
+}
+
+// Benchmark: latence ajoutée par le modem sleep (modèle). Réveil aux balises DTIM:
+// une réponse arrive au hasard dans l'intervalle, attente moyenne d'un demi-intervalle
+// par aller-retour; une requête HTTPS (TCP + TLS + requête) compte ~4 allers-retours.
+void test_bench_dtim_latency_model() {
+    const int dtims[] = { 1, 3, 10 };
+    for (unsigned i = 0; i < sizeof(dtims) / sizeof(dtims[0]); i++) {
+        double intervalMs = 102.4 * dtims[i];
+        double perRoundTrip = intervalMs / 2;
+        printf("[BENCH] wifi_power DTIM %2d (%.0f ms): +%.0f ms moyen par aller-retour, "
+               "+%.0f ms par requête HTTPS (4 A/R), pire cas +%.0f ms -> 0 en WIFI_PS_NONE\n",
+               dtims[i], intervalMs, perRoundTrip, 4 * perRoundTrip, 4 * intervalMs);
+    }
+    // Journée type: 200 transactions de 15 s, radio éveillée uniquement pendant celles-ci
+    WifiPower_Init(&power, WIFI_POWER_MODEM_SLEEP, 30, 110, 0);
+    uint32_t now = 0;
+    for (int t = 0; t < 200; t++) {
+        now += 417000;
+        WifiPower_SetMode(&power, WIFI_POWER_AWAKE, now);
+        now += 15000;
+        WifiPower_SetMode(&power, WIFI_POWER_MODEM_SLEEP, now);
+    }
+    uint32_t avg = WifiPower_AvgCurrentDeciMa(&power, now);
+    TEST_ASSERT_TRUE(avg > 300 && avg < 350);
+    printf("[BENCH] wifi_power: 200 transactions/jour -> %.1f mA moyen (30.0 mA modem sleep permanent, 110.0 mA sans modem sleep)\n",
+           avg / 10.0);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests politique
+    RUN_TEST(test_transaction_switches_mode_once);
+
+    // Tests mesures
+    RUN_TEST(test_latency_attributed_to_current_mode);
+    RUN_TEST(test_average_current_weighted_by_time);
+
+    // Benchmark
+    RUN_TEST(test_bench_dtim_latency_model);
+    return UNITY_END();
+}
@@ -0,0 +1,59 @@
+#include "../../include/wifi_power.h"
+#include <string.h>
+
+void WifiPower_Init(WifiPower* p, WifiPowerMode mode, uint16_t sleepMa, uint16_t awakeMa, uint32_t nowMs) {
+  if (!p) return;
+  memset(p, 0, sizeof(*p));
+  p->mode = mode < WIFI_POWER_MODES ? mode : WIFI_POWER_MODEM_SLEEP;
+  p->sinceMs = nowMs;
+  p->currentMa[WIFI_POWER_MODEM_SLEEP] = sleepMa;
+  p->currentMa[WIFI_POWER_AWAKE] = awakeMa;
+  p->modes[p->mode].entries = 1;
+}
+
+WifiPowerMode WifiPower_ModeFor(bool transactionActive) {
+  return transactionActive ? WIFI_POWER_AWAKE : WIFI_POWER_MODEM_SLEEP;
+}
+
+bool WifiPower_SetMode(WifiPower* p, WifiPowerMode mode, uint32_t nowMs) {
+  if (!p || mode >= WIFI_POWER_MODES || mode == p->mode) return false;
+  p->modes[p->mode].timeMs += nowMs - p->sinceMs;
+  p->mode = mode;
+  p->sinceMs = nowMs;
+  p->modes[mode].entries++;
+  return true;
+}
+
+void WifiPower_Record(WifiPower* p, WifiPowerSample kind, uint32_t latencyMs) {
+  if (!p || kind >= WIFI_POWER_SAMPLES) return;
+  WifiPowerLatency* l = &p->modes[p->mode].latency[kind];
+  l->count++;
+  l->sumMs += latencyMs;
+  if (latencyMs > l->maxMs) l->maxMs = latencyMs;
+}
+
+uint64_t WifiPower_TimeMs(const WifiPower* p, WifiPowerMode mode, uint32_t nowMs) {
+  if (!p || mode >= WIFI_POWER_MODES) return 0;
+  uint64_t t = p->modes[mode].timeMs;
+  if (mode == p->mode) t += nowMs - p->sinceMs;
+  return t;
+}
+
+uint32_t WifiPower_AvgLatencyMs(const WifiPower* p, WifiPowerMode mode, WifiPowerSample kind) {
+  if (!p || mode >= WIFI_POWER_MODES || kind >= WIFI_POWER_SAMPLES) return 0;
+  const WifiPowerLatency* l = &p->modes[mode].latency[kind];
+  return l->count ? (uint32_t)(l->sumMs / l->count) : 0;
+}
+
+uint32_t WifiPower_AvgCurrentDeciMa(const WifiPower* p, uint32_t nowMs) {
+  if (!p) return 0;
+  uint64_t total = 0;
+  uint64_t weighted = 0;
+  for (int m = 0; m < WIFI_POWER_MODES; m++) {
+    uint64_t t = WifiPower_TimeMs(p, (WifiPowerMode)m, nowMs);
+    total += t;
+    weighted += t * p->currentMa[m] * 10u;
+  }
+  if (total == 0) return (uint32_t)p->currentMa[p->mode] * 10u;
+  return (uint32_t)((weighted + total / 2) / total);
+}
@@ -0,0 +1,133 @@
+#include <unity.h>
+#include "../../include/wifi_reconnect.h"
+#include <stdio.h>
+
+static WifiReconnect rc;
+static const WifiRcConfig cfg = { 500, 60000, 15000 };
+
+void setUp(void) {
+    WifiRc_Init(&rc, &cfg, 12345);
+}
+void tearDown(void) {}
+
+// Tests délai exponentiel
+void test_backoff_doubles_with_jitter_and_cap() {
+    // Tirage minimal: moitié du délai, maximal: délai entier
+    TEST_ASSERT_EQUAL_UINT32(250, WifiRc_BackoffMs(&cfg, 0, 0));
+    TEST_ASSERT_EQUAL_UINT32(500, WifiRc_BackoffMs(&cfg, 0, 250));
+    TEST_ASSERT_EQUAL_UINT32(1000, WifiRc_BackoffMs(&cfg, 2, 0));
+    TEST_ASSERT_EQUAL_UINT32(2000, WifiRc_BackoffMs(&cfg, 2, 1000));
+    TEST_ASSERT_EQUAL_UINT32(30000, WifiRc_BackoffMs(&cfg, 7, 0));     // 64000 plafonné à 60000
+    TEST_ASSERT_EQUAL_UINT32(60000, WifiRc_BackoffMs(&cfg, 1000, 30000));
+
+    // Gigue: les délais tirés couvrent l'intervalle [délai/2, délai]
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (int i = 0; i < 1000; i++) {
+        rc.failures = 2;
+        WifiRc_OnAttempt(&rc, 0);
+        WifiRc_OnDisconnected(&rc, WIFI_RC_REASON_NO_AP_FOUND, 0);   // 3e échec: 4000 ms
+        uint32_t d = rc.deadlineMs;
+        if (d < lo) lo = d;
+        if (d > hi) hi = d;
+    }
+    TEST_ASSERT_TRUE(lo >= 2000 && lo < 2200);
+    TEST_ASSERT_TRUE(hi <= 4000 && hi > 3800);
+}
+
+// Tests machine à états
+void test_drop_then_reconnect_cycle() {
+    WifiRc_OnAttempt(&rc, 0);
+    TEST_ASSERT_EQUAL(WIFI_RC_CONNECTING, rc.state);
+    WifiRc_OnGotIp(&rc);
+    TEST_ASSERT_EQUAL(WIFI_RC_CONNECTED, rc.state);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, WifiRc_NextDelayMs(&rc, 100));
+    TEST_ASSERT_FALSE(WifiRc_ShouldAttempt(&rc, 100000));
+
+    // Coupure: première tentative rapide (250..500 ms)
+    WifiRc_OnDisconnected(&rc, 8, 1000);
+    TEST_ASSERT_EQUAL(WIFI_RC_BACKOFF, rc.state);
+    TEST_ASSERT_EQUAL_UINT32(1, rc.disconnects);
+    TEST_ASSERT_EQUAL_UINT16(8, rc.lastReason);
+    uint32_t wait = WifiRc_NextDelayMs(&rc, 1000);
+    TEST_ASSERT_TRUE(wait >= 250 && wait <= 500);
+    TEST_ASSERT_FALSE(WifiRc_ShouldAttempt(&rc, 1000 + wait - 1));
+    TEST_ASSERT_TRUE(WifiRc_ShouldAttempt(&rc, 1000 + wait));
+
+    // Déconnexions répétées pendant l'attente: ignorées
+    WifiRc_OnDisconnected(&rc, 201, 1001);
+    TEST_ASSERT_EQUAL_UINT32(1, rc.disconnects);
+    TEST_ASSERT_EQUAL_UINT32(0, rc.failures);
+
+    // Échecs successifs: délai croissant
+    uint32_t now = 2000;
+    for (uint32_t i = 1; i <= 3; i++) {
+        WifiRc_OnAttempt(&rc, now);
+        WifiRc_OnDisconnected(&rc, WIFI_RC_REASON_NO_AP_FOUND, now + 100);
+        TEST_ASSERT_EQUAL_UINT32(i, rc.failures);
+        wait = WifiRc_NextDelayMs(&rc, now + 100);
+        TEST_ASSERT_TRUE(wait >= (500u << i) / 2 && wait <= (500u << i));
+        now += 100 + wait;
+        TEST_ASSERT_TRUE(WifiRc_ShouldAttempt(&rc, now));
+    }
+    WifiRc_OnAttempt(&rc, now);
+    WifiRc_OnGotIp(&rc);
+    TEST_ASSERT_EQUAL_UINT32(0, rc.failures);
+    TEST_ASSERT_EQUAL_UINT32(5, rc.attempts);
+}
+
+void test_silent_attempt_and_auth_failure() {
+    // Tentative sans réponse du pilote: échec au bout de attemptTimeoutMs
+    WifiRc_OnAttempt(&rc, 0xFFFFF000u);
+    TEST_ASSERT_FALSE(WifiRc_ShouldAttempt(&rc, 0xFFFFF000u + 14999));
+    TEST_ASSERT_EQUAL(WIFI_RC_CONNECTING, rc.state);
+    TEST_ASSERT_FALSE(WifiRc_ShouldAttempt(&rc, 0xFFFFF000u + 15000));   // à travers le débordement
+    TEST_ASSERT_EQUAL(WIFI_RC_BACKOFF, rc.state);
+    TEST_ASSERT_EQUAL_UINT32(1, rc.failures);
+
+    // Mot de passe refusé: délai maximal sans attendre la montée exponentielle
+    WifiRc_OnAttempt(&rc, 0);
+    WifiRc_OnDisconnected(&rc, WIFI_RC_REASON_AUTH_FAIL, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, rc.authFailures);
+    TEST_ASSERT_TRUE(WifiRc_NextDelayMs(&rc, 0) >= 30000);
+
+    // Sans credentials: jamais de tentative
+    WifiRc_Init(&rc, &cfg, 0);
+    TEST_ASSERT_FALSE(WifiRc_ShouldAttempt(&rc, 1000000));
+    WifiRc_OnDisconnected(&rc, 8, 0);
+    TEST_ASSERT_EQUAL(WIFI_RC_IDLE, rc.state);
+}
+
+// Tests hôte du backend
+void test_parse_backend_host() {
+    char host[64];
+    uint16_t port = 0;
+    TEST_ASSERT_TRUE(WifiRc_ParseHost("https://iot-vending-machine.osc-fr1.scalingo.io", host, sizeof(host), &port));
+    TEST_ASSERT_EQUAL_STRING("iot-vending-machine.osc-fr1.scalingo.io", host);
+    TEST_ASSERT_EQUAL_UINT16(443, port);
+    TEST_ASSERT_TRUE(WifiRc_ParseHost("http://192.168.1.10:3000/api", host, sizeof(host), &port));
+    TEST_ASSERT_EQUAL_STRING("192.168.1.10", host);
+    TEST_ASSERT_EQUAL_UINT16(3000, port);
+    TEST_ASSERT_TRUE(WifiRc_ParseHost("http://backend/", host, sizeof(host), &port));
+    TEST_ASSERT_EQUAL_UINT16(80, port);
+
+    TEST_ASSERT_FALSE(WifiRc_ParseHost("ftp://backend", host, sizeof(host), &port));
+    TEST_ASSERT_FALSE(WifiRc_ParseHost("https://", host, sizeof(host), &port));
+    TEST_ASSERT_FALSE(WifiRc_ParseHost("https://backend:99999", host, sizeof(host), &port));
+    TEST_ASSERT_FALSE(WifiRc_ParseHost("https://backend:80x", host, sizeof(host), &port));
+    TEST_ASSERT_FALSE(WifiRc_ParseHost("https://a-very-long-host-name.example", host, 8, &port));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Tests délai exponentiel
+    RUN_TEST(test_backoff_doubles_with_jitter_and_cap);
+
+    // Tests machine à états
+    RUN_TEST(test_drop_then_reconnect_cycle);
+    RUN_TEST(test_silent_attempt_and_auth_failure);
+
+    // Tests hôte du backend
+    RUN_TEST(test_parse_backend_host);
+    return UNITY_END();
+}
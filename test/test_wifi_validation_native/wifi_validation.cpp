@@ -1,49 +1,23 @@
 #include "../../include/wifi_validation.h"
+#include "../../include/char_class.h"
 #include <string.h>
 
+// SSID: octets quelconques (UTF-8) sauf caractères de contrôle autres que TAB et DEL
+static constexpr CharClass SSID_BYTES =
+    CharClass_Union(CharClass_Union(CHAR_CLASS_PRINTABLE, CharClass_FromRange(0x80, 0xFF)), CharClass_FromChars("\t"));
+
 bool Wifi_IsValidSsid_C(const char* ssid) {
-    if (!ssid) return false;
-    size_t len = strlen(ssid);
-    if (len == 0 || len > 32) return false; // SSID max 32 bytes selon IEEE 802.11
-    
-    // Vérifier les caractères autorisés (UTF-8 basique)
-    for (size_t i = 0; i < len; i++) {
-        unsigned char c = (unsigned char)ssid[i];
-        // Rejeter les caractères de contrôle
-        if (c < 0x20 && c != 0x09) return false; // Sauf TAB
-        // Rejeter DEL
-        if (c == 0x7F) return false;
-    }
-    
-    return true;
+    // SSID max 32 bytes selon IEEE 802.11
+    return CharClass_Matches(&SSID_BYTES, ssid, 1, 32);
 }
 
 bool Wifi_IsValidPassword_C(const char* password) {
     if (!password) return true; // Réseau ouvert autorisé
-    size_t len = strlen(password);
-    if (len == 0) return true; // Mot de passe vide = réseau ouvert
-    
-    // WPA/WPA2: 8-63 caractères ASCII ou 64 caractères hex
-    if (len < 8) return false;
-    if (len > 64) return false;
-    
-    // Si exactement 64 caractères, doit être hexadécimal (PSK)
-    if (len == 64) {
-        for (size_t i = 0; i < len; i++) {
-            char c = password[i];
-            if (!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'))) {
-                return false;
-            }
-        }
-    } else {
-        // Sinon, vérifier les caractères ASCII imprimables
-        for (size_t i = 0; i < len; i++) {
-            unsigned char c = (unsigned char)password[i];
-            if (c < 0x20 || c > 0x7E) return false;
-        }
-    }
+    if (password[0] == '\0') return true; // Mot de passe vide = réseau ouvert
     
-    return true;
+    // WPA/WPA2: 8-63 caractères ASCII imprimables ou 64 caractères hex (PSK)
+    return CharClass_Matches(&CHAR_CLASS_PRINTABLE, password, 8, 63) ||
+           CharClass_Matches(&CHAR_CLASS_HEX, password, 64, 64);
 }
 
 bool Wifi_IsValidChannel_C(int channel) {